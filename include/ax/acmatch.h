@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_ACMATCH_H
+#define AX_ACMATCH_H
+#include "type/trie.h"
+#include "iobuf.h"
+#include <stdint.h>
+
+#ifndef AX_ACMATCH_DEFINED
+#define AX_ACMATCH_DEFINED
+typedef struct ax_acmatch_st ax_acmatch;
+#endif
+
+#ifndef AX_ACMATCH_STREAM_DEFINED
+#define AX_ACMATCH_STREAM_DEFINED
+typedef struct ax_acmatch_stream_st ax_acmatch_stream;
+#endif
+
+/*
+ * Aho-Corasick automaton matching all keys of a trie of byte words in one
+ * pass over the input. Transitions are a flat table of one row per state,
+ * indexed by the class of the input byte, where all bytes absent from the
+ * patterns share a class. The automaton is read-only once compiled and can
+ * be shared by streams in different threads.
+ */
+
+struct ax_acmatch_st
+{
+	uint32_t *delta;
+	struct ax_acmatch_state_st *states;
+	uint32_t nstates;
+	uint32_t npatterns;
+	uint16_t nclasses;
+	uint8_t classes[256];
+};
+
+struct ax_acmatch_stream_st
+{
+	const ax_acmatch *ac;
+	uint32_t state;
+	size_t offset;
+};
+
+/* Return the id reported for the pattern, val is the value in the trie */
+typedef uint32_t (*ax_acmatch_id_f)(const void *val, void *ctx);
+
+/* end is the offset just after the match in the stream, return true to stop */
+typedef bool (*ax_acmatch_cb_f)(size_t end, size_t len, uint32_t id, void *ctx);
+
+/*
+ * Compile the keys of trie as patterns, the key words must be one byte in
+ * size and the empty key is ignored. Without id_f, the id of each pattern
+ * is its position in byte order.
+ */
+ax_fail ax_acmatch_compile(ax_acmatch *ac, const ax_trie *trie, ax_acmatch_id_f id_f, void *ctx);
+
+void ax_acmatch_free(ax_acmatch *ac);
+
+inline static size_t ax_acmatch_size(const ax_acmatch *ac)
+{
+	return ac->npatterns;
+}
+
+/* Report the matches in a single buffer, return the bytes scanned */
+size_t ax_acmatch_scan(const ax_acmatch *ac, const void *data, size_t size, ax_acmatch_cb_f cb, void *ctx);
+
+inline static void ax_acmatch_stream_init(ax_acmatch_stream *st, const ax_acmatch *ac)
+{
+	st->ac = ac;
+	st->state = 0;
+	st->offset = 0;
+}
+
+/*
+ * Continue the stream with the next chunk, matches may span chunks. Return
+ * the bytes consumed, which is less than size only if cb stopped it.
+ */
+size_t ax_acmatch_stream_feed(ax_acmatch_stream *st, const void *data, size_t size, ax_acmatch_cb_f cb, void *ctx);
+
+/* Consume the data in b as the next chunks of the stream */
+size_t ax_acmatch_stream_feed_iobuf(ax_acmatch_stream *st, ax_iobuf *b, ax_acmatch_cb_f cb, void *ctx);
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_ART_H
+#define AX_ART_H
+#include "type/trie.h"
+
+#ifndef AX_ART_DEFINED
+#define AX_ART_DEFINED
+typedef struct ax_art_st ax_art;
+#endif
+
+/*
+ * Adaptive radix tree, the words of keys must be single bytes such as
+ * ax_t(char) or ax_t(u8), and the children of a node are visited in
+ * unsigned byte order. Inner nodes hold 4, 16, 48 or 256 children and grow
+ * or shrink as needed, single-child paths are compressed into the node
+ * below, and a key is stored whole in one leaf, so a trie node made of a
+ * path or a leaf tail costs no memory. Iterators and value pointers are
+ * invalidated by insertion and erasure.
+ */
+
+#define ax_baseof_ax_art ax_trie
+ax_concrete_declare(4, ax_art);
+
+extern const ax_trie_trait ax_art_tr;
+
+ax_trie *__ax_art_construct(const ax_trait* key_tr, const ax_trait* val_tr);
+
+inline static ax_concrete_creator(ax_art, const ax_trait* key_tr, const ax_trait* val_tr)
+{
+	return __ax_art_construct(key_tr, val_tr);
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_ATOM_H
+#define AX_ATOM_H
+#include "trait.h"
+
+#ifndef AX_ATOM_DEFINED
+#define AX_ATOM_DEFINED
+typedef struct ax_atom_st ax_atom;
+#endif
+
+/*
+ * String interning table shared by threads. Each distinct string is stored
+ * once and interning it again returns the same pointer, so two atoms from
+ * the same table are equal exactly when the pointers are. The strings are
+ * packed into blocks that are only released with the table. Like ax_chmap,
+ * the table is split into shards guarded by their own read-write locks.
+ */
+
+ax_atom *ax_atom_create(size_t nshard);
+
+void ax_atom_free(ax_atom *atom);
+
+/* Return the canonical copy of the string, or NULL if out of memory */
+const char *ax_atom_intern(ax_atom *atom, const char *s);
+
+const char *ax_atom_intern_n(ax_atom *atom, const char *s, size_t len);
+
+/* Return the canonical copy if the string has been interned, or NULL */
+const char *ax_atom_lookup(ax_atom *atom, const char *s);
+
+size_t ax_atom_size(ax_atom *atom);
+
+/* Length of an interned string, without scanning it */
+size_t ax_atom_length(const char *s);
+
+/*
+ * Trait of interned strings, the element is the pointer returned by the
+ * table. Equality and hash only look at the pointer, and the order is the
+ * order of addresses, which is stable but has nothing to do with the text.
+ * Copying and freeing an element leave the string to the table.
+ */
+extern const ax_trait ax_t_atom;
+
+typedef const char *ax_type(atom);
+
+#endif
@@ -38,5 +38,38 @@ extern const ax_map_trait ax_hmap_tr;
 
 ax_concrete_creator(ax_avl, const ax_trait* key_tr, const ax_trait* val_tr);
 
+/*
+ * Insert n pairs from arrays of keys and values, keys must be in strictly
+ * ascending order. If vals is NULL, values are initialized by default. An
+ * empty tree is built bottom-up in linear time, otherwise the pairs are put
+ * one by one. On failure of building an empty tree, it stays empty.
+ */
+ax_fail ax_avl_build(ax_avl *avl, const void *keys, const void *vals, size_t n);
+
+/* Same as ax_avl_build, taking pairs from [first, last) of a map with the same traits */
+ax_fail ax_avl_build_range(ax_avl *avl, const ax_citer *first, const ax_citer *last);
+
+/*
+ * The following operations relink the nodes of the trees instead of copying
+ * pairs, so they never fail, and iterators to the pairs which are kept stay
+ * valid. Two trees operated together must have the same key trait, and the
+ * same value trait if pairs are moved between them.
+ */
+
+/* Move the pairs whose keys are not less than key to right, which must be empty */
+void ax_avl_split(ax_avl *avl, const void *key, ax_avl *right);
+
+/* Move all pairs of right to avl, keys in right must be greater than all keys in avl */
+void ax_avl_join(ax_avl *avl, ax_avl *right);
+
+/* Move all pairs of other to avl, replacing the pairs of the same keys in avl */
+void ax_avl_union(ax_avl *avl, ax_avl *other);
+
+/* Erase the pairs whose keys are not in other */
+void ax_avl_intersection(ax_avl *avl, const ax_avl *other);
+
+/* Erase the pairs whose keys are in other */
+void ax_avl_difference(ax_avl *avl, const ax_avl *other);
+
 #endif
 
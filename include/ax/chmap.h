@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_CHMAP_H
+#define AX_CHMAP_H
+#include "trait.h"
+#include "type/map.h"
+
+#ifndef AX_CHMAP_DEFINED
+#define AX_CHMAP_DEFINED
+typedef struct ax_chmap_st ax_chmap;
+#endif
+
+/*
+ * Hash map shared by threads. Keys are spread over shards, each shard is an
+ * ax_hmap guarded by its own read-write lock, so threads working on
+ * different shards do not contend. Values never leave the map by pointer,
+ * they are copied out by the value trait and must be freed by the caller
+ * with ax_trait_free().
+ */
+
+/* Initialize the value at val for the absent key, returns true on failure */
+typedef ax_fail ax_chmap_compute_f(const void *key, void *val, void *arg);
+
+ax_chmap *ax_chmap_create(const ax_trait *key_tr, const ax_trait *val_tr, size_t nshard);
+
+void ax_chmap_free(ax_chmap *chmap);
+
+ax_fail ax_chmap_put(ax_chmap *chmap, const void *key, const void *val);
+
+ax_fail ax_chmap_get(ax_chmap *chmap, const void *key, void *val);
+
+bool ax_chmap_exist(ax_chmap *chmap, const void *key);
+
+ax_fail ax_chmap_erase(ax_chmap *chmap, const void *key);
+
+ax_fail ax_chmap_compute_if_absent(ax_chmap *chmap, const void *key,
+		ax_chmap_compute_f *compute, void *arg, void *val);
+
+size_t ax_chmap_size(ax_chmap *chmap);
+
+size_t ax_chmap_shards(const ax_chmap *chmap);
+
+/* Copy all the entries into a new ax_hmap, while every shard is read locked */
+ax_map *ax_chmap_snapshot(ax_chmap *chmap);
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_DATRIE_H
+#define AX_DATRIE_H
+#include "type/trie.h"
+#include <stdint.h>
+
+#ifndef AX_DATRIE_DEFINED
+#define AX_DATRIE_DEFINED
+typedef struct ax_datrie_st ax_datrie;
+#endif
+
+/*
+ * Read-only double-array trie compiled from a trie of byte words, each key
+ * maps to a 32-bit value. The compiled trie is a single flat image without
+ * pointers, it can be written to a file and later mapped into memory and
+ * queried in place by any number of processes. The image is stored in the
+ * native byte order.
+ */
+
+struct ax_datrie_st
+{
+	const uint32_t *units; /* Pairs of base and check */
+	uint32_t nunits;
+	uint32_t nkeys;
+	void *buf; /* The image owned, NULL for a loaded one */
+};
+
+/* Return the value stored for the key, val is the value in the trie */
+typedef uint32_t (*ax_datrie_value_f)(const void *val, void *ctx);
+
+/* Return true to stop enumerating */
+typedef bool (*ax_datrie_enum_cb_f)(const ax_byte *key, size_t len, uint32_t value, void *ctx);
+
+/*
+ * Compile trie into dat. The key words of trie must be one byte in size.
+ * Without value_f, the value of each key is its position in byte order.
+ */
+ax_fail ax_datrie_freeze(ax_datrie *dat, const ax_trie *trie, ax_datrie_value_f value_f, void *ctx);
+
+/*
+ * Use an image saved before, the image is not copied and must stay valid
+ * and 4-byte aligned while dat is in use. Return true if it is malformed.
+ */
+ax_fail ax_datrie_load(ax_datrie *dat, const void *image, size_t size);
+
+const void *ax_datrie_image(const ax_datrie *dat, size_t *size);
+
+void ax_datrie_free(ax_datrie *dat);
+
+inline static size_t ax_datrie_size(const ax_datrie *dat)
+{
+	return dat->nkeys;
+}
+
+bool ax_datrie_get(const ax_datrie *dat, const void *key, size_t len, uint32_t *value);
+
+/* Find the longest key which is a prefix of text */
+bool ax_datrie_longest_prefix(const ax_datrie *dat, const void *text, size_t len,
+		size_t *match_len, uint32_t *value);
+
+/* Enumerate the keys starting with prefix in byte order */
+ax_fail ax_datrie_enum_prefix(const ax_datrie *dat, const void *prefix, size_t len,
+		ax_datrie_enum_cb_f cb, void *ctx);
+
+#endif
@@ -63,6 +63,8 @@ ax_dump *ax_dump_ptr(const void *val);
 
 ax_dump *ax_dump_str(const char *val);
 
+ax_dump *ax_dump_strn(const char *val, size_t len);
+
 ax_dump *ax_dump_wcs(const wchar_t *val);
 
 ax_dump *ax_dump_mem(const void *ptr, size_t size);
@@ -29,6 +29,11 @@
 typedef struct ax_hmap_st ax_hmap;
 #endif
 
+/*
+ * Each node caches the hash of its key, define AX_HMAP_NO_HASH_CACHE when
+ * building the library to trade it for a smaller node.
+ */
+
 #define ax_baseof_ax_hmap ax_map
 ax_concrete_declare(4, ax_hmap);
 
@@ -50,5 +55,31 @@ size_t ax_hmap_threshold(ax_hmap *hmap);
 
 ax_fail ax_hmap_rehash(ax_hmap *hmap, size_t size);
 
+/*
+ * When step is not zero, growing or shrinking the bucket table no longer
+ * moves every node at once. The old table is kept beside the new one and
+ * each put or erase moves at most step buckets of it, lookups consult both
+ * tables meanwhile. Zero (the default) restores the one-shot rehash.
+ */
+ax_fail ax_hmap_set_rehash_step(ax_hmap *hmap, size_t step);
+
+size_t ax_hmap_rehash_step(ax_hmap *hmap);
+
+size_t ax_hmap_rehash_pending(const ax_hmap *hmap);
+
+/*
+ * Operations taking the hash of the key from the caller, for callers which
+ * hashed the key already. The hash is the one returned by ax_hmap_hash(),
+ * keys and values are in the form given to the trait operations, see
+ * ax_trait_in(), and the value returned is the one of ax_map_cget().
+ */
+size_t ax_hmap_hash(const ax_hmap *hmap, const void *key);
+
+void *ax_hmap_put_hashed(ax_hmap *hmap, const void *key, size_t hash, const void *val);
+
+void *ax_hmap_get_hashed(const ax_hmap *hmap, const void *key, size_t hash);
+
+ax_fail ax_hmap_erase_hashed(ax_hmap *hmap, const void *key, size_t hash);
+
 #endif
 
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_IHASH_H
+#define AX_IHASH_H
+#include "def.h"
+
+#ifndef AX_IHASH_DEFINED
+#define AX_IHASH_DEFINED
+typedef struct ax_ihash_st ax_ihash;
+#endif
+
+#ifndef AX_IHASH_NODE_DEFINED
+#define AX_IHASH_NODE_DEFINED
+typedef struct ax_ihash_node_st ax_ihash_node;
+#endif
+
+/*
+ * Intrusive hash table with separate chaining, the node is embedded in the
+ * user structure and carries the hash value given on insertion. Only the
+ * bucket array is allocated, it grows when the table is as large as the
+ * bucket count, and insertion still succeeds with longer chains if the
+ * growing fails. The bucket is picked by the low bits of the hash, so the
+ * hash should be well mixed, ax_hash_u64() will do for integer keys.
+ */
+
+typedef bool ax_ihash_equal_f(const ax_ihash_node *node1, const ax_ihash_node *node2, void *ctx);
+
+struct ax_ihash_node_st
+{
+	ax_ihash_node *next;
+	size_t hash;
+};
+
+struct ax_ihash_st
+{
+	ax_ihash_node **buckets;
+	size_t nbuckets;
+	size_t size;
+	ax_ihash_equal_f *equal;
+	void *ctx;
+};
+
+#define ax_ihash_entry(ptr, type, member) ax_container_of(ptr, type, member)
+
+#define ax_ihash_foreach(pos, ht) \
+	for (pos = ax_ihash_first(ht); pos; pos = ax_ihash_next(ht, pos))
+
+ax_fail ax_ihash_init(ax_ihash *ht, ax_ihash_equal_f *equal, void *ctx);
+
+/* Free the bucket array, the nodes are left to the user */
+void ax_ihash_destroy(ax_ihash *ht);
+
+inline static size_t ax_ihash_size(const ax_ihash *ht)
+{
+	return ht->size;
+}
+
+ax_fail ax_ihash_reserve(ax_ihash *ht, size_t size);
+
+/*
+ * Link the node into the table. If an equal node exists, the table is left
+ * unchanged and that node is returned, otherwise NULL is returned.
+ */
+ax_ihash_node *ax_ihash_insert(ax_ihash *ht, ax_ihash_node *node, size_t hash);
+
+ax_ihash_node *ax_ihash_find(const ax_ihash *ht, const ax_ihash_node *probe, size_t hash);
+
+void ax_ihash_remove(ax_ihash *ht, ax_ihash_node *node);
+
+ax_ihash_node *ax_ihash_first(const ax_ihash *ht);
+
+ax_ihash_node *ax_ihash_next(const ax_ihash *ht, const ax_ihash_node *node);
+
+#endif
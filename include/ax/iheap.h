@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_IHEAP_H
+#define AX_IHEAP_H
+#include "def.h"
+
+#ifndef AX_IHEAP_DEFINED
+#define AX_IHEAP_DEFINED
+typedef struct ax_iheap_st ax_iheap;
+#endif
+
+#ifndef AX_IHEAP_NODE_DEFINED
+#define AX_IHEAP_NODE_DEFINED
+typedef struct ax_iheap_node_st ax_iheap_node;
+#endif
+
+/*
+ * Indexed binary heap over intrusive nodes, the least node by the less
+ * function is on the top. Every node records its own position in the heap,
+ * so that it can be removed or repositioned after its key changed in
+ * O(log n). The heap holds node pointers in an array which grows on demand,
+ * reserve it in advance to keep pushing free of allocation.
+ */
+
+typedef bool ax_iheap_less_f(const ax_iheap_node *node1, const ax_iheap_node *node2, void *ctx);
+
+struct ax_iheap_node_st
+{
+	size_t index;
+};
+
+struct ax_iheap_st
+{
+	ax_iheap_node **table;
+	size_t size;
+	size_t capacity;
+	ax_iheap_less_f *less;
+	void *ctx;
+};
+
+#define AX_IHEAP_NPOS ((size_t)-1)
+
+#define AX_IHEAP_INITIALIZER(less, ctx) { NULL, 0, 0, less, ctx }
+
+#define ax_iheap_entry(ptr, type, member) ax_container_of(ptr, type, member)
+
+inline static void ax_iheap_init(ax_iheap *heap, ax_iheap_less_f *less, void *ctx)
+{
+	heap->table = NULL;
+	heap->size = 0;
+	heap->capacity = 0;
+	heap->less = less;
+	heap->ctx = ctx;
+}
+
+/* Free the pointer array, the nodes are left to the user */
+void ax_iheap_destroy(ax_iheap *heap);
+
+inline static size_t ax_iheap_size(const ax_iheap *heap)
+{
+	return heap->size;
+}
+
+inline static void ax_iheap_node_init(ax_iheap_node *node)
+{
+	node->index = AX_IHEAP_NPOS;
+}
+
+inline static bool ax_iheap_node_linked(const ax_iheap_node *node)
+{
+	return node->index != AX_IHEAP_NPOS;
+}
+
+inline static ax_iheap_node *ax_iheap_top(const ax_iheap *heap)
+{
+	return heap->size ? heap->table[0] : NULL;
+}
+
+ax_fail ax_iheap_reserve(ax_iheap *heap, size_t size);
+
+ax_fail ax_iheap_push(ax_iheap *heap, ax_iheap_node *node);
+
+ax_iheap_node *ax_iheap_pop(ax_iheap *heap);
+
+void ax_iheap_remove(ax_iheap *heap, ax_iheap_node *node);
+
+/* Restore the order after the key of a linked node changed */
+void ax_iheap_update(ax_iheap *heap, ax_iheap_node *node);
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_IRB_H
+#define AX_IRB_H
+#include "def.h"
+
+#ifndef AX_IRB_DEFINED
+#define AX_IRB_DEFINED
+typedef struct ax_irb_st ax_irb;
+#endif
+
+#ifndef AX_IRB_NODE_DEFINED
+#define AX_IRB_NODE_DEFINED
+typedef struct ax_irb_node_st ax_irb_node;
+#endif
+
+/*
+ * Intrusive red-black tree, the node is embedded in the user structure and
+ * the tree never allocates memory. Nodes are ordered by the less function,
+ * lookups take a probe node which is usually embedded in a stack object
+ * holding the key only.
+ */
+
+typedef bool ax_irb_less_f(const ax_irb_node *node1, const ax_irb_node *node2, void *ctx);
+
+struct ax_irb_node_st
+{
+	ax_irb_node *parent, *left, *right;
+	bool red;
+};
+
+struct ax_irb_st
+{
+	ax_irb_node *root;
+	size_t size;
+	ax_irb_less_f *less;
+	void *ctx;
+};
+
+#define AX_IRB_INITIALIZER(less, ctx) { NULL, 0, less, ctx }
+
+#define ax_irb_entry(ptr, type, member) ax_container_of(ptr, type, member)
+
+#define ax_irb_foreach(pos, tree) \
+	for (pos = ax_irb_first(tree); pos; pos = ax_irb_next(pos))
+
+inline static void ax_irb_init(ax_irb *tree, ax_irb_less_f *less, void *ctx)
+{
+	tree->root = NULL;
+	tree->size = 0;
+	tree->less = less;
+	tree->ctx = ctx;
+}
+
+inline static size_t ax_irb_size(const ax_irb *tree)
+{
+	return tree->size;
+}
+
+/*
+ * Link the node into the tree. If an equivalent node exists, the tree is
+ * left unchanged and that node is returned, otherwise NULL is returned.
+ */
+ax_irb_node *ax_irb_insert(ax_irb *tree, ax_irb_node *node);
+
+void ax_irb_remove(ax_irb *tree, ax_irb_node *node);
+
+ax_irb_node *ax_irb_find(const ax_irb *tree, const ax_irb_node *probe);
+
+/* The first node not less than the probe */
+ax_irb_node *ax_irb_lower_bound(const ax_irb *tree, const ax_irb_node *probe);
+
+/* The first node greater than the probe */
+ax_irb_node *ax_irb_upper_bound(const ax_irb *tree, const ax_irb_node *probe);
+
+ax_irb_node *ax_irb_first(const ax_irb *tree);
+
+ax_irb_node *ax_irb_last(const ax_irb *tree);
+
+ax_irb_node *ax_irb_next(const ax_irb_node *node);
+
+ax_irb_node *ax_irb_prev(const ax_irb_node *node);
+
+#endif
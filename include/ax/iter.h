@@ -61,6 +61,7 @@ typedef struct ax_iter_trait_st
 	void     (*swap)  (ax_iter *it1, ax_iter *it2);
 	void    *(*get)   (const ax_citer *it);
 	ax_box  *(*box)   (const ax_citer *it);
+	size_t   (*span)  (      ax_citer *it, const ax_citer *last, size_t max, void **ptr);
 	bool     (norm);
 	unsigned char (type);
 } ax_iter_trait;
@@ -247,6 +248,45 @@ inline static bool ax_iter_is(const ax_iter *it, int type)
 	return ax_citer_is(ax_iter_cc(it), type);
 }
 
+/*
+ * Get the elements stored contiguously from it, at most max of them and not
+ * beyond last, or the end of the container if last is NULL. *ptr is set to the
+ * first element and it is moved past them, the count is returned. Only
+ * iterators with the span operation support it, check ax_citer_spannable.
+ */
+inline static size_t ax_citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr)
+{
+	ax_assert(it->tr->span, "operation not supported");
+	return it->tr->span(it, last, max, ptr);
+}
+
+inline static size_t ax_iter_span(ax_iter *it, const ax_iter *last, size_t max, void **ptr)
+{
+	return ax_citer_span(ax_iter_c(it), ax_iter_cc(last), max, ptr);
+}
+
+inline static bool ax_citer_spannable(const ax_citer *it)
+{
+	return !!it->tr->span;
+}
+
+inline static bool ax_iter_spannable(const ax_iter *it)
+{
+	return ax_citer_spannable(ax_iter_cc(it));
+}
+
+inline static size_t ax_citer_range_size(const ax_citer *first, const ax_citer *last)
+{
+	if (ax_citer_is(first, AX_IT_RAND))
+		return ax_citer_dist(first, last);
+
+	ax_citer it = *first;
+	size_t n = 0;
+	for (; !ax_citer_equal(&it, last); ax_citer_next(&it))
+		n++;
+	return n;
+}
+
 inline static const ax_box *ax_citer_box(const ax_citer *it)
 {
 	ax_assert(it->tr->box, "operation not supported");
@@ -74,6 +74,23 @@ wchar_t *ax_wcsdup(const wchar_t *str);
 
 void *ax_memdup(const void *p, size_t size);
 
+/*
+ * The hash functions below are seeded, the seed is chosen randomly when it
+ * is first used, so that the keys colliding in hash tables can not be worked
+ * out in advance. For reproducible results, set the environment variable
+ * AX_HASH_SEED or call ax_hash_set_seed() before any hash is computed, the
+ * seed can not change once it is used. A seed of 0 stands for a fixed
+ * nonzero one.
+ */
+
+uint64_t ax_hash64(const void *p, size_t size, uint64_t seed);
+
+uint64_t ax_hash_seed(void);
+
+void ax_hash_set_seed(uint64_t seed);
+
+uint64_t ax_hash_u64(uint64_t key);
+
 size_t ax_strhash(const char *s);
 
 size_t ax_wcshash(const wchar_t *s);
@@ -84,6 +101,20 @@ uint64_t ax_hash64_thomas(uint64_t key);
 
 uint64_t ax_hash64inv_thomas(uint64_t key);
 
+/*
+ * The search functions below use SSE2 or AVX2 kernels when the processor
+ * supports them, the kernel is chosen on the first call.
+ * ax_memscan_kernel() returns the name of the kernel in use.
+ */
+
+void *ax_memchr(const void *p, int ch, size_t size);
+
+void *ax_memmem(const void *p, size_t size, const void *pat, size_t pat_size);
+
+char *ax_strchrnul(const char *s, int ch);
+
+const char *ax_memscan_kernel(void);
+
 char *ax_strsplit(char **s, char ch);
 
 size_t ax_strtoargv(char *s, char *argv[], size_t len);
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_PRB_H
+#define AX_PRB_H
+#include "type/map.h"
+
+#ifndef AX_PRB_DEFINED
+#define AX_PRB_DEFINED
+typedef struct ax_prb_st ax_prb;
+#endif
+
+/*
+ * Persistent red-black tree map. Nodes are reference counted and shared
+ * between versions, an update copies the shared nodes on its search path
+ * only, so taking a snapshot costs O(1). A snapshot is immutable and can be
+ * iterated by another thread without locking while the writer goes on, the
+ * nodes are freed when the last version referring to them is released.
+ *
+ * Iterators and value pointers are invalidated by updates, and values must
+ * be changed with ax_map_put. Nodes have no parent pointers, so moving an
+ * iterator costs O(log n) in the worst case.
+ */
+
+#define ax_baseof_ax_prb ax_map
+ax_concrete_declare(4, ax_prb);
+
+extern const ax_map_trait ax_prb_tr;
+
+ax_map *__ax_prb_construct(
+		const ax_trait* key_tr,
+		const ax_trait* val_tr
+);
+
+inline static ax_concrete_creator(ax_prb, const ax_trait* key_tr, const ax_trait* val_tr)
+{
+	return __ax_prb_construct(key_tr, val_tr);
+}
+
+/*
+ * Take an immutable snapshot of prb, release it with ax_one_free. Taking a
+ * snapshot must be serialized with the updates of prb, after that the
+ * snapshot can be read and released in any thread. ax_any_copy returns a
+ * writable version sharing the nodes in the same way.
+ */
+ax_map *ax_prb_snapshot(const ax_prb *prb);
+
+#endif
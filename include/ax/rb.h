@@ -47,5 +47,39 @@ inline static ax_concrete_creator(ax_rb, const ax_trait* key_tr, const ax_trait*
 	return __ax_rb_construct(key_tr, val_tr);
 }
 
+/*
+ * Insert n pairs from arrays of keys and values, keys must be in strictly
+ * ascending order. If vals is NULL, values are initialized by default. An
+ * empty tree is built bottom-up in linear time, otherwise the pairs are put
+ * one by one, in which keys greater than all existing ones are appended
+ * without searching. On failure of building an empty tree, it stays empty.
+ */
+ax_fail ax_rb_build(ax_rb *rb, const void *keys, const void *vals, size_t n);
+
+/* Same as ax_rb_build, taking pairs from [first, last) of a map with the same traits */
+ax_fail ax_rb_build_range(ax_rb *rb, const ax_citer *first, const ax_citer *last);
+
+/*
+ * The following operations relink the nodes of the trees instead of copying
+ * pairs, so they never fail, and iterators to the pairs which are kept stay
+ * valid. Two trees operated together must have the same key trait, and the
+ * same value trait if pairs are moved between them.
+ */
+
+/* Move the pairs whose keys are not less than key to right, which must be empty */
+void ax_rb_split(ax_rb *rb, const void *key, ax_rb *right);
+
+/* Move all pairs of right to rb, keys in right must be greater than all keys in rb */
+void ax_rb_join(ax_rb *rb, ax_rb *right);
+
+/* Move all pairs of other to rb, replacing the pairs of the same keys in rb */
+void ax_rb_union(ax_rb *rb, ax_rb *other);
+
+/* Erase the pairs whose keys are not in other */
+void ax_rb_intersection(ax_rb *rb, const ax_rb *other);
+
+/* Erase the pairs whose keys are in other */
+void ax_rb_difference(ax_rb *rb, const ax_rb *other);
+
 #endif
 
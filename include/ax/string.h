@@ -30,6 +30,23 @@
 typedef struct ax_string_st ax_string;
 #endif
 
+/*
+ * Byte string container, up to AX_STRING_INLINE_CAPACITY chars are stored in
+ * the object itself. Longer strings live in a reference counted buffer which
+ * ax_any_copy() and ax_str_substr() share instead of copying bytes, it is
+ * copied by the first string modifying it. A string which handed out
+ * iterators or the pointer returned by ax_str_strz() is no longer shared by
+ * new copies and substrings. ax_iter_set() on a string sharing its buffer
+ * moves the iterator to a private copy, the other iterators of the string
+ * are invalidated, element pointers and spans of such a string must not be
+ * written through.
+ *
+ * ax_str_split() copies every piece into a C string, to cut a string
+ * without copying, split its view with ax_strview_split().
+ */
+
+#define AX_STRING_INLINE_CAPACITY 22
+
 #define ax_baseof_ax_string ax_str
 ax_concrete_declare(5, ax_string);
 
@@ -40,4 +57,12 @@ inline static ax_concrete_creator0(ax_string)
 	return __ax_string_construct();
 }
 
+bool ax_string_inlined(const ax_string *string);
+
+bool ax_string_shared(const ax_string *string);
+
+/* Read-only access to the chars without making the buffer private, the
+ * chars of a substring are not terminated */
+const char *ax_string_data(const ax_string *string);
+
 #endif
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_STRVIEW_H
+#define AX_STRVIEW_H
+#include "trait.h"
+#include "iobuf.h"
+
+#ifndef AX_STRING_DEFINED
+#define AX_STRING_DEFINED
+typedef struct ax_string_st ax_string;
+#endif
+
+#ifndef AX_BUFF_DEFINED
+#define AX_BUFF_DEFINED
+typedef struct ax_buff_st ax_buff;
+#endif
+
+#ifndef AX_SEQ_DEFINED
+#define AX_SEQ_DEFINED
+typedef struct ax_seq_st ax_seq;
+#endif
+
+#ifndef AX_STRVIEW_DEFINED
+#define AX_STRVIEW_DEFINED
+typedef struct ax_strview_st ax_strview;
+#endif
+
+/*
+ * Chars borrowed from a buffer owned by someone else, not terminated. The
+ * view is only valid while the owner keeps the chars in place, a view taken
+ * from a container is invalidated by anything that modifies it.
+ */
+
+struct ax_strview_st
+{
+	const char *ptr;
+	size_t len;
+};
+
+inline static ax_strview ax_strview_make(const char *ptr, size_t len)
+{
+	assert(ptr || !len);
+	ax_strview view = { ptr, len };
+	return view;
+}
+
+inline static ax_strview ax_strview_cstr(const char *s)
+{
+	assert(s);
+	return ax_strview_make(s, strlen(s));
+}
+
+inline static ax_strview ax_strview_sub(ax_strview view, size_t start, size_t len)
+{
+	assert(start <= view.len && len <= view.len - start);
+	return ax_strview_make(view.ptr + start, len);
+}
+
+int ax_strview_comp(ax_strview view1, ax_strview view2);
+
+inline static bool ax_strview_equal(ax_strview view1, ax_strview view2)
+{
+	return view1.len == view2.len && (!view1.len || !memcmp(view1.ptr, view2.ptr, view1.len));
+}
+
+ax_strview ax_strview_from_string(const ax_string *string);
+
+ax_strview ax_strview_from_buff(const ax_buff *buff);
+
+/* The readable part up to the end of the ring, call ax_iobuf_pullup() first
+ * to take all the data */
+ax_strview ax_strview_from_iobuf(const ax_iobuf *iobuf);
+
+/*
+ * Trait of views, hash, equality and order look at the chars and copying
+ * an element copies the view only. Views passed to containers are pointers
+ * to ax_strview, as for other value types.
+ */
+extern const ax_trait ax_t_strview;
+
+typedef ax_strview ax_type(strview);
+
+/* Cut the view at every ch into a vector of ax_t(strview), no chars are
+ * copied, so the pieces are valid as long as the view is */
+ax_seq *ax_strview_split(ax_strview view, char ch);
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_SVEC_H
+#define AX_SVEC_H
+#include "type/seq.h"
+
+#ifndef AX_SVEC_DEFINED
+#define AX_SVEC_DEFINED
+typedef struct ax_svec_st ax_svec;
+#endif
+
+/*
+ * Vector with small buffer optimization, the first ninline elements are
+ * stored in the same allocation as the object itself, a heap buffer is
+ * allocated only when the vector grows beyond it. Iterators and element
+ * pointers are invalidated by the insertion which causes the buffer to grow.
+ */
+
+#define ax_baseof_ax_svec ax_seq
+ax_concrete_declare(4, ax_svec);
+
+extern const ax_seq_trait ax_svec_tr;
+
+ax_seq *__ax_svec_construct(const ax_trait* elem_tr, size_t ninline);
+
+inline static ax_concrete_creator(ax_svec, const ax_trait* trait, size_t ninline)
+{
+	return __ax_svec_construct(trait, ninline);
+}
+
+void *ax_svec_buffer(ax_svec *svec);
+
+size_t ax_svec_capacity(const ax_svec *svec);
+
+bool ax_svec_inlined(const ax_svec *svec);
+
+ax_fail ax_svec_reserve(ax_svec *svec, size_t size);
+
+#endif
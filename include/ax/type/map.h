@@ -64,6 +64,18 @@ ax_abstract_code_begin(ax_map)
 	void *(*chkey) (ax_map *map, const void *key, const void *new_key);
 	ax_fail (*erase) (ax_map *map, const void *key);
 	const void *(*itkey)(const ax_citer *it);
+
+	/* Optional, ax_map_get_batch and ax_map_exist_batch loop over get without them */
+	size_t (*get_batch)(const ax_map *map, const void *const keys[], size_t n, void *vals[]);
+	size_t (*exist_batch)(const ax_map *map, const void *const keys[], size_t n, bool exist[]);
+
+	/* Optional, ax_map_select and ax_map_rank walk the map without them */
+	ax_iter (*select)(const ax_map *map, size_t index);
+	size_t (*rank)(const ax_map *map, const void *key);
+
+	/* Only for ordered maps */
+	ax_iter (*lower_bound)(const ax_map *map, const void *key);
+	ax_iter (*upper_bound)(const ax_map *map, const void *key);
 ax_end;
 
 ax_abstract_data_begin(ax_map)
@@ -124,20 +136,59 @@ inline static void *ax_map_chkey(ax_map *map, const void *key, const void *new_k
 			ax_trait_in(map->env.key_tr, new_key));
 }
 
+/* Iterator to the first pair whose key is not less than key */
+inline static ax_iter ax_map_lower_bound(ax_map *map, const void *key)
+{
+	ax_assert(ax_class_trait(map).lower_bound, "%s is unordered", ax_one_name(ax_r(ax_map, map).ax_one));
+	return ax_class_trait(map).lower_bound(map, ax_trait_in(map->env.key_tr, key));
+}
+
+/* Iterator to the first pair whose key is greater than key */
+inline static ax_iter ax_map_upper_bound(ax_map *map, const void *key)
+{
+	ax_assert(ax_class_trait(map).upper_bound, "%s is unordered", ax_one_name(ax_r(ax_map, map).ax_one));
+	return ax_class_trait(map).upper_bound(map, ax_trait_in(map->env.key_tr, key));
+}
+
+/* Range of pairs whose keys are equal to key, it holds at most one pair */
+inline static void ax_map_equal_range(ax_map *map, const void *key, ax_iter *first, ax_iter *last)
+{
+	*first = ax_map_lower_bound(map, key);
+	*last = ax_map_upper_bound(map, key);
+}
+
 inline static const void *ax_map_citer_key(const ax_citer *it)
 {
 	ax_obj_require((const ax_map *)it->owner, itkey);
-	return ax_trait_out(it->etr, ax_class_trait((const ax_map *)it->owner).itkey(it));
+	return ax_class_trait((const ax_map *)it->owner).itkey(it);
 }
 
 inline static void *ax_map_iter_key(const ax_iter *it)
 {
 	ax_obj_require((const ax_map *)it->owner, itkey);
-	return (void *)ax_trait_out(it->etr, ax_class_trait((const ax_map *)it->owner).itkey(ax_iter_cc(it)));
+	return (void *)ax_class_trait((const ax_map *)it->owner).itkey(ax_iter_cc(it));
 }
 
 const void *ax_map_key(ax_map *map, const void *key);
 
+/*
+ * Look up n keys at once, keys are passed as the key argument of
+ * ax_map_get. vals[i] is set to the value of keys[i], or NULL if it does
+ * not exist. Returns the number of keys found.
+ */
+size_t ax_map_get_batch(ax_map *map, const void *const keys[], size_t n, void *vals[]);
+
+size_t ax_map_exist_batch(const ax_map *map, const void *const keys[], size_t n, bool exist[]);
+
+/*
+ * Iterator to the pair at index in iteration order, which is the key order
+ * for ordered maps, or the end if index is not less than the size
+ */
+ax_iter ax_map_select(ax_map *map, size_t index);
+
+/* Number of keys less than key */
+size_t ax_map_rank(const ax_map *map, const void *key);
+
 ax_dump *ax_map_dump(const ax_map *map);
 
 #endif
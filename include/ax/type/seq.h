@@ -36,6 +36,9 @@ typedef ax_fail (*ax_seq_trunc_f)  (ax_seq *seq, size_t size);
 typedef ax_iter (*ax_seq_at_f)     (const ax_seq *seq, size_t index);
 typedef ax_fail (*ax_seq_insert_f) (ax_seq *seq, ax_iter *iter, const void *val, va_list *ap);
 typedef void   *(*ax_seq_end_f)    (const ax_seq *seq);
+typedef ax_fail (*ax_seq_push_n_f) (ax_seq *seq, const void *arr, size_t n);
+typedef ax_fail (*ax_seq_insert_range_f) (ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+typedef void    (*ax_seq_erase_range_f)  (ax_seq *seq, ax_iter *first, ax_iter *last);
 
 typedef ax_seq *(ax_seq_construct_f)(const ax_trait *tr);
 
@@ -55,6 +58,9 @@ ax_abstract_code_begin(ax_seq)
 	const ax_seq_insert_f insert;
 	const ax_seq_end_f   first;
 	const ax_seq_end_f   last;
+	const ax_seq_push_n_f push_n;
+	const ax_seq_insert_range_f insert_range;
+	const ax_seq_erase_range_f  erase_range;
 ax_end;
 
 ax_abstract_declare(3, ax_seq);
@@ -155,6 +161,25 @@ size_t ax_seq_array(ax_seq *seq, void *elems[], size_t len);
 
 ax_fail ax_seq_push_arraya(ax_seq *seq, const void *arrp);
 
+/*
+ * Bulk operations, a sequence may leave push_n, insert_range and erase_range
+ * NULL in its trait and an element-wise version is used instead.
+ *
+ * ax_seq_push_n appends n elements stored contiguously in arr, nothing is
+ * appended on failure.
+ *
+ * ax_seq_insert_range inserts copies of [first, last) before it, the same way
+ * as ax_seq_insert does element by element, the range must not belong to seq.
+ *
+ * ax_seq_erase_range erases [first, last), both iterators are moved to the
+ * element which followed the range.
+ */
+ax_fail ax_seq_push_n(ax_seq *seq, const void *arr, size_t n);
+
+ax_fail ax_seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+
+void ax_seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
+
 ax_dump *ax_seq_dump(const ax_seq *seq);
 
 #endif
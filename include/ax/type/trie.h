@@ -51,6 +51,11 @@ ax_abstract_code_begin(ax_trie)
 	bool        (*it_parent)(const ax_citer *it, ax_iter *parent);
 	bool        (*it_valued)(const ax_citer *it);
 	void        (*it_clean) (const ax_iter *it);
+
+	/* Keys given as packed words, see ax_trie_get_bytes */
+	void       *(*put_bytes)  (ax_trie *trie, const void *key, size_t len, const void *val, va_list *ap);
+	void       *(*get_bytes)  (const ax_trie *trie, const void *key, size_t len);
+	bool        (*exist_bytes)(const ax_trie *trie, const void *key, size_t len, bool *valued);
 ax_end;
 
 ax_abstract_data_begin(ax_trie)
@@ -88,6 +93,40 @@ inline static void *ax_trie_get(ax_trie *trie, const ax_seq *key)
 	return ax_obj_do(trie, get, key);
 }
 
+/*
+ * The _bytes variants take the key as len bytes of words packed as in an
+ * array of key_tr elements, e.g. the characters of a C string for a trie of
+ * ax_t(char). No sequence is built and the words are read in place.
+ */
+inline static void *ax_trie_get_bytes(ax_trie *trie, const void *key, size_t len)
+{
+	return ax_obj_do(trie, get_bytes, key, len);
+}
+
+inline static void *ax_trie_cget_bytes(const ax_trie *trie, const void *key, size_t len)
+{
+	return ax_obj_do(trie, get_bytes, key, len);
+}
+
+inline static void *ax_trie_put_bytes(ax_trie *trie, const void *key, size_t len, const void *val)
+{
+	return ax_obj_do(trie, put_bytes, key, len, val, NULL);
+}
+
+inline static void *ax_trie_iput_bytes(ax_trie *trie, const void *key, size_t len, ...)
+{
+	va_list ap;
+	va_start(ap, len);
+	void *ret = ax_obj_do(trie, put_bytes, key, len, NULL, &ap);
+	va_end(ap);
+	return ret;
+}
+
+inline static bool ax_trie_exist_bytes(const ax_trie *trie, const void *key, size_t len, bool *valued)
+{
+	return ax_obj_do(trie, exist_bytes, key, len, valued);
+}
+
 inline static ax_iter ax_trie_at(ax_trie *trie, const ax_seq *key)
 {
 	return ax_obj_do(trie, at, key);
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef AX_ULIST_H
+#define AX_ULIST_H
+#include "type/seq.h"
+
+#ifndef AX_ULIST_DEFINED
+#define AX_ULIST_DEFINED
+typedef struct ax_ulist_st ax_ulist;
+#endif
+
+/*
+ * Unrolled linked list, every node holds an array of up to a few hundred
+ * bytes of elements. Pushing and popping at both ends is O(1), insertion
+ * moves elements inside a single node, a full node is split in half. A node
+ * falling under half full by erasure takes elements from a neighbour, or is
+ * merged with it. Iterators and element pointers are invalidated by any
+ * insertion or erasure.
+ */
+
+#define ax_baseof_ax_ulist ax_seq
+
+ax_concrete_declare(4, ax_ulist);
+
+extern const ax_seq_trait ax_ulist_tr;
+
+ax_seq *__ax_ulist_construct(const ax_trait *elem_tr);
+
+inline static ax_concrete_creator(ax_ulist, const ax_trait* trait)
+{
+	return __ax_ulist_construct(trait);
+}
+
+size_t ax_ulist_node_capacity(const ax_ulist *ulist);
+
+#endif
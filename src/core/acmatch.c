@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/acmatch.h"
+#include "ax/iter.h"
+#include "ax/debug.h"
+#include "ax/trait.h"
+#include "check.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define NONE UINT32_MAX
+
+struct ax_acmatch_state_st
+{
+	uint32_t match; /* First state with a pattern on the failure chain, itself included */
+	uint32_t next;  /* Next state with a pattern on the failure chain */
+	uint32_t id;
+	uint32_t depth;
+};
+
+struct frame_st
+{
+	ax_citer it;
+	uint32_t parent;
+	uint32_t depth;
+	ax_byte byte;
+};
+
+typedef ax_fail (*visit_f)(void *ctx, uint32_t state, const struct frame_st *frame);
+
+struct build_st
+{
+	ax_acmatch *ac;
+	ax_acmatch_id_f id_f;
+	void *ctx;
+	bool used[256];
+};
+
+/* Visit the nodes of trie in preorder, numbering them as states */
+static ax_fail walk(const ax_trie *trie, visit_f visit, void *ctx)
+{
+	ax_trie_cr self = AX_R_INIT(ax_trie, trie);
+	ax_citer root = ax_box_cbegin(self.ax_box), end = ax_box_cend(self.ax_box);
+	if (ax_citer_equal(&root, &end))
+		return visit(ctx, 0, NULL);
+
+	size_t top = 0, stack_size = 256;
+	struct frame_st *stack = malloc(sizeof *stack * stack_size);
+	if (!stack)
+		return true;
+	stack[top++] = (struct frame_st) { .it = root, .parent = NONE };
+
+	ax_fail retval = true;
+	uint32_t state = 0;
+	while (top) {
+		struct frame_st frame = stack[--top];
+		if (state == NONE || visit(ctx, state, &frame))
+			goto out;
+
+		size_t first = top;
+		ax_citer cur = ax_trie_citer_cbegin(&frame.it), cend = ax_trie_citer_cend(&frame.it);
+		for (; !ax_citer_equal(&cur, &cend); ax_citer_next(&cur)) {
+			if (top == stack_size) {
+				struct frame_st *new_stack = realloc(stack, sizeof *stack * stack_size * 2);
+				if (!new_stack)
+					goto out;
+				stack = new_stack;
+				stack_size *= 2;
+			}
+			stack[top++] = (struct frame_st) {
+				.it = cur,
+				.parent = state,
+				.depth = frame.depth + 1,
+				.byte = *(const ax_byte *)ax_trie_citer_word(&cur),
+			};
+		}
+
+		/* Children come in the order of the key trait, which for a signed
+		 * char trie is not byte order */
+		for (size_t i = first + 1; i < top; i++) {
+			struct frame_st child = stack[i];
+			size_t j = i;
+			for (; j > first && stack[j - 1].byte > child.byte; j--)
+				stack[j] = stack[j - 1];
+			stack[j] = child;
+		}
+
+		/* Pop the smallest child first */
+		for (size_t i = first, j = top; i + 1 < j; i++, j--) {
+			struct frame_st tmp = stack[i];
+			stack[i] = stack[j - 1];
+			stack[j - 1] = tmp;
+		}
+		state++;
+	}
+	retval = false;
+out:
+	free(stack);
+	return retval;
+}
+
+static ax_fail count_visit(void *ctx, uint32_t state, const struct frame_st *frame)
+{
+	struct build_st *b = ctx;
+	b->ac->nstates = state + 1;
+	if (frame && frame->parent != NONE)
+		b->used[frame->byte] = true;
+	return false;
+}
+
+static ax_fail fill_visit(void *ctx, uint32_t state, const struct frame_st *frame)
+{
+	struct build_st *b = ctx;
+	ax_acmatch *ac = b->ac;
+	struct ax_acmatch_state_st *st = ac->states + state;
+
+	st->id = NONE;
+	st->depth = 0;
+	if (!frame)
+		return false;
+
+	st->depth = frame->depth;
+	if (frame->parent != NONE)
+		ac->delta[(size_t)frame->parent * ac->nclasses + ac->classes[frame->byte]] = state;
+	if (frame->depth && ax_trie_citer_valued(&frame->it)) {
+		st->id = b->id_f ? b->id_f(ax_citer_get(&frame->it), b->ctx) : ac->npatterns;
+		ac->npatterns++;
+	}
+	return false;
+}
+
+/* Complete the transitions with failure links, visiting states by depth */
+static ax_fail link_failures(ax_acmatch *ac)
+{
+	uint32_t *queue = malloc(sizeof *queue * ac->nstates);
+	uint32_t *fail = malloc(sizeof *fail * ac->nstates);
+	if (!queue || !fail) {
+		free(queue);
+		free(fail);
+		return true;
+	}
+
+	size_t head = 0, tail = 0, ncl = ac->nclasses;
+	ac->states[0].match = ac->states[0].next = NONE;
+	for (size_t c = 0; c < ncl; c++) {
+		uint32_t t = ac->delta[c];
+		if (t == NONE)
+			ac->delta[c] = 0;
+		else {
+			fail[t] = 0;
+			queue[tail++] = t;
+		}
+	}
+
+	while (head < tail) {
+		uint32_t s = queue[head++];
+		struct ax_acmatch_state_st *st = ac->states + s;
+		st->next = ac->states[fail[s]].match;
+		st->match = st->id != NONE ? s : st->next;
+
+		uint32_t *row = ac->delta + s * ncl, *fail_row = ac->delta + fail[s] * ncl;
+		for (size_t c = 0; c < ncl; c++) {
+			if (row[c] == NONE)
+				row[c] = fail_row[c];
+			else {
+				fail[row[c]] = fail_row[c];
+				queue[tail++] = row[c];
+			}
+		}
+	}
+
+	free(queue);
+	free(fail);
+	return false;
+}
+
+ax_fail ax_acmatch_compile(ax_acmatch *ac, const ax_trie *trie, ax_acmatch_id_f id_f, void *ctx)
+{
+	CHECK_PARAM_NULL(ac);
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(trie, ax_trait_size(ax_class_data(trie).key_tr) == 1);
+
+	struct build_st b = { .ac = ac, .id_f = id_f, .ctx = ctx };
+	memset(ac, 0, sizeof *ac);
+
+	if (walk(trie, count_visit, &b))
+		return true;
+
+	/* Bytes absent from all patterns share class 0 */
+	ac->nclasses = 1;
+	for (int i = 0; i < 256; i++)
+		ac->classes[i] = b.used[i] ? ac->nclasses++ : 0;
+
+	if ((size_t)ac->nstates > SIZE_MAX / sizeof(uint32_t) / ac->nclasses)
+		return true;
+	ac->delta = malloc(sizeof *ac->delta * ac->nstates * ac->nclasses);
+	ac->states = malloc(sizeof *ac->states * ac->nstates);
+	if (!ac->delta || !ac->states)
+		goto fail;
+	memset(ac->delta, 0xFF, sizeof *ac->delta * ac->nstates * ac->nclasses);
+
+	if (walk(trie, fill_visit, &b))
+		goto fail;
+	if (link_failures(ac))
+		goto fail;
+	return false;
+fail:
+	ax_acmatch_free(ac);
+	return true;
+}
+
+void ax_acmatch_free(ax_acmatch *ac)
+{
+	if (!ac)
+		return;
+	free(ac->delta);
+	free(ac->states);
+	ac->delta = NULL;
+	ac->states = NULL;
+	ac->nstates = 0;
+	ac->npatterns = 0;
+}
+
+static bool report(const ax_acmatch *ac, uint32_t s, size_t end, ax_acmatch_cb_f cb, void *ctx)
+{
+	for (; s != NONE; s = ac->states[s].next)
+		if (cb(end, ac->states[s].depth, ac->states[s].id, ctx))
+			return true;
+	return false;
+}
+
+size_t ax_acmatch_stream_feed(ax_acmatch_stream *st, const void *data, size_t size, ax_acmatch_cb_f cb, void *ctx)
+{
+	CHECK_PARAM_NULL(st);
+	CHECK_PARAM_VALIDITY(data, data || !size);
+	CHECK_PARAM_NULL(cb);
+
+	const ax_acmatch *ac = st->ac;
+	const uint32_t *delta = ac->delta;
+	const ax_byte *p = data;
+	size_t ncl = ac->nclasses, i;
+	uint32_t s = st->state;
+
+	for (i = 0; i < size; i++) {
+		s = delta[s * ncl + ac->classes[p[i]]];
+		uint32_t m = ac->states[s].match;
+		if (m != NONE && report(ac, m, st->offset + i + 1, cb, ctx)) {
+			i++;
+			break;
+		}
+	}
+	st->state = s;
+	st->offset += i;
+	return i;
+}
+
+size_t ax_acmatch_stream_feed_iobuf(ax_acmatch_stream *st, ax_iobuf *b, ax_acmatch_cb_f cb, void *ctx)
+{
+	CHECK_PARAM_NULL(st);
+	CHECK_PARAM_NULL(b);
+
+	size_t total = 0;
+	void *ptr;
+	size_t size;
+	while ((size = ax_iobuf_zread(b, &ptr))) {
+		size_t n = ax_acmatch_stream_feed(st, ptr, size, cb, ctx);
+		ax_iobuf_zread_commit(b, n);
+		total += n;
+		if (n < size)
+			break;
+	}
+	return total;
+}
+
+size_t ax_acmatch_scan(const ax_acmatch *ac, const void *data, size_t size, ax_acmatch_cb_f cb, void *ctx)
+{
+	CHECK_PARAM_NULL(ac);
+
+	ax_acmatch_stream st;
+	ax_acmatch_stream_init(&st, ac);
+	return ax_acmatch_stream_feed(&st, data, size, cb, ctx);
+}
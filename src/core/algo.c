@@ -54,6 +54,32 @@ void ax_transform(const ax_citer *first1, const ax_citer *last1, const ax_iter *
 	CHECK_ITER_COMPARABLE(first1, last1);
 	ax_citer cur1 = *first1;
 	ax_iter cur2 = *first2;
+
+	if (ax_citer_spannable(&cur1)) {
+		const ax_trait *etr1 = first1->etr, *etr2 = first2->etr;
+		size_t esize1 = ax_trait_size(etr1), esize2 = ax_trait_size(etr2);
+		void *p1, *p2;
+		size_t n1, n2;
+		while ((n1 = ax_citer_span(&cur1, last1, SIZE_MAX, &p1))) {
+			ax_byte *src = p1;
+			if (!ax_iter_spannable(&cur2)) {
+				for (size_t i = 0; i < n1; i++, src += esize1) {
+					ax_pred1_do(pred1, ax_iter_get(&cur2), ax_trait_out(etr1, src));
+					ax_iter_next(&cur2);
+				}
+				continue;
+			}
+			for (; n1; n1 -= n2) {
+				n2 = ax_iter_span(&cur2, NULL, n1, &p2);
+				ax_assert(n2, "destination range is shorter than source");
+				ax_byte *dst = p2;
+				for (size_t i = 0; i < n2; i++, src += esize1, dst += esize2)
+					ax_pred1_do(pred1, ax_trait_out(etr2, dst), ax_trait_out(etr1, src));
+			}
+		}
+		return;
+	}
+
 	for (; !ax_citer_equal(&cur1, last1); ax_citer_next(&cur1)) {
 		ax_pred1_do(pred1, ax_iter_get(&cur2), ax_citer_get(&cur1));
 		ax_iter_next(&cur2);
@@ -109,6 +135,23 @@ size_t ax_count_if(const ax_citer *first, const ax_citer *last, ax_pred1 *pred1)
 
 	size_t count = 0;
 	bool out = false;
+
+	if (ax_citer_spannable(first)) {
+		const ax_trait *etr = first->etr;
+		size_t esize = ax_trait_size(etr);
+		ax_citer it = *first;
+		void *p;
+		size_t n;
+		while ((n = ax_citer_span(&it, last, SIZE_MAX, &p))) {
+			ax_byte *e = p;
+			for (size_t i = 0; i < n; i++, e += esize) {
+				ax_pred1_do(pred1, &out, ax_trait_out(etr, e));
+				count += out ? 1 : 0;
+			}
+		}
+		return count;
+	}
+
 	for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it)) {
 		ax_pred1_do(pred1, &out, ax_citer_get(&it));
 		count += out ? 1 : 0;
@@ -140,6 +183,25 @@ void ax_generate(const ax_iter *first, const ax_iter *last, const void *ptr)
 
 	const ax_trait *etr = first->etr;
 
+	if (ax_iter_spannable(first)) {
+		size_t esize = ax_trait_size(etr);
+		ax_iter it = *first;
+		void *p;
+		size_t n;
+		while ((n = ax_iter_span(&it, last, SIZE_MAX, &p))) {
+			ax_byte *e = p;
+			if (etr->t_copy)
+				for (size_t i = 0; i < n; i++, e += esize)
+					ax_trait_copy(etr, e, ptr);
+			else if (esize == 1)
+				memset(e, *(ax_byte *)ptr, n);
+			else
+				for (size_t i = 0; i < n; i++, e += esize)
+					memcpy(e, ptr, esize);
+		}
+		return;
+	}
+
 	for (ax_iter it = *first; !ax_iter_equal(&it, last); ax_iter_next(&it)) {
 		void *p = ax_iter_get(&it);
 		ax_trait_copy(etr, p, ptr);
@@ -152,6 +214,29 @@ void ax_find_if(ax_citer *first, const ax_citer *last, ax_pred1 *pred1)
 	CHECK_ITER_COMPARABLE(first, last);
 
 	bool retval;
+
+	if (ax_citer_spannable(first)) {
+		const ax_trait *etr = first->etr;
+		size_t esize = ax_trait_size(etr);
+		ax_citer chunk = *first;
+		void *p;
+		size_t n;
+		while ((n = ax_citer_span(first, last, SIZE_MAX, &p))) {
+			ax_byte *e = p;
+			for (size_t i = 0; i < n; i++, e += esize) {
+				if (*(bool *)ax_pred1_do(pred1, &retval, ax_trait_out(etr, e))) {
+					/* Span again up to the element found */
+					*first = chunk;
+					ax_citer_span(first, last, i, &p);
+					return;
+				}
+			}
+			chunk = *first;
+		}
+		*first = *last;
+		return;
+	}
+
 	while (!ax_citer_equal(first, last)) {
 		if (*(bool *)ax_pred1_do(pred1, &retval, ax_citer_get(first)))
 			return;
@@ -407,6 +492,32 @@ bool ax_equal_to_array(const ax_iter *first, const ax_iter *last, void *arr, siz
 	ax_assert(size % ax_trait_size(tr) == 0, "unexpected 0 size");
 	size_t pos = 0;
 	ax_iter cur = *first;
+
+	if (ax_iter_spannable(first)) {
+		size_t esize = ax_trait_size(tr);
+		void *p;
+		size_t n;
+		while (pos < size && (n = ax_iter_span(&cur, last, (size - pos) / esize, &p))) {
+			if (!pred2 && !tr->t_equal) {
+				if (memcmp(p, (ax_byte*)arr + pos, n * esize))
+					return false;
+				pos += n * esize;
+				continue;
+			}
+			ax_byte *e = p;
+			for (size_t i = 0; i < n; i++, e += esize, pos += esize) {
+				bool equal;
+				if (pred2)
+					ax_pred2_do(pred2, &equal, ax_trait_out(tr, e), (ax_byte*)arr + pos);
+				else
+					equal = ax_trait_equal(tr, ax_trait_out(tr, e), (ax_byte*)arr + pos);
+				if (!equal)
+					return false;
+			}
+		}
+		return ax_iter_equal(&cur, last) == (pos == size);
+	}
+
 	while (!ax_iter_equal(&cur, last) && pos < size) {
 		bool equal;
 		if (pred2)
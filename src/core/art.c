@@ -0,0 +1,1445 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/art.h"
+#include "ax/iter.h"
+#include "ax/debug.h"
+#include "ax/trait.h"
+#include "check.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define VAL_TR(r) ax_class_data(r.ax_box).elem_tr
+
+#define NODE4   0
+#define NODE16  1
+#define NODE48  2
+#define NODE256 3
+
+/* Bytes of the compressed path stored in a node, the rest are read from a leaf */
+#define MAX_PREFIX 8
+
+/* Keys not longer than this are gathered from ax_seq on the stack */
+#define KEY_BUF_SIZE 256
+
+/* Child references are tagged, the low bit is set for leaves */
+#define IS_LEAF(ref)   ((ref) & 1)
+#define LEAF_OF(ref)   ((struct leaf_st *)((ref) - 1))
+#define NODE_OF(ref)   ((struct node_st *)(ref))
+#define LEAF_REF(leaf) ((uintptr_t)(leaf) + 1)
+#define NODE_REF(node) ((uintptr_t)(node))
+
+struct leaf_st
+{
+	size_t len;
+	ax_byte buf[]; /* The value, followed by the key */
+};
+
+struct node_st
+{
+	uint32_t depth;       /* Length of the key before the branching byte */
+	uint32_t prefix_len;  /* Length of the compressed path above the branching byte */
+	struct leaf_st *leaf; /* The pair whose key ends at depth */
+	uint16_t count;
+	uint8_t type;
+	ax_byte prefix[MAX_PREFIX];
+};
+
+struct node4_st
+{
+	struct node_st node;
+	ax_byte keys[4];
+	uintptr_t child[4];
+};
+
+struct node16_st
+{
+	struct node_st node;
+	ax_byte keys[16];
+	uintptr_t child[16];
+};
+
+struct node48_st
+{
+	struct node_st node;
+	ax_byte index[256]; /* Position in child plus one, 0 for none */
+	uintptr_t child[48];
+};
+
+struct node256_st
+{
+	struct node_st node;
+	uintptr_t child[256];
+};
+
+ax_concrete_begin(ax_art)
+	uintptr_t root;
+	size_t size;
+ax_end;
+
+static void    *trie_put(ax_trie *trie, const ax_seq *key, const void *val, va_list *ap);
+static void    *trie_get(const ax_trie *trie, const ax_seq *key);
+static ax_iter  trie_at(const ax_trie *trie, const ax_seq *key);
+static bool     trie_exist(const ax_trie *trie, const ax_seq *key, bool *valued);
+static bool     trie_erase(ax_trie *trie, const ax_seq *key);
+static bool     trie_prune(ax_trie *trie, const ax_seq *key);
+static ax_fail  trie_rekey(ax_trie *trie, const ax_seq *key_from, const ax_seq *key_to);
+static void    *trie_put_bytes(ax_trie *trie, const void *key, size_t len, const void *val, va_list *ap);
+static void    *trie_get_bytes(const ax_trie *trie, const void *key, size_t len);
+static bool     trie_exist_bytes(const ax_trie *trie, const void *key, size_t len, bool *valued);
+
+static const void *trie_it_word(const ax_citer *it);
+static ax_iter  trie_it_begin(const ax_citer *it);
+static ax_iter  trie_it_end(const ax_citer *it);
+static bool     trie_it_parent(const ax_citer *it, ax_iter *parent);
+static bool     trie_it_valued(const ax_citer *it);
+
+static size_t   box_size(const ax_box *box);
+static size_t   box_maxsize(const ax_box *box);
+static ax_iter  box_begin(ax_box *box);
+static ax_iter  box_end(ax_box *box);
+static ax_iter  box_rbegin(ax_box *box);
+static ax_iter  box_rend(ax_box *box);
+static void     box_clear(ax_box *box);
+
+static ax_any  *any_copy(const ax_any *any);
+static ax_dump *any_dump(const ax_any *any);
+
+static void     one_free(ax_one *one);
+static const char *one_name(const ax_one *one);
+
+static void     citer_prev(ax_citer *it);
+static void     citer_next(ax_citer *it);
+static ax_box  *citer_box(const ax_citer *it);
+static void    *citer_get(const ax_citer *it);
+static ax_fail  iter_set(const ax_iter *it, const void *val, va_list *ap);
+static void     iter_erase(ax_iter *it);
+
+inline static size_t min_size(size_t a, size_t b)
+{
+	return a < b ? a : b;
+}
+
+inline static int lowest_bit(unsigned mask)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	int i = 0;
+	while (!(mask & 1))
+		mask >>= 1, i++;
+	return i;
+#endif
+}
+
+inline static void *leaf_val(struct leaf_st *leaf)
+{
+	return leaf->buf;
+}
+
+inline static const ax_byte *leaf_key(const ax_art *tree, const struct leaf_st *leaf)
+{
+	ax_art_cr self = AX_R_INIT(ax_art, tree);
+	return leaf->buf + ax_trait_size(VAL_TR(self));
+}
+
+inline static bool leaf_match(const ax_art *tree, const struct leaf_st *leaf, const ax_byte *key, size_t len)
+{
+	return leaf->len == len && memcmp(leaf_key(tree, leaf), key, len) == 0;
+}
+
+static struct leaf_st *leaf_create(ax_art *tree, const ax_byte *key, size_t len, const void *val, va_list *ap)
+{
+	ax_art_r self = AX_R_INIT(ax_art, tree);
+	const ax_trait *vtr = VAL_TR(self);
+
+	struct leaf_st *leaf = malloc(sizeof(struct leaf_st) + ax_trait_size(vtr) + len);
+	if (!leaf)
+		return NULL;
+	if (ax_trait_copy_or_init(vtr, leaf_val(leaf), val, ap)) {
+		free(leaf);
+		return NULL;
+	}
+	leaf->len = len;
+	memcpy(leaf->buf + ax_trait_size(vtr), key, len);
+	return leaf;
+}
+
+static void leaf_free(ax_art *tree, struct leaf_st *leaf)
+{
+	ax_art_r self = AX_R_INIT(ax_art, tree);
+	ax_trait_free(VAL_TR(self), leaf_val(leaf));
+	free(leaf);
+}
+
+static struct node_st *node_create(int type)
+{
+	static const size_t sizes[] = {
+		sizeof(struct node4_st), sizeof(struct node16_st),
+		sizeof(struct node48_st), sizeof(struct node256_st),
+	};
+	struct node_st *node = calloc(1, sizes[type]);
+	if (node)
+		node->type = type;
+	return node;
+}
+
+/* Copy the header without the children */
+inline static void node_copy_header(struct node_st *dst, const struct node_st *src)
+{
+	dst->depth = src->depth;
+	dst->prefix_len = src->prefix_len;
+	dst->leaf = src->leaf;
+	dst->count = src->count;
+	memcpy(dst->prefix, src->prefix, sizeof dst->prefix);
+}
+
+static uintptr_t *find_child(struct node_st *node, ax_byte b)
+{
+	switch (node->type) {
+		case NODE4: {
+			struct node4_st *n = (struct node4_st *)node;
+			for (int i = 0; i < node->count; i++)
+				if (n->keys[i] == b)
+					return n->child + i;
+			return NULL;
+		}
+		case NODE16: {
+			struct node16_st *n = (struct node16_st *)node;
+#ifdef USE_SSE2
+			__m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)b),
+					_mm_loadu_si128((const __m128i *)n->keys));
+			unsigned mask = (unsigned)_mm_movemask_epi8(cmp) & ((1u << node->count) - 1);
+			return mask ? n->child + lowest_bit(mask) : NULL;
+#else
+			for (int i = 0; i < node->count; i++)
+				if (n->keys[i] == b)
+					return n->child + i;
+			return NULL;
+#endif
+		}
+		case NODE48: {
+			struct node48_st *n = (struct node48_st *)node;
+			return n->index[b] ? n->child + n->index[b] - 1 : NULL;
+		}
+		case NODE256: {
+			struct node256_st *n = (struct node256_st *)node;
+			return n->child[b] ? n->child + b : NULL;
+		}
+	}
+	return NULL;
+}
+
+/* The first child whose byte is greater than after, or 0 */
+static uintptr_t child_after(const struct node_st *node, int after, ax_byte *byte)
+{
+	switch (node->type) {
+		case NODE4:
+		case NODE16: {
+			const ax_byte *keys = node->type == NODE4
+				? ((const struct node4_st *)node)->keys
+				: ((const struct node16_st *)node)->keys;
+			const uintptr_t *child = node->type == NODE4
+				? ((const struct node4_st *)node)->child
+				: ((const struct node16_st *)node)->child;
+			for (int i = 0; i < node->count; i++)
+				if (keys[i] > after) {
+					*byte = keys[i];
+					return child[i];
+				}
+			return 0;
+		}
+		case NODE48: {
+			const struct node48_st *n = (const struct node48_st *)node;
+			for (int i = after + 1; i < 256; i++)
+				if (n->index[i]) {
+					*byte = i;
+					return n->child[n->index[i] - 1];
+				}
+			return 0;
+		}
+		case NODE256: {
+			const struct node256_st *n = (const struct node256_st *)node;
+			for (int i = after + 1; i < 256; i++)
+				if (n->child[i]) {
+					*byte = i;
+					return n->child[i];
+				}
+			return 0;
+		}
+	}
+	return 0;
+}
+
+/* The last child whose byte is less than before, or 0 */
+static uintptr_t child_before(const struct node_st *node, int before, ax_byte *byte)
+{
+	switch (node->type) {
+		case NODE4:
+		case NODE16: {
+			const ax_byte *keys = node->type == NODE4
+				? ((const struct node4_st *)node)->keys
+				: ((const struct node16_st *)node)->keys;
+			const uintptr_t *child = node->type == NODE4
+				? ((const struct node4_st *)node)->child
+				: ((const struct node16_st *)node)->child;
+			for (int i = node->count - 1; i >= 0; i--)
+				if (keys[i] < before) {
+					*byte = keys[i];
+					return child[i];
+				}
+			return 0;
+		}
+		case NODE48: {
+			const struct node48_st *n = (const struct node48_st *)node;
+			for (int i = before - 1; i >= 0; i--)
+				if (n->index[i]) {
+					*byte = i;
+					return n->child[n->index[i] - 1];
+				}
+			return 0;
+		}
+		case NODE256: {
+			const struct node256_st *n = (const struct node256_st *)node;
+			for (int i = before - 1; i >= 0; i--)
+				if (n->child[i]) {
+					*byte = i;
+					return n->child[i];
+				}
+			return 0;
+		}
+	}
+	return 0;
+}
+
+static struct leaf_st *minimum_leaf(uintptr_t ref)
+{
+	while (!IS_LEAF(ref)) {
+		struct node_st *node = NODE_OF(ref);
+		if (node->leaf)
+			return node->leaf;
+		ax_byte b;
+		ref = child_after(node, -1, &b);
+	}
+	return LEAF_OF(ref);
+}
+
+inline static void insert_sorted(ax_byte *keys, uintptr_t *child, int count, ax_byte b, uintptr_t ref)
+{
+	int i = count;
+	while (i > 0 && keys[i - 1] > b) {
+		keys[i] = keys[i - 1];
+		child[i] = child[i - 1];
+		i--;
+	}
+	keys[i] = b;
+	child[i] = ref;
+}
+
+/* Add a child to the node in slot, which is replaced with a larger one if it is full */
+static ax_fail add_child(uintptr_t *slot, struct node_st *node, ax_byte b, uintptr_t ref)
+{
+	switch (node->type) {
+		case NODE4: {
+			struct node4_st *n = (struct node4_st *)node;
+			if (node->count < 4) {
+				insert_sorted(n->keys, n->child, node->count, b, ref);
+				break;
+			}
+			struct node16_st *g = (struct node16_st *)node_create(NODE16);
+			if (!g)
+				return true;
+			node_copy_header(&g->node, node);
+			memcpy(g->keys, n->keys, sizeof n->keys);
+			memcpy(g->child, n->child, sizeof n->child);
+			insert_sorted(g->keys, g->child, node->count, b, ref);
+			*slot = NODE_REF(g);
+			free(n);
+			node = &g->node;
+			break;
+		}
+		case NODE16: {
+			struct node16_st *n = (struct node16_st *)node;
+			if (node->count < 16) {
+				insert_sorted(n->keys, n->child, node->count, b, ref);
+				break;
+			}
+			struct node48_st *g = (struct node48_st *)node_create(NODE48);
+			if (!g)
+				return true;
+			node_copy_header(&g->node, node);
+			for (int i = 0; i < 16; i++) {
+				g->index[n->keys[i]] = i + 1;
+				g->child[i] = n->child[i];
+			}
+			g->index[b] = 17;
+			g->child[16] = ref;
+			*slot = NODE_REF(g);
+			free(n);
+			node = &g->node;
+			break;
+		}
+		case NODE48: {
+			struct node48_st *n = (struct node48_st *)node;
+			if (node->count < 48) {
+				n->index[b] = node->count + 1;
+				n->child[node->count] = ref;
+				break;
+			}
+			struct node256_st *g = (struct node256_st *)node_create(NODE256);
+			if (!g)
+				return true;
+			node_copy_header(&g->node, node);
+			for (int i = 0; i < 256; i++)
+				if (n->index[i])
+					g->child[i] = n->child[n->index[i] - 1];
+			g->child[b] = ref;
+			*slot = NODE_REF(g);
+			free(n);
+			node = &g->node;
+			break;
+		}
+		case NODE256: {
+			struct node256_st *n = (struct node256_st *)node;
+			n->child[b] = ref;
+			break;
+		}
+	}
+	node->count++;
+	return false;
+}
+
+/* Put a pair into a new node which has at most one child */
+static void node_place(const ax_art *tree, struct node_st *node, struct leaf_st *leaf)
+{
+	if (leaf->len == node->depth)
+		node->leaf = leaf;
+	else {
+		struct node4_st *n = (struct node4_st *)node;
+		insert_sorted(n->keys, n->child, node->count, leaf_key(tree, leaf)[node->depth], LEAF_REF(leaf));
+		node->count++;
+	}
+}
+
+/* Merge the node in slot into its only child, or replace it with its leaf */
+static void collapse(uintptr_t *slot, struct node_st *node)
+{
+	if (node->count == 0) {
+		*slot = LEAF_REF(node->leaf);
+		free(node);
+		return;
+	}
+
+	ax_byte b;
+	uintptr_t ref = child_after(node, -1, &b);
+	if (!IS_LEAF(ref)) {
+		struct node_st *child = NODE_OF(ref);
+		ax_byte prefix[MAX_PREFIX];
+		size_t n = 0;
+		for (size_t i = 0; i < min_size(node->prefix_len, MAX_PREFIX); i++)
+			prefix[n++] = node->prefix[i];
+		if (n < MAX_PREFIX)
+			prefix[n++] = b;
+		for (size_t i = 0; n < MAX_PREFIX && i < min_size(child->prefix_len, MAX_PREFIX); i++)
+			prefix[n++] = child->prefix[i];
+		memcpy(child->prefix, prefix, n);
+		child->prefix_len += node->prefix_len + 1;
+	}
+	*slot = ref;
+	free(node);
+}
+
+/* Remove the child of byte b from the node in slot, shrinking or collapsing the node */
+static void remove_child(uintptr_t *slot, struct node_st *node, ax_byte b)
+{
+	switch (node->type) {
+		case NODE4:
+		case NODE16: {
+			ax_byte *keys = node->type == NODE4
+				? ((struct node4_st *)node)->keys
+				: ((struct node16_st *)node)->keys;
+			uintptr_t *child = node->type == NODE4
+				? ((struct node4_st *)node)->child
+				: ((struct node16_st *)node)->child;
+			int i = 0;
+			while (keys[i] != b)
+				i++;
+			memmove(keys + i, keys + i + 1, node->count - i - 1);
+			memmove(child + i, child + i + 1, (node->count - i - 1) * sizeof *child);
+			node->count--;
+
+			if (node->type == NODE16 && node->count <= 3) {
+				struct node4_st *s = (struct node4_st *)node_create(NODE4);
+				if (s) {
+					node_copy_header(&s->node, node);
+					memcpy(s->keys, keys, node->count);
+					memcpy(s->child, child, node->count * sizeof *child);
+					*slot = NODE_REF(s);
+					free(node);
+					node = &s->node;
+				}
+			}
+			break;
+		}
+		case NODE48: {
+			struct node48_st *n = (struct node48_st *)node;
+			int pos = n->index[b] - 1, last = node->count - 1;
+			n->index[b] = 0;
+			if (pos != last) {
+				/* Keep the children packed */
+				n->child[pos] = n->child[last];
+				for (int i = 0; i < 256; i++)
+					if (n->index[i] == last + 1) {
+						n->index[i] = pos + 1;
+						break;
+					}
+			}
+			n->child[last] = 0;
+			node->count--;
+
+			if (node->count <= 12) {
+				struct node16_st *s = (struct node16_st *)node_create(NODE16);
+				if (s) {
+					node_copy_header(&s->node, node);
+					int j = 0;
+					for (int i = 0; i < 256; i++)
+						if (n->index[i]) {
+							s->keys[j] = i;
+							s->child[j] = n->child[n->index[i] - 1];
+							j++;
+						}
+					*slot = NODE_REF(s);
+					free(node);
+					node = &s->node;
+				}
+			}
+			break;
+		}
+		case NODE256: {
+			struct node256_st *n = (struct node256_st *)node;
+			n->child[b] = 0;
+			node->count--;
+
+			if (node->count <= 36) {
+				struct node48_st *s = (struct node48_st *)node_create(NODE48);
+				if (s) {
+					node_copy_header(&s->node, node);
+					int j = 0;
+					for (int i = 0; i < 256; i++)
+						if (n->child[i]) {
+							s->index[i] = j + 1;
+							s->child[j] = n->child[i];
+							j++;
+						}
+					*slot = NODE_REF(s);
+					free(node);
+					node = &s->node;
+				}
+			}
+			break;
+		}
+	}
+
+	if (node->count + !!node->leaf == 1)
+		collapse(slot, node);
+}
+
+/* Length of the common part of the compressed path of node and key */
+static size_t prefix_mismatch(const ax_art *tree, const struct node_st *node, const ax_byte *key, size_t len)
+{
+	size_t start = node->depth - node->prefix_len;
+	size_t max = min_size(node->prefix_len, len - start);
+	size_t stored = min_size(max, MAX_PREFIX), i;
+	for (i = 0; i < stored; i++)
+		if (node->prefix[i] != key[start + i])
+			return i;
+	if (max > MAX_PREFIX) {
+		const ax_byte *full = leaf_key(tree, minimum_leaf(NODE_REF(node))) + start;
+		for (; i < max; i++)
+			if (full[i] != key[start + i])
+				return i;
+	}
+	return i;
+}
+
+/* Compare the stored part of the compressed path only, the leaf found is compared at last */
+inline static bool prefix_match_stored(const struct node_st *node, const ax_byte *key)
+{
+	size_t start = node->depth - node->prefix_len;
+	return memcmp(node->prefix, key + start, min_size(node->prefix_len, MAX_PREFIX)) == 0;
+}
+
+static struct leaf_st *search(const ax_art *tree, const ax_byte *key, size_t len)
+{
+	uintptr_t ref = tree->root;
+	while (ref) {
+		if (IS_LEAF(ref))
+			return leaf_match(tree, LEAF_OF(ref), key, len) ? LEAF_OF(ref) : NULL;
+
+		struct node_st *node = NODE_OF(ref);
+		if (node->depth > len || !prefix_match_stored(node, key))
+			return NULL;
+		if (node->depth == len)
+			return node->leaf && leaf_match(tree, node->leaf, key, len) ? node->leaf : NULL;
+
+		uintptr_t *child = find_child(node, key[node->depth]);
+		ref = child ? *child : 0;
+	}
+	return NULL;
+}
+
+/* Insert a leaf whose key is not in the tree */
+static ax_fail insert(ax_art *tree, struct leaf_st *leaf)
+{
+	const ax_byte *key = leaf_key(tree, leaf);
+	size_t len = leaf->len, depth = 0;
+	uintptr_t *slot = &tree->root;
+
+	while (*slot) {
+		if (IS_LEAF(*slot)) {
+			/* Lazy expansion, split the leaf where the keys differ */
+			struct leaf_st *old = LEAF_OF(*slot);
+			const ax_byte *old_key = leaf_key(tree, old);
+			size_t limit = min_size(old->len, len), p = depth;
+			while (p < limit && old_key[p] == key[p])
+				p++;
+
+			struct node_st *node = node_create(NODE4);
+			if (!node)
+				return true;
+			node->depth = p;
+			node->prefix_len = p - depth;
+			memcpy(node->prefix, key + depth, min_size(node->prefix_len, MAX_PREFIX));
+			node_place(tree, node, old);
+			node_place(tree, node, leaf);
+			*slot = NODE_REF(node);
+			return false;
+		}
+
+		struct node_st *node = NODE_OF(*slot);
+		size_t p = prefix_mismatch(tree, node, key, len);
+		if (p < node->prefix_len) {
+			/* Split the compressed path */
+			struct node_st *parent = node_create(NODE4);
+			if (!parent)
+				return true;
+			parent->depth = depth + p;
+			parent->prefix_len = p;
+			memcpy(parent->prefix, node->prefix, min_size(p, MAX_PREFIX));
+
+			const ax_byte *full = node->prefix_len > MAX_PREFIX
+				? leaf_key(tree, minimum_leaf(NODE_REF(node))) + depth
+				: node->prefix;
+			ax_byte b = full[p];
+			size_t rest = node->prefix_len - p - 1;
+			memmove(node->prefix, full + p + 1, min_size(rest, MAX_PREFIX));
+			node->prefix_len = rest;
+
+			struct node4_st *n = (struct node4_st *)parent;
+			insert_sorted(n->keys, n->child, 0, b, NODE_REF(node));
+			parent->count = 1;
+			node_place(tree, parent, leaf);
+			*slot = NODE_REF(parent);
+			return false;
+		}
+
+		if (node->depth == len) {
+			node->leaf = leaf;
+			return false;
+		}
+
+		uintptr_t *child = find_child(node, key[node->depth]);
+		if (!child)
+			return add_child(slot, node, key[node->depth], LEAF_REF(leaf));
+		depth = node->depth + 1;
+		slot = child;
+	}
+
+	*slot = LEAF_REF(leaf);
+	return false;
+}
+
+/* Unlink the leaf of key from the tree */
+static struct leaf_st *detach(ax_art *tree, const ax_byte *key, size_t len)
+{
+	uintptr_t *slot = &tree->root, *parent_slot = NULL;
+	struct node_st *parent = NULL;
+
+	while (*slot) {
+		if (IS_LEAF(*slot)) {
+			struct leaf_st *leaf = LEAF_OF(*slot);
+			if (!leaf_match(tree, leaf, key, len))
+				return NULL;
+			if (parent)
+				remove_child(parent_slot, parent, key[parent->depth]);
+			else
+				tree->root = 0;
+			return leaf;
+		}
+
+		struct node_st *node = NODE_OF(*slot);
+		if (node->depth > len || !prefix_match_stored(node, key))
+			return NULL;
+		if (node->depth == len) {
+			struct leaf_st *leaf = node->leaf;
+			if (!leaf || !leaf_match(tree, leaf, key, len))
+				return NULL;
+			node->leaf = NULL;
+			if (node->count == 1)
+				collapse(slot, node);
+			return leaf;
+		}
+
+		uintptr_t *child = find_child(node, key[node->depth]);
+		if (!child)
+			return NULL;
+		parent_slot = slot;
+		parent = node;
+		slot = child;
+	}
+	return NULL;
+}
+
+/*
+ * Find the slot of the tree node holding the trie node of the first depth
+ * bytes of key, parent_slot is set to the slot of its parent if any
+ */
+static uintptr_t *locate(const ax_art *tree, const ax_byte *key, size_t depth, uintptr_t **parent_slot)
+{
+	uintptr_t *slot = (uintptr_t *)&tree->root;
+	if (parent_slot)
+		*parent_slot = NULL;
+	if (!*slot)
+		return NULL;
+
+	for (;;) {
+		if (IS_LEAF(*slot)) {
+			if (LEAF_OF(*slot)->len < depth)
+				return NULL;
+			break;
+		}
+		struct node_st *node = NODE_OF(*slot);
+		if (depth <= node->depth)
+			break;
+		uintptr_t *child = find_child(node, key[node->depth]);
+		if (!child)
+			return NULL;
+		if (parent_slot)
+			*parent_slot = slot;
+		slot = child;
+	}
+
+	return memcmp(leaf_key(tree, minimum_leaf(*slot)), key, depth) == 0 ? slot : NULL;
+}
+
+/* The pair whose key ends at the trie node of depth in ref */
+static struct leaf_st *value_leaf(uintptr_t ref, size_t depth)
+{
+	if (IS_LEAF(ref))
+		return LEAF_OF(ref)->len == depth ? LEAF_OF(ref) : NULL;
+	return NODE_OF(ref)->depth == depth ? NODE_OF(ref)->leaf : NULL;
+}
+
+/*
+ * The tree node holding the first child, whose byte is greater than after,
+ * of the trie node of depth in ref, or 0
+ */
+static uintptr_t next_child(const ax_art *tree, uintptr_t ref, size_t depth, int after)
+{
+	if (!IS_LEAF(ref) && NODE_OF(ref)->depth == depth) {
+		ax_byte b;
+		return child_after(NODE_OF(ref), after, &b);
+	}
+	struct leaf_st *leaf = minimum_leaf(ref);
+	if (leaf->len == depth)
+		return 0;
+	return leaf_key(tree, leaf)[depth] > after ? ref : 0;
+}
+
+/* Same as next_child, the last child whose byte is less than before */
+static uintptr_t prev_child(const ax_art *tree, uintptr_t ref, size_t depth, int before)
+{
+	if (!IS_LEAF(ref) && NODE_OF(ref)->depth == depth) {
+		ax_byte b;
+		return child_before(NODE_OF(ref), before, &b);
+	}
+	struct leaf_st *leaf = minimum_leaf(ref);
+	if (leaf->len == depth)
+		return 0;
+	return leaf_key(tree, leaf)[depth] < before ? ref : 0;
+}
+
+static size_t free_subtree(ax_art *tree, uintptr_t ref)
+{
+	if (IS_LEAF(ref)) {
+		leaf_free(tree, LEAF_OF(ref));
+		return 1;
+	}
+
+	struct node_st *node = NODE_OF(ref);
+	size_t count = 0;
+	if (node->leaf) {
+		leaf_free(tree, node->leaf);
+		count++;
+	}
+	ax_byte b;
+	for (uintptr_t child = child_after(node, -1, &b); child; child = b < 255 ? child_after(node, b, &b) : 0)
+		count += free_subtree(tree, child);
+	free(node);
+	return count;
+}
+
+/* Copy the words of key into buf, or into a new block if the key is longer */
+static ax_byte *key_bytes(const ax_trie *trie, const ax_seq *key, ax_byte *buf, size_t *len)
+{
+	ax_assert(ax_class_data(trie).key_tr == ax_class_data(ax_cr(ax_seq, key).ax_box).elem_tr,
+			"invalid element trait for the key");
+
+	size_t size = ax_box_size(ax_cr(ax_seq, key).ax_box);
+	ax_byte *bytes = size <= KEY_BUF_SIZE ? buf : malloc(size);
+	if (!bytes)
+		return NULL;
+
+	size_t i = 0;
+	ax_box_cforeach(ax_cr(ax_seq, key).ax_box, const ax_byte *, word)
+		bytes[i++] = *word;
+	*len = size;
+	return bytes;
+}
+
+inline static void key_bytes_free(ax_byte *bytes, ax_byte *buf)
+{
+	if (bytes != buf)
+		free(bytes);
+}
+
+inline static ax_iter make_iter(const ax_art *tree, uintptr_t ref, size_t depth)
+{
+	ax_art_cr self = AX_R_INIT(ax_art, tree);
+	return (ax_iter) {
+		.owner = (void *)tree,
+		.point = (void *)ref,
+		.extra = ref ? depth : 0,
+		.tr = &ax_art_tr.ax_box.iter,
+		.etr = VAL_TR(self),
+	};
+}
+
+inline static ax_iter make_riter(const ax_art *tree, uintptr_t ref, size_t depth)
+{
+	ax_iter it = make_iter(tree, ref, depth);
+	it.tr = &ax_art_tr.ax_box.riter;
+	return it;
+}
+
+static void *put(ax_art *tree, const ax_byte *key, size_t len, const void *val, va_list *ap)
+{
+	ax_art_r self = AX_R_INIT(ax_art, tree);
+	const ax_trait *vtr = VAL_TR(self);
+
+	struct leaf_st *leaf = search(tree, key, len);
+	if (leaf) {
+		void *ptr = leaf_val(leaf);
+		ax_byte tmp[ax_trait_size(vtr)]; // Backup old value
+		memcpy(tmp, ptr, ax_trait_size(vtr));
+		if (ax_trait_copy_or_init(vtr, ptr, val, ap)) {
+			memcpy(ptr, tmp, ax_trait_size(vtr)); // Restore old value
+			return NULL;
+		}
+		ax_trait_free(vtr, tmp);
+		return ptr;
+	}
+
+	leaf = leaf_create(tree, key, len, val, ap);
+	if (!leaf)
+		return NULL;
+	if (insert(tree, leaf)) {
+		leaf_free(tree, leaf);
+		return NULL;
+	}
+	tree->size++;
+	return leaf_val(leaf);
+}
+
+static void *trie_put(ax_trie *trie, const ax_seq *key, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_r self = AX_R_INIT(ax_trie, trie);
+	ax_byte buf[KEY_BUF_SIZE];
+	size_t len;
+	ax_byte *bytes = key_bytes(trie, key, buf, &len);
+	if (!bytes)
+		return NULL;
+	CHECK_PARAM_VALIDITY(key, len < UINT32_MAX);
+
+	void *ret = put(self.ax_art, bytes, len, val, ap);
+	key_bytes_free(bytes, buf);
+	return ret;
+}
+
+static void *trie_get(const ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_cr self = AX_R_INIT(ax_trie, trie);
+	ax_byte buf[KEY_BUF_SIZE];
+	size_t len;
+	ax_byte *bytes = key_bytes(trie, key, buf, &len);
+	if (!bytes)
+		return NULL;
+
+	struct leaf_st *leaf = search(self.ax_art, bytes, len);
+	key_bytes_free(bytes, buf);
+	return leaf ? leaf_val(leaf) : NULL;
+}
+
+static ax_iter trie_at(const ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_cr self = AX_R_INIT(ax_trie, trie);
+	ax_byte buf[KEY_BUF_SIZE];
+	size_t len;
+	ax_byte *bytes = key_bytes(trie, key, buf, &len);
+	if (!bytes)
+		return make_iter(self.ax_art, 0, 0);
+
+	uintptr_t *slot = locate(self.ax_art, bytes, len, NULL);
+	key_bytes_free(bytes, buf);
+	return make_iter(self.ax_art, slot ? *slot : 0, len);
+}
+
+static bool trie_exist(const ax_trie *trie, const ax_seq *key, bool *valued)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_iter it = trie_at(trie, key);
+	if (!it.point)
+		return false;
+	if (valued)
+		*valued = !!value_leaf((uintptr_t)it.point, it.extra);
+	return true;
+}
+
+static bool trie_erase(ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_r self = AX_R_INIT(ax_trie, trie);
+	ax_byte buf[KEY_BUF_SIZE];
+	size_t len;
+	ax_byte *bytes = key_bytes(trie, key, buf, &len);
+	if (!bytes)
+		return false;
+
+	struct leaf_st *leaf = detach(self.ax_art, bytes, len);
+	key_bytes_free(bytes, buf);
+	if (!leaf)
+		return false;
+	leaf_free(self.ax_art, leaf);
+	self.ax_art->size--;
+	return true;
+}
+
+static bool trie_prune(ax_trie *trie, const ax_seq *key)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key);
+
+	ax_art_r self = AX_R_INIT(ax_trie, trie);
+	ax_art *tree = self.ax_art;
+	ax_byte buf[KEY_BUF_SIZE];
+	size_t len;
+	ax_byte *bytes = key_bytes(trie, key, buf, &len);
+	if (!bytes)
+		return false;
+
+	/* All pairs under the trie node are in the same tree node */
+	uintptr_t *parent_slot, *slot = locate(tree, bytes, len, &parent_slot);
+	if (slot) {
+		uintptr_t ref = *slot;
+		if (parent_slot) {
+			struct node_st *parent = NODE_OF(*parent_slot);
+			remove_child(parent_slot, parent, bytes[parent->depth]);
+		} else
+			tree->root = 0;
+		tree->size -= free_subtree(tree, ref);
+	}
+	key_bytes_free(bytes, buf);
+	return !!slot;
+}
+
+static ax_fail trie_rekey(ax_trie *trie, const ax_seq *key_from, const ax_seq *key_to)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_NULL(key_from);
+	CHECK_PARAM_NULL(key_to);
+
+	ax_art_r self = AX_R_INIT(ax_trie, trie);
+	ax_art *tree = self.ax_art;
+	const ax_trait *vtr = VAL_TR(self);
+	ax_fail retval = false;
+
+	ax_byte from_buf[KEY_BUF_SIZE], to_buf[KEY_BUF_SIZE];
+	size_t from_len, to_len;
+	ax_byte *from = key_bytes(trie, key_from, from_buf, &from_len);
+	ax_byte *to = key_bytes(trie, key_to, to_buf, &to_len);
+	if (!from || !to) {
+		retval = true;
+		goto out;
+	}
+
+	struct leaf_st *leaf = search(tree, from, from_len);
+	if (!leaf || (from_len == to_len && memcmp(from, to, to_len) == 0))
+		goto out;
+
+	/* The value is moved bitwise to the leaf of the new key */
+	struct leaf_st *target = search(tree, to, to_len);
+	if (target)
+		ax_trait_free(vtr, leaf_val(target));
+	else {
+		target = malloc(sizeof(struct leaf_st) + ax_trait_size(vtr) + to_len);
+		if (!target) {
+			retval = true;
+			goto out;
+		}
+		target->len = to_len;
+		memcpy(target->buf + ax_trait_size(vtr), to, to_len);
+		if (insert(tree, target)) {
+			free(target);
+			retval = true;
+			goto out;
+		}
+		tree->size++;
+	}
+	memcpy(leaf_val(target), leaf_val(leaf), ax_trait_size(vtr));
+	free(detach(tree, from, from_len));
+	tree->size--;
+out:
+	if (from)
+		key_bytes_free(from, from_buf);
+	if (to)
+		key_bytes_free(to, to_buf);
+	return retval;
+}
+
+static void *trie_put_bytes(ax_trie *trie, const void *key, size_t len, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || !len);
+	CHECK_PARAM_VALIDITY(len, len < UINT32_MAX);
+
+	ax_art_r self = AX_R_INIT(ax_trie, trie);
+	return put(self.ax_art, len ? key : "", len, val, ap);
+}
+
+static void *trie_get_bytes(const ax_trie *trie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || !len);
+
+	ax_art_cr self = AX_R_INIT(ax_trie, trie);
+	struct leaf_st *leaf = search(self.ax_art, len ? key : "", len);
+	return leaf ? leaf_val(leaf) : NULL;
+}
+
+static bool trie_exist_bytes(const ax_trie *trie, const void *key, size_t len, bool *valued)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || !len);
+
+	ax_art_cr self = AX_R_INIT(ax_trie, trie);
+	uintptr_t *slot = locate(self.ax_art, len ? key : "", len, NULL);
+	if (!slot)
+		return false;
+	if (valued)
+		*valued = !!value_leaf(*slot, len);
+	return true;
+}
+
+static const void *trie_it_word(const ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	if (it->extra == 0)
+		return NULL;
+	return leaf_key(it->owner, minimum_leaf((uintptr_t)it->point)) + it->extra - 1;
+}
+
+static ax_iter trie_it_begin(const ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	uintptr_t child = next_child(it->owner, (uintptr_t)it->point, it->extra, -1);
+	return make_iter(it->owner, child, it->extra + 1);
+}
+
+static ax_iter trie_it_end(const ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner);
+
+	return make_iter(it->owner, 0, 0);
+}
+
+static bool trie_it_parent(const ax_citer *it, ax_iter *parent)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	const ax_art *tree = it->owner;
+	if (it->extra == 0)
+		return false;
+	const ax_byte *key = leaf_key(tree, minimum_leaf((uintptr_t)it->point));
+	uintptr_t *slot = locate(tree, key, it->extra - 1, NULL);
+	*parent = make_iter(tree, *slot, it->extra - 1);
+	return true;
+}
+
+static bool trie_it_valued(const ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	return !!value_leaf((uintptr_t)it->point, it->extra);
+}
+
+/* The sibling after or before the trie node of it */
+static uintptr_t sibling(const ax_citer *it, bool next)
+{
+	const ax_art *tree = it->owner;
+	size_t depth = it->extra;
+	if (depth == 0)
+		return 0;
+
+	const ax_byte *key = leaf_key(tree, minimum_leaf((uintptr_t)it->point));
+	uintptr_t parent = *locate(tree, key, depth - 1, NULL);
+	return next
+		? next_child(tree, parent, depth - 1, key[depth - 1])
+		: prev_child(tree, parent, depth - 1, key[depth - 1]);
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+	ax_assert(it->point, "iterator boundary exceeded");
+
+	uintptr_t ref = sibling(it, ax_citer_norm(it));
+	it->point = (void *)ref;
+	if (!ref)
+		it->extra = 0;
+}
+
+static void citer_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+	ax_assert(it->point, "the end of siblings has no previous one");
+
+	uintptr_t ref = sibling(it, !ax_citer_norm(it));
+	it->point = (void *)ref;
+	if (!ref)
+		it->extra = 0;
+}
+
+static ax_box *citer_box(const ax_citer *it)
+{
+	return (ax_box *)it->owner;
+}
+
+static void *citer_get(const ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	struct leaf_st *leaf = value_leaf((uintptr_t)it->point, it->extra);
+	return leaf ? leaf_val(leaf) : NULL;
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val, va_list *ap)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	ax_art_r self = AX_R_INIT(ax_one, it->owner);
+	const ax_trait *vtr = VAL_TR(self);
+	struct leaf_st *leaf = minimum_leaf((uintptr_t)it->point);
+
+	if (leaf->len != it->extra) {
+		/* No pair ends here, the new one invalidates iterators */
+		ax_byte buf[KEY_BUF_SIZE];
+		ax_byte *key = it->extra <= KEY_BUF_SIZE ? buf : malloc(it->extra);
+		if (!key)
+			return true;
+		memcpy(key, leaf_key(self.ax_art, leaf), it->extra);
+		void *ret = put(self.ax_art, key, it->extra, val, ap);
+		key_bytes_free(key, buf);
+		return !ret;
+	}
+
+	void *ptr = leaf_val(leaf);
+	ax_byte tmp[ax_trait_size(vtr)]; // Backup old value
+	memcpy(tmp, ptr, ax_trait_size(vtr));
+	if (ax_trait_copy_or_init(vtr, ptr, val, ap)) {
+		memcpy(ptr, tmp, ax_trait_size(vtr)); // Restore old value
+		return true;
+	}
+	ax_trait_free(vtr, tmp);
+	return false;
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	ax_art_r self = AX_R_INIT(ax_one, it->owner);
+	ax_art *tree = self.ax_art;
+	size_t depth = it->extra;
+
+	struct leaf_st *leaf = value_leaf((uintptr_t)it->point, depth);
+	if (!leaf)
+		return;
+
+	if (depth == 0) {
+		leaf_free(tree, detach(tree, (const ax_byte *)"", 0));
+		tree->size--;
+		*it = make_iter(tree, tree->root, 0);
+		return;
+	}
+
+	/* Remember the path of the parent, the trie node may be gone with the pair */
+	ax_byte buf[KEY_BUF_SIZE];
+	ax_byte *key = depth <= KEY_BUF_SIZE ? buf : malloc(depth);
+	ax_assert(key, "out of memory");
+	memcpy(key, leaf_key(tree, leaf), depth);
+
+	leaf_free(tree, detach(tree, key, depth));
+	tree->size--;
+
+	/* Stay at the trie node if it still exists, otherwise move to the next sibling */
+	uintptr_t *parent = locate(tree, key, depth - 1, NULL);
+	uintptr_t ref = parent ? next_child(tree, *parent, depth - 1, key[depth - 1] - 1) : 0;
+	it->point = (void *)ref;
+	it->extra = ref ? depth : 0;
+	key_bytes_free(key, buf);
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_art_r self = AX_R_INIT(ax_one, one);
+	box_clear(self.ax_box);
+	free(one);
+}
+
+static const char *one_name(const ax_one *one)
+{
+	return ax_class_name(4, ax_art);
+}
+
+static ax_dump *any_dump(const ax_any *any)
+{
+	ax_trie_cr self = AX_R_INIT(ax_any, any);
+	return ax_trie_dump(self.ax_trie);
+}
+
+static ax_fail copy_subtree(ax_art *dst, const ax_art *src, uintptr_t ref)
+{
+	if (IS_LEAF(ref)) {
+		struct leaf_st *leaf = LEAF_OF(ref);
+		return !put(dst, leaf_key(src, leaf), leaf->len, leaf_val(leaf), NULL);
+	}
+
+	const struct node_st *node = NODE_OF(ref);
+	if (node->leaf && copy_subtree(dst, src, LEAF_REF(node->leaf)))
+		return true;
+	ax_byte b;
+	for (uintptr_t child = child_after(node, -1, &b); child; child = b < 255 ? child_after(node, b, &b) : 0)
+		if (copy_subtree(dst, src, child))
+			return true;
+	return false;
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_art_cr src = AX_R_INIT(ax_any, any);
+	ax_art_r dst = { .ax_trie = __ax_art_construct(ax_class_data(src.ax_trie).key_tr, VAL_TR(src)) };
+	if (!dst.ax_trie)
+		return NULL;
+
+	if (src.ax_art->root && copy_subtree(dst.ax_art, src.ax_art, src.ax_art->root)) {
+		ax_one_free(dst.ax_one);
+		return NULL;
+	}
+	return dst.ax_any;
+}
+
+static size_t box_size(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_cr self = AX_R_INIT(ax_box, box);
+	return self.ax_art->size;
+}
+
+static size_t box_maxsize(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return SIZE_MAX;
+}
+
+static ax_iter box_begin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_r self = AX_R_INIT(ax_box, box);
+	return make_iter(self.ax_art, self.ax_art->root, 0);
+}
+
+static ax_iter box_end(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_r self = AX_R_INIT(ax_box, box);
+	return make_iter(self.ax_art, 0, 0);
+}
+
+static ax_iter box_rbegin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_r self = AX_R_INIT(ax_box, box);
+	return make_riter(self.ax_art, self.ax_art->root, 0);
+}
+
+static ax_iter box_rend(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_r self = AX_R_INIT(ax_box, box);
+	return make_riter(self.ax_art, 0, 0);
+}
+
+static void box_clear(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_art_r self = AX_R_INIT(ax_box, box);
+	if (self.ax_art->root)
+		free_subtree(self.ax_art, self.ax_art->root);
+	self.ax_art->root = 0;
+	self.ax_art->size = 0;
+}
+
+const ax_trie_trait ax_art_tr =
+{
+	.ax_box = {
+		.ax_any = {
+			.ax_one = {
+				.name = one_name,
+				.free = one_free,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+		},
+		.iter = {
+			.norm = true,
+			.type = AX_IT_BID,
+			.next = citer_next,
+			.prev = citer_prev,
+			.box = citer_box,
+			.get = citer_get,
+			.set = iter_set,
+			.erase = iter_erase,
+		},
+		.riter = {
+			.norm = false,
+			.type = AX_IT_BID,
+			.next = citer_next,
+			.prev = citer_prev,
+			.box = citer_box,
+			.get = citer_get,
+			.set = iter_set,
+			.erase = iter_erase,
+		},
+		.size = box_size,
+		.maxsize = box_maxsize,
+		.begin = box_begin,
+		.end = box_end,
+		.rbegin = box_rbegin,
+		.rend = box_rend,
+		.clear = box_clear,
+	},
+
+	.put = trie_put,
+	.get = trie_get,
+	.at = trie_at,
+	.exist = trie_exist,
+	.prune = trie_prune,
+	.rekey = trie_rekey,
+	.erase = trie_erase,
+	.it_word = trie_it_word,
+	.it_begin = trie_it_begin,
+	.it_end = trie_it_end,
+	.it_parent = trie_it_parent,
+	.it_valued = trie_it_valued,
+	.put_bytes = trie_put_bytes,
+	.get_bytes = trie_get_bytes,
+	.exist_bytes = trie_exist_bytes,
+};
+
+ax_trie *__ax_art_construct(const ax_trait *key_tr, const ax_trait *val_tr)
+{
+	CHECK_PARAM_NULL(key_tr);
+	CHECK_PARAM_NULL(val_tr);
+	CHECK_PARAM_VALIDITY(key_tr, ax_trait_size(key_tr) == 1);
+
+	ax_art *self = malloc(sizeof(ax_art));
+	if (!self)
+		return NULL;
+
+	ax_art art_init = {
+		.ax_trie = {
+			.tr = &ax_art_tr,
+			.env = {
+				.key_tr = key_tr,
+				.ax_box.elem_tr = val_tr,
+			},
+		},
+		.root = 0,
+		.size = 0,
+	};
+	memcpy(self, &art_init, sizeof art_init);
+	return ax_r(ax_art, self).ax_trie;
+}
@@ -41,6 +41,7 @@ ax_concrete_begin(ax_avl)
 	struct node_st {
 		struct node_st *left, *right, *parent;
 		size_t height;
+		size_t count; /* Nodes in the subtree, for rank and select */
 		ax_byte kvbuffer[];
 	} *root;
 size_t size;
@@ -63,10 +64,16 @@ static ax_dump *any_dump(const ax_any* any);
 static ax_any *any_copy(const ax_any* any);
 static void one_free(ax_one* one);
 static const char *one_name(const ax_one *one);
+static ax_iter map_select(const ax_map *map, size_t index);
+static size_t map_rank(const ax_map *map, const void *key);
+static ax_iter map_lower_bound(const ax_map *map, const void *key);
+static ax_iter map_upper_bound(const ax_map *map, const void *key);
+static void citer_move(ax_citer *it, long i);
 static void citer_prev(ax_citer *it);
 static void citer_next(ax_citer *it);
 static bool citer_less(const ax_citer *it1, const ax_citer *it2);
 static long citer_dist(const ax_citer *it1, const ax_citer *it2);
+static void rciter_move(ax_citer *it, long i);
 static void rciter_prev(ax_citer *it);
 static void rciter_next(ax_citer *it);
 static bool rciter_less(const ax_citer *it1, const ax_citer *it2);
@@ -162,9 +169,16 @@ inline static int height(struct node_st *root)
 	return root ? root->height : 0;
 }
 
-inline static void adjust_height(struct node_st *root)
+inline static size_t count(const struct node_st *root)
+{
+	return root ? root->count : 0;
+}
+
+/* Every node whose children changed is adjusted on the way up to the root */
+inline static void adjust_node(struct node_st *root)
 {
 	root->height = 1 + ax_max(height(root->left), height(root->right));
+	root->count = 1 + count(root->left) + count(root->right);
 }
 
 static struct node_st *rotate_right(struct node_st *root)
@@ -183,8 +197,8 @@ static struct node_st *rotate_right(struct node_st *root)
 		root->left->parent = root;
 	new_root->right = root;
 
-	adjust_height(root);
-	adjust_height(new_root);
+	adjust_node(root);
+	adjust_node(new_root);
 	return new_root;
 }
 
@@ -204,8 +218,8 @@ static struct node_st *rotate_left(struct node_st *root)
 		root->right->parent = root;
 	new_root->left = root;
 
-	adjust_height(root);
-	adjust_height(new_root);
+	adjust_node(root);
+	adjust_node(new_root);
 	return new_root;
 }
 
@@ -219,6 +233,7 @@ static struct node_st *make_node(ax_map *map, struct node_st *parent, const void
 
 	node->parent = parent;
 	node->height = 1;
+	node->count = 1;
 	node->left = NULL;
 	node->right = NULL;
 	const ax_trait *ktr = ax_class_data(map).key_tr;
@@ -236,7 +251,7 @@ failed:
 static struct node_st *balance(struct node_st *root)
 {
 	if (height(root->left) - height(root->right) > 1) {
-		if (height(root->left->left) > height(root->left->right)) {
+		if (height(root->left->left) >= height(root->left->right)) {
 			root = rotate_right(root);
 		} else {
 			rotate_left(root->left);
@@ -244,7 +259,7 @@ static struct node_st *balance(struct node_st *root)
 		}
 	}
 	else if (height(root->right) - height(root->left) > 1) {
-		if (height(root->right->right) > height(root->right->left)) {
+		if (height(root->right->right) >= height(root->right->left)) {
 			root = rotate_left(root);
 		} else {
 			rotate_right(root->right);
@@ -307,6 +322,42 @@ static struct node_st* remove_node(ax_avl *avl, struct node_st* node)
 	return dirty_node;
 }
 
+static struct node_st *select_node(const ax_avl *avl, size_t index)
+{
+	struct node_st *node = avl->root;
+	while (node) {
+		size_t left = count(node->left);
+		if (index < left)
+			node = node->left;
+		else if (index == left)
+			break;
+		else {
+			index -= left + 1;
+			node = node->right;
+		}
+	}
+	return node;
+}
+
+/* Position of node in key order, the end is at size */
+static size_t node_rank(const ax_avl *avl, const struct node_st *node)
+{
+	if (!node)
+		return avl->size;
+
+	size_t rank = count(node->left);
+	for (; node->parent; node = node->parent)
+		if (node->parent->right == node)
+			rank += count(node->parent->left) + 1;
+	return rank;
+}
+
+/* Position in reverse order, the end is at size */
+static size_t node_rrank(const ax_avl *avl, const struct node_st *node)
+{
+	return node ? avl->size - 1 - node_rank(avl, node) : avl->size;
+}
+
 static void remove_child(struct node_st *node) {
 	if (node) {
 		remove_child(node->left);
@@ -343,28 +394,18 @@ static long citer_dist(const ax_citer *it1, const ax_citer *it2)
 {
 	CHECK_ITER_COMPARABLE(it1, it2);
 
-	ax_avl_r self = AX_R_INIT(ax_one, (ax_one *)it1->owner);
-
-	struct node_st *node1 = it1->point;
-	struct node_st *node2 = it2->point;
-	struct node_st *cur = lowest_node(self.ax_map, self.ax_avl->root);
-
-	size_t loc1, loc2;
-	loc1 = loc2 = self.ax_avl->size;
-
-	int found = !node1 + !node2;
-
-	for (int i = 0; found < 2 && cur; i++) {
-		if (cur == node1)
-			loc1 = i, found++;
-		if (cur == node2)
-			loc2 = i, found++;
-		cur = higher_node(self.ax_map, cur);
-	}
+	const ax_avl *avl = it1->owner;
+	return (long)node_rank(avl, it2->point) - (long)node_rank(avl, it1->point);
+}
 
-	ax_assert(found == 2, "bad iterator");
+static void citer_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
 
-	return loc2 - loc1;
+	const ax_avl *avl = it->owner;
+	long rank = (long)node_rank(avl, it->point) + i;
+	ax_assert(rank >= 0 && rank <= (long)avl->size, "iterator boundary exceeded");
+	it->point = select_node(avl, rank);
 }
 
 static void rciter_prev(ax_citer *it)
@@ -393,7 +434,20 @@ static bool rciter_less(const ax_citer *it1, const ax_citer *it2)
 
 static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
 {
-	return citer_dist(it2, it1);
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_avl *avl = it1->owner;
+	return (long)node_rrank(avl, it2->point) - (long)node_rrank(avl, it1->point);
+}
+
+static void rciter_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_avl *avl = it->owner;
+	long rrank = (long)node_rrank(avl, it->point) + i;
+	ax_assert(rrank >= 0 && rrank <= (long)avl->size, "iterator boundary exceeded");
+	it->point = (size_t)rrank == avl->size ? NULL : select_node(avl, avl->size - 1 - rrank);
 }
 
 static void *citer_get(const ax_citer *it)
@@ -440,11 +494,11 @@ static void iter_erase(ax_iter *it)
 
 	if (current) {
 		while (current->parent) {
-			adjust_height(current);
+			adjust_node(current);
 			current = balance(current);
 			current  = current->parent;
 		} 
-		adjust_height(current);
+		adjust_node(current);
 		current = balance(current);
 	}
 	self.ax_avl->root = current;
@@ -511,7 +565,7 @@ static void *map_put (ax_map* map, const void *key, const void *val, va_list *ap
 
 	do {
 		current  = current->parent;
-		adjust_height(current);
+		adjust_node(current);
 		current = balance(current);
 	} while (current->parent);
 	self.ax_avl->size ++;
@@ -532,11 +586,11 @@ static ax_fail map_erase (ax_map* map, const void *key)
 
 	if (current) {
 		while (current->parent) {
-			adjust_height(current);
+			adjust_node(current);
 			current = balance(current);
 			current  = current->parent;
 		} 
-		adjust_height(current);
+		adjust_node(current);
 		current = balance(current);
 	}
 
@@ -581,6 +635,78 @@ static bool map_exist(const ax_map* map, const void *key)
 	return !!find_node(map, self.ax_avl->root, key);
 }
 
+static ax_iter map_select(const ax_map *map, size_t index)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_avl_cr self = AX_R_INIT(ax_map, map);
+	return (ax_iter) {
+		.owner = (void *)map,
+		.point = select_node(self.ax_avl, index),
+		.tr = &ax_avl_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+}
+
+static size_t map_rank(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_avl_cr self = AX_R_INIT(ax_map, map);
+	const ax_trait *ktr = ax_class_data(self.ax_map).key_tr;
+	size_t rank = 0;
+	for (struct node_st *node = self.ax_avl->root; node; ) {
+		if (ax_trait_less(ktr, node->kvbuffer, key)) {
+			rank += count(node->left) + 1;
+			node = node->right;
+		} else
+			node = node->left;
+	}
+	return rank;
+}
+
+/* The first node whose key is not less than key, or greater than key if upper is true */
+static struct node_st *bound_node(const ax_avl *avl, const void *key, bool upper)
+{
+	ax_avl_cr self = AX_R_INIT(ax_avl, avl);
+	const ax_trait *ktr = ax_class_data(self.ax_map).key_tr;
+	struct node_st *node = avl->root, *bound = NULL;
+	while (node) {
+		if (upper ? ax_trait_less(ktr, key, node->kvbuffer) : !ax_trait_less(ktr, node->kvbuffer, key)) {
+			bound = node;
+			node = node->left;
+		} else
+			node = node->right;
+	}
+	return bound;
+}
+
+static ax_iter map_lower_bound(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_avl_cr self = AX_R_INIT(ax_map, map);
+	return (ax_iter) {
+		.owner = (void *)map,
+		.point = bound_node(self.ax_avl, key, false),
+		.tr = &ax_avl_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+}
+
+static ax_iter map_upper_bound(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_avl_cr self = AX_R_INIT(ax_map, map);
+	return (ax_iter) {
+		.owner = (void *)map,
+		.point = bound_node(self.ax_avl, key, true),
+		.tr = &ax_avl_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+}
+
 static const void *map_it_key(const ax_citer *it)
 {
 	CHECK_PARAM_VALIDITY(it, it->owner && it->point && it->tr);
@@ -622,7 +748,7 @@ static ax_any *any_copy(const ax_any *any)
 		return NULL;
 
 	ax_map_cforeach(src.ax_map, const void *, key, const void *, val) {
-		if (!map_put(dst.ax_map, key, val, NULL))
+		if (!ax_map_put(dst.ax_map, key, val))
 			goto fail;
 	}
 
@@ -735,6 +861,407 @@ static void box_clear(ax_box* box)
 	self.ax_avl->size = 0;
 }
 
+/* Pairs read by ax_avl_build, either from arrays or from a map iterator */
+struct pair_src_st
+{
+	const ax_trait *ktr, *vtr;
+	const ax_byte *keys, *vals;
+	ax_citer it;
+	const void *key;
+};
+
+static void pair_src_next(struct pair_src_st *src, const void **key, const void **val)
+{
+	if (src->keys) {
+		*key = src->keys;
+		*val = src->vals;
+		src->keys += ax_trait_size(src->ktr);
+		if (src->vals)
+			src->vals += ax_trait_size(src->vtr);
+		return;
+	}
+
+	src->key = ax_class_trait((const ax_map *)src->it.owner).itkey(&src->it);
+	*key = ax_trait_in(src->ktr, src->key);
+	*val = src->it.tr->get(&src->it);
+	ax_citer_next(&src->it);
+}
+
+static void free_node(ax_avl *avl, struct node_st *node)
+{
+	ax_avl_r self = AX_R_INIT(ax_avl, avl);
+	ax_trait_free(ax_class_data(self.ax_map).key_tr, node->kvbuffer);
+	ax_trait_free(ax_class_data(self.ax_box).elem_tr, node_val(self.ax_map, node));
+	free(node);
+}
+
+static void free_subtree(ax_avl *avl, struct node_st *node)
+{
+	if (!node)
+		return;
+
+	free_subtree(avl, node->left);
+	free_subtree(avl, node->right);
+	free_node(avl, node);
+}
+
+/* Build a subtree of the next n pairs in order, sizes of both sides differ at most by one */
+static struct node_st *build_subtree(ax_avl *avl, struct pair_src_st *src, size_t n, struct node_st **last)
+{
+	size_t nleft = (n - 1) / 2, nright = n - 1 - nleft;
+
+	struct node_st *left = NULL, *right = NULL, *node = NULL;
+	if (nleft && !(left = build_subtree(avl, src, nleft, last)))
+		return NULL;
+
+	const void *key, *val;
+	pair_src_next(src, &key, &val);
+	ax_assert(!*last || ax_trait_less(src->ktr, (*last)->kvbuffer, key),
+			"keys are not in strictly ascending order");
+
+	node = make_node(ax_r(ax_avl, avl).ax_map, NULL, key, val, NULL);
+	if (!node)
+		goto fail;
+	node->left = left;
+	*last = node;
+
+	if (nright && !(right = build_subtree(avl, src, nright, last))) {
+		left = node;
+		goto fail;
+	}
+	node->right = right;
+
+	if (left)
+		left->parent = node;
+	if (right)
+		right->parent = node;
+	adjust_node(node);
+	return node;
+fail:
+	free_subtree(avl, left);
+	return NULL;
+}
+
+static ax_fail build(ax_avl *avl, struct pair_src_st *src, size_t n)
+{
+	if (!n)
+		return false;
+
+	if (avl->root) {
+		ax_avl_r self = AX_R_INIT(ax_avl, avl);
+		for (size_t i = 0; i < n; i++) {
+			const void *key, *val;
+			pair_src_next(src, &key, &val);
+			if (!map_put(self.ax_map, key, val, NULL))
+				return true;
+		}
+		return false;
+	}
+
+	struct node_st *last = NULL;
+	struct node_st *root = build_subtree(avl, src, n, &last);
+	if (!root)
+		return true;
+
+	avl->root = root;
+	avl->size = n;
+	return false;
+}
+
+ax_fail ax_avl_build(ax_avl *avl, const void *keys, const void *vals, size_t n)
+{
+	CHECK_PARAM_NULL(avl);
+	CHECK_PARAM_VALIDITY(keys, keys || !n);
+
+	ax_avl_r self = AX_R_INIT(ax_avl, avl);
+	struct pair_src_st src = {
+		.ktr = ax_class_data(self.ax_map).key_tr,
+		.vtr = ax_class_data(self.ax_box).elem_tr,
+		.keys = keys,
+		.vals = vals,
+	};
+	return build(avl, &src, n);
+}
+
+ax_fail ax_avl_build_range(ax_avl *avl, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(avl);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_ITER_COMPARABLE(first, last);
+
+	ax_avl_r self = AX_R_INIT(ax_avl, avl);
+	const ax_trait *ktr = ax_class_data(self.ax_map).key_tr,
+	      *vtr = ax_class_data(self.ax_box).elem_tr;
+	CHECK_PARAM_VALIDITY(first, ax_class_data((const ax_map *)first->owner).key_tr == ktr);
+	CHECK_PARAM_VALIDITY(first, first->etr == vtr);
+
+	size_t n = 0;
+	if (first->tr->dist)
+		n = ax_citer_dist(first, last);
+	else
+		for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it))
+			n++;
+
+	struct pair_src_st src = {
+		.ktr = ktr,
+		.vtr = vtr,
+		.it = *first,
+	};
+	return build(avl, &src, n);
+}
+
+/*
+ * Split, join and the set operations below work on detached subtrees, whose
+ * roots have no parent. Joining two subtrees only walks down the spine of the
+ * higher one, by the difference of their heights.
+ */
+
+static struct node_st *detach(struct node_st *child)
+{
+	if (child)
+		child->parent = NULL;
+	return child;
+}
+
+/* Join l, k and r, all keys in l are less than the key of k, which is less than all keys in r */
+static struct node_st *join(struct node_st *l, struct node_st *k, struct node_st *r)
+{
+	k->parent = NULL;
+	if (abs(height(l) - height(r)) <= 1) {
+		k->left = l;
+		k->right = r;
+		if (l)
+			l->parent = k;
+		if (r)
+			r->parent = k;
+		adjust_node(k);
+		return k;
+	}
+
+	/* Walk down the spine of the higher subtree to a node, which is at
+	 * most one level higher than the lower subtree */
+	bool right = height(l) > height(r);
+	struct node_st *high = right ? l : r, *low = right ? r : l;
+	struct node_st *parent = NULL, *cur = high;
+	while (height(cur) > height(low) + 1) {
+		parent = cur;
+		cur = right ? cur->right : cur->left;
+	}
+
+	/* Replace cur with k, which takes cur and the lower subtree as children */
+	k->parent = parent;
+	if (right) {
+		k->left = cur;
+		k->right = low;
+		parent->right = k;
+	} else {
+		k->left = low;
+		k->right = cur;
+		parent->left = k;
+	}
+	if (cur)
+		cur->parent = k;
+	if (low)
+		low->parent = k;
+	adjust_node(k);
+
+	struct node_st *node = parent, *root;
+	do {
+		adjust_node(node);
+		root = balance(node);
+		node = root->parent;
+	} while (node);
+	return root;
+}
+
+/* Remove the lowest node from t, the rest is returned by rest */
+static struct node_st *split_first(struct node_st *t, struct node_st **rest)
+{
+	struct node_st *left = detach(t->left), *right = detach(t->right);
+	if (!left) {
+		*rest = right;
+		return t;
+	}
+
+	struct node_st *first = split_first(left, rest);
+	*rest = join(*rest, t, right);
+	return first;
+}
+
+/* Join l and r, all keys in l are less than all keys in r */
+static struct node_st *join2(struct node_st *l, struct node_st *r)
+{
+	if (!l)
+		return r;
+	if (!r)
+		return l;
+
+	struct node_st *rest;
+	struct node_st *first = split_first(r, &rest);
+	return join(l, first, rest);
+}
+
+/* Split t by key into l and r, the node of key is neither of them but returned */
+static struct node_st *split(const ax_trait *ktr, struct node_st *t, const void *key,
+		struct node_st **l, struct node_st **r)
+{
+	if (!t) {
+		*l = *r = NULL;
+		return NULL;
+	}
+
+	struct node_st *left = detach(t->left), *right = detach(t->right), *found;
+	if (ax_trait_less(ktr, key, t->kvbuffer)) {
+		found = split(ktr, left, key, l, r);
+		*r = join(*r, t, right);
+	} else if (ax_trait_less(ktr, t->kvbuffer, key)) {
+		found = split(ktr, right, key, l, r);
+		*l = join(left, t, *l);
+	} else {
+		*l = left;
+		*r = right;
+		found = t;
+	}
+	return found;
+}
+
+/* Pairs of t2 replace the ones of the same keys in t1 */
+static struct node_st *unite(ax_avl *avl, struct node_st *t1, struct node_st *t2)
+{
+	if (!t1)
+		return t2;
+	if (!t2)
+		return t1;
+
+	ax_avl_r self = AX_R_INIT(ax_avl, avl);
+	struct node_st *l1, *r1,
+		       *l2 = detach(t2->left),
+		       *r2 = detach(t2->right),
+		       *found = split(ax_class_data(self.ax_map).key_tr, t1, t2->kvbuffer, &l1, &r1);
+	if (found)
+		free_node(avl, found);
+	l1 = unite(avl, l1, l2);
+	r1 = unite(avl, r1, r2);
+	return join(l1, t2, r1);
+}
+
+/* If keep is true, free the nodes of t1 whose keys are not in the subtree of
+ * n2, otherwise free the ones whose keys are in it */
+static struct node_st *filter(ax_avl *avl, struct node_st *t1, const struct node_st *n2, bool keep)
+{
+	if (!t1)
+		return NULL;
+	if (!n2) {
+		if (keep) {
+			free_subtree(avl, t1);
+			return NULL;
+		}
+		return t1;
+	}
+
+	ax_avl_r self = AX_R_INIT(ax_avl, avl);
+	struct node_st *l1, *r1,
+		       *found = split(ax_class_data(self.ax_map).key_tr, t1, n2->kvbuffer, &l1, &r1);
+	l1 = filter(avl, l1, n2->left, keep);
+	r1 = filter(avl, r1, n2->right, keep);
+	if (found) {
+		if (keep)
+			return join(l1, found, r1);
+		free_node(avl, found);
+	}
+	return join2(l1, r1);
+}
+
+static struct node_st *take_tree(ax_avl *avl)
+{
+	struct node_st *root = avl->root;
+	avl->root = NULL;
+	avl->size = 0;
+	return root;
+}
+
+static void put_tree(ax_avl *avl, struct node_st *root)
+{
+	avl->root = root;
+	avl->size = count(root);
+}
+
+inline static bool same_traits(const ax_avl *avl1, const ax_avl *avl2, bool with_val)
+{
+	ax_avl_cr r1 = AX_R_INIT(ax_avl, avl1), r2 = AX_R_INIT(ax_avl, avl2);
+	return ax_class_data(r1.ax_map).key_tr == ax_class_data(r2.ax_map).key_tr
+		&& (!with_val || ax_class_data(r1.ax_box).elem_tr == ax_class_data(r2.ax_box).elem_tr);
+}
+
+inline static bool ordered_trees(const ax_avl *left, const ax_avl *right)
+{
+	ax_avl_cr self = AX_R_INIT(ax_avl, left);
+	return !left->root || !right->root
+		|| ax_trait_less(ax_class_data(self.ax_map).key_tr,
+				highest_node(self.ax_map, left->root)->kvbuffer,
+				lowest_node(self.ax_map, right->root)->kvbuffer);
+}
+
+void ax_avl_split(ax_avl *avl, const void *key, ax_avl *right)
+{
+	CHECK_PARAM_NULL(avl);
+	CHECK_PARAM_NULL(right);
+	CHECK_PARAM_VALIDITY(right, right != avl && !right->root);
+	CHECK_PARAM_VALIDITY(right, same_traits(avl, right, true));
+
+	ax_avl_r self = AX_R_INIT(ax_avl, avl);
+	const ax_trait *ktr = ax_class_data(self.ax_map).key_tr;
+	struct node_st *l, *r, *found = split(ktr, take_tree(avl), ax_trait_in(ktr, key), &l, &r);
+	if (found)
+		r = join(NULL, found, r);
+	put_tree(avl, l);
+	put_tree(right, r);
+}
+
+void ax_avl_join(ax_avl *avl, ax_avl *right)
+{
+	CHECK_PARAM_NULL(avl);
+	CHECK_PARAM_NULL(right);
+	CHECK_PARAM_VALIDITY(right, right != avl);
+	CHECK_PARAM_VALIDITY(right, same_traits(avl, right, true));
+	CHECK_PARAM_VALIDITY(right, ordered_trees(avl, right));
+
+	struct node_st *l = take_tree(avl), *r = take_tree(right);
+	put_tree(avl, join2(l, r));
+}
+
+void ax_avl_union(ax_avl *avl, ax_avl *other)
+{
+	CHECK_PARAM_NULL(avl);
+	CHECK_PARAM_NULL(other);
+	CHECK_PARAM_VALIDITY(other, other != avl);
+	CHECK_PARAM_VALIDITY(other, same_traits(avl, other, true));
+
+	struct node_st *t1 = take_tree(avl), *t2 = take_tree(other);
+	put_tree(avl, unite(avl, t1, t2));
+}
+
+void ax_avl_intersection(ax_avl *avl, const ax_avl *other)
+{
+	CHECK_PARAM_NULL(avl);
+	CHECK_PARAM_NULL(other);
+	CHECK_PARAM_VALIDITY(other, other != avl);
+	CHECK_PARAM_VALIDITY(other, same_traits(avl, other, false));
+
+	put_tree(avl, filter(avl, take_tree(avl), other->root, true));
+}
+
+void ax_avl_difference(ax_avl *avl, const ax_avl *other)
+{
+	CHECK_PARAM_NULL(avl);
+	CHECK_PARAM_NULL(other);
+	CHECK_PARAM_VALIDITY(other, other != avl);
+	CHECK_PARAM_VALIDITY(other, same_traits(avl, other, false));
+
+	put_tree(avl, filter(avl, take_tree(avl), other->root, false));
+}
+
 const ax_map_trait ax_avl_tr =
 {
 	.ax_box = {
@@ -749,7 +1276,7 @@ const ax_map_trait ax_avl_tr =
 		.iter = {
 			.norm = true,
 			.type = AX_IT_BID,
-			.move = NULL,
+			.move = citer_move,
 			.prev = citer_prev,
 			.next = citer_next,
 			.less = citer_less,
@@ -761,7 +1288,7 @@ const ax_map_trait ax_avl_tr =
 		.riter = {
 			.norm = false,
 			.type = AX_IT_BID,
-			.move = NULL,
+			.move = rciter_move,
 			.prev = rciter_prev,
 			.next = rciter_next,
 			.less = rciter_less,
@@ -785,6 +1312,10 @@ const ax_map_trait ax_avl_tr =
 	.erase = map_erase,
 	.exist = map_exist,
 	.itkey = map_it_key,
+	.select = map_select,
+	.rank  = map_rank,
+	.lower_bound = map_lower_bound,
+	.upper_bound = map_upper_bound,
 };
 
 ax_concrete_creator(ax_avl, const ax_trait* keytr, const ax_trait* valtr)
@@ -0,0 +1,1193 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/btree.h"
+#include "ax/iter.h"
+#include "ax/debug.h"
+#include "ax/trait.h"
+#include "check.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#define KEY_TR(r) ax_class_data(r.ax_map).key_tr
+#define VAL_TR(r) ax_class_data(r.ax_box).elem_tr
+
+/* Bytes of pairs in a leaf, and of children and separators in an inner node */
+#define NODE_BYTES 256
+
+#define MIN_FANOUT 4
+
+/* Every inner node has at least two children except for a transient one,
+ * so the height is bounded by the bits of size_t */
+#define MAX_DEPTH 64
+
+#undef free
+
+struct node_st
+{
+	size_t count; /* Pairs in a leaf, children in an inner node */
+	bool leaf;
+};
+
+struct leaf_st
+{
+	struct node_st node;
+	struct leaf_st *prev, *next;
+	ax_byte slots[];
+};
+
+/* child[i] holds the keys in [sep[i - 1], sep[i]), the separators are
+ * owned copies of keys and stored after inner_cap children */
+struct inner_st
+{
+	struct node_st node;
+	struct node_st *child[];
+};
+
+struct path_st
+{
+	struct inner_st *inner;
+	size_t index;
+};
+
+ax_concrete_begin(ax_btree)
+	struct node_st *root;
+	struct leaf_st *head, *tail;
+	size_t size;
+	size_t slot_size;
+	size_t leaf_cap;
+	size_t inner_cap;
+ax_end;
+
+static void    *map_put(ax_map *map, const void *key, const void *val, va_list *ap);
+static ax_fail  map_erase(ax_map *map, const void *key);
+static void    *map_get(const ax_map *map, const void *key);
+static ax_iter  map_at(const ax_map *map, const void *key);
+static bool     map_exist(const ax_map *map, const void *key);
+static void    *map_chkey(ax_map *map, const void *key, const void *new_key);
+static ax_iter  map_lower_bound(const ax_map *map, const void *key);
+static ax_iter  map_upper_bound(const ax_map *map, const void *key);
+
+static const void *map_it_key(const ax_citer *it);
+
+static size_t   box_size(const ax_box *box);
+static size_t   box_maxsize(const ax_box *box);
+static ax_iter  box_begin(ax_box *box);
+static ax_iter  box_end(ax_box *box);
+static ax_iter  box_rbegin(ax_box *box);
+static ax_iter  box_rend(ax_box *box);
+static void     box_clear(ax_box *box);
+
+static ax_dump *any_dump(const ax_any *any);
+static ax_any  *any_copy(const ax_any *any);
+
+static void     one_free(ax_one *one);
+static const char *one_name(const ax_one *one);
+
+static void     citer_prev(ax_citer *it);
+static void     citer_next(ax_citer *it);
+static bool     citer_less(const ax_citer *it1, const ax_citer *it2);
+static long     citer_dist(const ax_citer *it1, const ax_citer *it2);
+static void     rciter_prev(ax_citer *it);
+static void     rciter_next(ax_citer *it);
+static bool     rciter_less(const ax_citer *it1, const ax_citer *it2);
+static long     rciter_dist(const ax_citer *it1, const ax_citer *it2);
+static void    *citer_get(const ax_citer *it);
+static ax_fail  iter_set(const ax_iter *it, const void *p, va_list *ap);
+static void     iter_erase(ax_iter *it);
+
+inline static const ax_trait *key_tr(const ax_btree *tree)
+{
+	return ax_class_data(ax_cr(ax_btree, tree).ax_map).key_tr;
+}
+
+inline static size_t key_size(const ax_btree *tree)
+{
+	return ax_trait_size(key_tr(tree));
+}
+
+inline static ax_byte *leaf_slot(const ax_btree *tree, const struct leaf_st *leaf, size_t index)
+{
+	return (ax_byte *)leaf->slots + index * tree->slot_size;
+}
+
+inline static size_t slot_index(const ax_btree *tree, const struct leaf_st *leaf, const void *slot)
+{
+	return ((const ax_byte *)slot - leaf->slots) / tree->slot_size;
+}
+
+inline static void *slot_val(const ax_btree *tree, void *slot)
+{
+	return (ax_byte *)slot + key_size(tree);
+}
+
+inline static ax_byte *inner_sep(const ax_btree *tree, const struct inner_st *inner, size_t index)
+{
+	return (ax_byte *)(inner->child + tree->inner_cap) + index * key_size(tree);
+}
+
+/* Index of the first pair whose key is not less than key */
+static size_t leaf_lower(const ax_btree *tree, const struct leaf_st *leaf, const void *key)
+{
+	const ax_trait *ktr = key_tr(tree);
+	size_t lo = 0, hi = leaf->node.count;
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (ax_trait_less(ktr, leaf_slot(tree, leaf, mid), key))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/* Index of the first pair whose key is greater than key */
+static size_t leaf_upper(const ax_btree *tree, const struct leaf_st *leaf, const void *key)
+{
+	const ax_trait *ktr = key_tr(tree);
+	size_t lo = 0, hi = leaf->node.count;
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (ax_trait_less(ktr, key, leaf_slot(tree, leaf, mid)))
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+/* Index of the child which may hold key */
+static size_t inner_locate(const ax_btree *tree, const struct inner_st *inner, const void *key)
+{
+	const ax_trait *ktr = key_tr(tree);
+	size_t lo = 0, hi = inner->node.count - 1;
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+		if (ax_trait_less(ktr, key, inner_sep(tree, inner, mid)))
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	return lo;
+}
+
+static struct leaf_st *descend(const ax_btree *tree, const void *key, struct path_st *path, size_t *depth)
+{
+	struct node_st *node = tree->root;
+	size_t d = 0;
+	while (!node->leaf) {
+		struct inner_st *inner = (struct inner_st *)node;
+		size_t index = inner_locate(tree, inner, key);
+		if (path) {
+			assert(d < MAX_DEPTH);
+			path[d].inner = inner;
+			path[d].index = index;
+		}
+		d++;
+		node = inner->child[index];
+	}
+	if (depth)
+		*depth = d;
+	return (struct leaf_st *)node;
+}
+
+static ax_byte *find_slot(const ax_btree *tree, const void *key, struct leaf_st **leafp)
+{
+	if (!tree->root)
+		return NULL;
+
+	struct leaf_st *leaf = descend(tree, key, NULL, NULL);
+	size_t i = leaf_lower(tree, leaf, key);
+	if (i == leaf->node.count)
+		return NULL;
+
+	ax_byte *slot = leaf_slot(tree, leaf, i);
+	if (ax_trait_less(key_tr(tree), key, slot))
+		return NULL;
+
+	if (leafp)
+		*leafp = leaf;
+	return slot;
+}
+
+static struct leaf_st *leaf_create(const ax_btree *tree)
+{
+	struct leaf_st *leaf = malloc(sizeof(struct leaf_st) + tree->leaf_cap * tree->slot_size);
+	if (!leaf)
+		return NULL;
+	leaf->node.count = 0;
+	leaf->node.leaf = true;
+	leaf->prev = leaf->next = NULL;
+	return leaf;
+}
+
+static struct inner_st *inner_create(const ax_btree *tree)
+{
+	struct inner_st *inner = malloc(sizeof(struct inner_st)
+			+ tree->inner_cap * sizeof(struct node_st *)
+			+ (tree->inner_cap - 1) * key_size(tree));
+	if (!inner)
+		return NULL;
+	inner->node.count = 0;
+	inner->node.leaf = false;
+	return inner;
+}
+
+static void leaf_unlink(ax_btree *tree, struct leaf_st *leaf)
+{
+	if (leaf->prev)
+		leaf->prev->next = leaf->next;
+	else
+		tree->head = leaf->next;
+
+	if (leaf->next)
+		leaf->next->prev = leaf->prev;
+	else
+		tree->tail = leaf->prev;
+}
+
+/* Add child at index + 1 with the separator sep at index */
+static void inner_insert(const ax_btree *tree, struct inner_st *inner, size_t index,
+		const void *sep, struct node_st *child)
+{
+	size_t n = inner->node.count, ksize = key_size(tree);
+	memmove(inner->child + index + 2, inner->child + index + 1, (n - index - 1) * sizeof(struct node_st *));
+	memmove(inner_sep(tree, inner, index + 1), inner_sep(tree, inner, index), (n - index - 1) * ksize);
+	inner->child[index + 1] = child;
+	memcpy(inner_sep(tree, inner, index), sep, ksize);
+	inner->node.count++;
+}
+
+/*
+ * Same as inner_insert but for a full node, the upper half is moved to
+ * sibling and the separator between them is stored into sep
+ */
+static void inner_split(const ax_btree *tree, struct inner_st *inner, size_t index,
+		void *sep, struct node_st *child, struct inner_st *sibling)
+{
+	size_t n = inner->node.count, ksize = key_size(tree);
+	struct node_st *children[n + 1];
+	ax_byte keys[n * ax_max(ksize, 1)];
+
+	memcpy(children, inner->child, (index + 1) * sizeof(struct node_st *));
+	children[index + 1] = child;
+	memcpy(children + index + 2, inner->child + index + 1, (n - index - 1) * sizeof(struct node_st *));
+
+	memcpy(keys, inner_sep(tree, inner, 0), index * ksize);
+	memcpy(keys + index * ksize, sep, ksize);
+	memcpy(keys + (index + 1) * ksize, inner_sep(tree, inner, index), (n - index - 1) * ksize);
+
+	size_t left = (n + 1) / 2;
+	memcpy(inner->child, children, left * sizeof(struct node_st *));
+	memcpy(inner_sep(tree, inner, 0), keys, (left - 1) * ksize);
+	inner->node.count = left;
+
+	memcpy(sibling->child, children + left, (n + 1 - left) * sizeof(struct node_st *));
+	memcpy(inner_sep(tree, sibling, 0), keys + left * ksize, (n - left) * ksize);
+	sibling->node.count = n + 1 - left;
+
+	memcpy(sep, keys + (left - 1) * ksize, ksize);
+}
+
+/*
+ * Find the slot of key, or make room for it and return the uninitialized
+ * slot. Nodes needed for splitting are allocated before the tree is
+ * modified, so that the tree stays unchanged on failure.
+ */
+static ax_byte *insert_slot(ax_btree *tree, const void *key, bool *exist, struct leaf_st **leafp)
+{
+	const ax_trait *ktr = key_tr(tree);
+	size_t ksize = ax_trait_size(ktr), ssize = tree->slot_size, cap = tree->leaf_cap;
+
+	if (!tree->root) {
+		struct leaf_st *leaf = leaf_create(tree);
+		if (!leaf)
+			return NULL;
+		tree->root = &leaf->node;
+		tree->head = tree->tail = leaf;
+	}
+
+	struct path_st path[MAX_DEPTH];
+	size_t depth;
+	struct leaf_st *leaf = descend(tree, key, path, &depth);
+	size_t pos = leaf_lower(tree, leaf, key);
+	if (pos < leaf->node.count && !ax_trait_less(ktr, key, leaf_slot(tree, leaf, pos))) {
+		*exist = true;
+		*leafp = leaf;
+		return leaf_slot(tree, leaf, pos);
+	}
+	*exist = false;
+
+	if (leaf->node.count < cap) {
+		memmove(leaf_slot(tree, leaf, pos + 1), leaf_slot(tree, leaf, pos), (leaf->node.count - pos) * ssize);
+		leaf->node.count++;
+		tree->size++;
+		*leafp = leaf;
+		return leaf_slot(tree, leaf, pos);
+	}
+
+	/* Every full inner node on the path splits as well, and so does the root */
+	size_t nsplit = 0;
+	while (nsplit < depth && path[depth - 1 - nsplit].inner->node.count == tree->inner_cap)
+		nsplit++;
+	size_t nspare = nsplit + (nsplit == depth);
+
+	/* The first key of the right leaf becomes the separator */
+	size_t half = (cap + 1) / 2;
+	const void *sep_src = half == pos
+		? key
+		: leaf_slot(tree, leaf, half < pos ? half : half - 1);
+
+	ax_byte sep[ax_max(ksize, 1)];
+	struct inner_st *spare[MAX_DEPTH + 1];
+	size_t nalloc = 0;
+	struct leaf_st *right = leaf_create(tree);
+	if (!right)
+		goto fail;
+	for (; nalloc < nspare; nalloc++)
+		if (!(spare[nalloc] = inner_create(tree)))
+			goto fail;
+	if (ax_trait_copy(ktr, sep, sep_src))
+		goto fail;
+
+	ax_byte *slot;
+	if (pos < half) {
+		size_t nmove = cap - (half - 1);
+		memcpy(right->slots, leaf_slot(tree, leaf, half - 1), nmove * ssize);
+		right->node.count = nmove;
+		memmove(leaf_slot(tree, leaf, pos + 1), leaf_slot(tree, leaf, pos), (half - 1 - pos) * ssize);
+		leaf->node.count = half;
+		slot = leaf_slot(tree, leaf, pos);
+		*leafp = leaf;
+	} else {
+		size_t rpos = pos - half;
+		memcpy(right->slots, leaf_slot(tree, leaf, half), rpos * ssize);
+		memcpy(leaf_slot(tree, right, rpos + 1), leaf_slot(tree, leaf, pos), (cap - pos) * ssize);
+		right->node.count = cap - half + 1;
+		leaf->node.count = half;
+		slot = leaf_slot(tree, right, rpos);
+		*leafp = right;
+	}
+
+	right->prev = leaf;
+	right->next = leaf->next;
+	if (leaf->next)
+		leaf->next->prev = right;
+	else
+		tree->tail = right;
+	leaf->next = right;
+	tree->size++;
+
+	struct node_st *child = &right->node;
+	size_t used = 0;
+	for (size_t d = depth; d-- > 0; ) {
+		struct inner_st *parent = path[d].inner;
+		if (parent->node.count < tree->inner_cap) {
+			inner_insert(tree, parent, path[d].index, sep, child);
+			assert(used == nspare);
+			return slot;
+		}
+		struct inner_st *sibling = spare[used++];
+		inner_split(tree, parent, path[d].index, sep, child, sibling);
+		child = &sibling->node;
+	}
+
+	struct inner_st *root = spare[used++];
+	assert(used == nspare);
+	root->child[0] = tree->root;
+	root->child[1] = child;
+	memcpy(inner_sep(tree, root, 0), sep, ksize);
+	root->node.count = 2;
+	tree->root = &root->node;
+	return slot;
+fail:
+	free(right);
+	for (size_t i = 0; i < nalloc; i++)
+		free(spare[i]);
+	if (tree->root == &leaf->node && leaf->node.count == 0) {
+		free(leaf);
+		tree->root = NULL;
+		tree->head = tree->tail = NULL;
+	}
+	return NULL;
+}
+
+/* Undo insert_slot, before the key is stored into the slot */
+static void cancel_insert(ax_btree *tree, struct leaf_st *leaf, ax_byte *slot)
+{
+	size_t index = slot_index(tree, leaf, slot);
+	memmove(slot, slot + tree->slot_size, (leaf->node.count - index - 1) * tree->slot_size);
+	leaf->node.count--;
+	tree->size--;
+
+	/* A leaf which just split keeps at least one pair, so only a new root can be emptied */
+	if (leaf->node.count == 0) {
+		assert(tree->root == &leaf->node);
+		free(leaf);
+		tree->root = NULL;
+		tree->head = tree->tail = NULL;
+	}
+}
+
+/* Remove child at index, with the separator on its left, or on its right for the first child */
+static void inner_remove(const ax_btree *tree, struct inner_st *inner, size_t index, bool free_sep)
+{
+	size_t n = inner->node.count, ksize = key_size(tree);
+	if (n > 1) {
+		size_t si = index ? index - 1 : 0;
+		if (free_sep)
+			ax_trait_free(key_tr(tree), inner_sep(tree, inner, si));
+		memmove(inner_sep(tree, inner, si), inner_sep(tree, inner, si + 1), (n - 2 - si) * ksize);
+	}
+	memmove(inner->child + index, inner->child + index + 1, (n - index - 1) * sizeof(struct node_st *));
+	inner->node.count--;
+}
+
+/* Append right to left with the separator between them pulled down */
+static void inner_merge(const ax_btree *tree, struct inner_st *left, struct inner_st *right, const void *sep)
+{
+	size_t ln = left->node.count, rn = right->node.count, ksize = key_size(tree);
+	memcpy(inner_sep(tree, left, ln - 1), sep, ksize);
+	memcpy(inner_sep(tree, left, ln), inner_sep(tree, right, 0), (rn - 1) * ksize);
+	memcpy(left->child + ln, right->child, rn * sizeof(struct node_st *));
+	left->node.count = ln + rn;
+}
+
+
+/* Append right to left and free right, sep is the separator between them */
+static void node_merge(ax_btree *tree, struct node_st *left, struct node_st *right, const void *sep)
+{
+	if (left->leaf) {
+		struct leaf_st *l = (struct leaf_st *)left, *r = (struct leaf_st *)right;
+		memcpy(leaf_slot(tree, l, l->node.count), r->slots, r->node.count * tree->slot_size);
+		l->node.count += r->node.count;
+		leaf_unlink(tree, r);
+	} else
+		inner_merge(tree, (struct inner_st *)left, (struct inner_st *)right, sep);
+	free(right);
+}
+
+/*
+ * Walk up from node at depth after a removal. An underfull node is merged
+ * with a sibling if the result still leaves room for insertions, pairs are
+ * never borrowed from siblings.
+ */
+static void rebalance(ax_btree *tree, struct path_st *path, size_t depth, struct node_st *node)
+{
+	for (; depth > 0; depth--) {
+		size_t cap = node->leaf ? tree->leaf_cap : tree->inner_cap;
+		size_t count = node->count;
+		if (count >= cap / 4)
+			return;
+
+		struct inner_st *parent = path[depth - 1].inner;
+		size_t index = path[depth - 1].index;
+		struct node_st *left = index > 0 ? parent->child[index - 1] : NULL;
+		struct node_st *right = index + 1 < parent->node.count ? parent->child[index + 1] : NULL;
+		size_t limit = cap - cap / 4;
+		bool leaf = node->leaf;
+
+		if (count == 0) {
+			if (leaf)
+				leaf_unlink(tree, (struct leaf_st *)node);
+			free(node);
+			inner_remove(tree, parent, index, true);
+		} else if (left && left->count + count <= limit) {
+			node_merge(tree, left, node, inner_sep(tree, parent, index - 1));
+			inner_remove(tree, parent, index, leaf);
+		} else if (right && count + right->count <= limit) {
+			node_merge(tree, node, right, inner_sep(tree, parent, index));
+			inner_remove(tree, parent, index + 1, leaf);
+		} else
+			return;
+
+		node = &parent->node;
+	}
+
+	if (node->leaf) {
+		if (node->count == 0) {
+			free(node);
+			tree->root = NULL;
+			tree->head = tree->tail = NULL;
+		}
+		return;
+	}
+
+	while (!tree->root->leaf && tree->root->count == 1) {
+		struct inner_st *root = (struct inner_st *)tree->root;
+		tree->root = root->child[0];
+		free(root);
+	}
+}
+
+/* Remove the pair of key, the value is moved into val if it is not NULL, otherwise freed */
+static ax_fail remove_key(ax_btree *tree, const void *key, void *val)
+{
+	if (!tree->root)
+		return true;
+
+	ax_btree_r self = AX_R_INIT(ax_btree, tree);
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+	size_t ksize = ax_trait_size(ktr);
+
+	struct path_st path[MAX_DEPTH];
+	size_t depth;
+	struct leaf_st *leaf = descend(tree, key, path, &depth);
+	size_t pos = leaf_lower(tree, leaf, key);
+	if (pos == leaf->node.count)
+		return true;
+	ax_byte *slot = leaf_slot(tree, leaf, pos);
+	if (ax_trait_less(ktr, key, slot))
+		return true;
+
+	/* key may point to the slot, it is not used after here */
+	ax_trait_free(ktr, slot);
+	if (val)
+		memcpy(val, slot + ksize, ax_trait_size(vtr));
+	else
+		ax_trait_free(vtr, slot + ksize);
+
+	memmove(slot, slot + tree->slot_size, (leaf->node.count - pos - 1) * tree->slot_size);
+	leaf->node.count--;
+	tree->size--;
+	rebalance(tree, path, depth, &leaf->node);
+	return false;
+}
+
+static void free_node(ax_btree *tree, struct node_st *node)
+{
+	ax_btree_r self = AX_R_INIT(ax_btree, tree);
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+
+	if (node->leaf) {
+		struct leaf_st *leaf = (struct leaf_st *)node;
+		for (size_t i = 0; i < node->count; i++) {
+			ax_byte *slot = leaf_slot(tree, leaf, i);
+			ax_trait_free(ktr, slot);
+			ax_trait_free(vtr, slot + ax_trait_size(ktr));
+		}
+	} else {
+		struct inner_st *inner = (struct inner_st *)node;
+		for (size_t i = 0; i < node->count; i++)
+			free_node(tree, inner->child[i]);
+		for (size_t i = 0; i + 1 < node->count; i++)
+			ax_trait_free(ktr, inner_sep(tree, inner, i));
+	}
+	free(node);
+}
+
+static ax_byte *first_slot(const ax_btree *tree, struct leaf_st **leafp)
+{
+	*leafp = tree->head;
+	return tree->head ? leaf_slot(tree, tree->head, 0) : NULL;
+}
+
+static ax_byte *last_slot(const ax_btree *tree, struct leaf_st **leafp)
+{
+	*leafp = tree->tail;
+	return tree->tail ? leaf_slot(tree, tree->tail, tree->tail->node.count - 1) : NULL;
+}
+
+static ax_byte *slot_next(const ax_btree *tree, struct leaf_st **leafp, const void *slot)
+{
+	struct leaf_st *leaf = *leafp;
+	size_t index = slot_index(tree, leaf, slot) + 1;
+	if (index == leaf->node.count) {
+		leaf = leaf->next;
+		index = 0;
+	}
+	*leafp = leaf;
+	return leaf ? leaf_slot(tree, leaf, index) : NULL;
+}
+
+static ax_byte *slot_prev(const ax_btree *tree, struct leaf_st **leafp, const void *slot)
+{
+	struct leaf_st *leaf = *leafp;
+	size_t index = slot_index(tree, leaf, slot);
+	if (index == 0) {
+		leaf = leaf->prev;
+		index = leaf ? leaf->node.count : 0;
+	}
+	*leafp = leaf;
+	return leaf ? leaf_slot(tree, leaf, index - 1) : NULL;
+}
+
+/* Position of the pair in key order, the end is at size */
+static size_t slot_rank(const ax_btree *tree, const struct leaf_st *leaf, const void *slot)
+{
+	if (!slot)
+		return tree->size;
+
+	size_t rank = slot_index(tree, leaf, slot);
+	for (leaf = leaf->prev; leaf; leaf = leaf->prev)
+		rank += leaf->node.count;
+	return rank;
+}
+
+static void *value_set(ax_map *map, void *slot, const void *val, va_list *ap)
+{
+	ax_btree_r self = AX_R_INIT(ax_map, map);
+	const ax_trait *vtr = VAL_TR(self);
+	ax_byte *value_ptr = slot_val(self.ax_btree, slot);
+	ax_byte tmp_buf[self.ax_btree->slot_size];
+	memcpy(tmp_buf, value_ptr, ax_trait_size(vtr));
+
+	if (ax_trait_copy_or_init(vtr, value_ptr, val, ap)) {
+		memcpy(value_ptr, tmp_buf, ax_trait_size(vtr));
+		return NULL;
+	}
+	ax_trait_free(vtr, tmp_buf);
+	return value_ptr;
+}
+
+inline static void citer_set(ax_citer *it, struct leaf_st *leaf, ax_byte *slot)
+{
+	it->point = slot;
+	it->extra = slot ? (uintptr_t)leaf : 0;
+}
+
+static void citer_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_btree *tree = it->owner;
+	struct leaf_st *leaf = (struct leaf_st *)it->extra;
+	ax_byte *slot = it->point
+		? slot_prev(tree, &leaf, it->point)
+		: last_slot(tree, &leaf);
+	citer_set(it, leaf, slot);
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	ax_assert(it->point != NULL, "iterator boundary exceeded");
+	const ax_btree *tree = it->owner;
+	struct leaf_st *leaf = (struct leaf_st *)it->extra;
+	ax_byte *slot = slot_next(tree, &leaf, it->point);
+	citer_set(it, leaf, slot);
+}
+
+static bool citer_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	if (!it1->point)
+		return false;
+	if (!it2->point)
+		return true;
+	return ax_trait_less(key_tr(it1->owner), it1->point, it2->point);
+}
+
+static long citer_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_btree *tree = it1->owner;
+	return (long)slot_rank(tree, (struct leaf_st *)it2->extra, it2->point)
+		- (long)slot_rank(tree, (struct leaf_st *)it1->extra, it1->point);
+}
+
+static void rciter_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_btree *tree = it->owner;
+	struct leaf_st *leaf = (struct leaf_st *)it->extra;
+	ax_byte *slot = it->point
+		? slot_next(tree, &leaf, it->point)
+		: first_slot(tree, &leaf);
+	citer_set(it, leaf, slot);
+}
+
+static void rciter_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	ax_assert(it->point != NULL, "iterator boundary exceeded");
+	const ax_btree *tree = it->owner;
+	struct leaf_st *leaf = (struct leaf_st *)it->extra;
+	ax_byte *slot = slot_prev(tree, &leaf, it->point);
+	citer_set(it, leaf, slot);
+}
+
+static bool rciter_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	if (!it1->point)
+		return false;
+	if (!it2->point)
+		return true;
+	return ax_trait_less(key_tr(it1->owner), it2->point, it1->point);
+}
+
+static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	/* The end of reverse iteration sits before the first pair */
+	const ax_btree *tree = it1->owner;
+	long rank1 = it1->point ? (long)slot_rank(tree, (struct leaf_st *)it1->extra, it1->point) : -1;
+	long rank2 = it2->point ? (long)slot_rank(tree, (struct leaf_st *)it2->extra, it2->point) : -1;
+	return rank1 - rank2;
+}
+
+static void *citer_get(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr && it->point);
+
+	return slot_val(it->owner, it->point);
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	return !value_set(it->owner, it->point, val, ap);
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(it->point);
+
+	ax_btree *tree = it->owner;
+	size_t ksize = key_size(tree);
+	struct leaf_st *leaf = (struct leaf_st *)it->extra;
+	ax_byte *next = ax_iter_norm(it)
+		? slot_next(tree, &leaf, it->point)
+		: slot_prev(tree, &leaf, it->point);
+
+	/* Slots move when nodes merge, so the next pair is looked up again by a
+	 * shallow copy of its key */
+	ax_byte next_key[ax_max(ksize, 1)];
+	if (next)
+		memcpy(next_key, next, ksize);
+
+	ax_fail fail = remove_key(tree, it->point, NULL);
+	ax_assert(!fail, "bad iterator");
+	(void)fail;
+
+	next = next ? find_slot(tree, next_key, &leaf) : NULL;
+	citer_set(ax_iter_c(it), leaf, next);
+}
+
+static void *map_put(ax_map *map, const void *key, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_btree_r self = AX_R_INIT(ax_map, map);
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+
+	bool exist;
+	struct leaf_st *leaf;
+	ax_byte *slot = insert_slot(self.ax_btree, key, &exist, &leaf);
+	if (!slot)
+		return NULL;
+	if (exist)
+		return value_set(map, slot, val, ap);
+
+	if (ax_trait_copy(ktr, slot, key))
+		goto fail;
+
+	if (ax_trait_copy_or_init(vtr, slot + ax_trait_size(ktr), val, ap)) {
+		ax_trait_free(ktr, slot);
+		goto fail;
+	}
+	return slot + ax_trait_size(ktr);
+fail:
+	cancel_insert(self.ax_btree, leaf, slot);
+	return NULL;
+}
+
+static ax_fail map_erase(ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_btree_r self = AX_R_INIT(ax_map, map);
+	return remove_key(self.ax_btree, key, NULL);
+}
+
+static void *map_get(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_btree_cr self = AX_R_INIT(ax_map, map);
+	ax_byte *slot = find_slot(self.ax_btree, key, NULL);
+	return slot ? slot_val(self.ax_btree, slot) : NULL;
+}
+
+static ax_iter map_at(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_btree_cr self = AX_R_INIT(ax_map, map);
+	struct leaf_st *leaf = NULL;
+	ax_byte *slot = find_slot(self.ax_btree, key, &leaf);
+
+	ax_iter it = {
+		.owner = (void *)map,
+		.tr = &ax_btree_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+	citer_set(ax_iter_c(&it), leaf, slot);
+	return it;
+}
+
+static bool map_exist(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_btree_cr self = AX_R_INIT(ax_map, map);
+	return find_slot(self.ax_btree, key, NULL) != NULL;
+}
+
+static void *map_chkey(ax_map *map, const void *key, const void *new_key)
+{
+	CHECK_PARAM_NULL(map);
+	CHECK_PARAM_NULL(key);
+	CHECK_PARAM_NULL(new_key);
+
+	ax_btree_r self = AX_R_INIT(ax_map, map);
+	ax_btree *tree = self.ax_btree;
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+	size_t ksize = ax_trait_size(ktr);
+
+	ax_byte *slot = find_slot(tree, key, NULL);
+	ax_assert(slot, "key does not exists");
+
+	ax_byte new_copy[ax_max(ksize, 1)];
+	if (ax_trait_copy(ktr, new_copy, new_key))
+		return NULL;
+
+	if (!ax_trait_less(ktr, slot, new_copy) && !ax_trait_less(ktr, new_copy, slot)) {
+		ax_trait_free(ktr, slot);
+		memcpy(slot, new_copy, ksize);
+		return slot;
+	}
+
+	/* Both key and new_key may point into the tree, keep shallow copies of
+	 * the stored keys to look the pairs up again after slots moved */
+	ax_byte old_key[ax_max(ksize, 1)];
+	memcpy(old_key, slot, ksize);
+
+	bool exist;
+	struct leaf_st *leaf;
+	ax_byte *new_slot = insert_slot(tree, new_copy, &exist, &leaf);
+	if (!new_slot) {
+		ax_trait_free(ktr, new_copy);
+		return NULL;
+	}
+
+	if (exist)
+		ax_trait_free(vtr, new_slot + ksize);
+	else
+		memcpy(new_slot, new_copy, ksize);
+
+	ax_byte val[self.ax_btree->slot_size];
+	remove_key(tree, old_key, val);
+
+	new_slot = find_slot(tree, new_copy, NULL);
+	memcpy(new_slot + ksize, val, ax_trait_size(vtr));
+	if (exist)
+		ax_trait_free(ktr, new_copy);
+	return new_slot;
+}
+
+/* Keys in the following leaves are not less than the separator above key, so
+ * the bound is in the leaf of key, or is the first pair of the next leaf */
+static ax_iter bound_iter(const ax_map *map, const void *key, bool upper)
+{
+	ax_btree_cr self = AX_R_INIT(ax_map, map);
+	const ax_btree *tree = self.ax_btree;
+
+	ax_iter it = {
+		.owner = (void *)map,
+		.tr = &ax_btree_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+	if (!tree->root) {
+		citer_set(ax_iter_c(&it), NULL, NULL);
+		return it;
+	}
+
+	struct leaf_st *leaf = descend(tree, key, NULL, NULL);
+	size_t index = upper ? leaf_upper(tree, leaf, key) : leaf_lower(tree, leaf, key);
+	if (index == leaf->node.count) {
+		leaf = leaf->next;
+		index = 0;
+	}
+	citer_set(ax_iter_c(&it), leaf, leaf ? leaf_slot(tree, leaf, index) : NULL);
+	return it;
+}
+
+static ax_iter map_lower_bound(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	return bound_iter(map, key, false);
+}
+
+static ax_iter map_upper_bound(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	return bound_iter(map, key, true);
+}
+
+static const void *map_it_key(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr && it->point);
+	CHECK_ITER_TYPE(it, one_name(NULL));
+
+	const ax_map *map = it->owner;
+	return ax_trait_out(ax_class_data(map).key_tr, it->point);
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_btree_r self = AX_R_INIT(ax_one, one);
+	box_clear(self.ax_box);
+	free(self.ax_btree);
+}
+
+static const char *one_name(const ax_one *one)
+{
+	return ax_class_name(4, ax_btree);
+}
+
+static ax_dump *any_dump(const ax_any *any)
+{
+	ax_map_cr self = AX_R_INIT(ax_any, any);
+	return ax_map_dump(self.ax_map);
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_btree_cr src = AX_R_INIT(ax_any, any);
+	const ax_trait *ktr = KEY_TR(src), *vtr = VAL_TR(src);
+	size_t ksize = ax_trait_size(ktr);
+
+	ax_btree_r dst = { .ax_map = __ax_btree_construct(ktr, vtr) };
+	if (ax_r_isnull(dst))
+		return NULL;
+
+	for (struct leaf_st *leaf = src.ax_btree->head; leaf; leaf = leaf->next) {
+		for (size_t i = 0; i < leaf->node.count; i++) {
+			ax_byte *slot = leaf_slot(src.ax_btree, leaf, i);
+			if (!map_put(dst.ax_map, slot, slot + ksize, NULL)) {
+				ax_one_free(dst.ax_one);
+				return NULL;
+			}
+		}
+	}
+	return dst.ax_any;
+}
+
+static size_t box_size(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_btree_cr self = AX_R_INIT(ax_box, box);
+	return self.ax_btree->size;
+}
+
+static size_t box_maxsize(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return SIZE_MAX;
+}
+
+static ax_iter box_begin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_btree_r self = AX_R_INIT(ax_box, box);
+	struct leaf_st *leaf;
+	ax_byte *slot = first_slot(self.ax_btree, &leaf);
+
+	ax_iter it = {
+		.owner = box,
+		.tr = &ax_btree_tr.ax_box.iter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	citer_set(ax_iter_c(&it), leaf, slot);
+	return it;
+}
+
+static ax_iter box_end(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.tr = &ax_btree_tr.ax_box.iter,
+		.point = NULL,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	return it;
+}
+
+static ax_iter box_rbegin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_btree_r self = AX_R_INIT(ax_box, box);
+	struct leaf_st *leaf;
+	ax_byte *slot = last_slot(self.ax_btree, &leaf);
+
+	ax_iter it = {
+		.owner = box,
+		.tr = &ax_btree_tr.ax_box.riter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	citer_set(ax_iter_c(&it), leaf, slot);
+	return it;
+}
+
+static ax_iter box_rend(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.tr = &ax_btree_tr.ax_box.riter,
+		.point = NULL,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	return it;
+}
+
+static void box_clear(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_btree_r self = AX_R_INIT(ax_box, box);
+	if (self.ax_btree->root)
+		free_node(self.ax_btree, self.ax_btree->root);
+
+	self.ax_btree->root = NULL;
+	self.ax_btree->head = self.ax_btree->tail = NULL;
+	self.ax_btree->size = 0;
+}
+
+const ax_map_trait ax_btree_tr =
+{
+	.ax_box = {
+		.ax_any = {
+			.ax_one = {
+				.name  = one_name,
+				.free  = one_free,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+		},
+
+		.iter = {
+			.norm  = true,
+			.type  = AX_IT_BID,
+			.move  = NULL,
+			.prev  = citer_prev,
+			.next  = citer_next,
+			.less  = citer_less,
+			.dist  = citer_dist,
+			.get   = citer_get,
+			.set   = iter_set,
+			.erase = iter_erase,
+		},
+		.riter = {
+			.norm  = false,
+			.type  = AX_IT_BID,
+			.move  = NULL,
+			.prev  = rciter_prev,
+			.next  = rciter_next,
+			.less  = rciter_less,
+			.dist  = rciter_dist,
+			.get   = citer_get,
+			.set   = iter_set,
+			.erase = iter_erase,
+		},
+		.size    = box_size,
+		.maxsize = box_maxsize,
+		.begin   = box_begin,
+		.end     = box_end,
+		.rbegin  = box_rbegin,
+		.rend    = box_rend,
+		.clear   = box_clear,
+	},
+	.put   = map_put,
+	.get   = map_get,
+	.at    = map_at,
+	.erase = map_erase,
+	.exist = map_exist,
+	.chkey = map_chkey,
+	.itkey = map_it_key,
+	.lower_bound = map_lower_bound,
+	.upper_bound = map_upper_bound,
+};
+
+ax_map *__ax_btree_construct(const ax_trait *key_tr, const ax_trait *val_tr)
+{
+	CHECK_PARAM_NULL(key_tr);
+	CHECK_PARAM_NULL(val_tr);
+
+	ax_btree *tree = malloc(sizeof(ax_btree));
+	if (!tree)
+		return NULL;
+
+	size_t ksize = ax_trait_size(key_tr);
+	size_t slot_size = ax_align(ax_max(ksize + ax_trait_size(val_tr), 1), sizeof(void *));
+
+	ax_btree tree_init = {
+		.ax_map = {
+			.tr = &ax_btree_tr,
+			.env = {
+				.ax_box.elem_tr = val_tr,
+				.key_tr = key_tr,
+			},
+		},
+		.root = NULL,
+		.head = NULL,
+		.tail = NULL,
+		.size = 0,
+		.slot_size = slot_size,
+		.leaf_cap = ax_max(NODE_BYTES / slot_size, MIN_FANOUT),
+		.inner_cap = ax_max(NODE_BYTES / (sizeof(struct node_st *) + ksize), MIN_FANOUT),
+	};
+
+	memcpy(tree, &tree_init, sizeof tree_init);
+	return ax_r(ax_btree, tree).ax_map;
+}
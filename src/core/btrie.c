@@ -56,6 +56,9 @@ static ax_iter  trie_at(const ax_trie *trie, const ax_seq *key);
 static bool     trie_exist(const ax_trie *trie, const ax_seq *key, bool *valued);
 static bool     trie_erase(ax_trie *trie, const ax_seq *key);
 static bool     trie_prune(ax_trie *trie, const ax_seq *key);
+static void    *trie_put_bytes(ax_trie *trie, const void *key, size_t len, const void *val, va_list *ap);
+static void    *trie_get_bytes(const ax_trie *trie, const void *key, size_t len);
+static bool     trie_exist_bytes(const ax_trie *trie, const void *key, size_t len, bool *valued);
 static ax_fail  trie_rekey(ax_trie *trie, const ax_seq *key_from, const ax_seq *key_to);
 
 static const void *trie_it_word(const ax_citer *it);
@@ -470,6 +473,130 @@ fail:
 	return NULL;
 }
 
+static struct node_st *root_node(const ax_btrie *self)
+{
+	if (ax_box_size(self->root_r.ax_box) == 0)
+		return NULL;
+	ax_iter it = ax_avl_tr.ax_box.begin(self->root_r.ax_box);
+	return ax_avl_tr.ax_box.iter.get(ax_iter_c(&it));
+}
+
+/* Walk the packed words of key from the root, the words are looked up in place */
+static struct node_st *match_bytes(const ax_btrie *self, const ax_byte *key, size_t nwords, size_t *matched)
+{
+	size_t size = ax_trait_size(ax_class_data(ax_cr(ax_btrie, self).ax_trie).key_tr);
+	struct node_st *node = root_node(self);
+	size_t i = 0;
+
+	if (node) {
+		for (; i < nwords; i++) {
+			struct node_st *next = ax_avl_tr.get(node->submap_r.ax_map, key + i * size);
+			if (!next)
+				break;
+			node = next;
+		}
+	}
+	*matched = i;
+	return node;
+}
+
+static struct node_st *make_path_bytes(ax_btrie *self, const ax_byte *key, size_t nwords)
+{
+	const ax_trait *ktr = ax_class_data(ax_r(ax_btrie, self).ax_trie).key_tr;
+	size_t size = ax_trait_size(ktr);
+
+	size_t matched;
+	struct node_st *last_node = match_bytes(self, key, nwords, &matched);
+	if (last_node && matched == nwords)
+		return last_node;
+
+	size_t ins_count = nwords - matched + !last_node;
+	struct node_st *new_node_tab = calloc(ins_count, sizeof(struct node_st));
+	if (!new_node_tab)
+		return NULL;
+
+	size_t i;
+	for (i = 0; i < ins_count; i++) {
+		ax_avl_r new_submap = ax_new(ax_avl, ktr, &node_tr);
+		if (ax_r_isnull(new_submap))
+			goto fail;
+		ax_class_data(new_submap.ax_one).scope.macro = ax_r(ax_btrie, self).ax_one;
+		new_node_tab[i].submap_r.ax_map = new_submap.ax_map;
+	}
+
+	i = 0;
+	if (!last_node) {
+		node_set_parent(new_node_tab + 0, self->root_r.ax_map);
+		last_node = ax_map_put(self->root_r.ax_map, NULL, new_node_tab + 0);
+		if (!last_node)
+			goto fail;
+		i = 1;
+	}
+
+	const ax_byte *word = key + matched * size;
+	for (ax_map *cur_map = last_node->submap_r.ax_map; i < ins_count; i++, word += size) {
+		node_set_parent(new_node_tab + i, cur_map);
+		last_node = ax_avl_tr.put(cur_map, word, new_node_tab + i, NULL);
+		if (!last_node)
+			goto fail;
+		cur_map = new_node_tab[i].submap_r.ax_map;
+	}
+
+	free(new_node_tab);
+	return last_node;
+fail:
+	/* Nodes already linked into the path are kept, they have no value */
+	for (; i < ins_count; i++)
+		ax_one_free(new_node_tab[i].submap_r.ax_one);
+	free(new_node_tab);
+	return NULL;
+}
+
+static void *trie_put_bytes(ax_trie *trie, const void *key, size_t len, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || !len);
+	CHECK_PARAM_VALIDITY(len, len % ax_trait_size(ax_class_data(trie).key_tr) == 0);
+
+	ax_btrie_r self_r = { .ax_trie = trie };
+
+	struct node_st *node = make_path_bytes(self_r.ax_btrie, key,
+			len / ax_trait_size(ax_class_data(trie).key_tr));
+	if (!node)
+		return NULL;
+
+	if (node_set_value(self_r.ax_btrie, node, val, ap))
+		return NULL;
+
+	return node->val;
+}
+
+static void *trie_get_bytes(const ax_trie *trie, const void *key, size_t len)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || !len);
+	CHECK_PARAM_VALIDITY(len, len % ax_trait_size(ax_class_data(trie).key_tr) == 0);
+
+	size_t nwords = len / ax_trait_size(ax_class_data(trie).key_tr), matched;
+	struct node_st *node = match_bytes((const ax_btrie *)trie, key, nwords, &matched);
+	return node && matched == nwords ? node->val : NULL;
+}
+
+static bool trie_exist_bytes(const ax_trie *trie, const void *key, size_t len, bool *valued)
+{
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(key, key || !len);
+	CHECK_PARAM_VALIDITY(len, len % ax_trait_size(ax_class_data(trie).key_tr) == 0);
+
+	size_t nwords = len / ax_trait_size(ax_class_data(trie).key_tr), matched;
+	struct node_st *node = match_bytes((const ax_btrie *)trie, key, nwords, &matched);
+	if (!node || matched != nwords)
+		return false;
+	if (valued)
+		*valued = !!node->val;
+	return true;
+}
+
 static void *trie_put(ax_trie *trie, const ax_seq *key, const void *val, va_list *ap)
 {
 	CHECK_PARAM_NULL(trie);
@@ -756,7 +883,10 @@ const ax_trie_trait ax_btrie_tr =
 	.it_begin = trie_it_begin,
 	.it_end = trie_it_end,
 	.it_parent = trie_it_parent,
-	.it_valued = trie_it_valued
+	.it_valued = trie_it_valued,
+	.put_bytes = trie_put_bytes,
+	.get_bytes = trie_get_bytes,
+	.exist_bytes = trie_exist_bytes,
 };
 
 ax_trie *__ax_btrie_construct(const ax_trait *key_tr, const ax_trait *val_tr)
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/datrie.h"
+#include "ax/iter.h"
+#include "ax/debug.h"
+#include "ax/trait.h"
+#include "check.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The image is an array of 32-bit words, a header followed by units. The
+ * child of unit s by code c is the unit t = base[s] + c where check[t] = s.
+ * Byte b has code b + 1, and code 0 leads to the terminal unit of a key
+ * whose base holds the value.
+ */
+
+#define MAGIC   0x41584441
+#define VERSION 1
+
+#define HEADER_WORDS 4
+
+#define EMPTY   UINT32_MAX
+#define ROOT    (UINT32_MAX - 1)
+#define NONE    UINT32_MAX
+
+/* Give up a free unit after it failed to place this many nodes */
+#define MAX_FAILS 16
+
+#define BASE(u, s)  ((u)[(size_t)(s) * 2])
+#define CHECK(u, s) ((u)[(size_t)(s) * 2 + 1])
+
+struct builder_st
+{
+	uint32_t *units;
+	uint32_t *next; /* Free unit list */
+	uint32_t *prev;
+	uint8_t *fails;
+	size_t size;
+	size_t capacity;
+	uint32_t head;
+	uint32_t tail;
+};
+
+struct frame_st
+{
+	ax_citer it;
+	uint32_t index;
+};
+
+inline static uint32_t child_of(const ax_datrie *dat, uint32_t s, unsigned code)
+{
+	size_t t = (size_t)BASE(dat->units, s) + code;
+	return t < dat->nunits && CHECK(dat->units, t) == s ? (uint32_t)t : NONE;
+}
+
+static void free_unlink(struct builder_st *b, uint32_t i)
+{
+	if (b->prev[i] == NONE)
+		b->head = b->next[i];
+	else
+		b->next[b->prev[i]] = b->next[i];
+	if (b->next[i] == NONE)
+		b->tail = b->prev[i];
+	else
+		b->prev[b->next[i]] = b->prev[i];
+	b->next[i] = b->prev[i] = NONE;
+}
+
+static ax_fail builder_reserve(struct builder_st *b, size_t size)
+{
+	if (size <= b->size)
+		return false;
+	if (size >= ROOT)
+		return true;
+
+	if (size > b->capacity) {
+		size_t capacity = b->capacity ? b->capacity : 1024;
+		while (capacity < size)
+			capacity *= 2;
+
+		uint32_t *units = realloc(b->units, capacity * 2 * sizeof *units);
+		if (!units)
+			return true;
+		b->units = units;
+		uint32_t *next = realloc(b->next, capacity * sizeof *next);
+		if (!next)
+			return true;
+		b->next = next;
+		uint32_t *prev = realloc(b->prev, capacity * sizeof *prev);
+		if (!prev)
+			return true;
+		b->prev = prev;
+		uint8_t *fails = realloc(b->fails, capacity);
+		if (!fails)
+			return true;
+		b->fails = fails;
+		b->capacity = capacity;
+	}
+
+	for (size_t i = b->size; i < size; i++) {
+		BASE(b->units, i) = 0;
+		CHECK(b->units, i) = EMPTY;
+		b->fails[i] = 0;
+		b->next[i] = NONE;
+		b->prev[i] = b->tail;
+		if (b->tail == NONE)
+			b->head = i;
+		else
+			b->next[b->tail] = i;
+		b->tail = i;
+	}
+	b->size = size;
+	return false;
+}
+
+inline static bool builder_fits(const struct builder_st *b, size_t base, const unsigned *codes, int n)
+{
+	for (int i = 0; i < n; i++)
+		if (base + codes[i] < b->size && CHECK(b->units, base + codes[i]) != EMPTY)
+			return false;
+	return true;
+}
+
+/* Find a base where all codes land on free units */
+static size_t builder_find_base(struct builder_st *b, const unsigned *codes, int n)
+{
+	uint32_t e = b->head;
+	while (e != NONE) {
+		uint32_t next = b->next[e];
+		if (e >= codes[0]) {
+			if (builder_fits(b, e - codes[0], codes, n))
+				return e - codes[0];
+			if (++b->fails[e] >= MAX_FAILS)
+				free_unlink(b, e);
+		}
+		e = next;
+	}
+	return b->size > codes[0] ? b->size - codes[0] : 0;
+}
+
+static ax_fail builder_place(struct builder_st *b, uint32_t s, const unsigned *codes, int n)
+{
+	size_t base = builder_find_base(b, codes, n);
+	if (builder_reserve(b, base + codes[n - 1] + 1))
+		return true;
+
+	BASE(b->units, s) = base;
+	for (int i = 0; i < n; i++) {
+		uint32_t t = base + codes[i];
+		if (b->next[t] != NONE || b->prev[t] != NONE || b->head == t)
+			free_unlink(b, t);
+		CHECK(b->units, t) = s;
+	}
+	return false;
+}
+
+static void builder_free(struct builder_st *b)
+{
+	free(b->units);
+	free(b->next);
+	free(b->prev);
+	free(b->fails);
+}
+
+ax_fail ax_datrie_freeze(ax_datrie *dat, const ax_trie *trie, ax_datrie_value_f value_f, void *ctx)
+{
+	CHECK_PARAM_NULL(dat);
+	CHECK_PARAM_NULL(trie);
+	CHECK_PARAM_VALIDITY(trie, ax_trait_size(ax_class_data(trie).key_tr) == 1);
+
+	ax_trie_cr self = AX_R_INIT(ax_trie, trie);
+	struct builder_st b = { .head = NONE, .tail = NONE };
+	struct frame_st *stack = NULL;
+	size_t top = 0, stack_size = 0;
+	uint32_t nkeys = 0;
+	ax_fail retval = true;
+
+	if (builder_reserve(&b, 1))
+		goto out;
+	free_unlink(&b, 0);
+	CHECK(b.units, 0) = ROOT;
+
+	ax_citer root = ax_box_cbegin(self.ax_box), end = ax_box_cend(self.ax_box);
+	if (!ax_citer_equal(&root, &end)) {
+		stack = malloc(sizeof *stack * 256);
+		if (!stack)
+			goto out;
+		stack_size = 256;
+		stack[top++] = (struct frame_st) { .it = root, .index = 0 };
+	}
+
+	/* Nodes are visited in preorder, so terminals are numbered in byte order */
+	while (top) {
+		struct frame_st frame = stack[--top];
+		unsigned codes[257];
+		int n = 0;
+
+		bool valued = ax_trie_citer_valued(&frame.it);
+		if (valued)
+			codes[n++] = 0;
+
+		size_t first = top;
+		ax_citer cur = ax_trie_citer_cbegin(&frame.it), cend = ax_trie_citer_cend(&frame.it);
+		for (; !ax_citer_equal(&cur, &cend); ax_citer_next(&cur)) {
+			if (top == stack_size) {
+				struct frame_st *new_stack = realloc(stack, sizeof *stack * stack_size * 2);
+				if (!new_stack)
+					goto out;
+				stack = new_stack;
+				stack_size *= 2;
+			}
+			codes[n++] = *(const ax_byte *)ax_trie_citer_word(&cur) + 1;
+			stack[top++].it = cur;
+		}
+
+		if (n == 0)
+			continue;
+
+		/* Children come in the order of the key trait, which for a signed
+		 * char trie is not byte order */
+		for (int i = valued + 1; i < n; i++) {
+			unsigned code = codes[i];
+			struct frame_st child = stack[first + i - valued];
+			int j = i;
+			for (; j > valued && codes[j - 1] > code; j--) {
+				codes[j] = codes[j - 1];
+				stack[first + j - valued] = stack[first + j - 1 - valued];
+			}
+			codes[j] = code;
+			stack[first + j - valued] = child;
+		}
+
+		if (builder_place(&b, frame.index, codes, n))
+			goto out;
+
+		uint32_t base = BASE(b.units, frame.index);
+		if (valued) {
+			BASE(b.units, base) = value_f ? value_f(ax_citer_get(&frame.it), ctx) : nkeys;
+			nkeys++;
+		}
+
+		/* Pop the smallest child first */
+		for (size_t i = first, j = valued; i < top; i++, j++)
+			stack[i].index = base + codes[j];
+		for (size_t i = first, j = top; i + 1 < j; i++, j--) {
+			struct frame_st tmp = stack[i];
+			stack[i] = stack[j - 1];
+			stack[j - 1] = tmp;
+		}
+	}
+
+	uint32_t *image = malloc((HEADER_WORDS + b.size * 2) * sizeof *image);
+	if (!image)
+		goto out;
+	image[0] = MAGIC;
+	image[1] = VERSION;
+	image[2] = b.size;
+	image[3] = nkeys;
+	memcpy(image + HEADER_WORDS, b.units, b.size * 2 * sizeof *image);
+
+	dat->buf = image;
+	dat->units = image + HEADER_WORDS;
+	dat->nunits = b.size;
+	dat->nkeys = nkeys;
+	retval = false;
+out:
+	builder_free(&b);
+	free(stack);
+	return retval;
+}
+
+ax_fail ax_datrie_load(ax_datrie *dat, const void *image, size_t size)
+{
+	CHECK_PARAM_NULL(dat);
+	CHECK_PARAM_NULL(image);
+
+	const uint32_t *words = image;
+	if ((uintptr_t)image % sizeof(uint32_t) || size < HEADER_WORDS * sizeof *words)
+		return true;
+	if (words[0] != MAGIC || words[1] != VERSION || words[2] == 0)
+		return true;
+	if ((size - HEADER_WORDS * sizeof *words) / (2 * sizeof *words) != words[2])
+		return true;
+
+	dat->buf = NULL;
+	dat->units = words + HEADER_WORDS;
+	dat->nunits = words[2];
+	dat->nkeys = words[3];
+	return false;
+}
+
+const void *ax_datrie_image(const ax_datrie *dat, size_t *size)
+{
+	CHECK_PARAM_NULL(dat);
+	CHECK_PARAM_NULL(size);
+
+	*size = (HEADER_WORDS + (size_t)dat->nunits * 2) * sizeof(uint32_t);
+	return dat->units - HEADER_WORDS;
+}
+
+void ax_datrie_free(ax_datrie *dat)
+{
+	if (!dat)
+		return;
+	free(dat->buf);
+	dat->buf = NULL;
+	dat->units = NULL;
+	dat->nunits = 0;
+	dat->nkeys = 0;
+}
+
+bool ax_datrie_get(const ax_datrie *dat, const void *key, size_t len, uint32_t *value)
+{
+	CHECK_PARAM_NULL(dat);
+	CHECK_PARAM_VALIDITY(key, key || !len);
+
+	const ax_byte *p = key;
+	uint32_t s = 0;
+	for (size_t i = 0; i < len; i++) {
+		s = child_of(dat, s, p[i] + 1);
+		if (s == NONE)
+			return false;
+	}
+
+	uint32_t t = child_of(dat, s, 0);
+	if (t == NONE)
+		return false;
+	if (value)
+		*value = BASE(dat->units, t);
+	return true;
+}
+
+bool ax_datrie_longest_prefix(const ax_datrie *dat, const void *text, size_t len,
+		size_t *match_len, uint32_t *value)
+{
+	CHECK_PARAM_NULL(dat);
+	CHECK_PARAM_VALIDITY(text, text || !len);
+
+	const ax_byte *p = text;
+	uint32_t s = 0;
+	bool found = false;
+	for (size_t i = 0; ; i++) {
+		uint32_t t = child_of(dat, s, 0);
+		if (t != NONE) {
+			found = true;
+			if (match_len)
+				*match_len = i;
+			if (value)
+				*value = BASE(dat->units, t);
+		}
+		if (i == len)
+			break;
+		s = child_of(dat, s, p[i] + 1);
+		if (s == NONE)
+			break;
+	}
+	return found;
+}
+
+ax_fail ax_datrie_enum_prefix(const ax_datrie *dat, const void *prefix, size_t len,
+		ax_datrie_enum_cb_f cb, void *ctx)
+{
+	CHECK_PARAM_NULL(dat);
+	CHECK_PARAM_VALIDITY(prefix, prefix || !len);
+	CHECK_PARAM_NULL(cb);
+
+	const ax_byte *p = prefix;
+	uint32_t s = 0;
+	for (size_t i = 0; i < len; i++) {
+		s = child_of(dat, s, p[i] + 1);
+		if (s == NONE)
+			return false;
+	}
+
+	/* Each level keeps its state and the next code to try */
+	size_t depth = 0, capacity = len + 64;
+	ax_byte *key = malloc(capacity);
+	uint32_t *states = malloc(capacity * sizeof *states);
+	uint16_t *codes = malloc(capacity * sizeof *codes);
+	ax_fail retval = true;
+	if (!key || !states || !codes)
+		goto out;
+	if (len)
+		memcpy(key, prefix, len);
+
+	states[0] = s;
+	codes[0] = 0;
+	while (true) {
+		s = states[depth];
+		unsigned code = codes[depth];
+		uint32_t t = NONE;
+		while (code <= 256 && (t = child_of(dat, s, code)) == NONE)
+			code++;
+
+		if (code > 256) {
+			if (depth == 0)
+				break;
+			depth--;
+			continue;
+		}
+		codes[depth] = code + 1;
+
+		if (code == 0) {
+			if (cb(key, len + depth, BASE(dat->units, t), ctx))
+				break;
+			continue;
+		}
+
+		if (len + depth + 1 >= capacity) {
+			capacity *= 2;
+			ax_byte *new_key = realloc(key, capacity);
+			if (!new_key)
+				goto out;
+			key = new_key;
+			uint32_t *new_states = realloc(states, capacity * sizeof *states);
+			if (!new_states)
+				goto out;
+			states = new_states;
+			uint16_t *new_codes = realloc(codes, capacity * sizeof *codes);
+			if (!new_codes)
+				goto out;
+			codes = new_codes;
+		}
+		key[len + depth] = code - 1;
+		depth++;
+		states[depth] = t;
+		codes[depth] = 0;
+	}
+	retval = false;
+out:
+	free(key);
+	free(states);
+	free(codes);
+	return retval;
+}
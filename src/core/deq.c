@@ -74,6 +74,9 @@ static ax_fail seq_pushf(ax_seq *seq, const void *val, va_list *ap);
 static ax_fail seq_popf(ax_seq *seq);
 static ax_fail seq_trunc(ax_seq *seq, size_t size);
 static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val, va_list *ap);
+static ax_fail seq_push_n(ax_seq *seq, const void *arr, size_t n);
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static void    seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
 static ax_iter seq_at(const ax_seq *seq, size_t midx);
 static void   *seq_last(const ax_seq *seq);
 static void   *seq_first(const ax_seq *seq);
@@ -96,6 +99,7 @@ static void    citer_prev(ax_citer *it);
 static void    citer_next(ax_citer *it);
 static bool    citer_less(const ax_citer *it1, const ax_citer *it2);
 static long    citer_dist(const ax_citer *it1, const ax_citer *it2);
+static size_t  citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr);
 
 static bool    rciter_less(const ax_citer *it1, const ax_citer *it2);
 static long    rciter_dist(const ax_citer *it1, const ax_citer *it2);
@@ -245,6 +249,34 @@ static long citer_dist(const ax_citer *it1, const ax_citer *it2)
 	return index2 - index1;
 }
 
+static size_t citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr)
+{
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr);
+
+	ax_deq *self = (ax_deq *)it->owner;
+	struct position pos = get_position_by_iter(it);
+	struct position end;
+	if (last) {
+		CHECK_ITER_COMPARABLE(it, last);
+		end = get_position_by_iter(last);
+	} else
+		end = back_end_position(self);
+
+	/* A span never crosses a block */
+	size_t n = (pos.midx == end.midx ? end.boff : BLOCK_SIZE) - pos.boff;
+	if (n > max)
+		n = max;
+	*ptr = it->point;
+
+	pos.boff += n;
+	if (pos.boff == BLOCK_SIZE) {
+		pos.midx++;
+		pos.boff = 0;
+	}
+	iter_set_pos(it, &pos);
+	return n;
+}
+
 static bool rciter_less(const ax_citer *it1, const ax_citer *it2)
 {
 	CHECK_ITER_COMPARABLE(it1, it2);
@@ -529,14 +561,230 @@ static ax_fail seq_push(ax_seq *seq, const void *val, va_list *ap)
 	return false;
 }
 
+static ax_fail seq_push_n(ax_seq *seq, const void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_deq_r self = AX_R_INIT(ax_seq, seq);
+	const ax_trait *etr = ELEM_TR(self);
+	size_t esize = ax_trait_size(etr);
+	const ax_byte *src = arr;
+
+	/* Fill the rear block a run at a time, the block following the run is
+	 * allocated first as seq_push does for a single element */
+	size_t done = 0;
+	while (done < n) {
+		ax_byte *block = *ax_ring_back(&self.ax_deq->map);
+		size_t rear = self.ax_deq->rear;
+		size_t run = BLOCK_SIZE - rear;
+		if (run > n - done)
+			run = n - done;
+
+		bool block_added = false;
+		if (rear + run == BLOCK_SIZE) {
+			ax_byte *new_block = malloc(BLOCK_SIZE * esize);
+			if (!new_block)
+				goto fail;
+			if (ax_ring_push_back(&self.ax_deq->map, &new_block)) {
+				free(new_block);
+				goto fail;
+			}
+			block_added = true;
+		}
+
+		if (!etr->t_copy)
+			memcpy(block + rear * esize, src + done * esize, run * esize);
+		else for (size_t i = 0; i < run; i++) {
+			if (ax_trait_copy(etr, block + (rear + i) * esize, src + (done + i) * esize)) {
+				while (i--)
+					ax_trait_free(etr, block + (rear + i) * esize);
+				if (block_added) {
+					free(*ax_ring_back(&self.ax_deq->map));
+					ax_ring_pop_back(&self.ax_deq->map);
+				}
+				goto fail;
+			}
+		}
+
+		self.ax_deq->rear = (rear + run) % BLOCK_SIZE;
+		done += run;
+	}
+	return false;
+fail:
+	while (done--)
+		seq_pop(seq);
+	return true;
+}
+
+inline static ax_byte *index_ptr(const ax_deq *deq, size_t idx)
+{
+	size_t amount = deq->front + 1 + idx;
+	struct position pos = { amount / BLOCK_SIZE, amount % BLOCK_SIZE, };
+	return position_ptr(deq, &pos);
+}
+
+inline static void iter_set_index(ax_citer *it, long idx)
+{
+	const ax_deq *deq = it->owner;
+	size_t amount = deq->front + 1 + idx;
+	struct position pos = { amount / BLOCK_SIZE, amount % BLOCK_SIZE, };
+	iter_set_pos(it, &pos);
+}
+
+/* Move n elements from index src to index dst as memmove does, a run at a
+ * time where neither side crosses a block */
+static void move_elems(ax_deq *deq, size_t dst, size_t src, size_t n)
+{
+	ax_deq_cr self = AX_R_INIT(ax_deq, deq);
+	size_t esize = ax_trait_size(ELEM_TR(self));
+	if (dst < src) {
+		while (n) {
+			size_t dst_off = (deq->front + 1 + dst) % BLOCK_SIZE,
+			       src_off = (deq->front + 1 + src) % BLOCK_SIZE;
+			size_t run = BLOCK_SIZE - (dst_off > src_off ? dst_off : src_off);
+			if (run > n)
+				run = n;
+			memmove(index_ptr(deq, dst), index_ptr(deq, src), run * esize);
+			dst += run;
+			src += run;
+			n -= run;
+		}
+	} else if (dst > src) {
+		dst += n;
+		src += n;
+		while (n) {
+			size_t dst_off = (deq->front + dst) % BLOCK_SIZE,
+			       src_off = (deq->front + src) % BLOCK_SIZE;
+			size_t run = (dst_off < src_off ? dst_off : src_off) + 1;
+			if (run > n)
+				run = n;
+			dst -= run;
+			src -= run;
+			n -= run;
+			memmove(index_ptr(deq, dst), index_ptr(deq, src), run * esize);
+		}
+	}
+}
+
+/* Free the blocks following the one where rear lies */
+static void shrink_rear(ax_deq *deq, size_t rear_amount)
+{
+	size_t nblocks = rear_amount / BLOCK_SIZE + 1;
+	while (ax_ring_size(&deq->map) > nblocks) {
+		free(*ax_ring_back(&deq->map));
+		ax_ring_pop_back(&deq->map);
+	}
+	deq->rear = rear_amount % BLOCK_SIZE;
+}
+
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && it->tr);
+
+	ax_deq_r self = AX_R_INIT(ax_seq, seq);
+	const ax_trait *etr = ELEM_TR(self);
+	size_t n = ax_citer_range_size(first, last);
+	if (n == 0)
+		return false;
+
+	size_t size = box_size(self.ax_box);
+	struct position pos = get_position_by_iter(ax_iter_c(it));
+
+	/* A reversed iterator sees the range backward in memory */
+	long it_idx = INDEX_BY_POS(self.ax_deq, pos);
+	size_t ins = ax_iter_norm(it) ? it_idx : it_idx + 1;
+
+	/* Every block the elements moved back will occupy is allocated first */
+	size_t old_blocks = ax_ring_size(&self.ax_deq->map);
+	size_t rear_amount = self.ax_deq->front + 1 + size;
+	while (ax_ring_size(&self.ax_deq->map) < (rear_amount + n) / BLOCK_SIZE + 1) {
+		ax_byte *block = malloc(BLOCK_SIZE * ax_trait_size(etr));
+		if (!block)
+			goto fail;
+		if (ax_ring_push_back(&self.ax_deq->map, &block)) {
+			free(block);
+			goto fail;
+		}
+	}
+
+	move_elems(self.ax_deq, ins + n, ins, size - ins);
+	self.ax_deq->rear = (rear_amount + n) % BLOCK_SIZE;
+
+	ax_citer cur = *first;
+	for (size_t i = 0; i < n; i++) {
+		size_t dst = ins + (ax_iter_norm(it) ? i : n - 1 - i);
+		if (ax_trait_copy(etr, index_ptr(self.ax_deq, dst), cur.tr->get(&cur))) {
+			while (i--)
+				ax_trait_free(etr, index_ptr(self.ax_deq, ins + (ax_iter_norm(it) ? i : n - 1 - i)));
+			move_elems(self.ax_deq, ins, ins + n, size - ins);
+			shrink_rear(self.ax_deq, rear_amount);
+			iter_set_index(ax_iter_c(it), it_idx);
+			return true;
+		}
+		ax_citer_next(&cur);
+	}
+
+	iter_set_index(ax_iter_c(it), ax_iter_norm(it) ? it_idx + n : it_idx);
+	return false;
+fail:
+	while (ax_ring_size(&self.ax_deq->map) > old_blocks) {
+		free(*ax_ring_back(&self.ax_deq->map));
+		ax_ring_pop_back(&self.ax_deq->map);
+	}
+	iter_set_index(ax_iter_c(it), it_idx);
+	return true;
+}
+
+static void seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(first, first->owner == seq && first->tr);
+	CHECK_PARAM_VALIDITY(last, last->owner == seq && last->tr);
+
+	ax_deq_r self = AX_R_INIT(ax_seq, seq);
+	const ax_trait *etr = ELEM_TR(self);
+	size_t size = box_size(self.ax_box);
+
+	struct position pos1 = get_position_by_iter(ax_iter_c(first)),
+			pos2 = get_position_by_iter(ax_iter_c(last));
+	long idx1 = INDEX_BY_POS(self.ax_deq, pos1),
+	     idx2 = INDEX_BY_POS(self.ax_deq, pos2);
+
+	size_t begin, end;
+	if (ax_iter_norm(first)) {
+		begin = idx1;
+		end = idx2;
+	} else {
+		begin = idx2 + 1;
+		end = idx1 + 1;
+	}
+
+	if (begin >= end)
+		return;
+
+	if (etr->t_free)
+		for (size_t i = begin; i < end; i++)
+			ax_trait_free(etr, index_ptr(self.ax_deq, i));
+	move_elems(self.ax_deq, begin, end, size - end);
+	shrink_rear(self.ax_deq, self.ax_deq->front + 1 + size - (end - begin));
+
+	long idx = ax_iter_norm(first) ? (long)begin : (long)begin - 1;
+	iter_set_index(ax_iter_c(first), idx);
+	iter_set_index(ax_iter_c(last), idx);
+}
+
 static ax_fail seq_pop(ax_seq *seq)
 {
 	CHECK_PARAM_NULL(seq);
 
 	ax_deq_r self = AX_R_INIT(ax_seq, seq);
 	struct position pos = { ax_ring_size(&self.ax_deq->map) - 1, self.ax_deq->rear, };
-	if (prev_position(self.ax_deq, &pos)) 
+	if (prev_position(self.ax_deq, &pos)) {
+		free(*ax_ring_back(&self.ax_deq->map));
 		ax_ring_pop_back(&self.ax_deq->map);
+	}
 	ax_trait_free(ax_class_data(self.ax_box).elem_tr, position_ptr(self.ax_deq, &pos));
 	self.ax_deq->rear = pos.boff;
 	return false;
@@ -580,6 +828,7 @@ static ax_fail seq_popf(ax_seq *seq)
 	ax_deq_r self = AX_R_INIT(ax_seq, seq);
 	struct position pos = { 0, self.ax_deq->front, };
 	if (next_position(self.ax_deq, &pos)) {
+		free(*ax_ring_front(&self.ax_deq->map));
 		ax_ring_pop_front(&self.ax_deq->map);
 		pos.midx = 0;
 	}
@@ -674,6 +923,7 @@ const ax_seq_trait ax_deq_tr =
 			.prev = citer_prev,
 			.less = citer_less,
 			.dist = citer_dist,
+			.span = citer_span,
 			.get = citer_get,
 			.set = iter_set,
 			.erase = iter_erase,
@@ -712,6 +962,9 @@ const ax_seq_trait ax_deq_tr =
 	.at = seq_at,
 	.first = seq_first,
 	.last = seq_last,
+	.push_n = seq_push_n,
+	.insert_range = seq_insert_range,
+	.erase_range = seq_erase_range,
 };
 
 
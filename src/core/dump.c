@@ -171,9 +171,14 @@ ax_dump *ax_dump_str(const char *val)
 {
 	if (val == NULL)
 		return ax_dump_symbol("NULL");
-	size_t len = strlen(val);
-	size_t siz = (len + 1) * sizeof(char);
-	ax_dump *dmp = malloc(sizeof(ax_dump) + sizeof(struct value_mem_st) + siz);
+	return ax_dump_strn(val, strlen(val));
+}
+
+ax_dump *ax_dump_strn(const char *val, size_t len)
+{
+	if (val == NULL)
+		return ax_dump_symbol("NULL");
+	ax_dump *dmp = malloc(sizeof(ax_dump) + sizeof(struct value_mem_st) + (len + 1) * sizeof(char));
 	if (!dmp)
 		return NOMEM_DMP;
 
@@ -181,7 +186,8 @@ ax_dump *ax_dump_str(const char *val)
 	union value_u *value = (void *)dmp->value;
 	value->str.size = len;
 	value->str.maddr = val;
-	memcpy(value->str.data, val, siz);
+	memcpy(value->str.data, val, len * sizeof(char));
+	value->str.data[len] = '\0';
 
 	return dmp;
 }
@@ -0,0 +1,739 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/flat_hmap.h"
+#include "ax/iter.h"
+#include "ax/debug.h"
+#include "ax/trait.h"
+#include "check.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#define KEY_TR(r) ax_class_data(r.ax_map).key_tr
+#define VAL_TR(r) ax_class_data(r.ax_box).elem_tr
+
+/* Number of control bytes matched at once */
+#define GROUP_WIDTH 16
+
+#define MIN_CAPACITY GROUP_WIDTH
+
+/* A full slot stores the lower 7 bits of hash, so the sign bit marks a free slot */
+#define CTRL_EMPTY   ((int8_t)-128)
+#define CTRL_DELETED ((int8_t)-2)
+
+#define NPOS SIZE_MAX
+
+#define H1(hash) ((size_t)((hash) >> 7))
+#define H2(hash) ((int8_t)((hash) & 0x7F))
+
+#undef free
+
+typedef uint32_t group_mask;
+
+ax_concrete_begin(ax_flat_hmap)
+	int8_t *ctrl;
+	ax_byte *slots;
+	size_t capacity;
+	size_t size;
+	size_t growth_left;
+	size_t slot_size;
+ax_end;
+
+static void    *map_put(ax_map *map, const void *key, const void *val, va_list *ap);
+static ax_fail  map_erase(ax_map *map, const void *key);
+static void    *map_get(const ax_map *map, const void *key);
+static ax_iter  map_at(const ax_map *map, const void *key);
+static bool     map_exist(const ax_map *map, const void *key);
+static void    *map_chkey(ax_map *map, const void *key, const void *new_key);
+
+static const void *map_it_key(const ax_citer *it);
+
+static size_t   box_size(const ax_box *box);
+static size_t   box_maxsize(const ax_box *box);
+static ax_iter  box_begin(ax_box *box);
+static ax_iter  box_end(ax_box *box);
+static void     box_clear(ax_box *box);
+
+static ax_dump *any_dump(const ax_any *any);
+static ax_any  *any_copy(const ax_any *any);
+
+static void     one_free(ax_one *one);
+static const char *one_name(const ax_one *one);
+
+static void     citer_next(ax_citer *it);
+static void    *citer_get(const ax_citer *it);
+static ax_fail  iter_set(const ax_iter *it, const void *p, va_list *ap);
+static void     iter_erase(ax_iter *it);
+
+#ifdef USE_SSE2
+
+inline static group_mask group_match(const int8_t *grp, int8_t h2)
+{
+	__m128i ctrl = _mm_loadu_si128((const __m128i *)grp);
+	return (group_mask)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+}
+
+inline static group_mask group_match_free(const int8_t *grp)
+{
+	return (group_mask)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)grp));
+}
+
+#else
+
+inline static group_mask group_match(const int8_t *grp, int8_t h2)
+{
+	group_mask mask = 0;
+	for (int i = 0; i < GROUP_WIDTH; i++)
+		mask |= (group_mask)(grp[i] == h2) << i;
+	return mask;
+}
+
+inline static group_mask group_match_free(const int8_t *grp)
+{
+	group_mask mask = 0;
+	for (int i = 0; i < GROUP_WIDTH; i++)
+		mask |= (group_mask)(grp[i] < 0) << i;
+	return mask;
+}
+
+#endif
+
+inline static group_mask group_match_empty(const int8_t *grp)
+{
+	return group_match(grp, CTRL_EMPTY);
+}
+
+inline static group_mask group_match_full(const int8_t *grp)
+{
+	return ~group_match_free(grp) & ((1u << GROUP_WIDTH) - 1);
+}
+
+inline static int mask_lowest(group_mask mask)
+{
+	assert(mask);
+#if defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	int i = 0;
+	while (!(mask & 1))
+		mask >>= 1, i++;
+	return i;
+#endif
+}
+
+inline static uint64_t mix_hash(size_t hash)
+{
+	uint64_t h = (uint64_t)hash * 0x9E3779B97F4A7C15ull;
+	return h ^ (h >> 32);
+}
+
+inline static size_t max_load(size_t capacity)
+{
+	return capacity - capacity / 8;
+}
+
+inline static ax_byte *slot_at(const ax_flat_hmap *fhmap, size_t index)
+{
+	return fhmap->slots + index * fhmap->slot_size;
+}
+
+inline static size_t slot_index(const ax_flat_hmap *fhmap, const void *slot)
+{
+	return ((const ax_byte *)slot - fhmap->slots) / fhmap->slot_size;
+}
+
+inline static void *slot_val(const ax_flat_hmap *fhmap, void *slot)
+{
+	return (ax_byte *)slot + ax_trait_size(ax_class_data(ax_cr(ax_flat_hmap, fhmap).ax_map).key_tr);
+}
+
+inline static uint64_t key_hash(const ax_flat_hmap *fhmap, const void *key)
+{
+	return mix_hash(ax_trait_hash(ax_class_data(ax_cr(ax_flat_hmap, fhmap).ax_map).key_tr, key));
+}
+
+static size_t find_free(const int8_t *ctrl, size_t capacity, uint64_t hash)
+{
+	size_t gmask = capacity / GROUP_WIDTH - 1;
+	size_t g = H1(hash) & gmask;
+	for (size_t step = 1; ; step++) {
+		group_mask m = group_match_free(ctrl + g * GROUP_WIDTH);
+		if (m)
+			return g * GROUP_WIDTH + mask_lowest(m);
+		g = (g + step) & gmask;
+	}
+}
+
+static size_t find_slot(const ax_flat_hmap *fhmap, const void *key, uint64_t hash)
+{
+	if (!fhmap->capacity)
+		return NPOS;
+
+	const ax_trait *ktr = ax_class_data(ax_cr(ax_flat_hmap, fhmap).ax_map).key_tr;
+	size_t gmask = fhmap->capacity / GROUP_WIDTH - 1;
+	size_t g = H1(hash) & gmask;
+	for (size_t step = 1; ; step++) {
+		const int8_t *grp = fhmap->ctrl + g * GROUP_WIDTH;
+		for (group_mask m = group_match(grp, H2(hash)); m; m &= m - 1) {
+			size_t i = g * GROUP_WIDTH + mask_lowest(m);
+			if (ax_trait_equal(ktr, slot_at(fhmap, i), key))
+				return i;
+		}
+		if (group_match_empty(grp))
+			return NPOS;
+		g = (g + step) & gmask;
+	}
+}
+
+static size_t next_full(const ax_flat_hmap *fhmap, size_t index)
+{
+	while (index < fhmap->capacity) {
+		size_t base = index - index % GROUP_WIDTH;
+		group_mask m = group_match_full(fhmap->ctrl + base) & ~(((group_mask)1 << (index - base)) - 1);
+		if (m)
+			return base + mask_lowest(m);
+		index = base + GROUP_WIDTH;
+	}
+	return fhmap->capacity;
+}
+
+static ax_fail resize(ax_flat_hmap *fhmap, size_t capacity)
+{
+	assert(capacity >= MIN_CAPACITY && capacity % GROUP_WIDTH == 0);
+	assert(max_load(capacity) >= fhmap->size);
+
+	if (capacity > (SIZE_MAX - capacity) / fhmap->slot_size) {
+		errno = ENOMEM;
+		return true;
+	}
+
+	int8_t *ctrl = malloc(capacity + capacity * fhmap->slot_size);
+	if (!ctrl)
+		return true;
+	ax_byte *slots = (ax_byte *)ctrl + capacity;
+	memset(ctrl, CTRL_EMPTY, capacity);
+
+	for (size_t i = next_full(fhmap, 0); i < fhmap->capacity; i = next_full(fhmap, i + 1)) {
+		ax_byte *slot = slot_at(fhmap, i);
+		uint64_t hash = key_hash(fhmap, slot);
+		size_t j = find_free(ctrl, capacity, hash);
+		ctrl[j] = H2(hash);
+		memcpy(slots + j * fhmap->slot_size, slot, fhmap->slot_size);
+	}
+
+	free(fhmap->ctrl);
+	fhmap->ctrl = ctrl;
+	fhmap->slots = slots;
+	fhmap->capacity = capacity;
+	fhmap->growth_left = max_load(capacity) - fhmap->size;
+	return false;
+}
+
+static ax_fail grow(ax_flat_hmap *fhmap)
+{
+	size_t capacity = fhmap->capacity;
+	if (!capacity)
+		capacity = MIN_CAPACITY;
+	else if (fhmap->size >= max_load(capacity) / 2) {
+		if (capacity > SIZE_MAX / 2) {
+			errno = ENOMEM;
+			return true;
+		}
+		capacity <<= 1;
+	}
+	/* Otherwise the table is mostly occupied by tombstones, just rehash in place */
+	return resize(fhmap, capacity);
+}
+
+static size_t prepare_insert(ax_flat_hmap *fhmap, uint64_t hash)
+{
+	if (!fhmap->capacity && grow(fhmap))
+		return NPOS;
+
+	size_t i = find_free(fhmap->ctrl, fhmap->capacity, hash);
+	if (fhmap->ctrl[i] == CTRL_EMPTY && fhmap->growth_left == 0) {
+		if (grow(fhmap))
+			return NPOS;
+		i = find_free(fhmap->ctrl, fhmap->capacity, hash);
+	}
+
+	if (fhmap->ctrl[i] == CTRL_EMPTY)
+		fhmap->growth_left--;
+	fhmap->ctrl[i] = H2(hash);
+	fhmap->size++;
+	return i;
+}
+
+static void erase_at(ax_flat_hmap *fhmap, size_t index, bool clean)
+{
+	ax_flat_hmap_r self = AX_R_INIT(ax_flat_hmap, fhmap);
+	ax_byte *slot = slot_at(fhmap, index);
+	if (clean) {
+		const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+		ax_trait_free(ktr, slot);
+		ax_trait_free(vtr, slot + ax_trait_size(ktr));
+	}
+
+	/* If the group was never filled up, no probe sequence has passed through
+	 * it, so the slot can be marked as empty rather than leaving a tombstone */
+	if (group_match_empty(fhmap->ctrl + (index - index % GROUP_WIDTH))) {
+		fhmap->ctrl[index] = CTRL_EMPTY;
+		fhmap->growth_left++;
+	} else
+		fhmap->ctrl[index] = CTRL_DELETED;
+	fhmap->size--;
+}
+
+static void *value_set(ax_map* map, void *slot, const void *val, va_list *ap)
+{
+	ax_flat_hmap_r self = AX_R_INIT(ax_map, map);
+	const ax_trait *vtr = VAL_TR(self);
+	ax_byte *value_ptr = slot_val(self.ax_flat_hmap, slot);
+	ax_byte tmp_buf[self.ax_flat_hmap->slot_size];
+	memcpy(tmp_buf, value_ptr, ax_trait_size(vtr));
+
+	if (ax_trait_copy_or_init(vtr, value_ptr, val, ap)) {
+		memcpy(value_ptr, tmp_buf, ax_trait_size(vtr));
+		return NULL;
+	}
+	ax_trait_free(vtr, tmp_buf);
+	return value_ptr;
+}
+
+ax_fail ax_flat_hmap_reserve(ax_flat_hmap *fhmap, size_t size)
+{
+	CHECK_PARAM_NULL(fhmap);
+
+	size_t capacity = MIN_CAPACITY;
+	while (max_load(capacity) < size) {
+		if (capacity > SIZE_MAX / 2) {
+			errno = ENOMEM;
+			return true;
+		}
+		capacity <<= 1;
+	}
+
+	if (capacity <= fhmap->capacity)
+		return false;
+
+	return resize(fhmap, capacity);
+}
+
+size_t ax_flat_hmap_capacity(const ax_flat_hmap *fhmap)
+{
+	CHECK_PARAM_NULL(fhmap);
+
+	return fhmap->capacity;
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr && it->point);
+
+	const ax_flat_hmap *fhmap = it->owner;
+	size_t i = next_full(fhmap, slot_index(fhmap, it->point) + 1);
+	it->point = i < fhmap->capacity ? slot_at(fhmap, i) : NULL;
+}
+
+static void *citer_get(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr && it->point);
+
+	return slot_val(it->owner, it->point);
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point);
+
+	return !value_set(it->owner, it->point, val, ap);
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(it->point);
+
+	ax_flat_hmap *fhmap = it->owner;
+	size_t index = slot_index(fhmap, it->point);
+	ax_assert(fhmap->ctrl[index] >= 0, "bad iterator");
+
+	size_t next = next_full(fhmap, index + 1);
+	erase_at(fhmap, index, true);
+	it->point = next < fhmap->capacity ? slot_at(fhmap, next) : NULL;
+}
+
+static void *map_put(ax_map *map, const void *key, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_flat_hmap_r self = AX_R_INIT(ax_map, map);
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+
+	uint64_t hash = key_hash(self.ax_flat_hmap, key);
+	size_t i = find_slot(self.ax_flat_hmap, key, hash);
+	if (i != NPOS)
+		return value_set(map, slot_at(self.ax_flat_hmap, i), val, ap);
+
+	i = prepare_insert(self.ax_flat_hmap, hash);
+	if (i == NPOS)
+		return NULL;
+
+	ax_byte *slot = slot_at(self.ax_flat_hmap, i);
+	if (ax_trait_copy(ktr, slot, key))
+		goto fail;
+
+	if (ax_trait_copy_or_init(vtr, slot + ax_trait_size(ktr), val, ap)) {
+		ax_trait_free(ktr, slot);
+		goto fail;
+	}
+	return slot + ax_trait_size(ktr);
+fail:
+	erase_at(self.ax_flat_hmap, i, false);
+	return NULL;
+}
+
+static ax_fail map_erase(ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_flat_hmap_r self = AX_R_INIT(ax_map, map);
+	size_t i = find_slot(self.ax_flat_hmap, key, key_hash(self.ax_flat_hmap, key));
+	if (i == NPOS)
+		return true;
+
+	erase_at(self.ax_flat_hmap, i, true);
+	return false;
+}
+
+static void *map_get(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_flat_hmap_cr self = AX_R_INIT(ax_map, map);
+	size_t i = find_slot(self.ax_flat_hmap, key, key_hash(self.ax_flat_hmap, key));
+	return i == NPOS ? NULL : slot_val(self.ax_flat_hmap, slot_at(self.ax_flat_hmap, i));
+}
+
+static ax_iter map_at(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_flat_hmap_cr self = AX_R_INIT(ax_map, map);
+	size_t i = find_slot(self.ax_flat_hmap, key, key_hash(self.ax_flat_hmap, key));
+	if (i == NPOS)
+		return box_end((ax_box *)self.ax_box);
+
+	return (ax_iter) {
+		.owner = (void *)map,
+		.point = slot_at(self.ax_flat_hmap, i),
+		.tr = &ax_flat_hmap_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+}
+
+static bool map_exist(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_flat_hmap_cr self = AX_R_INIT(ax_map, map);
+	return find_slot(self.ax_flat_hmap, key, key_hash(self.ax_flat_hmap, key)) != NPOS;
+}
+
+static void *map_chkey(ax_map *map, const void *key, const void *new_key)
+{
+	CHECK_PARAM_NULL(map);
+	CHECK_PARAM_NULL(key);
+	CHECK_PARAM_NULL(new_key);
+
+	ax_flat_hmap_r self = AX_R_INIT(ax_map, map);
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+	size_t ksize = ax_trait_size(ktr);
+
+	size_t i = find_slot(self.ax_flat_hmap, key, key_hash(self.ax_flat_hmap, key));
+	ax_assert(i != NPOS, "key does not exists");
+
+	ax_byte tmp[self.ax_flat_hmap->slot_size];
+	if (ax_trait_copy(ktr, tmp, new_key))
+		return NULL;
+
+	ax_byte *slot = slot_at(self.ax_flat_hmap, i);
+	uint64_t hash = key_hash(self.ax_flat_hmap, new_key);
+	size_t j = find_slot(self.ax_flat_hmap, new_key, hash);
+	if (j == i) {
+		ax_trait_free(ktr, slot);
+		memcpy(slot, tmp, ksize);
+		return slot;
+	}
+
+	if (j != NPOS)
+		erase_at(self.ax_flat_hmap, j, true);
+
+	/* Move the pair out of the table, since the slot is determined by the new key */
+	ax_trait_free(ktr, slot);
+	memcpy(tmp + ksize, slot + ksize, ax_trait_size(vtr));
+	erase_at(self.ax_flat_hmap, i, false);
+
+	j = prepare_insert(self.ax_flat_hmap, hash);
+	if (j == NPOS) {
+		ax_trait_free(ktr, tmp);
+		ax_trait_free(vtr, tmp + ksize);
+		return NULL;
+	}
+	slot = slot_at(self.ax_flat_hmap, j);
+	memcpy(slot, tmp, ksize + ax_trait_size(vtr));
+	return slot;
+}
+
+static const void *map_it_key(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr && it->point);
+	CHECK_ITER_TYPE(it, one_name(NULL));
+
+	const ax_map *map = it->owner;
+	return ax_trait_out(ax_class_data(map).key_tr, it->point);
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_flat_hmap_r self = AX_R_INIT(ax_one, one);
+	box_clear(self.ax_box);
+	free(self.ax_flat_hmap);
+}
+
+static const char *one_name(const ax_one *one)
+{
+	return ax_class_name(4, ax_flat_hmap);
+}
+
+static ax_dump *any_dump(const ax_any *any)
+{
+	ax_map_cr self = AX_R_INIT(ax_any, any);
+	return ax_map_dump(self.ax_map);
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_flat_hmap_cr src = AX_R_INIT(ax_any, any);
+	const ax_trait *ktr = KEY_TR(src), *vtr = VAL_TR(src);
+	size_t ksize = ax_trait_size(ktr);
+
+	ax_flat_hmap_r dst = { .ax_map = __ax_flat_hmap_construct(ktr, vtr) };
+	if (ax_r_isnull(dst))
+		return NULL;
+
+	size_t capacity = src.ax_flat_hmap->capacity;
+	if (!capacity)
+		return dst.ax_any;
+
+	/* Same capacity and hash function, so every pair keeps its position */
+	int8_t *ctrl = malloc(capacity + capacity * src.ax_flat_hmap->slot_size);
+	if (!ctrl)
+		goto fail;
+	memcpy(ctrl, src.ax_flat_hmap->ctrl, capacity);
+	dst.ax_flat_hmap->ctrl = ctrl;
+	dst.ax_flat_hmap->slots = (ax_byte *)ctrl + capacity;
+	dst.ax_flat_hmap->capacity = capacity;
+	dst.ax_flat_hmap->growth_left = src.ax_flat_hmap->growth_left;
+
+	for (size_t i = next_full(src.ax_flat_hmap, 0); i < capacity; i = next_full(src.ax_flat_hmap, i + 1)) {
+		ax_byte *from = slot_at(src.ax_flat_hmap, i), *to = slot_at(dst.ax_flat_hmap, i);
+		if (ax_trait_copy(ktr, to, from))
+			goto partial;
+		if (ax_trait_copy(vtr, to + ksize, from + ksize)) {
+			ax_trait_free(ktr, to);
+			goto partial;
+		}
+		dst.ax_flat_hmap->size++;
+		continue;
+partial:
+		/* Drop the slots which are not copied yet */
+		for (size_t j = i; j < capacity; j++)
+			if (ctrl[j] >= 0)
+				ctrl[j] = CTRL_DELETED;
+		goto fail;
+	}
+
+	return dst.ax_any;
+fail:
+	ax_one_free(dst.ax_one);
+	return NULL;
+}
+
+static size_t box_size(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_flat_hmap_cr self = AX_R_INIT(ax_box, box);
+	return self.ax_flat_hmap->size;
+}
+
+static size_t box_maxsize(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return SIZE_MAX;
+}
+
+static ax_iter box_begin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_flat_hmap_r self = AX_R_INIT(ax_box, box);
+	size_t i = next_full(self.ax_flat_hmap, 0);
+
+	ax_iter it = {
+		.owner = (void *)box,
+		.tr = &ax_flat_hmap_tr.ax_box.iter,
+		.point = i < self.ax_flat_hmap->capacity
+			? slot_at(self.ax_flat_hmap, i)
+			: NULL,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	return it;
+}
+
+static ax_iter box_end(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_iter it = {
+		.owner = box,
+		.tr = &ax_flat_hmap_tr.ax_box.iter,
+		.point = NULL,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	return it;
+}
+
+static void box_clear(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_flat_hmap_r self = AX_R_INIT(ax_box, box);
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+
+	for (size_t i = next_full(self.ax_flat_hmap, 0);
+			i < self.ax_flat_hmap->capacity;
+			i = next_full(self.ax_flat_hmap, i + 1)) {
+		ax_byte *slot = slot_at(self.ax_flat_hmap, i);
+		ax_trait_free(ktr, slot);
+		ax_trait_free(vtr, slot + ax_trait_size(ktr));
+	}
+
+	free(self.ax_flat_hmap->ctrl);
+	self.ax_flat_hmap->ctrl = NULL;
+	self.ax_flat_hmap->slots = NULL;
+	self.ax_flat_hmap->capacity = 0;
+	self.ax_flat_hmap->size = 0;
+	self.ax_flat_hmap->growth_left = 0;
+}
+
+const ax_map_trait ax_flat_hmap_tr =
+{
+	.ax_box = {
+		.ax_any = {
+			.ax_one = {
+				.name  = one_name,
+				.free  = one_free,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+		},
+
+		.iter = {
+			.norm  = true,
+			.type  = AX_IT_FORW,
+			.move = NULL,
+			.prev = NULL,
+			.next = citer_next,
+			.less  = NULL,
+			.dist  = NULL,
+			.get   = citer_get,
+			.set   = iter_set,
+			.erase = iter_erase,
+		},
+		.size    = box_size,
+		.maxsize = box_maxsize,
+		.begin   = box_begin,
+		.end     = box_end,
+		.rbegin  = NULL,
+		.rend    = NULL,
+		.clear   = box_clear,
+	},
+	.put   = map_put,
+	.get   = map_get,
+	.at    = map_at,
+	.erase = map_erase,
+	.exist = map_exist,
+	.chkey = map_chkey,
+	.itkey = map_it_key,
+};
+
+ax_map *__ax_flat_hmap_construct(const ax_trait *key_tr, const ax_trait *val_tr)
+{
+	CHECK_PARAM_NULL(key_tr);
+	CHECK_PARAM_NULL(val_tr);
+
+	ax_flat_hmap *fhmap = malloc(sizeof(ax_flat_hmap));
+	if (!fhmap)
+		return NULL;
+
+	size_t kvsize = ax_trait_size(key_tr) + ax_trait_size(val_tr);
+
+	ax_flat_hmap fhmap_init = {
+		.ax_map = {
+			.tr = &ax_flat_hmap_tr,
+			.env = {
+				.ax_box.elem_tr = val_tr,
+				.key_tr = key_tr,
+			},
+		},
+		.ctrl = NULL,
+		.slots = NULL,
+		.capacity = 0,
+		.size = 0,
+		.growth_left = 0,
+		.slot_size = ax_align(ax_max(kvsize, 1), sizeof(void *)),
+	};
+
+	memcpy(fhmap, &fhmap_init, sizeof fhmap_init);
+	return ax_r(ax_flat_hmap, fhmap).ax_map;
+}
@@ -35,14 +35,31 @@
 
 #define DEFAULT_THRESHOLD 8
 
+/* Number of keys of which the buckets are prefetched together in batch lookup */
+#define BATCH_WIDTH 16
+
+#ifdef __GNUC__
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p) ((void)(p))
+#endif
+
 #define KEY_TR(r) ax_class_data(r.ax_map).key_tr
 #define VAL_TR(r) ax_class_data(r.ax_box).elem_tr
 
 #undef free
 
+/*
+ * The hash of the key is cached in node unless AX_HMAP_NO_HASH_CACHE is
+ * defined, rehashing then never calls the hash function again and most of
+ * mismatched keys are skipped without calling the equality function.
+ */
 struct node_st
 {
 	struct node_st *next;
+#ifndef AX_HMAP_NO_HASH_CACHE
+	size_t hash;
+#endif
 	ax_byte kvbuffer[];
 };
 
@@ -60,6 +77,12 @@ ax_concrete_begin(ax_hmap)
 	size_t reserved;
 	struct bucket_st *bucket_list;
 	struct bucket_st *bucket_tab;
+
+	/* Buckets in old_tab below migrated have been moved into bucket_tab */
+	struct bucket_st *old_tab;
+	size_t old_buckets;
+	size_t migrated;
+	size_t rehash_step;
 ax_end;
 
 static void    *map_put(ax_map *map, const void *key, const void *val, va_list *ap);
@@ -70,6 +93,9 @@ static bool     map_exist(const ax_map *map, const void *key);
 static void    *map_chkey(ax_map *map, const void *key, const void *new_key);
 
 static const void *map_it_key(const ax_citer *it);
+static size_t   find_batch(const ax_map *map, const void *const keys[], size_t n, struct node_st *nodes[]);
+static size_t   map_get_batch(const ax_map *map, const void *const keys[], size_t n, void *vals[]);
+static size_t   map_exist_batch(const ax_map *map, const void *const keys[], size_t n, bool exist[]);
 
 static size_t   box_size(const ax_box *box);
 static size_t   box_maxsize(const ax_box *box);
@@ -89,11 +115,15 @@ static ax_fail  iter_set(const ax_iter *it, const void *p, va_list *ap);
 static void     iter_erase(ax_iter *it);
 
 static ax_fail rehash(ax_hmap *hmap, size_t new_size);
-static struct node_st *make_node(ax_map *map, const void *key, const void *val, va_list *ap);
-static struct bucket_st *locate_bucket(const ax_hmap *hmap, const void *key);
+static ax_fail resize(ax_hmap *hmap, size_t nbucket);
+static void migrate(ax_hmap *hmap, size_t nbucket);
+static struct node_st *make_node(ax_map *map, const void *key, size_t hash, const void *val, va_list *ap);
+static size_t key_hash(const ax_hmap *hmap, const void *key);
+static size_t node_hash(const ax_hmap *hmap, const struct node_st *node);
+static struct bucket_st *locate_bucket(const ax_hmap *hmap, size_t hash);
 static void bucket_push_node(ax_hmap *hmap, struct bucket_st *bucket, struct node_st *node);
 static struct bucket_st *unlink_bucket(struct bucket_st *head, struct bucket_st *bucket);
-static struct node_st **find_node(const ax_map *map, struct bucket_st *bucket, const void *key);
+static struct node_st **find_node(const ax_map *map, struct bucket_st *bucket, const void *key, size_t hash);
 static void free_node(ax_map *map, struct node_st **pp_node);
 static void *value_set(ax_map* map, struct node_st *node, const void *val, va_list *ap);
 
@@ -128,9 +158,55 @@ inline static void size_bit_set(size_t *size, bool bit, int len)
 }
 */
 
+static void migrate(ax_hmap *hmap, size_t nbucket)
+{
+	while (hmap->old_tab && nbucket--) {
+		struct bucket_st *bucket = hmap->old_tab + hmap->migrated;
+		if (bucket->node_list) {
+			hmap->bucket_list = unlink_bucket(hmap->bucket_list, bucket);
+			for (struct node_st *node = bucket->node_list, *next; node; node = next) {
+				next = node->next;
+				struct bucket_st *new_bucket = hmap->bucket_tab
+					+ node_hash(hmap, node) % hmap->buckets;
+				bucket_push_node(hmap, new_bucket, node);
+			}
+			bucket->node_list = NULL;
+		}
+
+		if (++hmap->migrated == hmap->old_buckets) {
+			free(hmap->old_tab);
+			hmap->old_tab = NULL;
+			hmap->old_buckets = 0;
+			hmap->migrated = 0;
+		}
+	}
+}
+
+static ax_fail resize(ax_hmap *hmap, size_t nbucket)
+{
+	if (!hmap->rehash_step)
+		return rehash(hmap, nbucket);
+
+	/* Only one migration is allowed at the same time */
+	migrate(hmap, hmap->old_buckets);
+
+	struct bucket_st *new_tab = calloc(nbucket, sizeof(struct bucket_st));
+	if (!new_tab)
+		return true;
+
+	hmap->old_tab = hmap->bucket_tab;
+	hmap->old_buckets = hmap->buckets;
+	hmap->migrated = 0;
+	hmap->bucket_tab = new_tab;
+	hmap->buckets = nbucket;
+	return false;
+}
+
 static ax_fail rehash(ax_hmap *hmap, size_t nbucket)
 {
 	assert(nbucket > 0);
+	migrate(hmap, hmap->old_buckets);
+
 	struct bucket_st *new_tab = malloc((nbucket * sizeof(struct bucket_st)));
 	if (!new_tab)
 		return true;
@@ -141,11 +217,8 @@ static ax_fail rehash(ax_hmap *hmap, size_t nbucket)
 	hmap->bucket_list = NULL;
 	for (; bucket; bucket = bucket->next) {
 		for (struct node_st *currnode = bucket->node_list; currnode;) {
-			const ax_trait *ktr = ax_class_data(ax_r(ax_hmap, hmap).ax_map).key_tr;
-
 			struct bucket_st *new_bucket = new_tab
-				+ ax_trait_hash(ktr, currnode->kvbuffer)
-				% nbucket;
+				+ node_hash(hmap, currnode) % nbucket;
 
 			if (!new_bucket->node_list) {
 				new_bucket->next = hmap->bucket_list;
@@ -211,7 +284,27 @@ size_t ax_hmap_threshold(ax_hmap *hmap)
 	return hmap->threshold;
 }
 
-static struct node_st *make_node(ax_map *map, const void *key, const void *val, va_list *ap)
+ax_fail ax_hmap_set_rehash_step(ax_hmap *hmap, size_t step)
+{
+	CHECK_PARAM_NULL(hmap);
+
+	if (!step)
+		migrate(hmap, hmap->old_buckets);
+	hmap->rehash_step = step;
+	return false;
+}
+
+size_t ax_hmap_rehash_step(ax_hmap *hmap)
+{
+	return hmap->rehash_step;
+}
+
+size_t ax_hmap_rehash_pending(const ax_hmap *hmap)
+{
+	return hmap->old_buckets - hmap->migrated;
+}
+
+static struct node_st *make_node(ax_map *map, const void *key, size_t hash, const void *val, va_list *ap)
 {
 	ax_hmap_r self = AX_R_INIT(ax_map, map);
 	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
@@ -227,16 +320,37 @@ static struct node_st *make_node(ax_map *map, const void *key, const void *val,
 
 	if (ax_trait_copy_or_init(vtr, node->kvbuffer + ax_trait_size(ktr), val, ap))
 		goto fail;
+#ifndef AX_HMAP_NO_HASH_CACHE
+	node->hash = hash;
+#endif
 	return node;
 fail:
 	free(node);
 	return NULL;
 }
 
-static inline struct bucket_st *locate_bucket(const ax_hmap *hmap, const void *key)
+static inline size_t key_hash(const ax_hmap *hmap, const void *key)
 {
-	size_t index = ax_trait_hash(ax_class_data(ax_cr(ax_hmap, hmap).ax_map).key_tr, key) % hmap->buckets;
-	return hmap->bucket_tab + index;
+	return ax_trait_hash(ax_class_data(ax_cr(ax_hmap, hmap).ax_map).key_tr, key);
+}
+
+static inline size_t node_hash(const ax_hmap *hmap, const struct node_st *node)
+{
+#ifndef AX_HMAP_NO_HASH_CACHE
+	return node->hash;
+#else
+	return key_hash(hmap, node->kvbuffer);
+#endif
+}
+
+static inline struct bucket_st *locate_bucket(const ax_hmap *hmap, size_t hash)
+{
+	if (hmap->old_tab) {
+		size_t index = hash % hmap->old_buckets;
+		if (index >= hmap->migrated)
+			return hmap->old_tab + index;
+	}
+	return hmap->bucket_tab + hash % hmap->buckets;
 }
 
 static void bucket_push_node(ax_hmap *hmap, struct bucket_st *bucket, struct node_st *node)
@@ -266,13 +380,20 @@ static struct bucket_st *unlink_bucket(struct bucket_st *head, struct bucket_st
 	return ret;
 }
 
-static struct node_st **find_node(const ax_map *map, struct bucket_st *bucket, const void *key)
+static struct node_st **find_node(const ax_map *map, struct bucket_st *bucket, const void *key, size_t hash)
 {
 	struct node_st **pp_node;
 	const ax_trait *ktr = ax_class_data(map).key_tr;
-	for (pp_node = &bucket->node_list; *pp_node; pp_node = &((*pp_node)->next))
+	for (pp_node = &bucket->node_list; *pp_node; pp_node = &((*pp_node)->next)) {
+#ifndef AX_HMAP_NO_HASH_CACHE
+		if ((*pp_node)->hash != hash)
+			continue;
+#else
+		ax_unused(hash);
+#endif
 		if (ax_trait_equal(ktr, (*pp_node)->kvbuffer, key))
 			return pp_node;
+	}
 	return NULL;
 }
 
@@ -297,7 +418,7 @@ static void citer_next(ax_citer *it)
 
 	const ax_hmap *hmap= it->owner;
 	struct node_st *node = it->point;
-	struct bucket_st *bucket = locate_bucket(hmap, node->kvbuffer);
+	struct bucket_st *bucket = locate_bucket(hmap, node_hash(hmap, node));
 	assert(bucket);
 	node = node->next;
 	if (!node) {
@@ -340,8 +461,9 @@ static void iter_erase(ax_iter *it)
 	struct node_st *node = it->point;
 	void *pkey = node->kvbuffer;
 
-	struct bucket_st *bucket = locate_bucket(self.ax_hmap, pkey);
-	struct node_st **findpp= find_node(self.ax_map, bucket, pkey);
+	size_t hash = node_hash(self.ax_hmap, node);
+	struct bucket_st *bucket = locate_bucket(self.ax_hmap, hash);
+	struct node_st **findpp= find_node(self.ax_map, bucket, pkey, hash);
 	ax_assert(findpp, "bad iterator");
 	assert(it->point == *findpp);
 
@@ -389,27 +511,27 @@ static void *value_set(ax_map* map, struct node_st *node, const void *val, va_li
 
 }
 
-static void *map_put(ax_map *map, const void *key, const void *val, va_list *ap)
+static void *put_hashed(ax_map *map, const void *key, size_t hash, const void *val, va_list *ap)
 {
-	CHECK_PARAM_NULL(map);
-
 	ax_hmap_r self = AX_R_INIT(ax_map, map);
 
-	struct bucket_st *bucket = locate_bucket(self.ax_hmap, key);
-	struct node_st **findpp = find_node(self.ax_map, bucket, key);
+	migrate(self.ax_hmap, self.ax_hmap->rehash_step);
+
+	struct bucket_st *bucket = locate_bucket(self.ax_hmap, hash);
+	struct node_st **findpp = find_node(self.ax_map, bucket, key, hash);
 	if (findpp)
 		return value_set(map, *findpp, val, ap);
 
-	if (self.ax_hmap->size == self.ax_hmap->buckets * self.ax_hmap->threshold) {
+	if (self.ax_hmap->size >= self.ax_hmap->buckets * self.ax_hmap->threshold) {
 		if (self.ax_hmap->buckets == ax_box_maxsize(ax_r(ax_map, map).ax_box)) {
 			return NULL;
 		}
 		size_t new_size = self.ax_hmap->buckets << 1 | 1;
-		if(rehash(self.ax_hmap, new_size))
+		if(resize(self.ax_hmap, new_size))
 			return NULL;
-		bucket = locate_bucket(self.ax_hmap, key);//bucket is invalid
+		bucket = locate_bucket(self.ax_hmap, hash);//bucket is invalid
 	}
-	struct node_st *new_node = make_node(self.ax_map, key, val, ap);
+	struct node_st *new_node = make_node(self.ax_map, key, hash, val, ap);
 	if (!new_node)
 		return NULL;
 	bucket_push_node(self.ax_hmap, bucket, new_node);
@@ -417,14 +539,22 @@ static void *map_put(ax_map *map, const void *key, const void *val, va_list *ap)
 	return node_val(map, new_node);
 }
 
-static ax_fail map_erase (ax_map *map, const void *key)
+static void *map_put(ax_map *map, const void *key, const void *val, va_list *ap)
 {
 	CHECK_PARAM_NULL(map);
 
+	ax_hmap_r self = AX_R_INIT(ax_map, map);
+	return put_hashed(map, key, key_hash(self.ax_hmap, key), val, ap);
+}
+
+static ax_fail erase_hashed(ax_map *map, const void *key, size_t hash)
+{
 	ax_hmap_r hmap_r = { .ax_map = map };
 
-	struct bucket_st *bucket = locate_bucket(hmap_r.ax_hmap, key);
-	struct node_st **findpp = find_node(hmap_r.ax_map, bucket, key);
+	migrate(hmap_r.ax_hmap, hmap_r.ax_hmap->rehash_step);
+
+	struct bucket_st *bucket = locate_bucket(hmap_r.ax_hmap, hash);
+	struct node_st **findpp = find_node(hmap_r.ax_map, bucket, key, hash);
 	if (!findpp)
 		return true;
 
@@ -433,8 +563,9 @@ static ax_fail map_erase (ax_map *map, const void *key)
 		hmap_r.ax_hmap->bucket_list = unlink_bucket(hmap_r.ax_hmap->bucket_list, bucket);
 
 
-	if (hmap_r.ax_hmap->size <= (hmap_r.ax_hmap->buckets >> 2) * hmap_r.ax_hmap->threshold) {
-		rehash(hmap_r.ax_hmap, hmap_r.ax_hmap->buckets >>= 1);
+	if (!hmap_r.ax_hmap->old_tab
+			&& hmap_r.ax_hmap->size <= (hmap_r.ax_hmap->buckets >> 2) * hmap_r.ax_hmap->threshold) {
+		resize(hmap_r.ax_hmap, hmap_r.ax_hmap->buckets >> 1);
 	}
 
 	hmap_r.ax_hmap->size --;
@@ -442,21 +573,35 @@ static ax_fail map_erase (ax_map *map, const void *key)
 	return false;
 }
 
-static void *map_get (const ax_map *map, const void *key)
+static ax_fail map_erase (ax_map *map, const void *key)
 {
 	CHECK_PARAM_NULL(map);
 
+	ax_hmap_r self = AX_R_INIT(ax_map, map);
+	return erase_hashed(map, key, key_hash(self.ax_hmap, key));
+}
+
+static void *get_hashed(const ax_map *map, const void *key, size_t hash)
+{
 	const ax_hmap_cr hmap_r = { .ax_map = map };
 
 	if (!hmap_r.ax_hmap->buckets)
 		return NULL;
 
-	struct bucket_st *bucket = locate_bucket(hmap_r.ax_hmap, key);
-	struct node_st **findpp = find_node(hmap_r.ax_map, bucket, key);
+	struct bucket_st *bucket = locate_bucket(hmap_r.ax_hmap, hash);
+	struct node_st **findpp = find_node(hmap_r.ax_map, bucket, key, hash);
 
 	return findpp ? node_val(hmap_r.ax_map, *findpp) : NULL;
 }
 
+static void *map_get (const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_hmap_cr self = AX_R_INIT(ax_map, map);
+	return get_hashed(map, key, key_hash(self.ax_hmap, key));
+}
+
 
 static ax_iter  map_at(const ax_map *map, const void *key)
 {
@@ -467,8 +612,9 @@ static ax_iter  map_at(const ax_map *map, const void *key)
 	if (!self.ax_hmap->buckets)
 		return box_end((ax_box *)self.ax_box);
 
-	struct bucket_st *bucket = locate_bucket(self.ax_hmap, key);
-	struct node_st **findpp = find_node(self.ax_map, bucket, key);
+	size_t hash = key_hash(self.ax_hmap, key);
+	struct bucket_st *bucket = locate_bucket(self.ax_hmap, hash);
+	struct node_st **findpp = find_node(self.ax_map, bucket, key, hash);
 	if (!findpp) {
 		return box_end((ax_box *)self.ax_box);
 	}
@@ -484,12 +630,8 @@ static bool map_exist (const ax_map *map, const void *key)
 {
 	CHECK_PARAM_NULL(map);
 
-	ax_hmap_r hmap_r = { .ax_map = (ax_map*)map };
-	struct bucket_st *bucket = locate_bucket(hmap_r.ax_hmap, key);
-	struct node_st **findpp = find_node(hmap_r.ax_map, bucket, key);
-	if (findpp)
-		return true;
-	return false;
+	ax_hmap_cr self = AX_R_INIT(ax_map, map);
+	return get_hashed(map, key, key_hash(self.ax_hmap, key)) != NULL;
 }
 
 static void *map_chkey(ax_map *map, const void *key, const void *new_key)
@@ -505,8 +647,9 @@ static void *map_chkey(ax_map *map, const void *key, const void *new_key)
 	if (!self.ax_hmap->buckets)
 		return NULL;
 
-	struct bucket_st *bucket = locate_bucket(self.ax_hmap, key);
-	struct node_st **findpp = find_node(self.ax_map, bucket, key);
+	size_t hash = key_hash(self.ax_hmap, key);
+	struct bucket_st *bucket = locate_bucket(self.ax_hmap, hash);
+	struct node_st **findpp = find_node(self.ax_map, bucket, key, hash);
 	ax_assert(findpp, "key does not exists");
 
 	struct node_st *node = *findpp;
@@ -514,16 +657,89 @@ static void *map_chkey(ax_map *map, const void *key, const void *new_key)
 		return NULL;
 
 	(*findpp) = node->next;
+	if (!bucket->node_list)
+		self.ax_hmap->bucket_list = unlink_bucket(self.ax_hmap->bucket_list, bucket);
 
-	struct bucket_st *new_bucket = locate_bucket(self.ax_hmap, new_key);
-	struct node_st **destpp = find_node(self.ax_map, new_bucket, new_key);
-	if (destpp)
+	size_t new_hash = key_hash(self.ax_hmap, new_key);
+	struct bucket_st *new_bucket = locate_bucket(self.ax_hmap, new_hash);
+	struct node_st **destpp = find_node(self.ax_map, new_bucket, new_key, new_hash);
+	if (destpp) {
 		free_node(self.ax_map, destpp);
+		if (!new_bucket->node_list)
+			self.ax_hmap->bucket_list = unlink_bucket(self.ax_hmap->bucket_list, new_bucket);
+		self.ax_hmap->size--;
+	}
 
+#ifndef AX_HMAP_NO_HASH_CACHE
+	node->hash = new_hash;
+#endif
 	bucket_push_node(self.ax_hmap, new_bucket, node);
 	return node_key(node);
 }
 
+/*
+ * The keys are hashed and their buckets are prefetched before any chain is
+ * walked, so that the cache misses of a batch overlap instead of queuing.
+ */
+static size_t find_batch(const ax_map *map, const void *const keys[], size_t n, struct node_st *nodes[])
+{
+	assert(n <= BATCH_WIDTH);
+
+	const ax_hmap_cr self = AX_R_INIT(ax_map, map);
+	const ax_trait *ktr = KEY_TR(self);
+	size_t hash[BATCH_WIDTH], found = 0;
+	struct bucket_st *bucket[BATCH_WIDTH];
+	const void *key[BATCH_WIDTH];
+
+	for (size_t i = 0; i < n; i++) {
+		key[i] = ax_trait_in(ktr, keys[i]);
+		hash[i] = key_hash(self.ax_hmap, key[i]);
+		bucket[i] = locate_bucket(self.ax_hmap, hash[i]);
+		PREFETCH(bucket[i]);
+	}
+
+	for (size_t i = 0; i < n; i++)
+		if (bucket[i]->node_list)
+			PREFETCH(bucket[i]->node_list);
+
+	for (size_t i = 0; i < n; i++) {
+		struct node_st **findpp = find_node(map, bucket[i], key[i], hash[i]);
+		nodes[i] = findpp ? *findpp : NULL;
+		found += !!findpp;
+	}
+	return found;
+}
+
+static size_t map_get_batch(const ax_map *map, const void *const keys[], size_t n, void *vals[])
+{
+	CHECK_PARAM_NULL(map);
+
+	struct node_st *nodes[BATCH_WIDTH];
+	size_t found = 0;
+	for (size_t base = 0; base < n; base += BATCH_WIDTH) {
+		size_t width = ax_min(n - base, BATCH_WIDTH);
+		found += find_batch(map, keys + base, width, nodes);
+		for (size_t i = 0; i < width; i++)
+			vals[base + i] = nodes[i] ? node_val(map, nodes[i]) : NULL;
+	}
+	return found;
+}
+
+static size_t map_exist_batch(const ax_map *map, const void *const keys[], size_t n, bool exist[])
+{
+	CHECK_PARAM_NULL(map);
+
+	struct node_st *nodes[BATCH_WIDTH];
+	size_t found = 0;
+	for (size_t base = 0; base < n; base += BATCH_WIDTH) {
+		size_t width = ax_min(n - base, BATCH_WIDTH);
+		found += find_batch(map, keys + base, width, nodes);
+		for (size_t i = 0; i < width; i++)
+			exist[base + i] = !!nodes[i];
+	}
+	return found;
+}
+
 static const void *map_it_key(const ax_citer *it)
 {
 	CHECK_PARAM_NULL(it);
@@ -542,6 +758,7 @@ static void one_free(ax_one *one)
 	ax_hmap_r self = AX_R_INIT(ax_one, one);
 	box_clear(self.ax_box);
 	free(self.ax_hmap->bucket_tab);
+	free(self.ax_hmap->old_tab);
 	free(self.ax_hmap);
 }
 
@@ -639,6 +856,11 @@ static void box_clear(ax_box *box)
 	self.ax_hmap->size = 0;
 	self.ax_hmap->bucket_list = NULL;
 	self.ax_hmap->buckets = 1;
+
+	free(self.ax_hmap->old_tab);
+	self.ax_hmap->old_tab = NULL;
+	self.ax_hmap->old_buckets = 0;
+	self.ax_hmap->migrated = 0;
 }
 
 const ax_map_trait ax_hmap_tr =
@@ -680,6 +902,8 @@ const ax_map_trait ax_hmap_tr =
 	.exist = map_exist,
 	.chkey = map_chkey,
 	.itkey = map_it_key,
+	.get_batch = map_get_batch,
+	.exist_batch = map_exist_batch,
 };
 
 ax_map *__ax_hmap_construct(const ax_trait *key_tr, const ax_trait *val_tr)
@@ -704,6 +928,10 @@ ax_map *__ax_hmap_construct(const ax_trait *key_tr, const ax_trait *val_tr)
 		.threshold = DEFAULT_THRESHOLD,
 		.bucket_tab = NULL,
 		.bucket_list = NULL,
+		.old_tab = NULL,
+		.old_buckets = 0,
+		.migrated = 0,
+		.rehash_step = 0,
 	};
 
 	hmap_init.bucket_tab = malloc(sizeof(struct bucket_st) * hmap_init.buckets);
@@ -715,6 +943,34 @@ ax_map *__ax_hmap_construct(const ax_trait *key_tr, const ax_trait *val_tr)
 	return (ax_map *) hmap;
 }
 
+size_t ax_hmap_hash(const ax_hmap *hmap, const void *key)
+{
+	CHECK_PARAM_NULL(hmap);
+
+	return key_hash(hmap, key);
+}
+
+void *ax_hmap_put_hashed(ax_hmap *hmap, const void *key, size_t hash, const void *val)
+{
+	CHECK_PARAM_NULL(hmap);
+
+	return put_hashed(ax_r(ax_hmap, hmap).ax_map, key, hash, val, NULL);
+}
+
+void *ax_hmap_get_hashed(const ax_hmap *hmap, const void *key, size_t hash)
+{
+	CHECK_PARAM_NULL(hmap);
+
+	return get_hashed(ax_cr(ax_hmap, hmap).ax_map, key, hash);
+}
+
+ax_fail ax_hmap_erase_hashed(ax_hmap *hmap, const void *key, size_t hash)
+{
+	CHECK_PARAM_NULL(hmap);
+
+	return erase_hashed(ax_r(ax_hmap, hmap).ax_map, key, hash);
+}
+
 void dump_hmap(ax_hmap *hmap)
 {
 	for (struct bucket_st *b = hmap->bucket_list; b; b = b->next) {
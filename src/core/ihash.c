@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/ihash.h"
+#include "check.h"
+
+#include <stdlib.h>
+
+#define MIN_BUCKETS 16
+
+static ax_fail rehash(ax_ihash *ht, size_t nbuckets)
+{
+	ax_ihash_node **buckets = calloc(nbuckets, sizeof *buckets);
+	if (!buckets)
+		return true;
+
+	for (size_t i = 0; i < ht->nbuckets; i++) {
+		ax_ihash_node *node = ht->buckets[i];
+		while (node) {
+			ax_ihash_node *next = node->next;
+			ax_ihash_node **bucket = buckets + (node->hash & (nbuckets - 1));
+			node->next = *bucket;
+			*bucket = node;
+			node = next;
+		}
+	}
+
+	free(ht->buckets);
+	ht->buckets = buckets;
+	ht->nbuckets = nbuckets;
+	return false;
+}
+
+ax_fail ax_ihash_init(ax_ihash *ht, ax_ihash_equal_f *equal, void *ctx)
+{
+	CHECK_PARAM_NULL(ht);
+	CHECK_PARAM_NULL(equal);
+
+	ht->buckets = calloc(MIN_BUCKETS, sizeof *ht->buckets);
+	if (!ht->buckets)
+		return true;
+	ht->nbuckets = MIN_BUCKETS;
+	ht->size = 0;
+	ht->equal = equal;
+	ht->ctx = ctx;
+	return false;
+}
+
+void ax_ihash_destroy(ax_ihash *ht)
+{
+	if (!ht)
+		return;
+
+	free(ht->buckets);
+	ht->buckets = NULL;
+	ht->nbuckets = 0;
+	ht->size = 0;
+}
+
+ax_fail ax_ihash_reserve(ax_ihash *ht, size_t size)
+{
+	CHECK_PARAM_NULL(ht);
+
+	size_t nbuckets = ht->nbuckets;
+	while (nbuckets < size)
+		nbuckets <<= 1;
+	return nbuckets == ht->nbuckets ? false : rehash(ht, nbuckets);
+}
+
+ax_ihash_node *ax_ihash_find(const ax_ihash *ht, const ax_ihash_node *probe, size_t hash)
+{
+	CHECK_PARAM_NULL(ht);
+	CHECK_PARAM_NULL(probe);
+
+	for (ax_ihash_node *node = ht->buckets[hash & (ht->nbuckets - 1)]; node; node = node->next)
+		if (node->hash == hash && ht->equal(node, probe, ht->ctx))
+			return node;
+	return NULL;
+}
+
+ax_ihash_node *ax_ihash_insert(ax_ihash *ht, ax_ihash_node *node, size_t hash)
+{
+	CHECK_PARAM_NULL(ht);
+	CHECK_PARAM_NULL(node);
+
+	ax_ihash_node *exist = ax_ihash_find(ht, node, hash);
+	if (exist)
+		return exist;
+
+	/* Keep the chains short if possible, a failure only costs speed */
+	if (ht->size >= ht->nbuckets)
+		(void)rehash(ht, ht->nbuckets << 1);
+
+	ax_ihash_node **bucket = ht->buckets + (hash & (ht->nbuckets - 1));
+	node->hash = hash;
+	node->next = *bucket;
+	*bucket = node;
+	ht->size++;
+	return NULL;
+}
+
+void ax_ihash_remove(ax_ihash *ht, ax_ihash_node *node)
+{
+	CHECK_PARAM_NULL(ht);
+	CHECK_PARAM_NULL(node);
+
+	ax_ihash_node **link = ht->buckets + (node->hash & (ht->nbuckets - 1));
+	while (*link != node) {
+		ax_assert(*link, "node is not in the table");
+		link = &(*link)->next;
+	}
+	*link = node->next;
+	node->next = NULL;
+	ht->size--;
+}
+
+static ax_ihash_node *first_from(const ax_ihash *ht, size_t index)
+{
+	for (size_t i = index; i < ht->nbuckets; i++)
+		if (ht->buckets[i])
+			return ht->buckets[i];
+	return NULL;
+}
+
+ax_ihash_node *ax_ihash_first(const ax_ihash *ht)
+{
+	CHECK_PARAM_NULL(ht);
+
+	return first_from(ht, 0);
+}
+
+ax_ihash_node *ax_ihash_next(const ax_ihash *ht, const ax_ihash_node *node)
+{
+	CHECK_PARAM_NULL(ht);
+	CHECK_PARAM_NULL(node);
+
+	if (node->next)
+		return node->next;
+	return first_from(ht, (node->hash & (ht->nbuckets - 1)) + 1);
+}
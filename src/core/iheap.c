@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/iheap.h"
+#include "check.h"
+
+#include <stdlib.h>
+
+#define MIN_CAPACITY 16
+
+#define PARENT(i) (((i) - 1) >> 1)
+#define LEFT_CHILD(i) (((i) << 1) + 1)
+
+inline static void place(ax_iheap *heap, size_t index, ax_iheap_node *node)
+{
+	heap->table[index] = node;
+	node->index = index;
+}
+
+/* Both sift functions move the hole rather than swapping on every level */
+static void sift_up(ax_iheap *heap, size_t index, ax_iheap_node *node)
+{
+	while (index > 0) {
+		ax_iheap_node *parent = heap->table[PARENT(index)];
+		if (!heap->less(node, parent, heap->ctx))
+			break;
+		place(heap, index, parent);
+		index = PARENT(index);
+	}
+	place(heap, index, node);
+}
+
+static void sift_down(ax_iheap *heap, size_t index, ax_iheap_node *node)
+{
+	size_t child;
+	while ((child = LEFT_CHILD(index)) < heap->size) {
+		if (child + 1 < heap->size
+				&& heap->less(heap->table[child + 1], heap->table[child], heap->ctx))
+			child++;
+		if (!heap->less(heap->table[child], node, heap->ctx))
+			break;
+		place(heap, index, heap->table[child]);
+		index = child;
+	}
+	place(heap, index, node);
+}
+
+/* Fill the hole at index with the node, moving it in either direction */
+static void settle(ax_iheap *heap, size_t index, ax_iheap_node *node)
+{
+	if (index > 0 && heap->less(node, heap->table[PARENT(index)], heap->ctx))
+		sift_up(heap, index, node);
+	else
+		sift_down(heap, index, node);
+}
+
+void ax_iheap_destroy(ax_iheap *heap)
+{
+	if (!heap)
+		return;
+
+	for (size_t i = 0; i < heap->size; i++)
+		heap->table[i]->index = AX_IHEAP_NPOS;
+	free(heap->table);
+	heap->table = NULL;
+	heap->size = heap->capacity = 0;
+}
+
+ax_fail ax_iheap_reserve(ax_iheap *heap, size_t size)
+{
+	CHECK_PARAM_NULL(heap);
+
+	if (size <= heap->capacity)
+		return false;
+
+	size_t capacity = heap->capacity ? heap->capacity : MIN_CAPACITY;
+	while (capacity < size)
+		capacity <<= 1;
+
+	ax_iheap_node **table = realloc(heap->table, capacity * sizeof *table);
+	if (!table)
+		return true;
+	heap->table = table;
+	heap->capacity = capacity;
+	return false;
+}
+
+ax_fail ax_iheap_push(ax_iheap *heap, ax_iheap_node *node)
+{
+	CHECK_PARAM_NULL(heap);
+	CHECK_PARAM_NULL(node);
+	CHECK_PARAM_VALIDITY(node, !ax_iheap_node_linked(node));
+
+	if (ax_iheap_reserve(heap, heap->size + 1))
+		return true;
+	sift_up(heap, heap->size++, node);
+	return false;
+}
+
+ax_iheap_node *ax_iheap_pop(ax_iheap *heap)
+{
+	CHECK_PARAM_NULL(heap);
+
+	ax_iheap_node *top = ax_iheap_top(heap);
+	if (top)
+		ax_iheap_remove(heap, top);
+	return top;
+}
+
+void ax_iheap_remove(ax_iheap *heap, ax_iheap_node *node)
+{
+	CHECK_PARAM_NULL(heap);
+	CHECK_PARAM_NULL(node);
+	CHECK_PARAM_VALIDITY(node, node->index < heap->size && heap->table[node->index] == node);
+
+	size_t index = node->index;
+	ax_iheap_node *last = heap->table[--heap->size];
+	if (last != node)
+		settle(heap, index, last);
+	node->index = AX_IHEAP_NPOS;
+}
+
+void ax_iheap_update(ax_iheap *heap, ax_iheap_node *node)
+{
+	CHECK_PARAM_NULL(heap);
+	CHECK_PARAM_NULL(node);
+	CHECK_PARAM_VALIDITY(node, node->index < heap->size && heap->table[node->index] == node);
+
+	settle(heap, node->index, node);
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/irb.h"
+#include "check.h"
+
+static void transplant(ax_irb *tree, ax_irb_node *old, ax_irb_node *node)
+{
+	if (!old->parent)
+		tree->root = node;
+	else if (old == old->parent->left)
+		old->parent->left = node;
+	else
+		old->parent->right = node;
+	if (node)
+		node->parent = old->parent;
+}
+
+static void rotate_left(ax_irb *tree, ax_irb_node *node)
+{
+	ax_irb_node *right = node->right;
+	node->right = right->left;
+	if (right->left)
+		right->left->parent = node;
+	transplant(tree, node, right);
+	right->left = node;
+	node->parent = right;
+}
+
+static void rotate_right(ax_irb *tree, ax_irb_node *node)
+{
+	ax_irb_node *left = node->left;
+	node->left = left->right;
+	if (left->right)
+		left->right->parent = node;
+	transplant(tree, node, left);
+	left->right = node;
+	node->parent = left;
+}
+
+inline static bool is_red(const ax_irb_node *node)
+{
+	return node && node->red;
+}
+
+static ax_irb_node *minimum(ax_irb_node *node)
+{
+	while (node->left)
+		node = node->left;
+	return node;
+}
+
+static ax_irb_node *maximum(ax_irb_node *node)
+{
+	while (node->right)
+		node = node->right;
+	return node;
+}
+
+static void insert_fixup(ax_irb *tree, ax_irb_node *node)
+{
+	ax_irb_node *parent;
+	while ((parent = node->parent) && parent->red) {
+		ax_irb_node *grand = parent->parent;
+		if (parent == grand->left) {
+			ax_irb_node *uncle = grand->right;
+			if (is_red(uncle)) {
+				parent->red = uncle->red = false;
+				grand->red = true;
+				node = grand;
+				continue;
+			}
+			if (node == parent->right) {
+				rotate_left(tree, parent);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->red = false;
+			grand->red = true;
+			rotate_right(tree, grand);
+		} else {
+			ax_irb_node *uncle = grand->left;
+			if (is_red(uncle)) {
+				parent->red = uncle->red = false;
+				grand->red = true;
+				node = grand;
+				continue;
+			}
+			if (node == parent->left) {
+				rotate_right(tree, parent);
+				node = parent;
+				parent = node->parent;
+			}
+			parent->red = false;
+			grand->red = true;
+			rotate_left(tree, grand);
+		}
+	}
+	tree->root->red = false;
+}
+
+/* The node is NULL when the removed black node had no child */
+static void remove_fixup(ax_irb *tree, ax_irb_node *node, ax_irb_node *parent)
+{
+	while (node != tree->root && !is_red(node)) {
+		if (node == parent->left) {
+			ax_irb_node *sibling = parent->right;
+			if (sibling->red) {
+				sibling->red = false;
+				parent->red = true;
+				rotate_left(tree, parent);
+				sibling = parent->right;
+			}
+			if (!is_red(sibling->left) && !is_red(sibling->right)) {
+				sibling->red = true;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+			if (!is_red(sibling->right)) {
+				sibling->left->red = false;
+				sibling->red = true;
+				rotate_right(tree, sibling);
+				sibling = parent->right;
+			}
+			sibling->red = parent->red;
+			parent->red = false;
+			sibling->right->red = false;
+			rotate_left(tree, parent);
+		} else {
+			ax_irb_node *sibling = parent->left;
+			if (sibling->red) {
+				sibling->red = false;
+				parent->red = true;
+				rotate_right(tree, parent);
+				sibling = parent->left;
+			}
+			if (!is_red(sibling->left) && !is_red(sibling->right)) {
+				sibling->red = true;
+				node = parent;
+				parent = node->parent;
+				continue;
+			}
+			if (!is_red(sibling->left)) {
+				sibling->right->red = false;
+				sibling->red = true;
+				rotate_left(tree, sibling);
+				sibling = parent->left;
+			}
+			sibling->red = parent->red;
+			parent->red = false;
+			sibling->left->red = false;
+			rotate_right(tree, parent);
+		}
+		node = tree->root;
+	}
+	if (node)
+		node->red = false;
+}
+
+ax_irb_node *ax_irb_insert(ax_irb *tree, ax_irb_node *node)
+{
+	CHECK_PARAM_NULL(tree);
+	CHECK_PARAM_NULL(node);
+
+	/* The last node on the path not greater than node, compare it once more
+	 * at the end rather than checking equality on every level */
+	ax_irb_node *parent = NULL, *candidate = NULL, **link = &tree->root;
+	while (*link) {
+		parent = *link;
+		if (tree->less(node, parent, tree->ctx))
+			link = &parent->left;
+		else {
+			candidate = parent;
+			link = &parent->right;
+		}
+	}
+	if (candidate && !tree->less(candidate, node, tree->ctx))
+		return candidate;
+
+	node->parent = parent;
+	node->left = node->right = NULL;
+	node->red = true;
+	*link = node;
+	tree->size++;
+	insert_fixup(tree, node);
+	return NULL;
+}
+
+void ax_irb_remove(ax_irb *tree, ax_irb_node *node)
+{
+	CHECK_PARAM_NULL(tree);
+	CHECK_PARAM_NULL(node);
+
+	ax_irb_node *child, *parent;
+	bool red;
+	if (!node->left || !node->right) {
+		child = node->left ? node->left : node->right;
+		parent = node->parent;
+		red = node->red;
+		transplant(tree, node, child);
+	} else {
+		ax_irb_node *next = minimum(node->right);
+		red = next->red;
+		child = next->right;
+		if (next->parent == node)
+			parent = next;
+		else {
+			parent = next->parent;
+			transplant(tree, next, next->right);
+			next->right = node->right;
+			next->right->parent = next;
+		}
+		transplant(tree, node, next);
+		next->left = node->left;
+		next->left->parent = next;
+		next->red = node->red;
+	}
+
+	if (!red)
+		remove_fixup(tree, child, parent);
+	tree->size--;
+	node->parent = node->left = node->right = NULL;
+}
+
+ax_irb_node *ax_irb_lower_bound(const ax_irb *tree, const ax_irb_node *probe)
+{
+	CHECK_PARAM_NULL(tree);
+	CHECK_PARAM_NULL(probe);
+
+	ax_irb_node *node = tree->root, *bound = NULL;
+	while (node) {
+		if (tree->less(node, probe, tree->ctx))
+			node = node->right;
+		else {
+			bound = node;
+			node = node->left;
+		}
+	}
+	return bound;
+}
+
+ax_irb_node *ax_irb_upper_bound(const ax_irb *tree, const ax_irb_node *probe)
+{
+	CHECK_PARAM_NULL(tree);
+	CHECK_PARAM_NULL(probe);
+
+	ax_irb_node *node = tree->root, *bound = NULL;
+	while (node) {
+		if (tree->less(probe, node, tree->ctx)) {
+			bound = node;
+			node = node->left;
+		}
+		else
+			node = node->right;
+	}
+	return bound;
+}
+
+ax_irb_node *ax_irb_find(const ax_irb *tree, const ax_irb_node *probe)
+{
+	ax_irb_node *node = ax_irb_lower_bound(tree, probe);
+	return node && !tree->less(probe, node, tree->ctx) ? node : NULL;
+}
+
+ax_irb_node *ax_irb_first(const ax_irb *tree)
+{
+	CHECK_PARAM_NULL(tree);
+
+	return tree->root ? minimum(tree->root) : NULL;
+}
+
+ax_irb_node *ax_irb_last(const ax_irb *tree)
+{
+	CHECK_PARAM_NULL(tree);
+
+	return tree->root ? maximum(tree->root) : NULL;
+}
+
+ax_irb_node *ax_irb_next(const ax_irb_node *node)
+{
+	CHECK_PARAM_NULL(node);
+
+	if (node->right)
+		return minimum(node->right);
+	while (node->parent && node == node->parent->right)
+		node = node->parent;
+	return node->parent;
+}
+
+ax_irb_node *ax_irb_prev(const ax_irb_node *node)
+{
+	CHECK_PARAM_NULL(node);
+
+	if (node->left)
+		return maximum(node->left);
+	while (node->parent && node == node->parent->left)
+		node = node->parent;
+	return node->parent;
+}
@@ -24,6 +24,7 @@
 #include "ax/iter.h"
 #include "ax/dump.h"
 #include "ax/trait.h"
+#include "check.h"
 
 const void *ax_map_key(ax_map *map, const void *key)
 {
@@ -64,3 +65,76 @@ ax_dump *ax_map_dump(const ax_map *map)
 	
 	return block_dmp;
 }
+
+size_t ax_map_get_batch(ax_map *map, const void *const keys[], size_t n, void *vals[])
+{
+	CHECK_PARAM_NULL(map);
+	CHECK_PARAM_NULL(keys);
+	CHECK_PARAM_NULL(vals);
+
+	const ax_trait *ktr = ax_class_data(map).key_tr,
+	      *vtr = ax_class_data(ax_r(ax_map, map).ax_box).elem_tr;
+	size_t found = 0;
+
+	if (ax_class_trait(map).get_batch)
+		found = ax_class_trait(map).get_batch(map, keys, n, vals);
+	else
+		for (size_t i = 0; i < n; i++) {
+			vals[i] = ax_obj_do(map, get, ax_trait_in(ktr, keys[i]));
+			found += !!vals[i];
+		}
+
+	for (size_t i = 0; i < n; i++)
+		vals[i] = ax_trait_out(vtr, vals[i]);
+	return found;
+}
+
+size_t ax_map_exist_batch(const ax_map *map, const void *const keys[], size_t n, bool exist[])
+{
+	CHECK_PARAM_NULL(map);
+	CHECK_PARAM_NULL(keys);
+	CHECK_PARAM_NULL(exist);
+
+	if (ax_class_trait(map).exist_batch)
+		return ax_class_trait(map).exist_batch(map, keys, n, exist);
+
+	const ax_trait *ktr = ax_class_data(map).key_tr;
+	size_t found = 0;
+	for (size_t i = 0; i < n; i++) {
+		exist[i] = ax_obj_do(map, exist, ax_trait_in(ktr, keys[i]));
+		found += exist[i];
+	}
+	return found;
+}
+
+ax_iter ax_map_select(ax_map *map, size_t index)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_map_r self = AX_R_INIT(ax_map, map);
+	if (ax_class_trait(map).select)
+		return ax_class_trait(map).select(map, index);
+
+	ax_iter it = ax_box_begin(self.ax_box), end = ax_box_end(self.ax_box);
+	for (size_t i = 0; i < index && !ax_iter_equal(&it, &end); i++)
+		ax_iter_next(&it);
+	return it;
+}
+
+size_t ax_map_rank(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	const ax_trait *ktr = ax_class_data(map).key_tr;
+	const void *kin = ax_trait_in(ktr, key);
+	if (ax_class_trait(map).rank)
+		return ax_class_trait(map).rank(map, kin);
+
+	ax_map_cr self = AX_R_INIT(ax_map, map);
+	size_t rank = 0;
+	ax_box_citerate(self.ax_box, it) {
+		const void *k = ax_class_trait(map).itkey(&it);
+		rank += ax_trait_less(ktr, ax_trait_in(ktr, k), kin);
+	}
+	return rank;
+}
@@ -22,6 +22,7 @@
 
 #include "ax/def.h"
 #include "ax/mem.h"
+#include "ax/detect.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -29,6 +30,8 @@
 #include <errno.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <time.h>
 
 #include "check.h"
 
@@ -104,145 +107,268 @@ void *ax_memdup(const void *p, size_t size)
 	return copy;
 }
 
+/*
+ * 64-bit hash of wyhash family, consumes the input 8 or 16 bytes at a time.
+ * The secret is fixed, the seed is picked once per process.
+ */
+
+static const uint64_t hash_secret[4] = {
+	0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+	0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull,
+};
+
+/* A seed of 0 means it is not chosen yet, a chosen 0 is replaced by this */
+#define HASH_SEED_UNSET 0
+#define HASH_SEED_ZERO 0x9e3779b97f4a7c15ull
+
+#if defined(__GNUC__)
+# define SEED_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+# define SEED_CAS(p, expect, desired) \
+	__atomic_compare_exchange_n((p), (expect), (desired), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#elif defined(AX_CC_MSVC)
+# include <intrin.h>
+# define SEED_LOAD(p) ((uint64_t)_InterlockedCompareExchange64((volatile __int64 *)(p), 0, 0))
+inline static bool seed_cas(uint64_t *p, uint64_t *expect, uint64_t desired)
+{
+	uint64_t old = _InterlockedCompareExchange64((volatile __int64 *)p, desired, *expect);
+	if (old == *expect)
+		return true;
+	*expect = old;
+	return false;
+}
+# define SEED_CAS(p, expect, desired) seed_cas((p), (expect), (desired))
+#else
+# error "atomic operations are not supported by the compiler"
+#endif
+
+static uint64_t hash_seed = HASH_SEED_UNSET;
+
+inline static void hash_mum(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+	__extension__ typedef unsigned __int128 u128;
+	u128 r = (u128)*a * *b;
+	*a = (uint64_t)r;
+	*b = (uint64_t)(r >> 64);
+#else
+	uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32), c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	*a = lo;
+	*b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline static uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+	hash_mum(&a, &b);
+	return a ^ b;
+}
+
+inline static uint64_t hash_read8(const ax_byte *p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+inline static uint64_t hash_read4(const ax_byte *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+uint64_t ax_hash64(const void *p, size_t size, uint64_t seed)
+{
+	const ax_byte *b = p;
+	uint64_t x, y;
+
+	seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+	if (size <= 16) {
+		if (size >= 4) {
+			size_t off = (size >> 3) << 2;
+			x = (hash_read4(b) << 32) | hash_read4(b + off);
+			y = (hash_read4(b + size - 4) << 32) | hash_read4(b + size - 4 - off);
+		} else if (size > 0) {
+			x = ((uint64_t)b[0] << 16) | ((uint64_t)b[size >> 1] << 8) | b[size - 1];
+			y = 0;
+		} else
+			x = y = 0;
+	} else {
+		size_t i = size;
+		if (i >= 48) {
+			uint64_t seed1 = seed, seed2 = seed;
+			do {
+				seed = hash_mix(hash_read8(b) ^ hash_secret[1], hash_read8(b + 8) ^ seed);
+				seed1 = hash_mix(hash_read8(b + 16) ^ hash_secret[2], hash_read8(b + 24) ^ seed1);
+				seed2 = hash_mix(hash_read8(b + 32) ^ hash_secret[3], hash_read8(b + 40) ^ seed2);
+				b += 48;
+				i -= 48;
+			} while (i >= 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (i > 16) {
+			seed = hash_mix(hash_read8(b) ^ hash_secret[1], hash_read8(b + 8) ^ seed);
+			b += 16;
+			i -= 16;
+		}
+		x = hash_read8(b + i - 16);
+		y = hash_read8(b + i - 8);
+	}
+
+	x ^= hash_secret[1];
+	y ^= seed;
+	hash_mum(&x, &y);
+	return hash_mix(x ^ hash_secret[0] ^ size, y ^ hash_secret[1]);
+}
+
+uint64_t ax_hash_seed(void)
+{
+	uint64_t seed = SEED_LOAD(&hash_seed);
+	if (seed != HASH_SEED_UNSET)
+		return seed;
+
+	const char *env = getenv("AX_HASH_SEED");
+	if (env) {
+		seed = strtoull(env, NULL, 0);
+	} else {
+		uint64_t local = 0;
+		seed = ax_hash64_thomas((uint64_t)time(NULL))
+			^ ax_hash64_thomas((uint64_t)clock())
+			^ ax_hash64_thomas((uintptr_t)&local)
+			^ (uintptr_t)&hash_seed;
+	}
+	if (seed == HASH_SEED_UNSET)
+		seed = HASH_SEED_ZERO;
+
+	/* Threads racing on the first use all take the seed stored first */
+	uint64_t expect = HASH_SEED_UNSET;
+	if (!SEED_CAS(&hash_seed, &expect, seed))
+		return expect;
+	return seed;
+}
+
+void ax_hash_set_seed(uint64_t seed)
+{
+	if (seed == HASH_SEED_UNSET)
+		seed = HASH_SEED_ZERO;
+
+	uint64_t expect = HASH_SEED_UNSET;
+	if (!SEED_CAS(&hash_seed, &expect, seed))
+		ax_assert(expect == seed, "the hash seed is set after it was used");
+}
+
+uint64_t ax_hash_u64(uint64_t key)
+{
+	return ax_hash64_thomas(key ^ ax_hash_seed());
+}
+
 size_t ax_strhash(const char *s)
 {
 	CHECK_PARAM_NULL(s);
 
-	register size_t h = 5381;
-	int c;
-	while ((c = *s++)) {
-		h = (h ^ (h << 5)) ^ c; /* hash * 33 + c */
-	}
-	return h;
+	return ax_hash64(s, strlen(s), ax_hash_seed());
 }
 
 size_t ax_wcshash(const wchar_t *s)
 {
 	CHECK_PARAM_NULL(s);
 
-	register size_t h = 5381;
-	int c;
-	while ((c = *s++)) {
-		h = (h ^ (h << 5)) ^ c; /* hash * 33 + c */
-	}
-	return h;
+	return ax_hash64(s, wcslen(s) * sizeof(wchar_t), ax_hash_seed());
 }
 
 size_t ax_memhash(const void *p, size_t size)
 {
 	CHECK_PARAM_NULL(p);
 
-	register size_t h = 5381;
-	for (size_t i = 0; i < size; i++) {
-		h = (h ^ (h << 5)) ^ ((ax_byte *)p)[i];
-	}
-	return h;
+	return ax_hash64(p, size, ax_hash_seed());
 }
 
 char *ax_strsplit(char **s, char ch)
 {
 	CHECK_PARAM_NULL(s);
 
-	char *ret;
-	if (*s) {
-		for (char *p = *s; *p; p++) {
-			if (*p != ch)
-				continue;
+	char *ret = *s;
+	if (ret) {
+		char *p = ax_strchrnul(ret, ch);
+		if (*p) {
 			*p = '\0';
-			ret = *s;
 			*s = p + 1;
-			return ret ;
+			return ret;
 		}
-		ret = *s;
-	} else {
-		ret = NULL;
 	}
 	*s = NULL;
 	return ret;
 }
 
-char *ax_strrepl(const char *orig, const char *rep, const char *with)
+/*
+ * Copy the input to the output once, replacing each occurrence of rep as it
+ * is found. The output starts with the size of the input and doubles when it
+ * runs out of space.
+ */
+static void *memrepl(const void *orig, size_t len, const void *rep, size_t len_rep,
+		const void *with, size_t len_with, size_t width)
 {
-	CHECK_PARAM_NULL(orig);
-	CHECK_PARAM_NULL(rep);
-	CHECK_PARAM_NULL(with);
-	ax_assert(rep[0], "length of parameter rep is 0");
-
-	const char *ins;  /* the next insert point */
-	char *result;     /* the return string */
-	char *tmp;        /* varies */
-
-	size_t len_rep,   /* length of rep (the string to remove) */
-	       len_with,  /* length of with (the string to replace rep with) */
-	       len_front, /* distance between rep and end of last rep */
-	       count;     /* number of replacements */
-
-	len_rep = strlen(rep);
-	if (len_rep == 0)
-		return NULL; /* empty rep causes infinite loop during count */
-	len_with = strlen(with);
-
-	/* count the number of replacements needed */
-	ins = orig;
-	for (count = 0; (tmp = strstr(ins, rep)); ++count) {
-		ins = tmp + len_rep;
-	}
-
-	tmp = result = malloc(strlen(orig) + (len_with - len_rep) * count + 1);
-
+	const ax_byte *in = orig, *end = in + len * width;
+	size_t size = (len + 1) * width, used = 0;
+	ax_byte *result = malloc(size);
 	if (!result)
 		return NULL;
 
-	/* first time through the loop, all the variable are set correctly
-	 * from here on,
-	 *    tmp points to the end of the result string
-	 *    ins points to the next occurrence of rep in orig
-	 *    orig points to the remainder of orig after "end of rep" */
-	while (count--) {
-		ins = strstr(orig, rep);
-		len_front = ins - orig;
-		tmp = strncpy(tmp, orig, len_front) + len_front;
-		tmp = strcpy(tmp, with) + len_with;
-		orig += len_front + len_rep; // move to next "end of rep"
+	while (in < end) {
+		const ax_byte *found = ax_memmem(in, end - in, rep, len_rep * width);
+		/* Wide strings must match on a character boundary */
+		while (found && (found - in) % width)
+			found = ax_memmem(found + 1, end - found - 1, rep, len_rep * width);
+		size_t len_front = (found ? found : end) - in;
+		size_t need = used + len_front + (found ? len_with * width : 0) + width;
+		if (need > size) {
+			while (size < need)
+				size <<= 1;
+			ax_byte *new_result = realloc(result, size);
+			if (!new_result) {
+				free(result);
+				return NULL;
+			}
+			result = new_result;
+		}
+		memcpy(result + used, in, len_front);
+		used += len_front;
+		if (!found)
+			break;
+		memcpy(result + used, with, len_with * width);
+		used += len_with * width;
+		in = found + len_rep * width;
 	}
-	strcpy(tmp, orig);
+	memset(result + used, 0, width);
 	return result;
 }
 
-wchar_t *ax_wcsrepl(const wchar_t *orig, const wchar_t *rep, const wchar_t *with)
+char *ax_strrepl(const char *orig, const char *rep, const char *with)
 {
 	CHECK_PARAM_NULL(orig);
 	CHECK_PARAM_NULL(rep);
 	CHECK_PARAM_NULL(with);
 	ax_assert(rep[0], "length of parameter rep is 0");
 
-	const wchar_t *ins;
-	wchar_t *result, *tmp;
-	size_t len_rep, len_with, len_front, count;
-
-	len_rep = wcslen(rep);
-	if (len_rep == 0)
+	if (!rep[0])
 		return NULL;
-	len_with = wcslen(with);
+	return memrepl(orig, strlen(orig), rep, strlen(rep), with, strlen(with), sizeof(char));
+}
 
-	ins = orig;
-	for (count = 0; (tmp = wcsstr(ins, rep)); ++count) {
-		ins = tmp + len_rep;
-	}
+wchar_t *ax_wcsrepl(const wchar_t *orig, const wchar_t *rep, const wchar_t *with)
+{
+	CHECK_PARAM_NULL(orig);
+	CHECK_PARAM_NULL(rep);
+	CHECK_PARAM_NULL(with);
+	ax_assert(rep[0], "length of parameter rep is 0");
 
-	tmp = result = malloc((wcslen(orig) + (len_with - len_rep) * count + 1) * sizeof(wchar_t));
-	if (!result)
+	if (!rep[0])
 		return NULL;
-
-	while (count--) {
-		ins = wcsstr(orig, rep);
-		len_front = ins - orig;
-		tmp = wcsncpy(tmp, orig, len_front) + len_front;
-		tmp = wcscpy(tmp, with) + len_with;
-		orig += len_front + len_rep;
-	}
-	wcscpy(tmp, orig);
-	return result;
+	return memrepl(orig, wcslen(orig), rep, wcslen(rep), with, wcslen(with), sizeof(wchar_t));
 }
 
 uint64_t ax_hash64_thomas(uint64_t key)
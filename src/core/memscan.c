@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/mem.h"
+#include "check.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Search kernels. The portable ones are always built, SSE2 is used whenever
+ * the target has it, and AVX2 is built with a function target attribute and
+ * only selected when the processor reports it at run time.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(USE_SSE2) && defined(__GNUC__) && (defined(__clang__) || __GNUC__ >= 5)
+#define USE_AVX2
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/* The string scan reads whole aligned blocks, which can not cross a page but
+ * may cover bytes past the terminator */
+#if defined(__SANITIZE_ADDRESS__)
+#define NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#endif
+#endif
+#ifndef NO_SANITIZE_ADDRESS
+#define NO_SANITIZE_ADDRESS
+#endif
+
+typedef void *memchr_f(const void *p, int ch, size_t size);
+typedef void *memmem_f(const void *p, size_t size, const void *pat, size_t pat_size);
+
+struct kernel_st
+{
+	memchr_f *memchr;
+	memmem_f *memmem;
+};
+
+inline static int mask_lowest(uint32_t mask)
+{
+#if defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	int i = 0;
+	while (!(mask & 1))
+		mask >>= 1, i++;
+	return i;
+#endif
+}
+
+static void *memchr_generic(const void *p, int ch, size_t size)
+{
+	return memchr(p, ch, size);
+}
+
+/* Candidates are found by the first byte, and filtered by the last one
+ * before the whole pattern is compared */
+static void *memmem_tail(memchr_f *find, const unsigned char *s, size_t size,
+		const unsigned char *pat, size_t pat_size)
+{
+	if (pat_size > size)
+		return NULL;
+	const unsigned char *last = s + size - pat_size;
+	while (s <= last) {
+		s = find(s, pat[0], last - s + 1);
+		if (!s)
+			return NULL;
+		if (s[pat_size - 1] == pat[pat_size - 1] && !memcmp(s + 1, pat + 1, pat_size - 1))
+			return (void *)s;
+		s++;
+	}
+	return NULL;
+}
+
+static void *memmem_generic(const void *p, size_t size, const void *pat, size_t pat_size)
+{
+	return memmem_tail(memchr_generic, p, size, pat, pat_size);
+}
+
+#ifdef USE_SSE2
+
+static void *memchr_sse2(const void *p, int ch, size_t size)
+{
+	const unsigned char *s = p, *end = s + size;
+	if (size < 16)
+		return memchr(p, ch, size);
+
+	const __m128i c = _mm_set1_epi8((char)ch);
+	for (; end - s >= 64; s += 64) {
+		__m128i m0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)s), c);
+		__m128i m1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(s + 16)), c);
+		__m128i m2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(s + 32)), c);
+		__m128i m3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(s + 48)), c);
+		if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))))
+			break;
+	}
+	for (; end - s >= 16; s += 16) {
+		uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)s), c));
+		if (mask)
+			return (void *)(s + mask_lowest(mask));
+	}
+	if (s == end)
+		return NULL;
+
+	/* The last block overlaps bytes already checked */
+	uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(end - 16)), c));
+	mask >>= 16 - (end - s);
+	return mask ? (void *)(s + mask_lowest(mask)) : NULL;
+}
+
+static void *memmem_sse2(const void *p, size_t size, const void *pat, size_t pat_size)
+{
+	const unsigned char *s = p, *n = pat;
+	if (pat_size < 2 || pat_size > size)
+		return pat_size == 1 ? memchr_sse2(p, n[0], size) : memmem_generic(p, size, pat, pat_size);
+
+	const __m128i first = _mm_set1_epi8((char)n[0]);
+	const __m128i last = _mm_set1_epi8((char)n[pat_size - 1]);
+	const unsigned char *end = s + size - pat_size + 1;
+	for (; end - s >= 16; s += 16) {
+		__m128i b0 = _mm_loadu_si128((const __m128i *)s);
+		__m128i b1 = _mm_loadu_si128((const __m128i *)(s + pat_size - 1));
+		uint32_t mask = _mm_movemask_epi8(_mm_and_si128(
+					_mm_cmpeq_epi8(b0, first), _mm_cmpeq_epi8(b1, last)));
+		while (mask) {
+			int i = mask_lowest(mask);
+			if (!memcmp(s + i + 1, n + 1, pat_size - 2))
+				return (void *)(s + i);
+			mask &= mask - 1;
+		}
+	}
+	return memmem_tail(memchr_sse2, s, end - s + pat_size - 1, n, pat_size);
+}
+
+static const struct kernel_st kernel_sse2 = { memchr_sse2, memmem_sse2 };
+
+#endif
+
+#ifdef USE_AVX2
+
+TARGET_AVX2
+static void *memchr_avx2(const void *p, int ch, size_t size)
+{
+	const unsigned char *s = p, *end = s + size;
+	if (size < 32)
+		return memchr_sse2(p, ch, size);
+
+	const __m256i c = _mm256_set1_epi8((char)ch);
+	for (; end - s >= 128; s += 128) {
+		__m256i m0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)s), c);
+		__m256i m1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(s + 32)), c);
+		__m256i m2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(s + 64)), c);
+		__m256i m3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(s + 96)), c);
+		if (_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3))))
+			break;
+	}
+	for (; end - s >= 32; s += 32) {
+		uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)s), c));
+		if (mask)
+			return (void *)(s + mask_lowest(mask));
+	}
+	if (s == end)
+		return NULL;
+
+	uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(end - 32)), c));
+	mask >>= 32 - (end - s);
+	return mask ? (void *)(s + mask_lowest(mask)) : NULL;
+}
+
+TARGET_AVX2
+static void *memmem_avx2(const void *p, size_t size, const void *pat, size_t pat_size)
+{
+	const unsigned char *s = p, *n = pat;
+	if (pat_size < 2 || pat_size > size)
+		return pat_size == 1 ? memchr_avx2(p, n[0], size) : memmem_generic(p, size, pat, pat_size);
+
+	const __m256i first = _mm256_set1_epi8((char)n[0]);
+	const __m256i last = _mm256_set1_epi8((char)n[pat_size - 1]);
+	const unsigned char *end = s + size - pat_size + 1;
+	for (; end - s >= 32; s += 32) {
+		__m256i b0 = _mm256_loadu_si256((const __m256i *)s);
+		__m256i b1 = _mm256_loadu_si256((const __m256i *)(s + pat_size - 1));
+		uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(
+					_mm256_cmpeq_epi8(b0, first), _mm256_cmpeq_epi8(b1, last)));
+		while (mask) {
+			int i = mask_lowest(mask);
+			if (!memcmp(s + i + 1, n + 1, pat_size - 2))
+				return (void *)(s + i);
+			mask &= mask - 1;
+		}
+	}
+	return memmem_tail(memchr_avx2, s, end - s + pat_size - 1, n, pat_size);
+}
+
+static const struct kernel_st kernel_avx2 = { memchr_avx2, memmem_avx2 };
+
+#endif
+
+static const struct kernel_st kernel_generic = { memchr_generic, memmem_generic };
+
+static const struct kernel_st *kernel_select(void)
+{
+#ifdef USE_AVX2
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return &kernel_avx2;
+#endif
+#ifdef USE_SSE2
+	return &kernel_sse2;
+#else
+	return &kernel_generic;
+#endif
+}
+
+static const struct kernel_st *kernel(void)
+{
+	static const struct kernel_st *selected;
+#if defined(__GNUC__)
+	const struct kernel_st *k = __atomic_load_n(&selected, __ATOMIC_ACQUIRE);
+	if (!k) {
+		k = kernel_select();
+		__atomic_store_n(&selected, k, __ATOMIC_RELEASE);
+	}
+#else
+	const struct kernel_st *k = selected;
+	if (!k)
+		selected = k = kernel_select();
+#endif
+	return k;
+}
+
+const char *ax_memscan_kernel(void)
+{
+	const struct kernel_st *k = kernel();
+#ifdef USE_AVX2
+	if (k == &kernel_avx2)
+		return "avx2";
+#endif
+#ifdef USE_SSE2
+	if (k == &kernel_sse2)
+		return "sse2";
+#endif
+	(void)kernel_generic;
+	return "generic";
+}
+
+void *ax_memchr(const void *p, int ch, size_t size)
+{
+	CHECK_PARAM_VALIDITY(p, p || !size);
+	return kernel()->memchr(p, ch, size);
+}
+
+void *ax_memmem(const void *p, size_t size, const void *pat, size_t pat_size)
+{
+	CHECK_PARAM_VALIDITY(p, p || !size);
+	CHECK_PARAM_VALIDITY(pat, pat || !pat_size);
+
+	if (!pat_size)
+		return (void *)p;
+	return kernel()->memmem(p, size, pat, pat_size);
+}
+
+NO_SANITIZE_ADDRESS
+char *ax_strchrnul(const char *s, int ch)
+{
+	CHECK_PARAM_NULL(s);
+#ifdef USE_SSE2
+	const __m128i c = _mm_set1_epi8((char)ch), zero = _mm_setzero_si128();
+	size_t offset = (uintptr_t)s & 15;
+	const __m128i *p = (const __m128i *)(s - offset);
+
+	__m128i b = _mm_load_si128(p);
+	uint32_t mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(b, c), _mm_cmpeq_epi8(b, zero)));
+	mask >>= offset;
+	if (mask)
+		return (char *)s + mask_lowest(mask);
+	for (;;) {
+		b = _mm_load_si128(++p);
+		mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(b, c), _mm_cmpeq_epi8(b, zero)));
+		if (mask)
+			return (char *)p + mask_lowest(mask);
+	}
+#else
+	while (*s && *s != (char)ch)
+		s++;
+	return (char *)s;
+#endif
+}
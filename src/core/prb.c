@@ -0,0 +1,1051 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/prb.h"
+#include "ax/iter.h"
+#include "ax/debug.h"
+#include "ax/trait.h"
+#include "ax/detect.h"
+#include "check.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#if defined(__GNUC__)
+# define REF_INC(p)  __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+# define REF_DEC(p)  __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+# define REF_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#elif defined(AX_CC_MSVC)
+# include <intrin.h>
+# define REF_INC(p)  _InterlockedIncrement(p)
+# define REF_DEC(p)  _InterlockedDecrement(p)
+# define REF_LOAD(p) (*(volatile long *)(p))
+#else
+# error "atomic reference counting is not supported by the compiler"
+#endif
+
+#define KEY_TR(r) ax_class_data(r.ax_map).key_tr
+#define VAL_TR(r) ax_class_data(r.ax_box).elem_tr
+
+#define COLOR_BLACK 0
+#define COLOR_RED   1
+
+/* Enough for the path from root to leaf, plus the path to the successor */
+#define MAX_DEPTH (sizeof(size_t) * CHAR_BIT * 2 + 2)
+
+/*
+ * The pair is allocated right after the node which was created for it, the
+ * copies of the node share the pair, and the memory block is freed along
+ * with the pair when no node refers to it.
+ */
+struct pair_st
+{
+	long ref;
+	ax_byte kvbuffer[];
+};
+
+struct node_st
+{
+	struct node_st *left, *right;
+	struct pair_st *pair;
+	size_t count; /* Nodes in the subtree, for rank and select */
+	long ref;
+	int color;
+};
+
+#define PAIR_OF(node) ((struct pair_st *)((node) + 1))
+
+ax_concrete_begin(ax_prb)
+	struct node_st *root;
+	struct node_st *spare; /* Nodes reserved for copying, linked by left */
+	size_t size;
+	size_t nspare;
+	bool frozen;
+ax_end;
+
+#define CHECK_WRITABLE(tree) ax_assert(!(tree)->frozen, "snapshot is immutable")
+
+static void *map_put(ax_map* map, const void *key, const void *val, va_list *ap);
+static ax_fail map_erase(ax_map* map, const void *key);
+static void *map_get(const ax_map* map, const void *key);
+static ax_iter map_at(const ax_map* map, const void *key);
+static bool map_exist(const ax_map* map, const void *key);
+static const void *map_it_key(const ax_citer *it);
+static ax_iter map_select(const ax_map *map, size_t index);
+static size_t map_rank(const ax_map *map, const void *key);
+static ax_iter map_lower_bound(const ax_map *map, const void *key);
+static ax_iter map_upper_bound(const ax_map *map, const void *key);
+static size_t box_size(const ax_box* box);
+static size_t box_maxsize(const ax_box* box);
+static ax_iter box_begin(ax_box* box);
+static ax_iter box_end(ax_box* box);
+static ax_iter box_rbegin(ax_box* box);
+static ax_iter box_rend(ax_box* box);
+static void box_clear(ax_box* box);
+static ax_dump *any_dump(const ax_any* any);
+static ax_any *any_copy(const ax_any* any);
+static void one_free(ax_one* one);
+static const char *one_name(const ax_one *one);
+static void citer_move(ax_citer *it, long i);
+static void citer_prev(ax_citer *it);
+static void citer_next(ax_citer *it);
+static bool citer_less(const ax_citer *it1, const ax_citer *it2);
+static long citer_dist(const ax_citer *it1, const ax_citer *it2);
+static void rciter_move(ax_citer *it, long i);
+static void rciter_prev(ax_citer *it);
+static void rciter_next(ax_citer *it);
+static bool rciter_less(const ax_citer *it1, const ax_citer *it2);
+static long rciter_dist(const ax_citer *it1, const ax_citer *it2);
+static void *citer_get(const ax_citer *it);
+static void iter_erase(ax_iter *it);
+
+inline static size_t node_count(const struct node_st *node)
+{
+	return node ? node->count : 0;
+}
+
+inline static bool node_is_red(const struct node_st *node)
+{
+	return node && node->color == COLOR_RED;
+}
+
+inline static void *node_key(const struct node_st *node)
+{
+	return node->pair->kvbuffer;
+}
+
+inline static void *node_val(const ax_prb *tree, const struct node_st *node)
+{
+	ax_prb_cr self = AX_R_INIT(ax_prb, tree);
+	return node->pair->kvbuffer + ax_trait_size(KEY_TR(self));
+}
+
+static void pair_release(const ax_trait *ktr, const ax_trait *vtr, struct pair_st *pair)
+{
+	if (REF_DEC(&pair->ref))
+		return;
+	ax_trait_free(ktr, pair->kvbuffer);
+	ax_trait_free(vtr, pair->kvbuffer + ax_trait_size(ktr));
+	free((struct node_st *)pair - 1);
+}
+
+/* Drop a reference to node, the subtree is released when it was the last one */
+static void node_release(const ax_trait *ktr, const ax_trait *vtr, struct node_st *node)
+{
+	while (node && !REF_DEC(&node->ref)) {
+		node_release(ktr, vtr, node->left);
+		struct node_st *right = node->right;
+		struct pair_st *pair = node->pair;
+		if (pair != PAIR_OF(node))
+			free(node);
+		pair_release(ktr, vtr, pair);
+		node = right;
+	}
+}
+
+static struct node_st *node_create(ax_prb *tree, const void *key, const void *val, va_list *ap)
+{
+	ax_prb_r self = AX_R_INIT(ax_prb, tree);
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+
+	struct node_st *node = malloc(sizeof(struct node_st) + sizeof(struct pair_st)
+			+ ax_trait_size(ktr) + ax_trait_size(vtr));
+	if (!node)
+		return NULL;
+
+	struct pair_st *pair = PAIR_OF(node);
+	if (ax_trait_copy(ktr, pair->kvbuffer, key))
+		goto fail;
+	if (ax_trait_copy_or_init(vtr, pair->kvbuffer + ax_trait_size(ktr), val, ap)) {
+		ax_trait_free(ktr, pair->kvbuffer);
+		goto fail;
+	}
+	pair->ref = 1;
+	node->pair = pair;
+	node->left = node->right = NULL;
+	node->count = 1;
+	node->ref = 1;
+	node->color = COLOR_RED;
+	return node;
+fail:
+	free(node);
+	return NULL;
+}
+
+/*
+ * Top up the spare nodes for the worst case of one update, 3 times the
+ * maximum height, so an update never fails after the tree is modified.
+ */
+static ax_fail reserve(ax_prb *tree)
+{
+	size_t height = 2;
+	for (size_t n = tree->size + 1; n; n >>= 1)
+		height += 2;
+
+	while (tree->nspare < 3 * height) {
+		struct node_st *node = malloc(sizeof *node);
+		if (!node)
+			return true;
+		node->left = tree->spare;
+		tree->spare = node;
+		tree->nspare++;
+	}
+	return false;
+}
+
+/* Make the node in slot private to the tree, copying it if it is shared */
+static struct node_st *own(ax_prb *tree, struct node_st **slot)
+{
+	struct node_st *node = *slot;
+	if (REF_LOAD(&node->ref) == 1)
+		return node;
+
+	ax_assert(tree->spare, "no spare node reserved");
+	struct node_st *copy = tree->spare;
+	tree->spare = copy->left;
+	tree->nspare--;
+
+	copy->left = node->left;
+	copy->right = node->right;
+	copy->pair = node->pair;
+	copy->count = node->count;
+	copy->color = node->color;
+	copy->ref = 1;
+	if (copy->left)
+		REF_INC(&copy->left->ref);
+	if (copy->right)
+		REF_INC(&copy->right->ref);
+	REF_INC(&copy->pair->ref);
+	*slot = copy;
+
+	ax_prb_r self = AX_R_INIT(ax_prb, tree);
+	node_release(KEY_TR(self), VAL_TR(self), node);
+	return copy;
+}
+
+/* The slot referring to path[i], path[0] is the root */
+inline static struct node_st **slot_of(ax_prb *tree, struct node_st **path, size_t i)
+{
+	if (i == 0)
+		return &tree->root;
+	return path[i - 1]->left == path[i] ? &path[i - 1]->left : &path[i - 1]->right;
+}
+
+/* Own the nodes on the search path of key, returns the length of the path */
+static size_t own_path(ax_prb *tree, const void *key, struct node_st **path, bool *found)
+{
+	ax_prb_r self = AX_R_INIT(ax_prb, tree);
+	const ax_trait *ktr = KEY_TR(self);
+
+	struct node_st **slot = &tree->root;
+	size_t n = 0;
+	*found = false;
+	while (*slot) {
+		struct node_st *node = own(tree, slot);
+		path[n++] = node;
+		if (ax_trait_equal(ktr, key, node_key(node))) {
+			*found = true;
+			break;
+		}
+		slot = ax_trait_less(ktr, key, node_key(node)) ? &node->left : &node->right;
+	}
+	return n;
+}
+
+inline static void rotate_left(struct node_st **slot)
+{
+	struct node_st *x = *slot, *y = x->right;
+	x->right = y->left;
+	y->left = x;
+	*slot = y;
+	y->count = x->count;
+	x->count = node_count(x->left) + node_count(x->right) + 1;
+}
+
+inline static void rotate_right(struct node_st **slot)
+{
+	struct node_st *x = *slot, *y = x->left;
+	x->left = y->right;
+	y->right = x;
+	*slot = y;
+	y->count = x->count;
+	x->count = node_count(x->left) + node_count(x->right) + 1;
+}
+
+/* path[i] is the red node just attached, all nodes on the path are owned */
+static void insert_fixup(ax_prb *tree, struct node_st **path, size_t i)
+{
+	while (i >= 2 && path[i - 1]->color == COLOR_RED) {
+		struct node_st *node = path[i], *parent = path[i - 1], *grand = path[i - 2];
+		bool parent_is_left = grand->left == parent;
+		struct node_st **uncle_slot = parent_is_left ? &grand->right : &grand->left;
+
+		if (node_is_red(*uncle_slot)) {
+			struct node_st *uncle = own(tree, uncle_slot);
+			parent->color = uncle->color = COLOR_BLACK;
+			grand->color = COLOR_RED;
+			i -= 2;
+			continue;
+		}
+
+		struct node_st **grand_slot = slot_of(tree, path, i - 2);
+		if (parent_is_left) {
+			if (parent->right == node)
+				rotate_left(&grand->left);
+			rotate_right(grand_slot);
+		} else {
+			if (parent->left == node)
+				rotate_right(&grand->right);
+			rotate_left(grand_slot);
+		}
+		(*grand_slot)->color = COLOR_BLACK;
+		grand->color = COLOR_RED;
+		break;
+	}
+	tree->root->color = COLOR_BLACK;
+}
+
+/*
+ * The subtree at the left of path[depth - 1] if is_left is true, otherwise
+ * at the right, is short of one black node
+ */
+static void erase_fixup(ax_prb *tree, struct node_st **path, size_t depth, bool is_left)
+{
+	while (depth > 0) {
+		struct node_st *parent = path[depth - 1];
+		struct node_st **sibling_slot = is_left ? &parent->right : &parent->left;
+		struct node_st *sibling = *sibling_slot;
+		ax_assert(sibling, "sibling of the short subtree is missing");
+
+		if (sibling->color == COLOR_RED) {
+			/* Case 1: turn the sibling into a black one */
+			sibling = own(tree, sibling_slot);
+			sibling->color = COLOR_BLACK;
+			parent->color = COLOR_RED;
+			struct node_st **parent_slot = slot_of(tree, path, depth - 1);
+			if (is_left)
+				rotate_left(parent_slot);
+			else
+				rotate_right(parent_slot);
+			path[depth - 1] = sibling;
+			path[depth] = parent;
+			depth++;
+			sibling_slot = is_left ? &parent->right : &parent->left;
+			sibling = *sibling_slot;
+		}
+
+		if (!node_is_red(sibling->left) && !node_is_red(sibling->right)) {
+			/* Case 2: move the shortage up */
+			sibling = own(tree, sibling_slot);
+			sibling->color = COLOR_RED;
+			if (parent->color == COLOR_RED) {
+				parent->color = COLOR_BLACK;
+				return;
+			}
+			depth--;
+			if (depth > 0)
+				is_left = path[depth - 1]->left == parent;
+			continue;
+		}
+
+		sibling = own(tree, sibling_slot);
+		struct node_st **parent_slot = slot_of(tree, path, depth - 1);
+		if (is_left) {
+			if (!node_is_red(sibling->right)) {
+				/* Case 3: make the far nephew red */
+				own(tree, &sibling->left)->color = COLOR_BLACK;
+				sibling->color = COLOR_RED;
+				rotate_right(sibling_slot);
+				sibling = *sibling_slot;
+			}
+			/* Case 4 */
+			own(tree, &sibling->right)->color = COLOR_BLACK;
+			sibling->color = parent->color;
+			parent->color = COLOR_BLACK;
+			rotate_left(parent_slot);
+		} else {
+			if (!node_is_red(sibling->left)) {
+				own(tree, &sibling->right)->color = COLOR_BLACK;
+				sibling->color = COLOR_RED;
+				rotate_left(sibling_slot);
+				sibling = *sibling_slot;
+			}
+			own(tree, &sibling->left)->color = COLOR_BLACK;
+			sibling->color = parent->color;
+			parent->color = COLOR_BLACK;
+			rotate_right(parent_slot);
+		}
+		return;
+	}
+}
+
+/* Remove path[n - 1] from the tree, all nodes on the path are owned */
+static void remove_at(ax_prb *tree, struct node_st **path, size_t n)
+{
+	size_t top = n - 1;
+	struct node_st *node = path[top];
+
+	if (node->left && node->right) {
+		/* The successor takes the place of node */
+		struct node_st **slot = &node->right;
+		for (;;) {
+			struct node_st *next = own(tree, slot);
+			path[n++] = next;
+			if (!next->left)
+				break;
+			slot = &next->left;
+		}
+	}
+
+	for (size_t i = 0; i < n - 1; i++)
+		path[i]->count--;
+
+	struct node_st *y = path[n - 1];
+	struct node_st *x = y->left ? y->left : y->right;
+	bool is_left = n >= 2 && path[n - 2]->left == y;
+	int y_color = y->color;
+	*slot_of(tree, path, n - 1) = x;
+
+	if (y != node) {
+		y->left = node->left;
+		y->right = node->right;
+		y->color = node->color;
+		y->count = node->count;
+		*slot_of(tree, path, top) = y;
+		path[top] = y;
+	}
+
+	node->left = node->right = NULL;
+	ax_prb_r self = AX_R_INIT(ax_prb, tree);
+	node_release(KEY_TR(self), VAL_TR(self), node);
+
+	size_t depth = n - 1;
+	if (y_color == COLOR_BLACK) {
+		struct node_st **x_slot = depth == 0 ? &tree->root
+			: (is_left ? &path[depth - 1]->left : &path[depth - 1]->right);
+		if (node_is_red(x))
+			own(tree, x_slot)->color = COLOR_BLACK;
+		else
+			erase_fixup(tree, path, depth, is_left);
+	}
+}
+
+static struct node_st *find_node(const ax_prb *tree, const void *key)
+{
+	ax_prb_cr self = AX_R_INIT(ax_prb, tree);
+	const ax_trait *ktr = KEY_TR(self);
+
+	struct node_st *node = tree->root;
+	while (node) {
+		if (ax_trait_equal(ktr, key, node_key(node)))
+			break;
+		node = ax_trait_less(ktr, key, node_key(node)) ? node->left : node->right;
+	}
+	return node;
+}
+
+/* The first node whose key is not less than key, or greater than key if upper is true */
+static struct node_st *bound_node(const ax_prb *tree, const void *key, bool upper)
+{
+	ax_prb_cr self = AX_R_INIT(ax_prb, tree);
+	const ax_trait *ktr = KEY_TR(self);
+	struct node_st *node = tree->root, *bound = NULL;
+	while (node) {
+		if (upper ? ax_trait_less(ktr, key, node_key(node)) : !ax_trait_less(ktr, node_key(node), key)) {
+			bound = node;
+			node = node->left;
+		} else
+			node = node->right;
+	}
+	return bound;
+}
+
+/* The last node whose key is less than key */
+static struct node_st *below_node(const ax_prb *tree, const void *key)
+{
+	ax_prb_cr self = AX_R_INIT(ax_prb, tree);
+	const ax_trait *ktr = KEY_TR(self);
+	struct node_st *node = tree->root, *below = NULL;
+	while (node) {
+		if (ax_trait_less(ktr, node_key(node), key)) {
+			below = node;
+			node = node->right;
+		} else
+			node = node->left;
+	}
+	return below;
+}
+
+inline static struct node_st *lowest_node(struct node_st *node)
+{
+	if (node)
+		while (node->left)
+			node = node->left;
+	return node;
+}
+
+inline static struct node_st *highest_node(struct node_st *node)
+{
+	if (node)
+		while (node->right)
+			node = node->right;
+	return node;
+}
+
+static struct node_st *higher_node(const ax_prb *tree, struct node_st *node)
+{
+	return node->right ? lowest_node(node->right) : bound_node(tree, node_key(node), true);
+}
+
+static struct node_st *lower_node(const ax_prb *tree, struct node_st *node)
+{
+	return node->left ? highest_node(node->left) : below_node(tree, node_key(node));
+}
+
+static struct node_st *select_node(const ax_prb *tree, size_t index)
+{
+	struct node_st *node = tree->root;
+	while (node) {
+		size_t left = node_count(node->left);
+		if (index < left)
+			node = node->left;
+		else if (index == left)
+			break;
+		else {
+			index -= left + 1;
+			node = node->right;
+		}
+	}
+	return node;
+}
+
+static size_t key_rank(const ax_prb *tree, const void *key)
+{
+	ax_prb_cr self = AX_R_INIT(ax_prb, tree);
+	const ax_trait *ktr = KEY_TR(self);
+	size_t rank = 0;
+	for (struct node_st *node = tree->root; node; ) {
+		if (ax_trait_less(ktr, node_key(node), key)) {
+			rank += node_count(node->left) + 1;
+			node = node->right;
+		} else
+			node = node->left;
+	}
+	return rank;
+}
+
+/* Position of node in key order, the end is at size */
+static size_t node_rank(const ax_prb *tree, const struct node_st *node)
+{
+	return node ? key_rank(tree, node_key(node)) : tree->size;
+}
+
+/* Position in reverse order, the end is at size */
+static size_t node_rrank(const ax_prb *tree, const struct node_st *node)
+{
+	return node ? tree->size - 1 - node_rank(tree, node) : tree->size;
+}
+
+inline static ax_iter make_iter(const ax_prb *tree, struct node_st *node, bool norm)
+{
+	ax_prb_cr self = AX_R_INIT(ax_prb, tree);
+	return (ax_iter) {
+		.owner = (void *)tree,
+		.point = node,
+		.tr = norm ? &ax_prb_tr.ax_box.iter : &ax_prb_tr.ax_box.riter,
+		.etr = VAL_TR(self),
+	};
+}
+
+static void citer_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_prb *tree = it->owner;
+	it->point = it->point ? lower_node(tree, it->point) : highest_node(tree->root);
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	ax_assert(it->point != NULL, "iterator boundary exceeded");
+	it->point = higher_node(it->owner, it->point);
+}
+
+static bool citer_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	if (!it1->point || !it2->point)
+		return !!it1->point;
+	ax_prb_cr self = AX_R_INIT(ax_one, it1->owner);
+	return ax_trait_less(KEY_TR(self), node_key(it1->point), node_key(it2->point));
+}
+
+static long citer_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_prb *tree = it1->owner;
+	return (long)node_rank(tree, it2->point) - (long)node_rank(tree, it1->point);
+}
+
+static void citer_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_prb *tree = it->owner;
+	long rank = (long)node_rank(tree, it->point) + i;
+	ax_assert(rank >= 0 && rank <= (long)tree->size, "iterator boundary exceeded");
+	it->point = select_node(tree, rank);
+}
+
+static void rciter_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_prb *tree = it->owner;
+	it->point = it->point ? higher_node(tree, it->point) : lowest_node(tree->root);
+}
+
+static void rciter_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	ax_assert(it->point != NULL, "iterator boundary exceeded");
+	it->point = lower_node(it->owner, it->point);
+}
+
+static bool rciter_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	if (!it1->point || !it2->point)
+		return !!it1->point;
+	ax_prb_cr self = AX_R_INIT(ax_one, it1->owner);
+	return ax_trait_less(KEY_TR(self), node_key(it2->point), node_key(it1->point));
+}
+
+static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_prb *tree = it1->owner;
+	return (long)node_rrank(tree, it2->point) - (long)node_rrank(tree, it1->point);
+}
+
+static void rciter_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	const ax_prb *tree = it->owner;
+	size_t size = tree->size;
+	long rrank = (long)node_rrank(tree, it->point) + i;
+	ax_assert(rrank >= 0 && rrank <= (long)size, "iterator boundary exceeded");
+	it->point = (size_t)rrank == size ? NULL : select_node(tree, size - 1 - rrank);
+}
+
+static void *citer_get(const ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point && it->tr);
+	return node_val(it->owner, it->point);
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(it->point);
+
+	ax_prb_r self = AX_R_INIT(ax_one, it->owner);
+	CHECK_WRITABLE(self.ax_prb);
+
+	/* Nodes may be copied by erasing, find the next one by its key later */
+	struct node_st *next = ax_iter_norm(it)
+		? higher_node(self.ax_prb, it->point)
+		: lower_node(self.ax_prb, it->point);
+	struct pair_st *next_pair = next ? next->pair : NULL;
+	if (next_pair)
+		REF_INC(&next_pair->ref);
+
+	ax_fail fail = map_erase(self.ax_map, node_key(it->point));
+	ax_assert(!fail, "failed to reserve nodes for erasing");
+	ax_unused(fail);
+
+	it->point = NULL;
+	if (next_pair) {
+		it->point = find_node(self.ax_prb, next_pair->kvbuffer);
+		pair_release(KEY_TR(self), VAL_TR(self), next_pair);
+	}
+}
+
+static void *map_put(ax_map* map, const void *key, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_r self = AX_R_INIT(ax_map, map);
+	ax_prb *tree = self.ax_prb;
+	const ax_trait *vtr = VAL_TR(self);
+	CHECK_WRITABLE(tree);
+
+	if (reserve(tree))
+		return NULL;
+
+	struct node_st *path[MAX_DEPTH];
+	bool found;
+	size_t n = own_path(tree, key, path, &found);
+
+	if (found) {
+		struct node_st *node = path[n - 1];
+		if (REF_LOAD(&node->pair->ref) == 1) {
+			/* The pair is private, set the value in place */
+			void *ptr = node_val(tree, node);
+			ax_byte tmp[ax_trait_size(vtr)]; // Backup old value
+			memcpy(tmp, ptr, ax_trait_size(vtr));
+			if (ax_trait_copy_or_init(vtr, ptr, val, ap)) {
+				memcpy(ptr, tmp, ax_trait_size(vtr)); // Restore old value
+				return NULL;
+			}
+			ax_trait_free(vtr, tmp);
+			return ptr;
+		}
+
+		/* The pair is seen by other versions, replace the node with a new one */
+		struct node_st *new_node = node_create(tree, key, val, ap);
+		if (!new_node)
+			return NULL;
+		new_node->left = node->left;
+		new_node->right = node->right;
+		new_node->color = node->color;
+		new_node->count = node->count;
+		*slot_of(tree, path, n - 1) = new_node;
+		node->left = node->right = NULL;
+		node_release(KEY_TR(self), vtr, node);
+		return node_val(tree, new_node);
+	}
+
+	struct node_st *new_node = node_create(tree, key, val, ap);
+	if (!new_node)
+		return NULL;
+
+	if (n == 0)
+		tree->root = new_node;
+	else if (ax_trait_less(KEY_TR(self), key, node_key(path[n - 1])))
+		path[n - 1]->left = new_node;
+	else
+		path[n - 1]->right = new_node;
+
+	for (size_t i = 0; i < n; i++)
+		path[i]->count++;
+	path[n] = new_node;
+	insert_fixup(tree, path, n);
+	tree->size++;
+
+	return node_val(tree, new_node);
+}
+
+static ax_fail map_erase(ax_map* map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_r self = AX_R_INIT(ax_map, map);
+	ax_prb *tree = self.ax_prb;
+	CHECK_WRITABLE(tree);
+
+	if (!find_node(tree, key))
+		return true;
+
+	if (reserve(tree))
+		return true;
+
+	struct node_st *path[MAX_DEPTH];
+	bool found;
+	size_t n = own_path(tree, key, path, &found);
+	remove_at(tree, path, n);
+	tree->size--;
+	return false;
+}
+
+static void *map_get(const ax_map* map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_cr self = AX_R_INIT(ax_map, map);
+	struct node_st *node = find_node(self.ax_prb, key);
+	return node ? node_val(self.ax_prb, node) : NULL;
+}
+
+static ax_iter map_at(const ax_map* map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_cr self = AX_R_INIT(ax_map, map);
+	return make_iter(self.ax_prb, find_node(self.ax_prb, key), true);
+}
+
+static bool map_exist(const ax_map* map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_cr self = AX_R_INIT(ax_map, map);
+	return !!find_node(self.ax_prb, key);
+}
+
+static ax_iter map_select(const ax_map *map, size_t index)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_cr self = AX_R_INIT(ax_map, map);
+	return make_iter(self.ax_prb, select_node(self.ax_prb, index), true);
+}
+
+static size_t map_rank(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_cr self = AX_R_INIT(ax_map, map);
+	return key_rank(self.ax_prb, key);
+}
+
+static ax_iter map_lower_bound(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_cr self = AX_R_INIT(ax_map, map);
+	return make_iter(self.ax_prb, bound_node(self.ax_prb, key, false), true);
+}
+
+static ax_iter map_upper_bound(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_prb_cr self = AX_R_INIT(ax_map, map);
+	return make_iter(self.ax_prb, bound_node(self.ax_prb, key, true), true);
+}
+
+static const void *map_it_key(const ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->point && it->tr);
+	CHECK_ITER_TYPE(it, one_name(NULL));
+	const ax_map *map = it->owner;
+	return ax_trait_out(ax_class_data(map).key_tr, node_key(it->point));
+}
+
+static void one_free(ax_one* one)
+{
+	if (!one)
+		return;
+
+	ax_prb_r self = AX_R_INIT(ax_one, one);
+	node_release(KEY_TR(self), VAL_TR(self), self.ax_prb->root);
+	while (self.ax_prb->spare) {
+		struct node_st *node = self.ax_prb->spare;
+		self.ax_prb->spare = node->left;
+		free(node);
+	}
+	free(one);
+}
+
+static const char *one_name(const ax_one *one)
+{
+	return ax_class_name(4, ax_prb);
+}
+
+static ax_dump *any_dump(const ax_any *any)
+{
+	ax_map_cr self = AX_R_INIT(ax_any, any);
+	return ax_map_dump(self.ax_map);
+}
+
+static ax_prb *share(const ax_prb *tree, bool frozen)
+{
+	ax_prb_cr src = AX_R_INIT(ax_prb, tree);
+	ax_prb_r dst = { .ax_map = __ax_prb_construct(KEY_TR(src), VAL_TR(src)) };
+	if (!dst.ax_map)
+		return NULL;
+
+	if (tree->root)
+		REF_INC(&tree->root->ref);
+	dst.ax_prb->root = tree->root;
+	dst.ax_prb->size = tree->size;
+	dst.ax_prb->frozen = frozen;
+	return dst.ax_prb;
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_prb_cr self = AX_R_INIT(ax_any, any);
+	ax_prb *copy = share(self.ax_prb, false);
+	return copy ? ax_r(ax_prb, copy).ax_any : NULL;
+}
+
+static size_t box_size(const ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_prb_cr self = AX_R_INIT(ax_box, box);
+	return self.ax_prb->size;
+}
+
+static size_t box_maxsize(const ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return SIZE_MAX;
+}
+
+static ax_iter box_begin(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_prb_r self = AX_R_INIT(ax_box, box);
+	return make_iter(self.ax_prb, lowest_node(self.ax_prb->root), true);
+}
+
+static ax_iter box_end(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_prb_r self = AX_R_INIT(ax_box, box);
+	return make_iter(self.ax_prb, NULL, true);
+}
+
+static ax_iter box_rbegin(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_prb_r self = AX_R_INIT(ax_box, box);
+	return make_iter(self.ax_prb, highest_node(self.ax_prb->root), false);
+}
+
+static ax_iter box_rend(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_prb_r self = AX_R_INIT(ax_box, box);
+	return make_iter(self.ax_prb, NULL, false);
+}
+
+static void box_clear(ax_box* box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_prb_r self = AX_R_INIT(ax_box, box);
+	CHECK_WRITABLE(self.ax_prb);
+
+	node_release(KEY_TR(self), VAL_TR(self), self.ax_prb->root);
+	self.ax_prb->root = NULL;
+	self.ax_prb->size = 0;
+}
+
+ax_map *ax_prb_snapshot(const ax_prb *prb)
+{
+	CHECK_PARAM_NULL(prb);
+
+	ax_prb *snapshot = share(prb, true);
+	return snapshot ? ax_r(ax_prb, snapshot).ax_map : NULL;
+}
+
+const ax_map_trait ax_prb_tr =
+{
+	.ax_box = {
+		.ax_any = {
+			.ax_one = {
+				.name  = one_name,
+				.free  = one_free,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+		},
+		.iter = {
+			.norm = true,
+			.type = AX_IT_BID,
+			.move = citer_move,
+			.prev = citer_prev,
+			.next = citer_next,
+			.less = citer_less,
+			.dist = citer_dist,
+			.get    = citer_get,
+			.set    = NULL,
+			.erase  = iter_erase,
+		},
+		.riter = {
+			.norm = false,
+			.type = AX_IT_BID,
+			.move = rciter_move,
+			.prev = rciter_prev,
+			.next = rciter_next,
+			.less = rciter_less,
+			.dist = rciter_dist,
+			.get    = citer_get,
+			.set    = NULL,
+			.erase  = iter_erase,
+		},
+
+		.size    = box_size,
+		.maxsize = box_maxsize,
+		.begin   = box_begin,
+		.end     = box_end,
+		.rbegin  = box_rbegin,
+		.rend    = box_rend,
+		.clear   = box_clear,
+	},
+	.put   = map_put,
+	.get   = map_get,
+	.at    = map_at,
+	.erase = map_erase,
+	.exist = map_exist,
+	.itkey = map_it_key,
+	.select = map_select,
+	.rank  = map_rank,
+	.lower_bound = map_lower_bound,
+	.upper_bound = map_upper_bound,
+};
+
+ax_map *__ax_prb_construct(const ax_trait* key_tr, const ax_trait* val_tr)
+{
+	CHECK_PARAM_NULL(key_tr);
+	CHECK_PARAM_NULL(val_tr);
+
+	ax_prb *prb = malloc(sizeof(ax_prb));
+	if (!prb)
+		return NULL;
+
+	ax_prb prb_init = {
+		.ax_map = {
+			.tr = &ax_prb_tr,
+			.env.key_tr = key_tr,
+			.env.ax_box.elem_tr = val_tr,
+		},
+		.root = NULL,
+		.spare = NULL,
+		.size = 0,
+		.nspare = 0,
+		.frozen = false,
+	};
+
+	memcpy(prb, &prb_init, sizeof prb_init);
+	return ax_r(ax_prb, prb).ax_map;
+}
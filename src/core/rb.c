@@ -47,6 +47,7 @@ ax_concrete_begin(ax_rb)
 #ifndef USE_AUGMENTED_PTR
 		unsigned int color;
 #endif
+		size_t count; /* Nodes in the subtree, for rank and select */
 		ax_byte kvbuffer[];
 	} *root;
 size_t size;
@@ -87,10 +88,16 @@ static ax_dump *any_dump(const ax_any* any);
 static ax_any *any_copy(const ax_any* any);
 static void one_free(ax_one* one);
 static const char *one_name(const ax_one *one);
+static ax_iter map_select(const ax_map *map, size_t index);
+static size_t map_rank(const ax_map *map, const void *key);
+static ax_iter map_lower_bound(const ax_map *map, const void *key);
+static ax_iter map_upper_bound(const ax_map *map, const void *key);
+static void citer_move(ax_citer *it, long i);
 static void citer_prev(ax_citer *it);
 static void citer_next(ax_citer *it);
 static bool citer_less(const ax_citer *it1, const ax_citer *it2);
 static long citer_dist(const ax_citer *it1, const ax_citer *it2);
+static void rciter_move(ax_citer *it, long i);
 static void rciter_prev(ax_citer *it);
 static void rciter_next(ax_citer *it);
 static bool rciter_less(const ax_citer *it1, const ax_citer *it2);
@@ -105,11 +112,15 @@ inline static struct node_st *get_grandparent(struct node_st *node);
 inline static void rotate_left(ax_rb *tree, struct node_st *node);
 inline static void rotate_right(ax_rb *tree, struct node_st *node);
 static struct node_st *rb_tree_find(const ax_rb *tree, const void *key);
-static void insert_rebalance(ax_rb *tree, struct node_st *node);
+static bool insert_rebalance(ax_rb *tree, struct node_st *node);
 static int rb_tree_find_or_insert(struct ax_rb_st  *tree, const void *key, struct node_st *new_candidate, struct node_st **value);
 static struct node_st *rb_tree_find_successor(struct node_st *node);
 static struct node_st *rb_tree_find_predecessor(struct node_st *node);
 
+inline static size_t node_count(const struct node_st *node)
+{
+	return node ? node->count : 0;
+}
 
 
 static struct node_st *rb_tree_find(const ax_rb *tree, const void *key)
@@ -174,6 +185,9 @@ inline static void rotate_left(ax_rb *tree, struct node_st *node)
 
 	y->left = x;
 	NODE_SET_PARENT(x, y);
+
+	y->count = x->count;
+	x->count = 1 + node_count(x->left) + node_count(x->right);
 }
 
 /* Helper function to do a right rotation of a given node */
@@ -204,12 +218,17 @@ inline static void rotate_right(ax_rb *tree, struct node_st *node)
 
 	y->right = x;
 	NODE_SET_PARENT(x, y);
+
+	y->count = x->count;
+	x->count = 1 + node_count(x->left) + node_count(x->right);
 }
 
-/* Function to perform a RB tree rebalancing after an insertion */
-static void insert_rebalance(ax_rb *tree, struct node_st *node)
+/* Function to perform a RB tree rebalancing after an insertion, return true
+ * if the root was colored red, which grows the black height of the tree */
+static bool insert_rebalance(ax_rb *tree, struct node_st *node)
 {
 	struct node_st *new_node_parent = NODE_GET_PARENT(node);
+	bool grown = false;
 
 	if (new_node_parent != NULL && NODE_GET_COLOR(new_node_parent) != COLOR_BLACK) {
 		struct node_st *pnode = node;
@@ -272,8 +291,10 @@ static void insert_rebalance(ax_rb *tree, struct node_st *node)
 
 		/* Make sure the tree root is black (Case 1: Continued) */
 		struct node_st *tree_root = tree->root;
+		grown = NODE_GET_COLOR(tree_root) == COLOR_RED;
 		NODE_SET_COLOR(tree_root, COLOR_BLACK);
 	}
+	return grown;
 }
 
 #if 0
@@ -365,6 +386,14 @@ static int rb_tree_find_or_insert(struct ax_rb_st  *tree, const void *key, struc
 
 	struct node_st *node_prev = NULL;
 	int dir = 0, rightmost = 1;
+
+	/* A key greater than all is appended without searching */
+	if (ax_trait_less(ax_class_data(self.ax_map).key_tr, tree->rightmost->kvbuffer, key)) {
+		node_prev = tree->rightmost;
+		dir = 1;
+		node = NULL;
+	}
+
 	while (node != NULL) {
 
 		if (ax_trait_equal(ax_class_data(self.ax_map).key_tr, key, node->kvbuffer)) {
@@ -398,6 +427,9 @@ static int rb_tree_find_or_insert(struct ax_rb_st  *tree, const void *key, struc
 	NODE_SET_PARENT(new_candidate, node_prev);
 	//ax_trait_copy(tree->map.env.key_tr, new_candidate->kvbuffer, key);
 
+	for (struct node_st *parent = node_prev; parent; parent = NODE_GET_PARENT(parent))
+		parent->count++;
+
 	node = new_candidate;
 
 	NODE_SET_COLOR(node, COLOR_RED);
@@ -476,6 +508,7 @@ static void swap_node(struct ax_rb_st *tree, struct node_st *x, struct node_st *
 	x->left = NULL;
 
 	NODE_SET_COLOR(y, NODE_GET_COLOR(x));
+	y->count = x->count;
 	x->parent = NULL;
 }
 
@@ -566,6 +599,10 @@ static void rb_tree_remove(struct ax_rb_st *tree, struct node_st *node)
 		y = rb_tree_find_successor(node);
 	}
 
+	/* y is unlinked from the tree, and takes the place of node if they differ */
+	for (struct node_st *parent = NODE_GET_PARENT(y); parent; parent = NODE_GET_PARENT(parent))
+		parent->count--;
+
 	struct node_st *x, *xp;
 
 	x = (y->left != NULL) ?  y->left : y->right;
@@ -682,6 +719,42 @@ static struct node_st *higher_node(const ax_map *map, struct node_st *node)
 	return node;
 }
 
+static struct node_st *select_node(const ax_rb *tree, size_t index)
+{
+	struct node_st *node = tree->root;
+	while (node) {
+		size_t left = node_count(node->left);
+		if (index < left)
+			node = node->left;
+		else if (index == left)
+			break;
+		else {
+			index -= left + 1;
+			node = node->right;
+		}
+	}
+	return node;
+}
+
+/* Position of node in key order, the end is at size */
+static size_t node_rank(const ax_rb *tree, const struct node_st *node)
+{
+	if (!node)
+		return tree->size;
+
+	size_t rank = node_count(node->left);
+	for (const struct node_st *parent; (parent = NODE_GET_PARENT(node)); node = parent)
+		if (parent->right == node)
+			rank += node_count(parent->left) + 1;
+	return rank;
+}
+
+/* Position in reverse order, the end is at size */
+static size_t node_rrank(const ax_rb *tree, const struct node_st *node)
+{
+	return node ? tree->size - 1 - node_rank(tree, node) : tree->size;
+}
+
 static void remove_child(struct node_st *node) {
 	if (node) {
 		remove_child(node->left);
@@ -719,27 +792,17 @@ static long citer_dist(const ax_citer *it1, const ax_citer *it2)
 	CHECK_ITER_COMPARABLE(it1, it2);
 
 	ax_rb_cr self = AX_R_INIT(ax_one, it1->owner);
+	return (long)node_rank(self.ax_rb, it2->point) - (long)node_rank(self.ax_rb, it1->point);
+}
 
-	struct node_st *node1 = it1->point;
-	struct node_st *node2 = it2->point;
-	struct node_st *cur = lowest_node(self.ax_rb->root);
-
-	size_t loc1, loc2;
-	loc1 = loc2 = self.ax_rb->size;
-
-	int found = !node1 + !node2;
-
-	for (int i = 0; found < 2 && cur; i++) {
-		if (cur == node1)
-			loc1 = i, found++;
-		if (cur == node2)
-			loc2 = i, found++;
-		cur = higher_node(self.ax_map, cur);
-	}
-
-	ax_assert(found == 2, "bad iterator");
+static void citer_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
 
-	return loc2 - loc1;
+	ax_rb_cr self = AX_R_INIT(ax_one, it->owner);
+	long rank = (long)node_rank(self.ax_rb, it->point) + i;
+	ax_assert(rank >= 0 && rank <= (long)self.ax_rb->size, "iterator boundary exceeded");
+	it->point = select_node(self.ax_rb, rank);
 }
 
 static void rciter_prev(ax_citer *it)
@@ -768,7 +831,21 @@ static bool rciter_less(const ax_citer *it1, const ax_citer *it2)
 
 static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
 {
-	return citer_dist(it2, it1);
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	ax_rb_cr self = AX_R_INIT(ax_one, it1->owner);
+	return (long)node_rrank(self.ax_rb, it2->point) - (long)node_rrank(self.ax_rb, it1->point);
+}
+
+static void rciter_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_VALIDITY(it, it->owner && it->tr);
+
+	ax_rb_cr self = AX_R_INIT(ax_one, it->owner);
+	size_t size = self.ax_rb->size;
+	long rrank = (long)node_rrank(self.ax_rb, it->point) + i;
+	ax_assert(rrank >= 0 && rrank <= (long)size, "iterator boundary exceeded");
+	it->point = (size_t)rrank == size ? NULL : select_node(self.ax_rb, size - 1 - rrank);
 }
 
 static void *citer_get(const ax_citer *it)
@@ -835,6 +912,7 @@ static void *map_put(ax_map* map, const void *key, const void *val, va_list *ap)
 	if (node == NULL)
 		return NULL;
 	node->left = node->right = node->parent = NULL;
+	node->count = 1;
 
 	struct node_st * candidate = NULL;
 	char *valptr = NULL;
@@ -921,6 +999,78 @@ static bool map_exist(const ax_map* map, const void *key)
 	return !!node;
 }
 
+static ax_iter map_select(const ax_map *map, size_t index)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_rb_cr self = AX_R_INIT(ax_map, map);
+	return (ax_iter) {
+		.owner = (void *)map,
+		.point = select_node(self.ax_rb, index),
+		.tr = &ax_rb_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+}
+
+static size_t map_rank(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_rb_cr self = AX_R_INIT(ax_map, map);
+	const ax_trait *ktr = KEY_TR(self);
+	size_t rank = 0;
+	for (struct node_st *node = self.ax_rb->root; node; ) {
+		if (ax_trait_less(ktr, node->kvbuffer, key)) {
+			rank += node_count(node->left) + 1;
+			node = node->right;
+		} else
+			node = node->left;
+	}
+	return rank;
+}
+
+/* The first node whose key is not less than key, or greater than key if upper is true */
+static struct node_st *bound_node(const ax_rb *tree, const void *key, bool upper)
+{
+	ax_rb_cr self = AX_R_INIT(ax_rb, tree);
+	const ax_trait *ktr = KEY_TR(self);
+	struct node_st *node = tree->root, *bound = NULL;
+	while (node) {
+		if (upper ? ax_trait_less(ktr, key, node->kvbuffer) : !ax_trait_less(ktr, node->kvbuffer, key)) {
+			bound = node;
+			node = node->left;
+		} else
+			node = node->right;
+	}
+	return bound;
+}
+
+static ax_iter map_lower_bound(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_rb_cr self = AX_R_INIT(ax_map, map);
+	return (ax_iter) {
+		.owner = (void *)map,
+		.point = bound_node(self.ax_rb, key, false),
+		.tr = &ax_rb_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+}
+
+static ax_iter map_upper_bound(const ax_map *map, const void *key)
+{
+	CHECK_PARAM_NULL(map);
+
+	ax_rb_cr self = AX_R_INIT(ax_map, map);
+	return (ax_iter) {
+		.owner = (void *)map,
+		.point = bound_node(self.ax_rb, key, true),
+		.tr = &ax_rb_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+}
+
 static const void *map_it_key(const ax_citer *it)
 {
 	CHECK_PARAM_VALIDITY(it, it->owner && it->point && it->tr);
@@ -1069,6 +1219,462 @@ static void box_clear(ax_box* box)
 	self.ax_rb->size = 0;
 }
 
+/* Pairs read by ax_rb_build, either from arrays or from a map iterator */
+struct pair_src_st
+{
+	const ax_trait *ktr, *vtr;
+	const ax_byte *keys, *vals;
+	ax_citer it;
+	const void *key;
+};
+
+static void pair_src_next(struct pair_src_st *src, const void **key, const void **val)
+{
+	if (src->keys) {
+		*key = src->keys;
+		*val = src->vals;
+		src->keys += ax_trait_size(src->ktr);
+		if (src->vals)
+			src->vals += ax_trait_size(src->vtr);
+		return;
+	}
+
+	src->key = ax_class_trait((const ax_map *)src->it.owner).itkey(&src->it);
+	*key = ax_trait_in(src->ktr, src->key);
+	*val = src->it.tr->get(&src->it);
+	ax_citer_next(&src->it);
+}
+
+static void free_node(ax_rb *tree, struct node_st *node)
+{
+	ax_rb_r self = AX_R_INIT(ax_rb, tree);
+	const ax_trait *ktr = KEY_TR(self), *vtr = VAL_TR(self);
+	ax_trait_free(ktr, node->kvbuffer);
+	ax_trait_free(vtr, node->kvbuffer + ax_trait_size(ktr));
+	free(node);
+}
+
+static void free_subtree(ax_rb *tree, struct node_st *node)
+{
+	if (!node)
+		return;
+
+	free_subtree(tree, node->left);
+	free_subtree(tree, node->right);
+	free_node(tree, node);
+}
+
+/*
+ * Build a subtree of the next n pairs in order. The subtree sizes on both
+ * sides differ at most by one, so only the nodes below the perfect part of
+ * the tree are at red_depth, and they are colored red.
+ */
+static struct node_st *build_subtree(ax_rb *tree, struct pair_src_st *src, size_t n,
+		size_t depth, size_t red_depth, struct node_st **last)
+{
+	const ax_trait *ktr = src->ktr, *vtr = src->vtr;
+	size_t nleft = (n - 1) / 2, nright = n - 1 - nleft;
+
+	struct node_st *left = NULL, *right = NULL, *node = NULL;
+	if (nleft && !(left = build_subtree(tree, src, nleft, depth + 1, red_depth, last)))
+		return NULL;
+
+	const void *key, *val;
+	pair_src_next(src, &key, &val);
+	ax_assert(!*last || ax_trait_less(ktr, (*last)->kvbuffer, key),
+			"keys are not in strictly ascending order");
+
+	node = malloc(sizeof(struct node_st) + ax_trait_size(ktr) + ax_trait_size(vtr));
+	if (!node)
+		goto fail;
+	if (ax_trait_copy(ktr, node->kvbuffer, key)) {
+		free(node);
+		goto fail;
+	}
+	if (ax_trait_copy_or_init(vtr, node->kvbuffer + ax_trait_size(ktr), val, NULL)) {
+		ax_trait_free(ktr, node->kvbuffer);
+		free(node);
+		goto fail;
+	}
+	node->parent = NULL;
+	node->left = left;
+	node->right = NULL;
+	*last = node;
+
+	if (nright && !(right = build_subtree(tree, src, nright, depth + 1, red_depth, last))) {
+		left = node;
+		goto fail;
+	}
+	node->right = right;
+
+	if (left)
+		NODE_SET_PARENT(left, node);
+	if (right)
+		NODE_SET_PARENT(right, node);
+	NODE_SET_COLOR(node, depth == red_depth ? COLOR_RED : COLOR_BLACK);
+	node->count = n;
+	return node;
+fail:
+	free_subtree(tree, left);
+	return NULL;
+}
+
+static ax_fail build(ax_rb *tree, struct pair_src_st *src, size_t n)
+{
+	if (!n)
+		return false;
+
+	if (tree->root) {
+		ax_rb_r self = AX_R_INIT(ax_rb, tree);
+		for (size_t i = 0; i < n; i++) {
+			const void *key, *val;
+			pair_src_next(src, &key, &val);
+			if (!map_put(self.ax_map, key, val, NULL))
+				return true;
+		}
+		return false;
+	}
+
+	/* Depth below the perfect part, which is floor(log2(n + 1)) */
+	size_t red_depth = 1;
+	while (red_depth < sizeof(size_t) * 8 - 1 && ((size_t)2 << red_depth) - 1 <= n)
+		red_depth++;
+
+	struct node_st *last = NULL;
+	struct node_st *root = build_subtree(tree, src, n, 0, red_depth, &last);
+	if (!root)
+		return true;
+
+	tree->root = root;
+	tree->rightmost = last;
+	tree->size = n;
+	return false;
+}
+
+ax_fail ax_rb_build(ax_rb *rb, const void *keys, const void *vals, size_t n)
+{
+	CHECK_PARAM_NULL(rb);
+	CHECK_PARAM_VALIDITY(keys, keys || !n);
+
+	ax_rb_r self = AX_R_INIT(ax_rb, rb);
+	struct pair_src_st src = {
+		.ktr = KEY_TR(self),
+		.vtr = VAL_TR(self),
+		.keys = keys,
+		.vals = vals,
+	};
+	return build(rb, &src, n);
+}
+
+ax_fail ax_rb_build_range(ax_rb *rb, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(rb);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_ITER_COMPARABLE(first, last);
+
+	ax_rb_r self = AX_R_INIT(ax_rb, rb);
+	CHECK_PARAM_VALIDITY(first, ax_class_data((const ax_map *)first->owner).key_tr == KEY_TR(self));
+	CHECK_PARAM_VALIDITY(first, first->etr == VAL_TR(self));
+
+	size_t n = 0;
+	if (first->tr->dist)
+		n = ax_citer_dist(first, last);
+	else
+		for (ax_citer it = *first; !ax_citer_equal(&it, last); ax_citer_next(&it))
+			n++;
+
+	struct pair_src_st src = {
+		.ktr = KEY_TR(self),
+		.vtr = VAL_TR(self),
+		.it = *first,
+	};
+	return build(rb, &src, n);
+}
+
+/*
+ * Split, join and the set operations below work on detached subtrees, whose
+ * roots have no parent and are colored black. The black height of a subtree
+ * is carried along with it, so joining two subtrees only walks down the
+ * spine of the higher one, by the difference of their black heights.
+ */
+struct subtree_st
+{
+	struct node_st *root;
+	size_t bh;
+};
+
+static const struct subtree_st empty_subtree = { NULL, 0 };
+
+/* Detach a child of the black root whose black height is bh */
+static struct subtree_st detach(struct node_st *child, size_t bh)
+{
+	if (!child)
+		return empty_subtree;
+
+	NODE_SET_PARENT(child, NULL);
+	if (NODE_GET_COLOR(child) == COLOR_RED) {
+		NODE_SET_COLOR(child, COLOR_BLACK);
+		return (struct subtree_st) { child, bh };
+	}
+	return (struct subtree_st) { child, bh - 1 };
+}
+
+/* Join l, k and r, all keys in l are less than the key of k, which is less than all keys in r */
+static struct subtree_st join(struct subtree_st l, struct node_st *k, struct subtree_st r)
+{
+	k->parent = NULL;
+	if (l.bh == r.bh) {
+		k->left = l.root;
+		k->right = r.root;
+		if (l.root)
+			NODE_SET_PARENT(l.root, k);
+		if (r.root)
+			NODE_SET_PARENT(r.root, k);
+		k->count = 1 + node_count(l.root) + node_count(r.root);
+		NODE_SET_COLOR(k, COLOR_BLACK);
+		return (struct subtree_st) { k, l.bh + 1 };
+	}
+
+	/* Walk down the spine of the higher subtree to a black node, at which
+	 * the black height is the same as the lower one */
+	bool right = l.bh > r.bh;
+	struct subtree_st high = right ? l : r, low = right ? r : l;
+	struct node_st *parent = NULL, *cur = high.root;
+	size_t bh = high.bh;
+	while (cur && (NODE_GET_COLOR(cur) == COLOR_RED || bh != low.bh)) {
+		if (NODE_GET_COLOR(cur) == COLOR_BLACK)
+			bh--;
+		cur->count += 1 + node_count(low.root);
+		parent = cur;
+		cur = right ? cur->right : cur->left;
+	}
+
+	/* Replace cur with k, which is red and takes cur and the lower subtree as children */
+	NODE_SET_PARENT(k, parent);
+	NODE_SET_COLOR(k, COLOR_RED);
+	if (right) {
+		k->left = cur;
+		k->right = low.root;
+		parent->right = k;
+	} else {
+		k->left = low.root;
+		k->right = cur;
+		parent->left = k;
+	}
+	if (cur)
+		NODE_SET_PARENT(cur, k);
+	if (low.root)
+		NODE_SET_PARENT(low.root, k);
+	k->count = 1 + node_count(k->left) + node_count(k->right);
+
+	ax_rb tmp = { .root = high.root };
+	if (insert_rebalance(&tmp, k))
+		high.bh++;
+	high.root = tmp.root;
+	return high;
+}
+
+/* Remove the lowest node from t, the rest is returned by rest */
+static struct node_st *split_first(struct subtree_st t, struct subtree_st *rest)
+{
+	struct node_st *node = t.root;
+	struct subtree_st left = detach(node->left, t.bh), right = detach(node->right, t.bh);
+	if (!left.root) {
+		*rest = right;
+		return node;
+	}
+
+	struct node_st *first = split_first(left, rest);
+	*rest = join(*rest, node, right);
+	return first;
+}
+
+/* Join l and r, all keys in l are less than all keys in r */
+static struct subtree_st join2(struct subtree_st l, struct subtree_st r)
+{
+	if (!l.root)
+		return r;
+	if (!r.root)
+		return l;
+
+	struct subtree_st rest;
+	struct node_st *first = split_first(r, &rest);
+	return join(l, first, rest);
+}
+
+/* Split t by key into l and r, the node of key is neither of them but returned */
+static struct node_st *split(const ax_trait *ktr, struct subtree_st t, const void *key,
+		struct subtree_st *l, struct subtree_st *r)
+{
+	if (!t.root) {
+		*l = *r = empty_subtree;
+		return NULL;
+	}
+
+	struct node_st *node = t.root, *found;
+	struct subtree_st left = detach(node->left, t.bh), right = detach(node->right, t.bh);
+	if (ax_trait_less(ktr, key, node->kvbuffer)) {
+		found = split(ktr, left, key, l, r);
+		*r = join(*r, node, right);
+	} else if (ax_trait_less(ktr, node->kvbuffer, key)) {
+		found = split(ktr, right, key, l, r);
+		*l = join(left, node, *l);
+	} else {
+		*l = left;
+		*r = right;
+		found = node;
+	}
+	return found;
+}
+
+/* Pairs of t2 replace the ones of the same keys in t1 */
+static struct subtree_st unite(ax_rb *tree, struct subtree_st t1, struct subtree_st t2)
+{
+	if (!t1.root)
+		return t2;
+	if (!t2.root)
+		return t1;
+
+	ax_rb_r self = AX_R_INIT(ax_rb, tree);
+	struct node_st *node = t2.root, *found;
+	struct subtree_st l1, r1,
+			  l2 = detach(node->left, t2.bh),
+			  r2 = detach(node->right, t2.bh);
+	found = split(KEY_TR(self), t1, node->kvbuffer, &l1, &r1);
+	if (found)
+		free_node(tree, found);
+	l1 = unite(tree, l1, l2);
+	r1 = unite(tree, r1, r2);
+	return join(l1, node, r1);
+}
+
+/* If keep is true, free the nodes of t1 whose keys are not in the subtree of
+ * n2, otherwise free the ones whose keys are in it */
+static struct subtree_st filter(ax_rb *tree, struct subtree_st t1, const struct node_st *n2, bool keep)
+{
+	if (!t1.root)
+		return t1;
+	if (!n2) {
+		if (keep) {
+			free_subtree(tree, t1.root);
+			return empty_subtree;
+		}
+		return t1;
+	}
+
+	ax_rb_r self = AX_R_INIT(ax_rb, tree);
+	struct subtree_st l1, r1;
+	struct node_st *found = split(KEY_TR(self), t1, n2->kvbuffer, &l1, &r1);
+	l1 = filter(tree, l1, n2->left, keep);
+	r1 = filter(tree, r1, n2->right, keep);
+	if (found) {
+		if (keep)
+			return join(l1, found, r1);
+		free_node(tree, found);
+	}
+	return join2(l1, r1);
+}
+
+static struct subtree_st take_tree(ax_rb *tree)
+{
+	struct subtree_st t = { tree->root, 0 };
+	if (t.root) {
+		NODE_SET_COLOR(t.root, COLOR_BLACK);
+		for (struct node_st *node = t.root; node; node = node->left)
+			if (NODE_GET_COLOR(node) == COLOR_BLACK)
+				t.bh++;
+	}
+	tree->root = NULL;
+	tree->rightmost = NULL;
+	tree->size = 0;
+	return t;
+}
+
+static void put_tree(ax_rb *tree, struct subtree_st t)
+{
+	tree->root = t.root;
+	tree->rightmost = t.root ? highest_node(t.root) : NULL;
+	tree->size = node_count(t.root);
+}
+
+inline static bool same_traits(const ax_rb *rb1, const ax_rb *rb2, bool with_val)
+{
+	ax_rb_cr r1 = AX_R_INIT(ax_rb, rb1), r2 = AX_R_INIT(ax_rb, rb2);
+	return KEY_TR(r1) == KEY_TR(r2) && (!with_val || VAL_TR(r1) == VAL_TR(r2));
+}
+
+inline static bool ordered_trees(const ax_rb *left, const ax_rb *right)
+{
+	ax_rb_cr self = AX_R_INIT(ax_rb, left);
+	return !left->root || !right->root
+		|| ax_trait_less(KEY_TR(self), left->rightmost->kvbuffer, lowest_node(right->root)->kvbuffer);
+}
+
+void ax_rb_split(ax_rb *rb, const void *key, ax_rb *right)
+{
+	CHECK_PARAM_NULL(rb);
+	CHECK_PARAM_NULL(right);
+	CHECK_PARAM_VALIDITY(right, right != rb && !right->root);
+	CHECK_PARAM_VALIDITY(right, same_traits(rb, right, true));
+
+	ax_rb_r self = AX_R_INIT(ax_rb, rb);
+
+	struct subtree_st l, r;
+	struct node_st *found = split(KEY_TR(self), take_tree(rb), ax_trait_in(KEY_TR(self), key), &l, &r);
+	if (found)
+		r = join(empty_subtree, found, r);
+	put_tree(rb, l);
+	put_tree(right, r);
+}
+
+void ax_rb_join(ax_rb *rb, ax_rb *right)
+{
+	CHECK_PARAM_NULL(rb);
+	CHECK_PARAM_NULL(right);
+
+	CHECK_PARAM_VALIDITY(right, right != rb);
+	CHECK_PARAM_VALIDITY(right, same_traits(rb, right, true));
+	CHECK_PARAM_VALIDITY(right, ordered_trees(rb, right));
+
+	struct subtree_st l = take_tree(rb), r = take_tree(right);
+	put_tree(rb, join2(l, r));
+}
+
+void ax_rb_union(ax_rb *rb, ax_rb *other)
+{
+	CHECK_PARAM_NULL(rb);
+	CHECK_PARAM_NULL(other);
+
+	CHECK_PARAM_VALIDITY(other, other != rb);
+	CHECK_PARAM_VALIDITY(other, same_traits(rb, other, true));
+
+	struct subtree_st t1 = take_tree(rb), t2 = take_tree(other);
+	put_tree(rb, unite(rb, t1, t2));
+}
+
+void ax_rb_intersection(ax_rb *rb, const ax_rb *other)
+{
+	CHECK_PARAM_NULL(rb);
+	CHECK_PARAM_NULL(other);
+
+	CHECK_PARAM_VALIDITY(other, other != rb);
+	CHECK_PARAM_VALIDITY(other, same_traits(rb, other, false));
+
+	put_tree(rb, filter(rb, take_tree(rb), other->root, true));
+}
+
+void ax_rb_difference(ax_rb *rb, const ax_rb *other)
+{
+	CHECK_PARAM_NULL(rb);
+	CHECK_PARAM_NULL(other);
+
+	CHECK_PARAM_VALIDITY(other, other != rb);
+	CHECK_PARAM_VALIDITY(other, same_traits(rb, other, false));
+
+	put_tree(rb, filter(rb, take_tree(rb), other->root, false));
+}
+
 const ax_map_trait ax_rb_tr =
 {
 	.ax_box = {
@@ -1083,7 +1689,7 @@ const ax_map_trait ax_rb_tr =
 		.iter = {
 			.norm = true,
 			.type = AX_IT_BID,
-			.move = NULL,
+			.move = citer_move,
 			.prev = citer_prev,
 			.next = citer_next,
 			.less = citer_less,
@@ -1095,7 +1701,7 @@ const ax_map_trait ax_rb_tr =
 		.riter = {
 			.norm = false,
 			.type = AX_IT_BID,
-			.move = NULL,
+			.move = rciter_move,
 			.prev = rciter_prev,
 			.next = rciter_next,
 			.less = rciter_less,
@@ -1119,6 +1725,10 @@ const ax_map_trait ax_rb_tr =
 	.erase = map_erase,
 	.exist = map_exist,
 	.itkey = map_it_key,
+	.select = map_select,
+	.rank  = map_rank,
+	.lower_bound = map_lower_bound,
+	.upper_bound = map_upper_bound,
 };
 
 ax_map *__ax_rb_construct(const ax_trait* key_tr, const ax_trait* val_tr)
@@ -71,9 +71,22 @@ ax_fail ax_seq_push_arraya(ax_seq *seq, const void *arrp)
 	int esize = ax_trait_size(ax_class_data(self.ax_box).elem_tr);
 	ax_assert(size % esize == 0,
 			"different size of elements with seq and arraya");
-	const ax_byte *p = arrp;
+	return ax_seq_push_n(seq, arrp, size / esize);
+}
+
+ax_fail ax_seq_push_n(ax_seq *seq, const void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(arr, arr || n == 0);
+
+	if (seq->tr->push_n)
+		return seq->tr->push_n(seq, arr, n);
+
+	ax_seq_cr self = AX_R_INIT(ax_seq, seq);
+	size_t esize = ax_trait_size(ax_class_data(self.ax_box).elem_tr);
+	const ax_byte *p = arr;
 	size_t i;
-	for (i = 0; i < size / esize; i++) {
+	for (i = 0; i < n; i++) {
 		if (seq->tr->push(seq, p + esize * i, NULL))
 			goto fail;
 	}
@@ -81,5 +94,53 @@ ax_fail ax_seq_push_arraya(ax_seq *seq, const void *arrp)
 fail:
 	for (size_t j = 0; j < i; j++)
 		seq->tr->pop(seq);
-	return true;;
+	return true;
+}
+
+ax_fail ax_seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_ITER_COMPARABLE(first, last);
+	CHECK_PARAM_VALIDITY(first, first->owner != seq);
+
+	if (seq->tr->insert_range)
+		return seq->tr->insert_range(seq, it, first, last);
+
+	ax_citer cur = *first;
+	size_t n = 0;
+	for (; !ax_citer_equal(&cur, last); ax_citer_next(&cur)) {
+		if (seq->tr->insert(seq, it, cur.tr->get(&cur), NULL))
+			goto fail;
+		n++;
+	}
+	return false;
+fail:
+	/* Elements inserted lie just before it, erasing moves it forward */
+	for (size_t i = 0; i < n; i++)
+		ax_iter_prev(it);
+	for (size_t i = 0; i < n; i++)
+		ax_iter_erase(it);
+	return true;
+}
+
+void ax_seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(first);
+	CHECK_PARAM_NULL(last);
+	CHECK_ITER_COMPARABLE(first, last);
+	CHECK_PARAM_VALIDITY(first, first->owner == seq);
+
+	if (seq->tr->erase_range) {
+		seq->tr->erase_range(seq, first, last);
+		return;
+	}
+
+	size_t n = ax_citer_range_size(ax_iter_cc(first), ax_iter_cc(last));
+	for (size_t i = 0; i < n; i++)
+		ax_iter_erase(first);
+	*last = *first;
 }
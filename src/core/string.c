@@ -22,7 +22,6 @@
 
 #include "ax/string.h"
 #include "ax/vector.h"
-#include "ax/buff.h"
 #include "ax/iter.h"
 #include "ax/mem.h"
 #include "ax/log.h"
@@ -33,12 +32,40 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+# define REF_INC(p)  __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+# define REF_DEC(p)  __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+# define REF_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+# define FLAG_SET(p)  __atomic_store_n((p), 1, __ATOMIC_RELAXED)
+# define FLAG_LOAD(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#elif defined(AX_CC_MSVC)
+# include <intrin.h>
+# define REF_INC(p)  _InterlockedIncrement(p)
+# define REF_DEC(p)  _InterlockedDecrement(p)
+# define REF_LOAD(p) (*(volatile long *)(p))
+# define FLAG_SET(p)  _InterlockedExchange((p), 1)
+# define FLAG_LOAD(p) (*(volatile long *)(p))
+#else
+# error "atomic reference counting is not supported by the compiler"
+#endif
 
-
-#define MIN_SIZE 16
+/* Heap buffer shared by the strings copied or cut from each other, the
+ * content is read-only as long as more than one string refers to it */
+struct shared_st
+{
+	long ref;
+	size_t capacity;
+	char data[];
+};
 
 ax_concrete_begin(ax_string)
-	ax_buff_r buff;
+	char *ptr;
+	size_t size;
+	struct shared_st *shared;
+	long pinned;
+	char store[AX_STRING_INLINE_CAPACITY + 1];
 ax_end;
 
 static void    citer_move(ax_citer *it, long i);
@@ -46,6 +73,7 @@ static void    citer_prev(ax_citer *it);
 static void    citer_next(ax_citer *it);
 static ax_fail citer_less(const ax_citer *it1, const ax_citer *it2);
 static long    citer_dist(const ax_citer *it1, const ax_citer *it2);
+static size_t  citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr);
 
 static void    rciter_move(ax_citer *it, long i);
 static void    rciter_prev(ax_citer *it);
@@ -71,6 +99,9 @@ static ax_fail seq_pop(ax_seq *seq);
 static ax_fail seq_trunc(ax_seq *seq, size_t size);
 static ax_iter seq_at(const ax_seq *seq, size_t index);
 static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val, va_list *ap);
+static ax_fail seq_push_n(ax_seq *seq, const void *arr, size_t n);
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static void    seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
 
 static size_t  box_size(const ax_box* box);
 static size_t  box_maxsize(const ax_box* box);
@@ -88,30 +119,145 @@ static const char *one_name(const ax_one *one);
 
 const ax_str_trait ax_string_tr;
 
+static void release(struct shared_st *shared)
+{
+	if (shared && !REF_DEC(&shared->ref))
+		free(shared);
+}
+
+static struct shared_st *shared_alloc(size_t capacity)
+{
+	struct shared_st *shared = malloc(sizeof(struct shared_st) + (capacity + 1) * sizeof(char));
+	if (!shared)
+		return NULL;
+	shared->ref = 1;
+	shared->capacity = capacity;
+	return shared;
+}
+
+/*
+ * Make the storage exclusive to the string and large enough for size chars
+ * and the terminator. The content is kept and terminated.
+ */
+static ax_fail reserve(ax_string *string, size_t size)
+{
+	struct shared_st *shared = string->shared;
+
+	if (!shared) {
+		if (size <= AX_STRING_INLINE_CAPACITY)
+			return false;
+		size_t capacity = AX_STRING_INLINE_CAPACITY * 2;
+		while (capacity < size)
+			capacity <<= 1;
+		struct shared_st *new_shared = shared_alloc(capacity);
+		if (!new_shared)
+			return true;
+		memcpy(new_shared->data, string->ptr, (string->size + 1) * sizeof(char));
+		string->shared = new_shared;
+		string->ptr = new_shared->data;
+		return false;
+	}
+
+	if (REF_LOAD(&shared->ref) == 1) {
+		/* The buffer is left by a substring, move the content to the front */
+		if (string->ptr != shared->data) {
+			if (string->ptr + size <= shared->data + shared->capacity) {
+				string->ptr[string->size] = '\0';
+				return false;
+			}
+			memmove(shared->data, string->ptr, string->size * sizeof(char));
+			string->ptr = shared->data;
+		}
+		if (size > shared->capacity) {
+			size_t capacity = shared->capacity;
+			while (capacity < size)
+				capacity <<= 1;
+			shared = realloc(shared, sizeof(struct shared_st) + (capacity + 1) * sizeof(char));
+			if (!shared)
+				return true;
+			shared->capacity = capacity;
+			string->shared = shared;
+			string->ptr = shared->data;
+		}
+		string->ptr[string->size] = '\0';
+		return false;
+	}
+
+	/* Leave the buffer to the other strings */
+	if (size <= AX_STRING_INLINE_CAPACITY) {
+		memcpy(string->store, string->ptr, string->size * sizeof(char));
+		string->store[string->size] = '\0';
+		string->ptr = string->store;
+		string->shared = NULL;
+	} else {
+		struct shared_st *new_shared = shared_alloc(size);
+		if (!new_shared)
+			return true;
+		memcpy(new_shared->data, string->ptr, string->size * sizeof(char));
+		new_shared->data[string->size] = '\0';
+		string->ptr = new_shared->data;
+		string->shared = new_shared;
+	}
+	release(shared);
+	return false;
+}
+
+inline static ax_fail detach(ax_string *string)
+{
+	return reserve(string, string->size);
+}
+
+inline static void set_size(ax_string *string, size_t size)
+{
+	string->size = size;
+	string->ptr[size] = '\0';
+}
+
+/* Iterators and the strz pointer may write into the buffer directly, so
+ * the buffer of a string which handed them out is not shared any more.
+ * The flag is set by readers of a const string as well. */
+inline static void pin(const ax_string *string)
+{
+	if (!FLAG_LOAD(&string->pinned))
+		FLAG_SET((long *)&string->pinned);
+}
+
+inline static bool shareable(const ax_string *string)
+{
+	return string->shared && !FLAG_LOAD(&string->pinned);
+}
+
+/* Copy size chars from ptr to an empty string */
+static ax_fail assign(ax_string *string, const char *ptr, size_t size)
+{
+	if (size > AX_STRING_INLINE_CAPACITY) {
+		struct shared_st *shared = shared_alloc(size);
+		if (!shared)
+			return true;
+		string->shared = shared;
+		string->ptr = shared->data;
+	}
+	memcpy(string->ptr, ptr, size * sizeof(char));
+	set_size(string, size);
+	return false;
+}
+
 #ifndef NDEBUG
 bool iter_if_valid(const ax_citer *it);
 bool iter_if_have_value(const ax_citer *it);
 
 bool iter_if_valid(const ax_citer *it)
 {
-	ax_string_cr self = AX_R_INIT(ax_one, it->owner);
-	ax_buff_r buff = self.ax_string->buff;
-	const ax_byte *ptr = ax_buff_cptr(buff.ax_buff);
+	const ax_string *self = it->owner;
 	return ax_citer_norm(it)
-		? (ax_byte *)it->point >= ptr && (ax_byte *)it->point <= ptr
-				+ ax_buff_size(buff.ax_buff, NULL) - sizeof(char)
-		: (ax_byte *)it->point >= ptr - sizeof(char)
-				&& (ax_byte *)it->point <= ptr + ax_buff_size(buff.ax_buff, NULL) - 2 * sizeof(char);
-
+		? (char *)it->point >= self->ptr && (char *)it->point <= self->ptr + self->size
+		: (char *)it->point >= self->ptr - 1 && (char *)it->point < self->ptr + self->size;
 }
 
 bool iter_if_have_value(const ax_citer *it)
 {
-	ax_string_cr self = AX_R_INIT(ax_one, it->owner);
-	const ax_buff *buff = self.ax_string->buff.ax_buff;
-	const ax_byte *ptr = ax_buff_cptr(buff);
-	return (ax_byte *)it->point >= ptr
-		&& (ax_byte *)it->point <= ptr + ax_buff_size(buff, NULL) - 2 * sizeof(char);
+	const ax_string *self = it->owner;
+	return (char *)it->point >= self->ptr && (char *)it->point < self->ptr + self->size;
 }
 
 #endif
@@ -162,6 +308,27 @@ static long citer_dist(const ax_citer *it1, const ax_citer *it2)
 	return (uintptr_t)((char *)it2->point - (char *)it1->point) / sizeof(char);
 }
 
+static size_t citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	const ax_string *self = it->owner;
+	char *end;
+	if (last) {
+		CHECK_ITER_COMPARABLE(it, last);
+		end = last->point;
+	} else
+		end = self->ptr + self->size;
+
+	size_t n = end - (char *)it->point;
+	if (n > max)
+		n = max;
+	*ptr = it->point;
+	it->point = (char *)it->point + n;
+	return n;
+}
+
 static void rciter_move(ax_citer *it, long i)
 {
 	CHECK_PARAM_NULL(it);
@@ -224,7 +391,14 @@ static ax_fail iter_set(const ax_iter *it, const void *val, va_list *ap)
 	CHECK_PARAM_NULL(val);
 	CHECK_PARAM_VALIDITY(it, iter_if_have_value(ax_iter_cc(it)));
 
-	*(char *)it->point = *(char *) val;
+	ax_string *self = (ax_string *)it->owner;
+	size_t off = (char *)it->point - self->ptr;
+	if (detach(self))
+		return true;
+
+	/* The iterator follows the chars to the private buffer */
+	((ax_iter *)it)->point = self->ptr + off;
+	self->ptr[off] = *(char *)val;
 	return false;
 }
 
@@ -233,19 +407,16 @@ static void iter_erase(ax_iter *it)
 	CHECK_PARAM_NULL(it);
 	CHECK_PARAM_VALIDITY(it, iter_if_have_value(ax_iter_c(it)));
 
-	ax_string_r self = AX_R_INIT(ax_one, it->owner);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-
-	size_t size = ax_buff_size(buff, NULL);
-	size_t nchar = size / sizeof(char);
-	char *ptr = ax_buff_ptr(buff);
-	size_t off = (char *)it->point - ptr;
+	ax_string *self = (ax_string *)it->owner;
+	size_t off = (char *)it->point - self->ptr;
+	if (detach(self))
+		return;
 
-	memmove(ptr + off + 1, ptr + off, size - (off + 1) * sizeof(char));
-	ptr[nchar - 2] = '\0';
-	(void)ax_buff_adapt(buff, size - sizeof(char));
+	char *ptr = self->ptr;
+	memmove(ptr + off, ptr + off + 1, (self->size - off) * sizeof(char));
+	self->size--;
 
-	it->point = ptr + off + (ax_iter_norm(it) ? 0 : 1);
+	it->point = ptr + off - (ax_iter_norm(it) ? 0 : 1);
 }
 
 static void one_free(ax_one* one)
@@ -254,7 +425,7 @@ static void one_free(ax_one* one)
 		return;
 
 	ax_string_r self = AX_R_INIT(ax_one, one);
-	ax_one_free(self.ax_string->buff.ax_one);
+	release(self.ax_string->shared);
 	free(one);
 }
 
@@ -265,10 +436,12 @@ static const char *one_name(const ax_one *one)
 
 static ax_dump *any_dump(const ax_any* any)
 {
-	ax_str_cr self = AX_R_INIT(ax_any, any);
-	ax_dump *block = NULL, *strdmp = NULL;
-	block = ax_dump_block(ax_one_name(self.ax_one), 1);
-	strdmp = ax_dump_str(ax_str_cstrz(self.ax_str));
+	ax_string_cr self = AX_R_INIT(ax_any, any);
+	const ax_string *string = self.ax_string;
+
+	/* A substring is not terminated in the shared buffer */
+	ax_dump *block = ax_dump_block(ax_one_name(self.ax_one), 1);
+	ax_dump *strdmp = ax_dump_strn(string->ptr, string->size);
 	ax_dump_bind(block, 0, strdmp);
 	return block;
 }
@@ -278,26 +451,21 @@ static ax_any* any_copy(const ax_any* any)
 	CHECK_PARAM_NULL(any);
 
 	ax_string_cr self = AX_R_INIT(ax_any, any);
-
-	ax_buff_r new_buf = { NULL };
-	ax_string_r new_str = { NULL };
-
-	new_str.ax_string = malloc((sizeof(ax_string)));
-	if (!new_str.ax_string) {
-		goto fail;
+	ax_string_r copy = { .ax_str = __ax_string_construct() };
+	if (!copy.ax_one)
+		return NULL;
+
+	/* Long strings share the buffer until either of them is modified */
+	if (shareable(self.ax_string)) {
+		REF_INC(&self.ax_string->shared->ref);
+		copy.ax_string->shared = self.ax_string->shared;
+		copy.ax_string->ptr = self.ax_string->ptr;
+		copy.ax_string->size = self.ax_string->size;
+	} else if (assign(copy.ax_string, self.ax_string->ptr, self.ax_string->size)) {
+		ax_one_free(copy.ax_one);
+		return NULL;
 	}
-
-	new_buf.ax_any = ax_any_copy(self.ax_string->buff.ax_any);
-	if (!new_buf.ax_any)
-		goto fail;
-
-	memcpy(new_str.ax_string, self.ax_string, sizeof(ax_string));
-
-	return new_str.ax_any;
-fail:
-	ax_one_free(new_buf.ax_one);
-	ax_one_free(new_str.ax_one);
-	return NULL;
+	return copy.ax_any;
 }
 
 static size_t box_size(const ax_box* box)
@@ -305,17 +473,14 @@ static size_t box_size(const ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_cr self = AX_R_INIT(ax_box, box);
-	size_t bsize = ax_buff_size(self.ax_string->buff.ax_buff, NULL);
-	return bsize / sizeof(char) - 1;
+	return self.ax_string->size;
 }
 
 static size_t box_maxsize(const ax_box* box)
 {
 	CHECK_PARAM_NULL(box);
 
-	ax_string_cr self = AX_R_INIT(ax_box, box);
-	size_t maxsize = ax_buff_max(self.ax_string->buff.ax_buff);
-	return maxsize / sizeof(char) - 1;
+	return (PTRDIFF_MAX - sizeof(struct shared_st)) / sizeof(char) - 1;
 }
 
 static ax_iter box_begin(ax_box* box)
@@ -323,25 +488,24 @@ static ax_iter box_begin(ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_r self = AX_R_INIT(ax_box, box);
+	pin(self.ax_string);
 	return (ax_iter) {
 		.owner = box,
-		.point = (ax_byte *)ax_buff_ptr(self.ax_string->buff.ax_buff),
+		.point = self.ax_string->ptr,
 		.tr = &ax_string_tr.ax_seq.ax_box.iter,
 		.etr = ax_class_data(box).elem_tr,
 	};
 }
 
-
 static ax_iter box_end(ax_box* box)
 {
 	CHECK_PARAM_NULL(box);
 
 	ax_string_r self = AX_R_INIT(ax_box, box);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
+	pin(self.ax_string);
 	return (ax_iter) {
 		.owner = box,
-		.point = (ax_byte *)ax_buff_ptr(buff)
-			+ ax_buff_size(buff, NULL) - sizeof(char),
+		.point = self.ax_string->ptr + self.ax_string->size,
 		.tr = &ax_string_tr.ax_seq.ax_box.iter,
 		.etr = ax_class_data(box).elem_tr,
 	};
@@ -352,11 +516,10 @@ static ax_iter box_rbegin(ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_r self = AX_R_INIT(ax_box, box);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
+	pin(self.ax_string);
 	return (ax_iter) {
 		.owner = box,
-		.point = (ax_byte *)ax_buff_ptr(buff)
-			+ ax_buff_size(buff, NULL) - 2 * sizeof(char),
+		.point = self.ax_string->ptr + self.ax_string->size - 1,
 		.tr = &ax_string_tr.ax_seq.ax_box.riter,
 		.etr = ax_class_data(box).elem_tr,
 	};
@@ -367,9 +530,10 @@ static ax_iter box_rend(ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_r self = AX_R_INIT(ax_box, box);
+	pin(self.ax_string);
 	return (ax_iter) {
 		.owner = box,
-		.point = (ax_byte *)ax_buff_ptr(self.ax_string->buff.ax_buff) - sizeof(char),
+		.point = self.ax_string->ptr - 1,
 		.tr = &ax_string_tr.ax_seq.ax_box.riter,
 		.etr = ax_class_data(box).elem_tr,
 	};
@@ -380,12 +544,11 @@ static void box_clear(ax_box* box)
 	CHECK_PARAM_NULL(box);
 
 	ax_string_r self = AX_R_INIT(ax_box, box);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-
-	(void)ax_buff_resize(buff, sizeof(char)); // Always success
-
-	char *ptr = ax_buff_ptr(buff);
-	ptr[0] = '\0';
+	release(self.ax_string->shared);
+	self.ax_string->shared = NULL;
+	self.ax_string->pinned = 0;
+	self.ax_string->ptr = self.ax_string->store;
+	set_size(self.ax_string, 0);
 }
 
 static ax_fail str_append(ax_str* str, const char *s)
@@ -394,39 +557,27 @@ static ax_fail str_append(ax_str* str, const char *s)
 	CHECK_PARAM_NULL(s);
 
 	ax_string_r self = AX_R_INIT(ax_str, str);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-
-	size_t append_len = strlen(s) * sizeof(char);
-	size_t old_size = ax_buff_size(buff, NULL);
-	size_t new_size = old_size + append_len;
-	
-	if (ax_buff_adapt(buff, new_size))
-		goto fail;
-
-	char *ptr = ax_buff_ptr(buff);
-	memcpy(ptr + old_size - sizeof(char), s, append_len + sizeof(char));
-	
-	return false;
-fail:
-	return true;
+	return seq_push_n(self.ax_seq, s, strlen(s));
 }
 
 static ax_fail str_insert(ax_str* str, size_t start, const char *s)
 {
 	CHECK_PARAM_NULL(str);
-	CHECK_PARAM_VALIDITY(start, start < ax_box_size(ax_r(ax_str, str).ax_box));
+	CHECK_PARAM_NULL(s);
+	CHECK_PARAM_VALIDITY(start, start <= ax_box_size(ax_r(ax_str, str).ax_box));
 	
 	ax_string_r self = AX_R_INIT(ax_str, str);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
+	ax_string *string = self.ax_string;
 
 	size_t insert_len = strlen(s);
-	size_t old_bsize = ax_buff_size(buff, NULL);
-	ax_buff_adapt(buff, old_bsize + insert_len);
-	char *ptr = ax_buff_ptr(buff);
-	memmove(ptr + (start + insert_len), ptr + start, old_bsize - start);
-	memcpy(ptr + start, s, insert_len);
+	if (reserve(string, string->size + insert_len))
+		return true;
 
-	return true;
+	char *ptr = string->ptr;
+	memmove(ptr + start + insert_len, ptr + start, (string->size - start) * sizeof(char));
+	memcpy(ptr + start, s, insert_len * sizeof(char));
+	set_size(string, string->size + insert_len);
+	return false;
 }
 
 static char *str_strz(ax_str* str)
@@ -434,8 +585,10 @@ static char *str_strz(ax_str* str)
 	CHECK_PARAM_NULL(str);
 
 	ax_string_r self = AX_R_INIT(ax_str, str);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-	return ax_buff_ptr(buff);
+	if (detach(self.ax_string))
+		return NULL;
+	pin(self.ax_string);
+	return self.ax_string->ptr;
 }
 
 static int str_comp(const ax_str* str, const char* s)
@@ -443,37 +596,38 @@ static int str_comp(const ax_str* str, const char* s)
 	CHECK_PARAM_NULL(str);
 	CHECK_PARAM_NULL(s);
 
+	/* A substring is not terminated in the shared buffer */
 	ax_string_cr self = AX_R_INIT(ax_str, str);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-	char *ptr = (char*) ax_buff_ptr(buff);
-	return strcmp(ptr, s);
+	const unsigned char *p1 = (unsigned char *)self.ax_string->ptr, *p2 = (unsigned char *)s;
+	for (size_t i = 0; i < self.ax_string->size; i++) {
+		if (p1[i] != p2[i])
+			return p2[i] ? p1[i] - p2[i] : 1;
+	}
+	return p2[self.ax_string->size] ? -1 : 0;
 }
 
 static ax_str *str_substr (const ax_str* str, size_t start, size_t len)
 {
 	CHECK_PARAM_NULL(str);
-	CHECK_PARAM_VALIDITY(start, start < ax_str_length(str));
-	CHECK_PARAM_VALIDITY(len, start + len < ax_str_length(str));
+	CHECK_PARAM_VALIDITY(start, start <= ax_str_length(str));
+	CHECK_PARAM_VALIDITY(len, start + len <= ax_str_length(str));
 
 	ax_string_cr self = AX_R_INIT(ax_str, str);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
 
-	ax_string_r ret = { NULL };
-	ret.ax_str = __ax_string_construct();
-	if (!ret.ax_one) {
-		goto fail;
+	ax_string_r ret = { .ax_str = __ax_string_construct() };
+	if (!ret.ax_one)
+		return NULL;
+
+	if (len > AX_STRING_INLINE_CAPACITY && shareable(self.ax_string)) {
+		REF_INC(&self.ax_string->shared->ref);
+		ret.ax_string->shared = self.ax_string->shared;
+		ret.ax_string->ptr = self.ax_string->ptr + start;
+		ret.ax_string->size = len;
+	} else if (assign(ret.ax_string, self.ax_string->ptr + start, len)) {
+		ax_one_free(ret.ax_one);
+		return NULL;
 	}
-
-	char* buffer = ax_buff_ptr(buff);
-	char back = buffer[start + len];
-	buffer[start + len] = '\0';
-	if (ax_str_append(ret.ax_str, buffer + start))
-		goto fail;
-	buffer[start + len] = back;
 	return ret.ax_str;
-fail:
-	ax_one_free(ret.ax_one);
-	return NULL;
 }
 
 static ax_seq *str_split (const ax_str* str, const char ch)
@@ -481,32 +635,44 @@ static ax_seq *str_split (const ax_str* str, const char ch)
 	CHECK_PARAM_NULL(str);
 
 	ax_string_cr self = AX_R_INIT(ax_str, str);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-
-	char *buffer = ax_buff_ptr(buff);
-	char *cur = buffer, *head = buffer;
+	const char *cur = self.ax_string->ptr, *end = cur + self.ax_string->size;
 
 	ax_vector_r ret = ax_new(ax_vector, ax_t(str));
 	if (ret.ax_one == NULL)
-		goto fail;
-
-	while (*cur) {
-		if (*cur == ch) {
-			char backup = *cur;
-			*cur = '\0';
-			if(ax_seq_push(ret.ax_seq, head))
+		return NULL;
+
+	/* Pieces are terminated in a scratch buffer as the source is read-only */
+	char stack_buf[64], *buf = stack_buf;
+	size_t buf_size = sizeof stack_buf;
+	for (;;) {
+		const char *sep = memchr(cur, ch, end - cur);
+		size_t len = (sep ? sep : end) - cur;
+		if (len >= buf_size) {
+			char *new_buf = malloc(len + 1);
+			if (!new_buf)
 				goto fail;
-			*cur = backup;
-			head = cur + 1;
+			if (buf != stack_buf)
+				free(buf);
+			buf = new_buf;
+			buf_size = len + 1;
 		}
-		cur++;
+		memcpy(buf, cur, len);
+		buf[len] = '\0';
+		if (ax_seq_push(ret.ax_seq, buf))
+			goto fail;
+		if (!sep)
+			break;
+		cur = sep + 1;
 	}
-	if(ax_seq_push(ret.ax_seq, head))
-		goto fail;
+
+	if (buf != stack_buf)
+		free(buf);
 	return ret.ax_seq;
 fail:
+	if (buf != stack_buf)
+		free(buf);
 	ax_one_free(ret.ax_one);
-       return NULL;
+	return NULL;
 }
 
 static ax_fail str_sprintf(ax_str* str, const char *fmt, va_list args)
@@ -533,27 +699,22 @@ static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val, va_list *ap
 	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
 
 	ax_string_r self = AX_R_INIT(ax_seq, seq);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-
-	char *ptr = ax_buff_ptr(buff);
-	size_t old_size = ax_buff_size(buff, NULL);
+	ax_string *string = self.ax_string;
 
-	long offset = (char *)it->point - ptr; //backup offset before realloc
-
-	if (ax_buff_adapt(buff, old_size + sizeof(char)))
+	long offset = (char *)it->point - string->ptr; //backup offset before realloc
+	if (reserve(string, string->size + 1))
 		return true;
 
-	ptr = ax_buff_ptr(buff);
+	char *ptr = string->ptr;
 	it->point = ptr + offset; //restore offset
 
-	size_t nchar = old_size / sizeof(char);
 	size_t ins_off = ax_iter_norm(it) ? offset : offset + 1;
-	memmove(ptr + ins_off + 1, ptr + ins_off, (nchar - offset) * sizeof(char));
-
+	memmove(ptr + ins_off + 1, ptr + ins_off, (string->size - ins_off) * sizeof(char));
 	ptr[ins_off] = *(char *)val;
+	set_size(string, string->size + 1);
 
 	if(ax_iter_norm(it))
-		it->point = (ax_byte*)it->point + sizeof(char);
+		it->point = (char *)it->point + 1;
 	return false;
 }
 
@@ -563,24 +724,16 @@ static ax_fail seq_push(ax_seq *seq, const void *val, va_list *ap)
 	CHECK_PARAM_NULL(val);
 
 	ax_string_r self = AX_R_INIT(ax_seq, seq);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
+	ax_string *string = self.ax_string;
 
 	if (!val || *(char *)val == '\0')
 		return false;
 
-	size_t size = ax_buff_size(buff, NULL);
-
-	size += sizeof(char);
-	if (ax_buff_adapt(buff, size))
+	if (reserve(string, string->size + 1))
 		return true;
 
-	char *ptr = ax_buff_ptr(buff);
-
-	size_t nchar = size / sizeof(char);
-
-	ptr[nchar - 2] = *(char *)val;
-	ptr[nchar - 1] = '\0';
-
+	string->ptr[string->size] = *(char *)val;
+	set_size(string, string->size + 1);
 	return false;
 }
 
@@ -589,21 +742,14 @@ static ax_fail seq_pop(ax_seq *seq)
 	CHECK_PARAM_NULL(seq);
 
 	ax_string_r self = AX_R_INIT(ax_seq, seq);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-
-	size_t size = ax_buff_size(buff, NULL);
-	char *ptr = ax_buff_ptr(buff);
+	ax_string *string = self.ax_string;
 
-	if (size == sizeof('\0')) {
+	if (string->size == 0)
 		return false;
-	}
 
-	size -= sizeof(char);
-	if (ax_buff_adapt(buff, size))
+	if (detach(string))
 		return true;
-	size_t nchar = size / sizeof(char);
-	ptr[nchar - 1] = '\0';
-
+	set_size(string, string->size - 1);
 	return false;
 }
 
@@ -612,18 +758,16 @@ static void seq_invert(ax_seq *seq)
 	CHECK_PARAM_NULL(seq);
 
 	ax_string_r self = AX_R_INIT(ax_seq, seq);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-	size_t size = ax_buff_size(buff, NULL);
-	char *ptr = ax_buff_ptr(buff);
+	ax_string *string = self.ax_string;
 
-	if (size == sizeof('\0'))
+	if (string->size < 2 || detach(string))
 		return;
 
-	size_t left = 0, right = size - sizeof('\0') - sizeof(char);
-	while (right - left > sizeof(char)) {
-		ax_swap(ptr + left, ptr + right, char);
-		left += sizeof(char);
-		right -= sizeof(char);
+	char *left = string->ptr, *right = string->ptr + string->size - 1;
+	while (left < right) {
+		ax_swap(left, right, char);
+		left++;
+		right--;
 	}
 }
 
@@ -633,43 +777,125 @@ static ax_fail seq_trunc(ax_seq *seq, size_t size)
 	CHECK_PARAM_VALIDITY(size, size <= ax_box_maxsize(ax_r(ax_seq, seq).ax_box));
 
 	ax_string_r self = AX_R_INIT(ax_seq, seq);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-
-	size_t old_size = ax_str_length(self.ax_str);
+	ax_string *string = self.ax_string;
 
+	size_t old_size = string->size;
 	if (size == old_size) 
 		return false;
 
+	if (reserve(string, size))
+		return true;
 
-	if (ax_buff_adapt(buff, size + sizeof(char)))
+	if (size > old_size)
+		memset(string->ptr + old_size, '\0', (size - old_size) * sizeof(char));
+	set_size(string, size);
+	return false;
+}
+
+static ax_fail seq_push_n(ax_seq *seq, const void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_string_r self = AX_R_INIT(ax_seq, seq);
+	ax_string *string = self.ax_string;
+
+	if (n == 0)
+		return false;
+
+	/* As seq_push does not store '\0', the input ends at the first one */
+	const char *nul = memchr(arr, '\0', n);
+	if (nul)
+		n = nul - (const char *)arr;
+
+	if (reserve(string, string->size + n))
 		return true;
-	char *ptr = ax_buff_ptr(buff);
 
-	if (size < old_size)
-		ptr[size - 1] =  '\0';
-	else
-		memset(ptr + old_size, '\0', size - old_size + sizeof(char));
+	memcpy(string->ptr + string->size, arr, n * sizeof(char));
+	set_size(string, string->size + n);
 	return false;
 }
 
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	ax_string_r self = AX_R_INIT(ax_seq, seq);
+	ax_string *string = self.ax_string;
+	size_t n = ax_citer_range_size(first, last);
+
+	if (n == 0)
+		return false;
+
+	long offset = (char *)it->point - string->ptr; //backup offset before realloc
+	if (reserve(string, string->size + n))
+		return true;
+
+	char *ptr = string->ptr;
+	it->point = ptr + offset; //restore offset
+
+	size_t ins_off = ax_iter_norm(it) ? offset : offset + 1;
+	memmove(ptr + ins_off + n, ptr + ins_off, (string->size - ins_off) * sizeof(char));
+
+	ax_citer cur = *first;
+	for (size_t i = 0; i < n; i++) {
+		ptr[ins_off + (ax_iter_norm(it) ? i : n - 1 - i)] = *(char *)cur.tr->get(&cur);
+		ax_citer_next(&cur);
+	}
+	set_size(string, string->size + n);
+
+	if (ax_iter_norm(it))
+		it->point = (char *)it->point + n;
+	return false;
+}
+
+static void seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(first, iter_if_valid(ax_iter_c(first)));
+	CHECK_PARAM_VALIDITY(last, iter_if_valid(ax_iter_c(last)));
+
+	ax_string_r self = AX_R_INIT(ax_seq, seq);
+	ax_string *string = self.ax_string;
+	char *ptr = string->ptr;
+
+	size_t begin, end;
+	if (ax_iter_norm(first)) {
+		begin = (char *)first->point - ptr;
+		end = (char *)last->point - ptr;
+	} else {
+		begin = (char *)last->point + 1 - ptr;
+		end = (char *)first->point + 1 - ptr;
+	}
+
+	if (begin >= end || detach(string))
+		return;
+
+	ptr = string->ptr;
+	memmove(ptr + begin, ptr + end, (string->size - end) * sizeof(char));
+	set_size(string, string->size - (end - begin));
+
+	char *pos = ax_iter_norm(first) ? ptr + begin : ptr + begin - 1;
+	first->point = last->point = pos;
+}
+
 static ax_iter seq_at(const ax_seq *seq, size_t index)
 {
 	CHECK_PARAM_NULL(seq);
 	CHECK_PARAM_VALIDITY(index, index <= ax_box_size(ax_cr(ax_seq, seq).ax_box));
 
-	ax_string_cr self = AX_R_INIT(ax_seq, seq);
-	ax_buff *buff = self.ax_string->buff.ax_buff;
-
-	char *ptr = ax_buff_ptr(buff);
+	ax_string_r self = AX_R_INIT(ax_seq, (ax_seq *)seq);
+	pin(self.ax_string);
 
 	ax_iter it = {
 		.owner = (void *)self.ax_one,
-		.point =  ptr + index,
+		.point = self.ax_string->ptr + index,
 		.tr = &ax_string_tr.ax_seq.ax_box.iter,
 		.etr = ax_class_data(self.ax_box).elem_tr,
 	};
 
-	CHECK_PARAM_VALIDITY(index, iter_if_have_value(ax_iter_c(&it)));
+	CHECK_PARAM_VALIDITY(index, iter_if_valid(ax_iter_c(&it)));
 	return it;
 }
 
@@ -693,6 +919,7 @@ const ax_str_trait ax_string_tr =
 				.next = citer_next,
 				.less = citer_less,
 				.dist = citer_dist,
+				.span = citer_span,
 				.get    = citer_get,
 				.set    = iter_set,
 				.erase  = iter_erase,
@@ -724,6 +951,9 @@ const ax_str_trait ax_string_tr =
 		.trunc = seq_trunc,
 		.at = seq_at,
 		.insert = seq_insert,
+		.push_n = seq_push_n,
+		.insert_range = seq_insert_range,
+		.erase_range = seq_erase_range,
 	},
 	.append = str_append,
 	.insert = str_insert,
@@ -736,34 +966,41 @@ const ax_str_trait ax_string_tr =
 
 ax_str *__ax_string_construct()
 {
-	ax_string_r self = AX_R_NULL;
-	ax_buff_r buff = AX_R_NULL;
-
-	self.ax_string = malloc(sizeof(ax_string));
-	if (ax_r_isnull(self))
-		goto fail;
-
-	buff = ax_new0(ax_buff);
-	if (ax_r_isnull(buff))
-		goto fail;
+	ax_string *self = malloc(sizeof(ax_string));
+	if (!self)
+		return NULL;
 
 	ax_string string_init = {
 		.ax_str = {
 			.tr = &ax_string_tr,
 			.env.ax_seq.ax_box.elem_tr = ax_t(char)
 		},
-		.buff = buff,
+		.size = 0,
+		.shared = NULL,
 	};
-	char zero = '\0';
-	ax_buff_reserve(buff.ax_buff, MIN_SIZE * sizeof(char));
-	ax_buff_resize(buff.ax_buff, sizeof(char));
-	char *ptr = ax_buff_ptr(buff.ax_buff);
-	ptr[0] = zero;
-
-	memcpy(self.ax_string, &string_init, sizeof string_init);
-	return self.ax_str;
-fail:
-	ax_one_free(buff.ax_one);
-	return NULL;
+	memcpy(self, &string_init, sizeof string_init);
+	self->ptr = self->store;
+	self->store[0] = '\0';
+	return ax_r(ax_string, self).ax_str;
 }
 
+bool ax_string_inlined(const ax_string *string)
+{
+	CHECK_PARAM_NULL(string);
+
+	return !string->shared;
+}
+
+bool ax_string_shared(const ax_string *string)
+{
+	CHECK_PARAM_NULL(string);
+
+	return string->shared && REF_LOAD(&string->shared->ref) > 1;
+}
+
+const char *ax_string_data(const ax_string *string)
+{
+	CHECK_PARAM_NULL(string);
+
+	return string->ptr;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/strview.h"
+#include "ax/string.h"
+#include "ax/buff.h"
+#include "ax/vector.h"
+#include "ax/mem.h"
+#include "ax/dump.h"
+#include "check.h"
+
+#include <stdarg.h>
+#include <string.h>
+
+int ax_strview_comp(ax_strview view1, ax_strview view2)
+{
+	size_t len = view1.len < view2.len ? view1.len : view2.len;
+	int ret = len ? memcmp(view1.ptr, view2.ptr, len) : 0;
+	if (ret)
+		return ret;
+	return (view1.len > view2.len) - (view1.len < view2.len);
+}
+
+ax_strview ax_strview_from_string(const ax_string *string)
+{
+	CHECK_PARAM_NULL(string);
+
+	return ax_strview_make(ax_string_data(string),
+			ax_str_length(ax_cr(ax_string, string).ax_str));
+}
+
+ax_strview ax_strview_from_buff(const ax_buff *buff)
+{
+	CHECK_PARAM_NULL(buff);
+
+	return ax_strview_make(ax_buff_cptr(buff), ax_buff_size(buff, NULL));
+}
+
+ax_strview ax_strview_from_iobuf(const ax_iobuf *iobuf)
+{
+	CHECK_PARAM_NULL(iobuf);
+
+	void *ptr;
+	size_t len = ax_iobuf_zread(iobuf, &ptr);
+	return ax_strview_make(ptr, len);
+}
+
+static bool equal_strview(const void *p1, const void *p2)
+{
+	return ax_strview_equal(*(const ax_strview *)p1, *(const ax_strview *)p2);
+}
+
+static bool less_strview(const void *p1, const void *p2)
+{
+	return ax_strview_comp(*(const ax_strview *)p1, *(const ax_strview *)p2) < 0;
+}
+
+static size_t hash_strview(const void *p)
+{
+	const ax_strview *view = p;
+	return ax_memhash(view->len ? view->ptr : "", view->len);
+}
+
+static ax_dump *dump_strview(const void *p)
+{
+	const ax_strview *view = p;
+	return ax_dump_strn(view->len ? view->ptr : "", view->len);
+}
+
+static ax_fail copy_strview(void *dst, const void *src)
+{
+	*(ax_strview *)dst = *(const ax_strview *)src;
+	return false;
+}
+
+static ax_fail init_strview(void *p, va_list *ap)
+{
+	*(ax_strview *)p = ap ? va_arg(*ap, ax_strview) : ax_strview_make("", 0);
+	return false;
+}
+
+static void free_strview(void *p)
+{
+}
+
+const ax_trait ax_t_strview = {
+	.t_size  = sizeof(ax_strview),
+	.t_equal = equal_strview,
+	.t_less  = less_strview,
+	.t_dump  = dump_strview,
+	.t_hash  = hash_strview,
+	.t_free  = free_strview,
+	.t_copy  = copy_strview,
+	.t_init  = init_strview,
+	.t_link  = false
+};
+
+ax_seq *ax_strview_split(ax_strview view, char ch)
+{
+	ax_vector_r ret = ax_new(ax_vector, ax_t(strview));
+	if (!ret.ax_one)
+		return NULL;
+
+	size_t start = 0;
+	for (;;) {
+		const char *sep = start < view.len
+			? memchr(view.ptr + start, ch, view.len - start)
+			: NULL;
+		size_t end = sep ? (size_t)(sep - view.ptr) : view.len;
+		ax_strview piece = ax_strview_make(view.len ? view.ptr + start : view.ptr, end - start);
+		if (ax_seq_push(ret.ax_seq, &piece)) {
+			ax_one_free(ret.ax_one);
+			return NULL;
+		}
+		if (!sep)
+			break;
+		start = end + 1;
+	}
+	return ret.ax_seq;
+}
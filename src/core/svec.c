@@ -0,0 +1,835 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/svec.h"
+#include "ax/def.h"
+#include "ax/iter.h"
+#include "ax/trait.h"
+#include "ax/mem.h"
+#include "check.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#define ELEM_SIZE(b) ax_trait_size(ax_class_data(b.ax_box).elem_tr)
+#undef free
+
+union inline_slot
+{
+	long double ld;
+	intmax_t im;
+	void *ptr;
+};
+
+ax_concrete_begin(ax_svec)
+	ax_byte *ptr;
+	size_t size;
+	size_t capacity;
+	size_t ninline;
+	union inline_slot store[];
+ax_end;
+
+static ax_fail seq_push(ax_seq *seq, const void *val, va_list *ap);
+static ax_fail seq_pop(ax_seq *seq);
+static void    seq_invert(ax_seq *seq);
+static ax_fail seq_trunc(ax_seq *seq, size_t size);
+static ax_iter seq_at(const ax_seq *seq, size_t index);
+static void   *seq_last(const ax_seq *seq);
+static void   *seq_first(const ax_seq *seq);
+
+static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val, va_list *ap);
+static ax_fail seq_push_n(ax_seq *seq, const void *arr, size_t n);
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static void    seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
+
+static size_t  box_size(const ax_box *box);
+static size_t  box_maxsize(const ax_box *box);
+static ax_iter box_begin(ax_box *box);
+static ax_iter box_end(ax_box *box);
+static ax_iter box_rbegin(ax_box *box);
+static ax_iter box_rend(ax_box *box);
+static void    box_clear(ax_box *box);
+
+static ax_any *any_copy(const ax_any *any);
+
+static void    one_free(ax_one *one);
+static const char *one_name(const ax_one *one);
+
+static void    citer_move(ax_citer *it, long i);
+static void    citer_prev(ax_citer *it);
+static void    citer_next(ax_citer *it);
+static bool    citer_less(const ax_citer *it1, const ax_citer *it2);
+static long    citer_dist(const ax_citer *it1, const ax_citer *it2);
+static ax_box *citer_box(const ax_citer *it);
+static size_t  citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr);
+static void    iter_erase(ax_iter *it);
+
+static void    rciter_move(ax_citer *it, long i);
+static void    rciter_prev(ax_citer *it);
+static void    rciter_next(ax_citer *it);
+static long    rciter_dist(const ax_citer *it1, const ax_citer *it2);
+static void    riter_erase(ax_iter *it);
+
+static void   *citer_get(const ax_citer *it);
+static ax_fail iter_set(const ax_iter *it, const void *val, va_list *ap);
+
+#ifndef NDEBUG
+static inline bool iter_if_valid(const ax_citer *it)
+{
+	const ax_svec *self = it->owner;
+	size_t elem_size = ax_trait_size(ax_class_data((ax_box *)it->owner).elem_tr);
+	ax_byte *ptr = self->ptr;
+	size_t size = self->size * elem_size;
+
+	return  (ax_citer_norm(it)
+		? ((ax_byte *)it->point >= ptr && (ax_byte *)it->point <= ptr + size)
+		: ((ax_byte *)it->point >= ptr - elem_size && (ax_byte *)it->point < ptr + size))
+		&& ((intptr_t)it->point - (intptr_t)ptr) % elem_size == 0;
+}
+
+static inline bool iter_if_have_value(const ax_citer *it)
+{
+	const ax_svec *self = it->owner;
+	size_t elem_size = ax_trait_size(ax_class_data((ax_box *)it->owner).elem_tr);
+	return (ax_byte *)it->point >= self->ptr
+		&& (ax_byte *)it->point < self->ptr + self->size * elem_size;
+}
+#endif
+
+static inline bool is_inlined(const ax_svec *svec)
+{
+	return svec->ptr == (ax_byte *)svec->store;
+}
+
+static ax_fail grow(ax_svec_r self, size_t need)
+{
+	ax_svec *svec = self.ax_svec;
+	if (need <= svec->capacity)
+		return false;
+
+	size_t elem_size = ELEM_SIZE(self);
+	if (need > PTRDIFF_MAX / elem_size)
+		return true;
+
+	size_t capacity = svec->capacity ? svec->capacity * 2 : 4;
+	if (capacity < need || capacity > PTRDIFF_MAX / elem_size)
+		capacity = need;
+
+	ax_byte *ptr;
+	if (is_inlined(svec)) {
+		ptr = malloc(capacity * elem_size);
+		if (!ptr)
+			return true;
+		memcpy(ptr, svec->ptr, svec->size * elem_size);
+	} else {
+		ptr = realloc(svec->ptr, capacity * elem_size);
+		if (!ptr)
+			return true;
+	}
+
+	svec->ptr = ptr;
+	svec->capacity = capacity;
+	return false;
+}
+
+static void citer_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it->owner);
+	it->point = (ax_byte*)it->point + (i * (long)ELEM_SIZE(self));
+
+	CHECK_PARAM_VALIDITY(i, iter_if_valid(it));
+}
+
+static void citer_prev(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it->owner);
+	it->point = (ax_byte*)it->point - ELEM_SIZE(self);
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it->owner);
+	it->point = (ax_byte*)it->point + ELEM_SIZE(self);
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static bool citer_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_PARAM_NULL(it1);
+	CHECK_PARAM_NULL(it2);
+	CHECK_ITER_COMPARABLE(it1, it2);
+	CHECK_PARAM_VALIDITY(it1, iter_if_valid(it1));
+	CHECK_PARAM_VALIDITY(it2, iter_if_valid(it2));
+
+	return ax_citer_norm(it1) ? (it1->point < it2->point) : (it1->point > it2->point);
+}
+
+static long citer_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+	CHECK_PARAM_VALIDITY(it1, iter_if_valid(it1));
+	CHECK_PARAM_VALIDITY(it2, iter_if_valid(it2));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it1->owner);
+	return ((ax_byte *)it2->point - (ax_byte *)it1->point)
+		/ (long)ELEM_SIZE(self);
+}
+
+static ax_box *citer_box(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	return (ax_box *)it->owner;
+}
+
+static size_t citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it->owner);
+	ax_byte *end;
+	if (last) {
+		CHECK_ITER_COMPARABLE(it, last);
+		end = last->point;
+	} else
+		end = self.ax_svec->ptr + self.ax_svec->size * ELEM_SIZE(self);
+
+	size_t n = (end - (ax_byte *)it->point) / ELEM_SIZE(self);
+	if (n > max)
+		n = max;
+	*ptr = it->point;
+	it->point = (ax_byte *)it->point + n * ELEM_SIZE(self);
+	return n;
+}
+
+static void rciter_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it->owner);
+	it->point = (ax_byte*)it->point - (i * (long)ELEM_SIZE(self));
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static void rciter_prev(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it->owner);
+	it->point = (ax_byte*)it->point + ELEM_SIZE(self);
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static void rciter_next(ax_citer *it)
+{
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it->owner);
+	it->point = (ax_byte*)it->point - ELEM_SIZE(self);
+
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+}
+
+static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	return - citer_dist(it1, it2);
+}
+
+static void *citer_get(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+	CHECK_ITERATOR_VALIDITY(it, iter_if_have_value(it));
+
+	return it->point;
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val, va_list *ap)
+{
+	CHECK_PARAM_VALIDITY(it, iter_if_have_value(ax_iter_cc(it)));
+
+	ax_svec_cr self = AX_R_INIT(ax_one, it->owner);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	ax_trait_free(etr, it->point);
+	if (ax_trait_copy_or_init(etr, it->point, val, ap))
+		return true;
+	return false;
+}
+
+static void erase_element(ax_svec_r self, void *point)
+{
+	ax_svec *svec = self.ax_svec;
+	size_t elem_size = ELEM_SIZE(self);
+	ax_byte *end = svec->ptr + svec->size * elem_size;
+
+	ax_trait_free(ax_class_data(self.ax_box).elem_tr, point);
+	memmove(point, (ax_byte *)point + elem_size, end - (ax_byte *)point - elem_size);
+	svec->size--;
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_PARAM_VALIDITY(it, iter_if_have_value(ax_iter_c(it)));
+
+	ax_svec_r self = AX_R_INIT(ax_one, it->owner);
+	erase_element(self, it->point);
+}
+
+static void riter_erase(ax_iter *it)
+{
+	CHECK_PARAM_VALIDITY(it, iter_if_have_value(ax_iter_c(it)));
+
+	ax_svec_r self = AX_R_INIT(ax_one, it->owner);
+	erase_element(self, it->point);
+	it->point = (ax_byte *)it->point - ELEM_SIZE(self);
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_svec_r self = AX_R_INIT(ax_one, one);
+	box_clear(self.ax_box);
+	free(one);
+}
+
+static const char *one_name(const ax_one *one)
+{
+	return ax_class_name(4, ax_svec);
+}
+
+static ax_dump *any_dump(const ax_any *any)
+{
+	ax_svec_cr self = AX_R_INIT(ax_any, any);
+	return ax_seq_dump(self.ax_seq);
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_svec_cr self = AX_R_INIT(ax_any, any);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t elem_size = ax_trait_size(etr);
+
+	ax_svec_r copy = { .ax_seq = __ax_svec_construct(etr, self.ax_svec->ninline) };
+	if (!copy.ax_one)
+		return NULL;
+
+	if (ax_svec_reserve(copy.ax_svec, self.ax_svec->size))
+		goto fail;
+
+	for (size_t i = 0; i < self.ax_svec->size; i++) {
+		if (ax_trait_copy(etr, copy.ax_svec->ptr + i * elem_size,
+					self.ax_svec->ptr + i * elem_size))
+			goto fail;
+		copy.ax_svec->size++;
+	}
+
+	return copy.ax_any;
+fail:
+	one_free(copy.ax_one);
+	return NULL;
+}
+
+static size_t box_size(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_svec_cr self = AX_R_INIT(ax_box, box);
+	return self.ax_svec->size;
+}
+
+static size_t box_maxsize(const ax_box *box)
+{
+	ax_svec_cr self = AX_R_INIT(ax_box, box);
+	return PTRDIFF_MAX / ELEM_SIZE(self);
+}
+
+static ax_iter box_begin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_svec_cr self = AX_R_INIT(ax_box, box);
+	ax_iter it = {
+		.owner = (void*)box,
+		.point = self.ax_svec->ptr,
+		.tr = &ax_svec_tr.ax_box.iter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	return it;
+}
+
+static ax_iter box_end(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_svec_cr self = AX_R_INIT(ax_box, box);
+	ax_iter it = {
+		.owner = (void*)box,
+		.point = self.ax_svec->ptr + self.ax_svec->size * ELEM_SIZE(self),
+		.tr = &ax_svec_tr.ax_box.iter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	return it;
+}
+
+static ax_iter box_rbegin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_svec_cr self = AX_R_INIT(ax_box, box);
+	ax_iter it = {
+		.owner = (void*)box,
+		.point = self.ax_svec->ptr + (self.ax_svec->size - 1) * ELEM_SIZE(self),
+		.tr = &ax_svec_tr.ax_box.riter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	return it;
+}
+
+static ax_iter box_rend(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_svec_cr self = AX_R_INIT(ax_box, box);
+	ax_iter it = {
+		.owner = (void*)box,
+		.point = self.ax_svec->ptr - ELEM_SIZE(self),
+		.tr = &ax_svec_tr.ax_box.riter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	return it;
+}
+
+static void box_clear(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_svec_r self = AX_R_INIT(ax_box, box);
+	ax_svec *svec = self.ax_svec;
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+
+	ax_byte *end = svec->ptr + svec->size * ELEM_SIZE(self);
+	for (ax_byte *p = svec->ptr; p < end; p += ELEM_SIZE(self))
+		ax_trait_free(etr, p);
+	svec->size = 0;
+
+	/* Give the heap buffer back, the vector returns to the inline storage */
+	if (!is_inlined(svec)) {
+		free(svec->ptr);
+		svec->ptr = (ax_byte *)svec->store;
+		svec->capacity = svec->ninline;
+	}
+}
+
+static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	ax_svec_r self = AX_R_INIT(ax_seq, seq);
+	ax_svec *svec = self.ax_svec;
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t elem_size = ELEM_SIZE(self);
+
+	size_t offset = (ax_byte *)it->point - svec->ptr; //backup offset before realloc
+	if (grow(self, svec->size + 1))
+		return true;
+	it->point = svec->ptr + offset; //restore offset
+
+	ax_byte *ins = ax_iter_norm(it) ? it->point : ((ax_byte*)it->point + elem_size);
+	ax_byte *end = svec->ptr + svec->size * elem_size;
+	memmove(ins + elem_size, ins, end - ins);
+
+	if (ax_trait_copy_or_init(etr, ins, val, ap)) {
+		memmove(ins, ins + elem_size, end - ins);
+		return true;
+	}
+	svec->size++;
+
+	if(ax_iter_norm(it))
+		it->point = (ax_byte*)it->point + elem_size;
+	return false;
+}
+
+static ax_fail seq_push(ax_seq *seq, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_svec_r self = AX_R_INIT(ax_seq, seq);
+	ax_svec *svec = self.ax_svec;
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+
+	if (grow(self, svec->size + 1))
+		return true;
+
+	if (ax_trait_copy_or_init(etr, svec->ptr + svec->size * ELEM_SIZE(self), val, ap))
+		return true;
+	svec->size++;
+
+	return false;
+}
+
+static ax_fail seq_pop(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_svec_r self = AX_R_INIT(ax_seq, seq);
+	ax_svec *svec = self.ax_svec;
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+
+	if (svec->size == 0)
+		return false;
+
+	svec->size--;
+	ax_trait_free(etr, svec->ptr + svec->size * ELEM_SIZE(self));
+	return false;
+}
+
+static void seq_invert(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_svec_r self = AX_R_INIT(ax_seq, seq);
+	ax_svec *svec = self.ax_svec;
+	size_t elem_size = ELEM_SIZE(self);
+
+	if (svec->size < 2)
+		return;
+
+	ax_byte *left = svec->ptr, *right = svec->ptr + (svec->size - 1) * elem_size;
+	while (left < right) {
+		ax_memswp(left, right, elem_size);
+		left += elem_size;
+		right -= elem_size;
+	}
+}
+
+static ax_fail seq_trunc(ax_seq *seq, size_t size)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(size, size <= ax_box_maxsize(ax_r(ax_seq, seq).ax_box));
+
+	ax_svec_r self = AX_R_INIT(ax_seq, seq);
+	ax_svec *svec = self.ax_svec;
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t elem_size = ELEM_SIZE(self);
+
+	if (size < svec->size) {
+		for (size_t i = size; i < svec->size; i++)
+			ax_trait_free(etr, svec->ptr + i * elem_size);
+		svec->size = size;
+		return false;
+	}
+
+	if (grow(self, size))
+		return true;
+
+	for (; svec->size < size; svec->size++)
+		if (ax_trait_init(etr, svec->ptr + svec->size * elem_size, NULL))
+			return true;
+	return false;
+}
+
+static ax_fail seq_push_n(ax_seq *seq, const void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_svec_r self = AX_R_INIT(ax_seq, seq);
+	ax_svec *svec = self.ax_svec;
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t elem_size = ELEM_SIZE(self);
+
+	if (n == 0)
+		return false;
+
+	if (grow(self, svec->size + n))
+		return true;
+
+	ax_byte *dst = svec->ptr + svec->size * elem_size;
+	if (!etr->t_copy) {
+		memcpy(dst, arr, n * elem_size);
+		svec->size += n;
+		return false;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		if (ax_trait_copy(etr, dst + i * elem_size, (ax_byte *)arr + i * elem_size)) {
+			while (i--)
+				ax_trait_free(etr, dst + i * elem_size);
+			return true;
+		}
+	}
+	svec->size += n;
+	return false;
+}
+
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	ax_svec_r self = AX_R_INIT(ax_seq, seq);
+	ax_svec *svec = self.ax_svec;
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t elem_size = ELEM_SIZE(self);
+	size_t n = ax_citer_range_size(first, last);
+
+	if (n == 0)
+		return false;
+
+	size_t offset = (ax_byte *)it->point - svec->ptr; //backup offset before realloc
+	if (grow(self, svec->size + n))
+		return true;
+	it->point = svec->ptr + offset; //restore offset
+
+	/* A reversed iterator sees the range backward in memory */
+	ax_byte *ins = ax_iter_norm(it) ? it->point : ((ax_byte*)it->point + elem_size);
+	ax_byte *end = svec->ptr + svec->size * elem_size;
+	memmove(ins + n * elem_size, ins, end - ins);
+
+	ax_citer cur = *first;
+	for (size_t i = 0; i < n; i++) {
+		ax_byte *dst = ins + (ax_iter_norm(it) ? i : n - 1 - i) * elem_size;
+		if (ax_trait_copy(etr, dst, cur.tr->get(&cur))) {
+			while (i--)
+				ax_trait_free(etr, ins + (ax_iter_norm(it) ? i : n - 1 - i) * elem_size);
+			memmove(ins, ins + n * elem_size, end - ins);
+			return true;
+		}
+		ax_citer_next(&cur);
+	}
+	svec->size += n;
+
+	if (ax_iter_norm(it))
+		it->point = (ax_byte*)it->point + n * elem_size;
+	return false;
+}
+
+static void seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(first, iter_if_valid(ax_iter_c(first)));
+	CHECK_PARAM_VALIDITY(last, iter_if_valid(ax_iter_c(last)));
+
+	ax_svec_r self = AX_R_INIT(ax_seq, seq);
+	ax_svec *svec = self.ax_svec;
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t elem_size = ELEM_SIZE(self);
+
+	ax_byte *begin, *end;
+	if (ax_iter_norm(first)) {
+		begin = first->point;
+		end = last->point;
+	} else {
+		begin = (ax_byte *)last->point + elem_size;
+		end = (ax_byte *)first->point + elem_size;
+	}
+
+	if (begin >= end)
+		return;
+
+	if (etr->t_free)
+		for (ax_byte *p = begin; p < end; p += elem_size)
+			ax_trait_free(etr, p);
+	memmove(begin, end, svec->ptr + svec->size * elem_size - end);
+	svec->size -= (end - begin) / elem_size;
+
+	if (ax_iter_norm(first))
+		*last = *first;
+	else
+		*first = *last;
+}
+
+static ax_iter seq_at(const ax_seq *seq, size_t index)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(index, index <= ax_box_size(ax_cr(ax_seq, seq).ax_box));
+
+	ax_svec_cr self = AX_R_INIT(ax_seq, seq);
+	ax_iter it = {
+		.owner = (void *)self.ax_one,
+		.point = self.ax_svec->ptr + index * ELEM_SIZE(self),
+		.tr = &ax_svec_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+	return it;
+}
+
+static void *seq_last(const ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+	ax_assert(ax_box_size(ax_cr(ax_seq, seq).ax_box) > 0, "empty");
+
+	ax_svec_cr self = AX_R_INIT(ax_seq, seq);
+	return self.ax_svec->ptr + (self.ax_svec->size - 1) * ELEM_SIZE(self);
+}
+
+static void *seq_first(const ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+	ax_assert(ax_box_size(ax_cr(ax_seq, seq).ax_box) > 0, "empty");
+
+	ax_svec_cr self = AX_R_INIT(ax_seq, seq);
+	return self.ax_svec->ptr;
+}
+
+const ax_seq_trait ax_svec_tr =
+{
+	.ax_box = {
+		.ax_any = {
+			.ax_one = {
+				.free = one_free,
+				.name = one_name,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+		},
+		.iter = {
+			.norm = true,
+			.type = AX_IT_RAND,
+			.move = citer_move,
+			.next = citer_next,
+			.prev = citer_prev,
+			.dist = citer_dist,
+			.less = citer_less,
+			.box  = citer_box,
+			.span = citer_span,
+			.get = citer_get,
+			.set = iter_set,
+			.erase = iter_erase,
+		},
+		.riter = {
+			.norm = false,
+			.type = AX_IT_RAND,
+			.move = rciter_move,
+			.next = rciter_next,
+			.prev = rciter_prev,
+			.dist = rciter_dist,
+			.less = citer_less,
+			.box  = citer_box,
+			.get = citer_get,
+			.set = iter_set,
+			.erase = riter_erase,
+		},
+
+		.size = box_size,
+		.maxsize = box_maxsize,
+
+		.begin = box_begin,
+		.end = box_end,
+		.rbegin = box_rbegin,
+		.rend = box_rend,
+
+		.clear = box_clear,
+
+	},
+	.push = seq_push,
+	.pop = seq_pop,
+	.pushf = NULL,
+	.popf = NULL,
+	.invert = seq_invert,
+	.trunc = seq_trunc,
+	.at = seq_at,
+	.last = seq_last,
+	.first = seq_first,
+	.insert = seq_insert,
+	.push_n = seq_push_n,
+	.insert_range = seq_insert_range,
+	.erase_range = seq_erase_range,
+};
+
+ax_seq *__ax_svec_construct(const ax_trait *elem_tr, size_t ninline)
+{
+	CHECK_PARAM_NULL(elem_tr);
+
+	size_t elem_size = ax_trait_size(elem_tr);
+	size_t nslots = (ninline * elem_size + sizeof(union inline_slot) - 1)
+		/ sizeof(union inline_slot);
+
+	ax_svec *svec = malloc(sizeof(ax_svec) + nslots * sizeof(union inline_slot));
+	if (!svec)
+		return NULL;
+
+	ax_svec svec_init = {
+		.ax_seq = {
+			.tr = &ax_svec_tr,
+			.env.ax_box.elem_tr = elem_tr,
+		},
+		.ptr = (ax_byte *)svec->store,
+		.size = 0,
+		.capacity = ninline,
+		.ninline = ninline,
+	};
+
+	memcpy(svec, &svec_init, sizeof svec_init);
+	return ax_r(ax_svec, svec).ax_seq;
+}
+
+void *ax_svec_buffer(ax_svec *svec)
+{
+	CHECK_PARAM_NULL(svec);
+
+	return svec->ptr;
+}
+
+size_t ax_svec_capacity(const ax_svec *svec)
+{
+	CHECK_PARAM_NULL(svec);
+
+	return svec->capacity;
+}
+
+bool ax_svec_inlined(const ax_svec *svec)
+{
+	CHECK_PARAM_NULL(svec);
+
+	return is_inlined(svec);
+}
+
+ax_fail ax_svec_reserve(ax_svec *svec, size_t size)
+{
+	CHECK_PARAM_NULL(svec);
+
+	return grow(ax_r(ax_svec, svec), size);
+}
@@ -382,7 +382,7 @@ static ax_fail init_wcs(void* p, va_list *ap) {
 #define TRAIT_HASH(name) \
 	size_t hash_##name(const void* p) \
 	{ \
-		return ax_hash_djb(p, sizeof(TYPE_##name)); \
+		return ax_hash_u64(*(TYPE_##name *)p); \
 	}
 
 TRAIT_HASH(i8)
@@ -393,15 +393,27 @@ TRAIT_HASH(u8)
 TRAIT_HASH(u16)
 TRAIT_HASH(u32)
 TRAIT_HASH(u64)
-TRAIT_HASH(float)
-TRAIT_HASH(double)
 TRAIT_HASH(size)
 TRAIT_HASH(diff)
-TRAIT_HASH(ptr)
+
+size_t hash_float(const void* p)
+{
+	return ax_memhash(p, sizeof(TYPE_float));
+}
+
+size_t hash_double(const void* p)
+{
+	return ax_memhash(p, sizeof(TYPE_double));
+}
+
+size_t hash_ptr(const void* p)
+{
+	return ax_hash_u64((uintptr_t)*(TYPE_ptr *)p);
+}
 
 static size_t hash_void(const void* p)
 {
-	return ax_hash_djb(NULL, 0);
+	return ax_hash_u64(0);
 } 
 
 static size_t hash_str(const void* p)
@@ -0,0 +1,903 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/ulist.h"
+#include "ax/def.h"
+#include "ax/iter.h"
+#include "ax/trait.h"
+#include "ax/mem.h"
+#include "check.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#define NODE_SIZE 512
+#define MIN_CAPACITY 4
+
+#define ELEM_SIZE(b) ax_trait_size(ax_class_data(b.ax_box).elem_tr)
+#undef free
+
+union node_data
+{
+	long double ld;
+	intmax_t im;
+	void *ptr;
+};
+
+struct node_st
+{
+	struct node_st *prev;
+	struct node_st *next;
+	size_t count;
+	union node_data data[];
+};
+
+ax_concrete_begin(ax_ulist)
+	struct node_st *head;
+	struct node_st *tail;
+	size_t size;
+	size_t capacity;
+ax_end;
+
+/* Element position, node is NULL for the end of both directions */
+struct position
+{
+	struct node_st *node;
+	size_t index;
+};
+
+static ax_fail seq_push(ax_seq *seq, const void *val, va_list *ap);
+static ax_fail seq_pop(ax_seq *seq);
+static ax_fail seq_pushf(ax_seq *seq, const void *val, va_list *ap);
+static ax_fail seq_popf(ax_seq *seq);
+static void    seq_invert(ax_seq *seq);
+static ax_fail seq_trunc(ax_seq *seq, size_t size);
+static ax_iter seq_at(const ax_seq *seq, size_t index);
+static void   *seq_last(const ax_seq *seq);
+static void   *seq_first(const ax_seq *seq);
+static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val, va_list *ap);
+
+static size_t  box_size(const ax_box *box);
+static size_t  box_maxsize(const ax_box *box);
+static ax_iter box_begin(ax_box *box);
+static ax_iter box_end(ax_box *box);
+static ax_iter box_rbegin(ax_box *box);
+static ax_iter box_rend(ax_box *box);
+static void    box_clear(ax_box *box);
+
+static ax_any *any_copy(const ax_any *any);
+
+static void    one_free(ax_one *one);
+static const char *one_name(const ax_one *one);
+
+static void    citer_move(ax_citer *it, long i);
+static void    citer_prev(ax_citer *it);
+static void    citer_next(ax_citer *it);
+static bool    citer_less(const ax_citer *it1, const ax_citer *it2);
+static long    citer_dist(const ax_citer *it1, const ax_citer *it2);
+static ax_box *citer_box(const ax_citer *it);
+static size_t  citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr);
+static void    iter_erase(ax_iter *it);
+
+static void    rciter_move(ax_citer *it, long i);
+static void    rciter_prev(ax_citer *it);
+static void    rciter_next(ax_citer *it);
+static bool    rciter_less(const ax_citer *it1, const ax_citer *it2);
+static long    rciter_dist(const ax_citer *it1, const ax_citer *it2);
+static void    riter_erase(ax_iter *it);
+
+static void   *citer_get(const ax_citer *it);
+static ax_fail iter_set(const ax_iter *it, const void *val, va_list *ap);
+
+inline static ax_byte *node_elem(const ax_ulist *ulist, const struct node_st *node, size_t index)
+{
+	ax_ulist_cr self = AX_R_INIT(ax_ulist, ulist);
+	return (ax_byte *)node->data + index * ELEM_SIZE(self);
+}
+
+inline static struct position iter_position(const ax_citer *it)
+{
+	const ax_ulist *self = it->owner;
+	struct node_st *node = (struct node_st *)it->extra;
+	if (!node)
+		return (struct position) { NULL, 0 };
+	return (struct position) {
+		node, ((ax_byte *)it->point - (ax_byte *)node->data) / ELEM_SIZE(ax_cr(ax_ulist, self)),
+	};
+}
+
+inline static void iter_set_position(ax_citer *it, struct position pos)
+{
+	it->extra = (uintptr_t)pos.node;
+	it->point = pos.node ? node_elem(it->owner, pos.node, pos.index) : NULL;
+}
+
+inline static struct position next_position(const ax_ulist *ulist, struct position pos)
+{
+	if (!pos.node)
+		return (struct position) { ulist->head, 0 };
+	if (pos.index + 1 < pos.node->count)
+		return (struct position) { pos.node, pos.index + 1 };
+	return (struct position) { pos.node->next, 0 };
+}
+
+inline static struct position prev_position(const ax_ulist *ulist, struct position pos)
+{
+	if (!pos.node)
+		return ulist->tail
+			? (struct position) { ulist->tail, ulist->tail->count - 1 }
+			: (struct position) { NULL, 0 };
+	if (pos.index > 0)
+		return (struct position) { pos.node, pos.index - 1 };
+	return pos.node->prev
+		? (struct position) { pos.node->prev, pos.node->prev->count - 1 }
+		: (struct position) { NULL, 0 };
+}
+
+/* Index of the position counted from head, the end is size */
+static size_t position_index(const ax_ulist *ulist, struct position pos)
+{
+	if (!pos.node)
+		return ulist->size;
+	size_t index = pos.index;
+	for (const struct node_st *node = pos.node->prev; node; node = node->prev)
+		index += node->count;
+	return index;
+}
+
+static struct position index_position(const ax_ulist *ulist, size_t index)
+{
+	struct node_st *node = ulist->head;
+	while (node && index >= node->count) {
+		index -= node->count;
+		node = node->next;
+	}
+	return (struct position) { node, node ? index : 0 };
+}
+
+static struct node_st *node_alloc(const ax_ulist *ulist)
+{
+	ax_ulist_cr self = AX_R_INIT(ax_ulist, ulist);
+	struct node_st *node = malloc(sizeof(struct node_st) + ulist->capacity * ELEM_SIZE(self));
+	if (!node)
+		return NULL;
+	node->prev = node->next = NULL;
+	node->count = 0;
+	return node;
+}
+
+static void link_after(ax_ulist *ulist, struct node_st *pos, struct node_st *node)
+{
+	node->prev = pos;
+	node->next = pos ? pos->next : ulist->head;
+	if (node->next)
+		node->next->prev = node;
+	else
+		ulist->tail = node;
+	if (pos)
+		pos->next = node;
+	else
+		ulist->head = node;
+}
+
+static void unlink_node(ax_ulist *ulist, struct node_st *node)
+{
+	if (node->prev)
+		node->prev->next = node->next;
+	else
+		ulist->head = node->next;
+	if (node->next)
+		node->next->prev = node->prev;
+	else
+		ulist->tail = node->prev;
+	free(node);
+}
+
+/*
+ * Insert an element before the position index of node, index may be equal to
+ * the count of the node. A full node is split in half first. The position of
+ * the new element is returned, or node is NULL on failure.
+ */
+static struct position insert_at(ax_ulist *ulist, struct node_st *node, size_t index,
+		const void *val, va_list *ap)
+{
+	ax_ulist_r self = AX_R_INIT(ax_ulist, ulist);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t elem_size = ELEM_SIZE(self);
+	struct position fail = { NULL, 0 };
+
+	if (node->count == ulist->capacity) {
+		struct node_st *new_node = node_alloc(ulist);
+		if (!new_node)
+			return fail;
+		size_t half = node->count / 2;
+		memcpy(new_node->data, node_elem(ulist, node, half), (node->count - half) * elem_size);
+		new_node->count = node->count - half;
+		node->count = half;
+		link_after(ulist, node, new_node);
+		if (index > half) {
+			node = new_node;
+			index -= half;
+		}
+	}
+
+	ax_byte *ins = node_elem(ulist, node, index);
+	memmove(ins + elem_size, ins, (node->count - index) * elem_size);
+	if (ax_trait_copy_or_init(etr, ins, val, ap)) {
+		memmove(ins, ins + elem_size, (node->count - index) * elem_size);
+		return fail;
+	}
+	node->count++;
+	ulist->size++;
+	return (struct position) { node, index };
+}
+
+/*
+ * Unlink a node left empty, otherwise refill it when it is under half full
+ * from its next node, or from its previous one at the tail, by merging the
+ * two when they fit in one node and by moving half of the difference
+ * otherwise. pos is in node and may be at its end, the position of the same
+ * element is returned.
+ */
+static struct position refill(ax_ulist *ulist, struct position pos)
+{
+	ax_ulist_r self = AX_R_INIT(ax_ulist, ulist);
+	size_t elem_size = ELEM_SIZE(self);
+	struct node_st *node = pos.node, *next = node->next, *prev = node->prev;
+
+	/* Popping at a node boundary must not copy a neighbour into it */
+	if (node->count == 0) {
+		unlink_node(ulist, node);
+		return (struct position) { next, 0 };
+	}
+
+	if (node->count >= ulist->capacity / 2)
+		goto out;
+
+	if (next) {
+		size_t n = node->count + next->count <= ulist->capacity
+			? next->count
+			: (next->count - node->count) / 2;
+		memcpy(node_elem(ulist, node, node->count), next->data, n * elem_size);
+		memmove(next->data, node_elem(ulist, next, n), (next->count - n) * elem_size);
+		node->count += n;
+		next->count -= n;
+		if (next->count == 0)
+			unlink_node(ulist, next);
+	} else if (prev) {
+		size_t n = node->count + prev->count <= ulist->capacity
+			? prev->count
+			: (prev->count - node->count) / 2;
+		memmove(node_elem(ulist, node, n), node->data, node->count * elem_size);
+		memcpy(node->data, node_elem(ulist, prev, prev->count - n), n * elem_size);
+		node->count += n;
+		prev->count -= n;
+		pos.index += n;
+		if (prev->count == 0)
+			unlink_node(ulist, prev);
+	}
+out:
+	return pos.index < node->count ? pos : (struct position) { node->next, 0 };
+}
+
+/* Erase the element at pos, the position of the element following it is returned */
+static struct position erase_at(ax_ulist *ulist, struct position pos)
+{
+	ax_ulist_r self = AX_R_INIT(ax_ulist, ulist);
+	size_t elem_size = ELEM_SIZE(self);
+	struct node_st *node = pos.node;
+
+	ax_byte *elem = node_elem(ulist, node, pos.index);
+	ax_trait_free(ax_class_data(self.ax_box).elem_tr, elem);
+	memmove(elem, elem + elem_size, (node->count - pos.index - 1) * elem_size);
+	node->count--;
+	ulist->size--;
+
+	return refill(ulist, pos);
+}
+
+#ifndef NDEBUG
+static bool iter_if_valid(const ax_citer *it)
+{
+	const struct node_st *node = (struct node_st *)it->extra;
+	if (!node)
+		return it->point == NULL;
+	return (ax_byte *)it->point >= (ax_byte *)node->data
+		&& (ax_byte *)it->point < node_elem(it->owner, node, node->count);
+}
+#endif
+
+static void citer_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	const ax_ulist *self = it->owner;
+	size_t index = position_index(self, iter_position(it)) + i;
+	CHECK_PARAM_VALIDITY(i, index <= self->size);
+	iter_set_position(it, index_position(self, index));
+}
+
+static void citer_prev(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	const ax_ulist *self = it->owner;
+	struct position pos = prev_position(self, iter_position(it));
+	ax_assert(pos.node, "iterator boundary exceed");
+	iter_set_position(it, pos);
+}
+
+static void citer_next(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->point && iter_if_valid(it));
+
+	iter_set_position(it, next_position(it->owner, iter_position(it)));
+}
+
+static bool citer_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_ulist *self = it1->owner;
+	return position_index(self, iter_position(it1)) < position_index(self, iter_position(it2));
+}
+
+static long citer_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_ulist *self = it1->owner;
+	return (long)position_index(self, iter_position(it2))
+		- (long)position_index(self, iter_position(it1));
+}
+
+static ax_box *citer_box(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	return (ax_box *)it->owner;
+}
+
+static size_t citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	struct position pos = iter_position(it);
+	if (!pos.node)
+		return 0;
+
+	size_t end = pos.node->count;
+	if (last) {
+		CHECK_ITER_COMPARABLE(it, last);
+		if ((struct node_st *)last->extra == pos.node)
+			end = iter_position(last).index;
+	}
+
+	size_t n = end - pos.index;
+	if (n > max)
+		n = max;
+	*ptr = it->point;
+
+	if (pos.index + n == pos.node->count)
+		iter_set_position(it, (struct position) { pos.node->next, 0 });
+	else
+		iter_set_position(it, (struct position) { pos.node, pos.index + n });
+	return n;
+}
+
+/* A reversed iterator maps index i to size - 1 - i, so rend is at size */
+static size_t rposition_index(const ax_ulist *ulist, struct position pos)
+{
+	return pos.node ? ulist->size - 1 - position_index(ulist, pos) : ulist->size;
+}
+
+static void rciter_move(ax_citer *it, long i)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	const ax_ulist *self = it->owner;
+	size_t rindex = rposition_index(self, iter_position(it)) + i;
+	CHECK_PARAM_VALIDITY(i, rindex <= self->size);
+	iter_set_position(it, rindex == self->size
+			? (struct position) { NULL, 0 }
+			: index_position(self, self->size - 1 - rindex));
+}
+
+static void rciter_prev(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	const ax_ulist *self = it->owner;
+	struct position pos = iter_position(it);
+	ax_assert(pos.node ? pos.index + 1 < pos.node->count || pos.node->next : !!self->head,
+			"iterator boundary exceed");
+	iter_set_position(it, next_position(self, pos));
+}
+
+static void rciter_next(ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->point && iter_if_valid(it));
+
+	iter_set_position(it, prev_position(it->owner, iter_position(it)));
+}
+
+static bool rciter_less(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_ulist *self = it1->owner;
+	return rposition_index(self, iter_position(it1)) < rposition_index(self, iter_position(it2));
+}
+
+static long rciter_dist(const ax_citer *it1, const ax_citer *it2)
+{
+	CHECK_ITER_COMPARABLE(it1, it2);
+
+	const ax_ulist *self = it1->owner;
+	return (long)rposition_index(self, iter_position(it2))
+		- (long)rposition_index(self, iter_position(it1));
+}
+
+static void *citer_get(const ax_citer *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	return it->point;
+}
+
+static ax_fail iter_set(const ax_iter *it, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	ax_ulist_cr self = AX_R_INIT(ax_one, it->owner);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	ax_byte tmp[ax_trait_size(etr)];
+	if (ax_trait_copy_or_init(etr, tmp, val, ap))
+		return true;
+	ax_trait_free(etr, it->point);
+	memcpy(it->point, tmp, ax_trait_size(etr));
+	return false;
+}
+
+static void iter_erase(ax_iter *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	ax_ulist *self = (ax_ulist *)it->owner;
+	iter_set_position(ax_iter_c(it), erase_at(self, iter_position(ax_iter_c(it))));
+}
+
+static void riter_erase(ax_iter *it)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_ITERATOR_VALIDITY(it, it->owner && it->tr && it->point);
+
+	ax_ulist *self = (ax_ulist *)it->owner;
+	/* The element in front of the erased one may have been moved by refill */
+	struct position next = erase_at(self, iter_position(ax_iter_c(it)));
+	iter_set_position(ax_iter_c(it), prev_position(self, next));
+}
+
+static void one_free(ax_one *one)
+{
+	if (!one)
+		return;
+
+	ax_ulist_r self = AX_R_INIT(ax_one, one);
+	box_clear(self.ax_box);
+	free(one);
+}
+
+static const char *one_name(const ax_one *one)
+{
+	return ax_class_name(4, ax_ulist);
+}
+
+static ax_dump *any_dump(const ax_any *any)
+{
+	ax_ulist_cr self = AX_R_INIT(ax_any, any);
+	return ax_seq_dump(self.ax_seq);
+}
+
+static ax_any *any_copy(const ax_any *any)
+{
+	CHECK_PARAM_NULL(any);
+
+	ax_ulist_cr self = AX_R_INIT(ax_any, any);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+
+	ax_ulist_r copy = { .ax_seq = __ax_ulist_construct(etr) };
+	if (!copy.ax_one)
+		return NULL;
+
+	for (const struct node_st *node = self.ax_ulist->head; node; node = node->next) {
+		struct node_st *new_node = node_alloc(copy.ax_ulist);
+		if (!new_node)
+			goto fail;
+		link_after(copy.ax_ulist, copy.ax_ulist->tail, new_node);
+		for (size_t i = 0; i < node->count; i++) {
+			if (ax_trait_copy(etr, node_elem(copy.ax_ulist, new_node, i),
+						node_elem(self.ax_ulist, node, i)))
+				goto fail;
+			new_node->count++;
+			copy.ax_ulist->size++;
+		}
+	}
+
+	return copy.ax_any;
+fail:
+	one_free(copy.ax_one);
+	return NULL;
+}
+
+static size_t box_size(const ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_ulist_cr self = AX_R_INIT(ax_box, box);
+	return self.ax_ulist->size;
+}
+
+static size_t box_maxsize(const ax_box *box)
+{
+	return PTRDIFF_MAX;
+}
+
+static ax_iter box_begin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_ulist_r self = AX_R_INIT(ax_box, box);
+	ax_iter it = {
+		.owner = box,
+		.tr = &ax_ulist_tr.ax_box.iter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	iter_set_position(ax_iter_c(&it), (struct position) { self.ax_ulist->head, 0 });
+	return it;
+}
+
+static ax_iter box_end(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return (ax_iter) {
+		.owner = box,
+		.tr = &ax_ulist_tr.ax_box.iter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+}
+
+static ax_iter box_rbegin(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_ulist_r self = AX_R_INIT(ax_box, box);
+	ax_iter it = {
+		.owner = box,
+		.tr = &ax_ulist_tr.ax_box.riter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+	iter_set_position(ax_iter_c(&it), prev_position(self.ax_ulist, (struct position) { NULL, 0 }));
+	return it;
+}
+
+static ax_iter box_rend(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	return (ax_iter) {
+		.owner = box,
+		.tr = &ax_ulist_tr.ax_box.riter,
+		.etr = ax_class_data(box).elem_tr,
+	};
+}
+
+static void box_clear(ax_box *box)
+{
+	CHECK_PARAM_NULL(box);
+
+	ax_ulist_r self = AX_R_INIT(ax_box, box);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+
+	struct node_st *node = self.ax_ulist->head;
+	while (node) {
+		struct node_st *next = node->next;
+		if (etr->t_free)
+			for (size_t i = 0; i < node->count; i++)
+				ax_trait_free(etr, node_elem(self.ax_ulist, node, i));
+		free(node);
+		node = next;
+	}
+	self.ax_ulist->head = self.ax_ulist->tail = NULL;
+	self.ax_ulist->size = 0;
+}
+
+static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	ax_ulist_r self = AX_R_INIT(ax_seq, seq);
+	struct position pos = iter_position(ax_iter_c(it));
+
+	if (!pos.node)
+		return ax_iter_norm(it)
+			? seq_push(seq, val, ap)
+			: seq_pushf(seq, val, ap);
+
+	/* A reversed iterator inserts behind the element in memory order */
+	struct position ins = insert_at(self.ax_ulist, pos.node,
+			ax_iter_norm(it) ? pos.index : pos.index + 1, val, ap);
+	if (!ins.node)
+		return true;
+
+	iter_set_position(ax_iter_c(it), ax_iter_norm(it)
+			? next_position(self.ax_ulist, ins)
+			: prev_position(self.ax_ulist, ins));
+	return false;
+}
+
+static ax_fail seq_push(ax_seq *seq, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist_r self = AX_R_INIT(ax_seq, seq);
+	ax_ulist *ulist = self.ax_ulist;
+	struct node_st *tail = ulist->tail;
+
+	if (!tail || tail->count == ulist->capacity) {
+		struct node_st *node = node_alloc(ulist);
+		if (!node)
+			return true;
+		link_after(ulist, tail, node);
+		if (!insert_at(ulist, node, 0, val, ap).node) {
+			unlink_node(ulist, node);
+			return true;
+		}
+		return false;
+	}
+
+	return !insert_at(ulist, tail, tail->count, val, ap).node;
+}
+
+static ax_fail seq_pop(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist_r self = AX_R_INIT(ax_seq, seq);
+	ax_ulist *ulist = self.ax_ulist;
+	if (ulist->size == 0)
+		return false;
+
+	erase_at(ulist, (struct position) { ulist->tail, ulist->tail->count - 1 });
+	return false;
+}
+
+static ax_fail seq_pushf(ax_seq *seq, const void *val, va_list *ap)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist_r self = AX_R_INIT(ax_seq, seq);
+	ax_ulist *ulist = self.ax_ulist;
+	struct node_st *head = ulist->head;
+
+	if (!head || head->count == ulist->capacity) {
+		struct node_st *node = node_alloc(ulist);
+		if (!node)
+			return true;
+		link_after(ulist, NULL, node);
+		if (!insert_at(ulist, node, 0, val, ap).node) {
+			unlink_node(ulist, node);
+			return true;
+		}
+		return false;
+	}
+
+	return !insert_at(ulist, head, 0, val, ap).node;
+}
+
+static ax_fail seq_popf(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist_r self = AX_R_INIT(ax_seq, seq);
+	ax_ulist *ulist = self.ax_ulist;
+	if (ulist->size == 0)
+		return false;
+
+	erase_at(ulist, (struct position) { ulist->head, 0 });
+	return false;
+}
+
+static void seq_invert(ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+
+	ax_ulist_r self = AX_R_INIT(ax_seq, seq);
+	ax_ulist *ulist = self.ax_ulist;
+	size_t elem_size = ELEM_SIZE(self);
+
+	struct position left = { ulist->head, 0 },
+			right = prev_position(ulist, (struct position) { NULL, 0 });
+	for (size_t i = 0; i < ulist->size / 2; i++) {
+		ax_memswp(node_elem(ulist, left.node, left.index),
+				node_elem(ulist, right.node, right.index), elem_size);
+		left = next_position(ulist, left);
+		right = prev_position(ulist, right);
+	}
+}
+
+static ax_fail seq_trunc(ax_seq *seq, size_t size)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(size, size <= box_maxsize(ax_r(ax_seq, seq).ax_box));
+
+	ax_ulist_r self = AX_R_INIT(ax_seq, seq);
+	while (self.ax_ulist->size > size)
+		seq_pop(seq);
+	while (self.ax_ulist->size < size)
+		if (seq_push(seq, NULL, NULL))
+			return true;
+	return false;
+}
+
+static ax_iter seq_at(const ax_seq *seq, size_t index)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(index, index <= ax_box_size(ax_cr(ax_seq, seq).ax_box));
+
+	ax_ulist_cr self = AX_R_INIT(ax_seq, seq);
+	ax_iter it = {
+		.owner = (void *)seq,
+		.tr = &ax_ulist_tr.ax_box.iter,
+		.etr = ax_class_data(self.ax_box).elem_tr,
+	};
+	iter_set_position(ax_iter_c(&it), index_position(self.ax_ulist, index));
+	return it;
+}
+
+static void *seq_last(const ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+	ax_assert(ax_box_size(ax_cr(ax_seq, seq).ax_box) > 0, "empty");
+
+	ax_ulist_cr self = AX_R_INIT(ax_seq, seq);
+	const struct node_st *tail = self.ax_ulist->tail;
+	return node_elem(self.ax_ulist, tail, tail->count - 1);
+}
+
+static void *seq_first(const ax_seq *seq)
+{
+	CHECK_PARAM_NULL(seq);
+	ax_assert(ax_box_size(ax_cr(ax_seq, seq).ax_box) > 0, "empty");
+
+	ax_ulist_cr self = AX_R_INIT(ax_seq, seq);
+	return self.ax_ulist->head->data;
+}
+
+const ax_seq_trait ax_ulist_tr =
+{
+	.ax_box = {
+		.ax_any = {
+			.ax_one = {
+				.free = one_free,
+				.name = one_name,
+			},
+			.dump = any_dump,
+			.copy = any_copy,
+		},
+		.iter = {
+			.norm = true,
+			.type = AX_IT_BID,
+			.move = citer_move,
+			.next = citer_next,
+			.prev = citer_prev,
+			.dist = citer_dist,
+			.less = citer_less,
+			.box  = citer_box,
+			.span = citer_span,
+			.get = citer_get,
+			.set = iter_set,
+			.erase = iter_erase,
+		},
+		.riter = {
+			.norm = false,
+			.type = AX_IT_BID,
+			.move = rciter_move,
+			.next = rciter_next,
+			.prev = rciter_prev,
+			.dist = rciter_dist,
+			.less = rciter_less,
+			.box  = citer_box,
+			.get = citer_get,
+			.set = iter_set,
+			.erase = riter_erase,
+		},
+
+		.size = box_size,
+		.maxsize = box_maxsize,
+
+		.begin = box_begin,
+		.end = box_end,
+		.rbegin = box_rbegin,
+		.rend = box_rend,
+
+		.clear = box_clear,
+	},
+	.push = seq_push,
+	.pop = seq_pop,
+	.pushf = seq_pushf,
+	.popf = seq_popf,
+	.invert = seq_invert,
+	.trunc = seq_trunc,
+	.at = seq_at,
+	.last = seq_last,
+	.first = seq_first,
+	.insert = seq_insert,
+};
+
+ax_seq *__ax_ulist_construct(const ax_trait *elem_tr)
+{
+	CHECK_PARAM_NULL(elem_tr);
+
+	size_t capacity = (NODE_SIZE - sizeof(struct node_st)) / ax_trait_size(elem_tr);
+	if (capacity < MIN_CAPACITY)
+		capacity = MIN_CAPACITY;
+
+	ax_ulist *ulist = malloc(sizeof(ax_ulist));
+	if (!ulist)
+		return NULL;
+
+	ax_ulist ulist_init = {
+		.ax_seq = {
+			.tr = &ax_ulist_tr,
+			.env.ax_box.elem_tr = elem_tr,
+		},
+		.head = NULL,
+		.tail = NULL,
+		.size = 0,
+		.capacity = capacity,
+	};
+
+	memcpy(ulist, &ulist_init, sizeof ulist_init);
+	return ax_r(ax_ulist, ulist).ax_seq;
+}
+
+size_t ax_ulist_node_capacity(const ax_ulist *ulist)
+{
+	CHECK_PARAM_NULL(ulist);
+
+	return ulist->capacity;
+}
@@ -50,6 +50,9 @@ static void   *seq_last(const ax_seq *seq);
 static void   *seq_first(const ax_seq *seq);
 
 static ax_fail seq_insert(ax_seq *seq, ax_iter *it, const void *val, va_list *ap);
+static ax_fail seq_push_n(ax_seq *seq, const void *arr, size_t n);
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last);
+static void    seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last);
 
 static size_t  box_size(const ax_box *box);
 static size_t  box_maxsize(const ax_box *box);
@@ -70,6 +73,7 @@ static void    citer_next(ax_citer *it);
 static bool    citer_less(const ax_citer *it1, const ax_citer *it2);
 static long    citer_dist(const ax_citer *it1, const ax_citer *it2);
 ax_box        *citer_box(const ax_citer *it);
+static size_t  citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr);
 static void    iter_erase(ax_iter *it);
 
 static void    rciter_move(ax_citer *it, long i);
@@ -167,6 +171,27 @@ ax_box *citer_box(const ax_citer *it)
 	return (ax_box *)it->owner;
 }
 
+static size_t citer_span(ax_citer *it, const ax_citer *last, size_t max, void **ptr)
+{
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, iter_if_valid(it));
+
+	ax_vector_cr self = AX_R_INIT(ax_one, it->owner);
+	ax_byte *end;
+	if (last) {
+		CHECK_ITER_COMPARABLE(it, last);
+		end = last->point;
+	} else
+		end = (ax_byte *)ax_buff_ptr(self.ax_vector->buff) + ax_buff_size(self.ax_vector->buff, NULL);
+
+	size_t n = (end - (ax_byte *)it->point) / ELEM_SIZE(self);
+	if (n > max)
+		n = max;
+	*ptr = it->point;
+	it->point = (ax_byte *)it->point + n * ELEM_SIZE(self);
+	return n;
+}
+
 static void rciter_move(ax_citer *it, long i)
 {
 	CHECK_PARAM_NULL(it);
@@ -533,6 +558,120 @@ static ax_fail seq_trunc(ax_seq *seq, size_t size)
 	return false;
 }
 
+static ax_fail seq_push_n(ax_seq *seq, const void *arr, size_t n)
+{
+	CHECK_PARAM_NULL(seq);
+
+	const ax_vector_cr self = AX_R_INIT(ax_seq, seq);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t size = ax_buff_size(self.ax_vector->buff, NULL);
+
+	if (n == 0)
+		return false;
+
+	if (ax_buff_adapt(self.ax_vector->buff, size + n * ELEM_SIZE(self)))
+		return true;
+
+	ax_byte *dst = (ax_byte *)ax_buff_ptr(self.ax_vector->buff) + size;
+	if (!etr->t_copy) {
+		memcpy(dst, arr, n * ELEM_SIZE(self));
+		return false;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		if (ax_trait_copy(etr, dst + i * ELEM_SIZE(self), (ax_byte *)arr + i * ELEM_SIZE(self))) {
+			while (i--)
+				ax_trait_free(etr, dst + i * ELEM_SIZE(self));
+			ax_buff_resize(self.ax_vector->buff, size);
+			return true;
+		}
+	}
+	return false;
+}
+
+static ax_fail seq_insert_range(ax_seq *seq, ax_iter *it, const ax_citer *first, const ax_citer *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_NULL(it);
+	CHECK_PARAM_VALIDITY(it, it->owner == seq && iter_if_valid(ax_iter_c(it)));
+
+	const ax_vector_cr self = AX_R_INIT(ax_seq, seq);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	size_t esize = ELEM_SIZE(self);
+	size_t n = ax_citer_range_size(first, last);
+	ax_byte *ptr = ax_buff_ptr(self.ax_vector->buff);
+	size_t size = ax_buff_size(self.ax_vector->buff, NULL);
+
+	if (n == 0)
+		return false;
+
+	long offset = (ax_byte *)it->point - ptr; //backup offset before realloc
+
+	if (ax_buff_adapt(self.ax_vector->buff, size + n * esize))
+		return true;
+
+	ptr = ax_buff_ptr(self.ax_vector->buff);
+	it->point = ptr + offset; //restore offset
+
+	/* A reversed iterator sees the range backward in memory */
+	ax_byte *ins = ax_iter_norm(it) ? it->point : ((ax_byte*)it->point + esize);
+	memmove(ins + n * esize, ins, ptr + size - ins);
+
+	ax_citer cur = *first;
+	for (size_t i = 0; i < n; i++) {
+		ax_byte *dst = ins + (ax_iter_norm(it) ? i : n - 1 - i) * esize;
+		if (ax_trait_copy(etr, dst, cur.tr->get(&cur))) {
+			while (i--)
+				ax_trait_free(etr, ins + (ax_iter_norm(it) ? i : n - 1 - i) * esize);
+			memmove(ins, ins + n * esize, ptr + size - ins);
+			ax_buff_resize(self.ax_vector->buff, size);
+			return true;
+		}
+		ax_citer_next(&cur);
+	}
+
+	if (ax_iter_norm(it))
+		it->point = (ax_byte*)it->point + n * esize;
+	return false;
+}
+
+static void seq_erase_range(ax_seq *seq, ax_iter *first, ax_iter *last)
+{
+	CHECK_PARAM_NULL(seq);
+	CHECK_PARAM_VALIDITY(first, iter_if_valid(ax_iter_c(first)));
+	CHECK_PARAM_VALIDITY(last, iter_if_valid(ax_iter_c(last)));
+
+	const ax_vector_cr self = AX_R_INIT(ax_seq, seq);
+	const ax_trait *etr = ax_class_data(self.ax_box).elem_tr;
+	ax_byte *ptr = ax_buff_ptr(self.ax_vector->buff);
+	size_t size = ax_buff_size(self.ax_vector->buff, NULL);
+
+	ax_byte *begin, *end;
+	if (ax_iter_norm(first)) {
+		begin = first->point;
+		end = last->point;
+	} else {
+		begin = (ax_byte *)last->point + ELEM_SIZE(self);
+		end = (ax_byte *)first->point + ELEM_SIZE(self);
+	}
+
+	if (begin >= end)
+		return;
+
+	if (etr->t_free)
+		for (ax_byte *p = begin; p < end; p += ELEM_SIZE(self))
+			ax_trait_free(etr, p);
+	memmove(begin, end, ptr + size - end);
+
+	if (ax_iter_norm(first))
+		*last = *first;
+	else
+		*first = *last;
+
+	(void)ax_buff_adapt(self.ax_vector->buff, size - (end - begin));
+	first->point = last->point = (ax_byte *)ax_buff_ptr(self.ax_vector->buff) + ((ax_byte *)first->point - ptr);
+}
+
 static ax_iter seq_at(const ax_seq *seq, size_t index)
 {
 	CHECK_PARAM_NULL(seq);
@@ -591,6 +730,7 @@ const ax_seq_trait ax_vector_tr =
 			.dist = citer_dist,
 			.less = citer_less,
 			.box  = citer_box,
+			.span = citer_span,
 			.get = citer_get,
 			.set = iter_set,
 			.erase = iter_erase,
@@ -629,6 +769,9 @@ const ax_seq_trait ax_vector_tr =
 	.last = seq_last,
 	.first = seq_first,
 	.insert = seq_insert,
+	.push_n = seq_push_n,
+	.insert_range = seq_insert_range,
+	.erase_range = seq_erase_range,
 };
 
 ax_seq *__ax_vector_construct(const ax_trait *elem_tr)
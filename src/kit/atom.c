@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/atom.h"
+#include "ax/ihash.h"
+#include "ax/rwlock.h"
+#include "ax/mem.h"
+#include "ax/dump.h"
+#include "ax/sys.h"
+
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#undef free
+
+#define BLOCK_SIZE (64 * 1024)
+
+/* The string follows the entry, the probe used for lookup points elsewhere */
+struct entry_st
+{
+	ax_ihash_node node;
+	const char *str;
+	size_t len;
+};
+
+struct block_st
+{
+	struct block_st *next;
+	size_t size;
+	size_t used;
+	union {
+		void *p;
+		size_t n;
+	} data[];
+};
+
+struct shard_st
+{
+	ax_rwlock lock;
+	ax_ihash table;
+	struct block_st *blocks;
+	ax_byte padding[64]; /* Keep locks of adjacent shards off the same cache line */
+};
+
+struct ax_atom_st
+{
+	size_t nshard;
+	struct shard_st *shards;
+};
+
+static bool entry_equal(const ax_ihash_node *node1, const ax_ihash_node *node2, void *ctx)
+{
+	const struct entry_st *e1 = ax_ihash_entry(node1, struct entry_st, node),
+	      *e2 = ax_ihash_entry(node2, struct entry_st, node);
+	return e1->len == e2->len && !memcmp(e1->str, e2->str, e1->len);
+}
+
+/*
+ * Bump allocation from the head block. A string too large for what is left
+ * gets a block of its own, which is linked behind the head so that the
+ * space left in the head is still used.
+ */
+static void *shard_alloc(struct shard_st *shard, size_t size)
+{
+	size = (size + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+
+	struct block_st *head = shard->blocks;
+	if (head && head->size - head->used >= size) {
+		void *p = (ax_byte *)head->data + head->used;
+		head->used += size;
+		return p;
+	}
+
+	size_t block_size = size > BLOCK_SIZE / 4 ? size : BLOCK_SIZE;
+	struct block_st *block = malloc(sizeof *block + block_size);
+	if (!block)
+		return NULL;
+	block->size = block_size;
+	block->used = size;
+	if (head && size > BLOCK_SIZE / 4) {
+		block->next = head->next;
+		head->next = block;
+	} else {
+		block->next = head;
+		shard->blocks = block;
+	}
+	return block->data;
+}
+
+static struct shard_st *locate_shard(ax_atom *atom, size_t hash)
+{
+	return atom->shards + ax_hash64_thomas(hash) % atom->nshard;
+}
+
+ax_atom *ax_atom_create(size_t nshard)
+{
+	if (!nshard) {
+		int nprocs = ax_sys_nprocs();
+		nshard = nprocs > 4 ? nprocs * 4 : 16;
+	}
+
+	ax_atom *atom = malloc(sizeof *atom);
+	if (!atom)
+		return NULL;
+
+	atom->nshard = 0;
+	atom->shards = malloc(nshard * sizeof(struct shard_st));
+	if (!atom->shards)
+		goto fail;
+
+	for (; atom->nshard < nshard; atom->nshard++) {
+		struct shard_st *shard = atom->shards + atom->nshard;
+		shard->blocks = NULL;
+		if (ax_ihash_init(&shard->table, entry_equal, NULL))
+			goto fail;
+		if (ax_rwlock_init(&shard->lock)) {
+			ax_ihash_destroy(&shard->table);
+			goto fail;
+		}
+	}
+	return atom;
+fail:
+	ax_atom_free(atom);
+	return NULL;
+}
+
+void ax_atom_free(ax_atom *atom)
+{
+	if (!atom)
+		return;
+
+	for (size_t i = 0; i < atom->nshard; i++) {
+		struct shard_st *shard = atom->shards + i;
+		ax_rwlock_destroy(&shard->lock);
+		ax_ihash_destroy(&shard->table);
+		while (shard->blocks) {
+			struct block_st *next = shard->blocks->next;
+			free(shard->blocks);
+			shard->blocks = next;
+		}
+	}
+	free(atom->shards);
+	free(atom);
+}
+
+const char *ax_atom_intern_n(ax_atom *atom, const char *s, size_t len)
+{
+	assert(atom);
+	assert(s || !len);
+
+	if (!len)
+		s = "";
+	struct entry_st probe = { .str = s, .len = len };
+	size_t hash = ax_memhash(s, len);
+	struct shard_st *shard = locate_shard(atom, hash);
+
+	ax_rwlock_rlock(&shard->lock);
+	ax_ihash_node *node = ax_ihash_find(&shard->table, &probe.node, hash);
+	ax_rwlock_unlock(&shard->lock);
+	if (node)
+		return ax_ihash_entry(node, struct entry_st, node)->str;
+
+	/* Another thread may have interned it before the write lock is held */
+	const char *ret = NULL;
+	ax_rwlock_wlock(&shard->lock);
+	node = ax_ihash_find(&shard->table, &probe.node, hash);
+	if (node) {
+		ret = ax_ihash_entry(node, struct entry_st, node)->str;
+		goto out;
+	}
+
+	struct entry_st *entry = shard_alloc(shard, sizeof *entry + len + 1);
+	if (!entry)
+		goto out;
+
+	char *str = (char *)(entry + 1);
+	memcpy(str, s, len);
+	str[len] = '\0';
+	entry->str = str;
+	entry->len = len;
+	ax_ihash_insert(&shard->table, &entry->node, hash);
+	ret = str;
+out:
+	ax_rwlock_unlock(&shard->lock);
+	return ret;
+}
+
+const char *ax_atom_intern(ax_atom *atom, const char *s)
+{
+	assert(s);
+	return ax_atom_intern_n(atom, s, strlen(s));
+}
+
+const char *ax_atom_lookup(ax_atom *atom, const char *s)
+{
+	assert(atom);
+	assert(s);
+
+	struct entry_st probe = { .str = s, .len = strlen(s) };
+	size_t hash = ax_memhash(s, probe.len);
+	struct shard_st *shard = locate_shard(atom, hash);
+
+	ax_rwlock_rlock(&shard->lock);
+	ax_ihash_node *node = ax_ihash_find(&shard->table, &probe.node, hash);
+	ax_rwlock_unlock(&shard->lock);
+	return node ? ax_ihash_entry(node, struct entry_st, node)->str : NULL;
+}
+
+size_t ax_atom_size(ax_atom *atom)
+{
+	assert(atom);
+
+	size_t size = 0;
+	for (size_t i = 0; i < atom->nshard; i++) {
+		struct shard_st *shard = atom->shards + i;
+		ax_rwlock_rlock(&shard->lock);
+		size += ax_ihash_size(&shard->table);
+		ax_rwlock_unlock(&shard->lock);
+	}
+	return size;
+}
+
+size_t ax_atom_length(const char *s)
+{
+	assert(s);
+	return ((const struct entry_st *)s - 1)->len;
+}
+
+static bool equal_atom(const void *p1, const void *p2)
+{
+	return *(const char **)p1 == *(const char **)p2;
+}
+
+static bool less_atom(const void *p1, const void *p2)
+{
+	return (uintptr_t)*(const char **)p1 < (uintptr_t)*(const char **)p2;
+}
+
+static size_t hash_atom(const void *p)
+{
+	return ax_hash_u64((uintptr_t)*(const char **)p);
+}
+
+static ax_dump *dump_atom(const void *p)
+{
+	const char *s = *(const char **)p;
+	return s ? ax_dump_str(s) : ax_dump_symbol("NULL");
+}
+
+static ax_fail copy_atom(void *dst, const void *src)
+{
+	*(const char **)dst = *(const char **)src;
+	return false;
+}
+
+static ax_fail init_atom(void *p, va_list *ap)
+{
+	*(const char **)p = ap ? va_arg(*ap, const char *) : NULL;
+	return false;
+}
+
+static void free_atom(void *p)
+{
+}
+
+const ax_trait ax_t_atom = {
+	.t_size  = sizeof(const char *),
+	.t_equal = equal_atom,
+	.t_less  = less_atom,
+	.t_dump  = dump_atom,
+	.t_hash  = hash_atom,
+	.t_free  = free_atom,
+	.t_copy  = copy_atom,
+	.t_init  = init_atom,
+	.t_link  = true
+};
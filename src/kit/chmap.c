@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/chmap.h"
+#include "ax/hmap.h"
+#include "ax/rwlock.h"
+#include "ax/mem.h"
+#include "ax/sys.h"
+
+#include <stdlib.h>
+#include <errno.h>
+
+#undef free
+
+struct shard_st
+{
+	ax_rwlock lock;
+	ax_map *map;
+	ax_byte padding[64]; /* Keep locks of adjacent shards off the same cache line */
+};
+
+struct ax_chmap_st
+{
+	const ax_trait *key_tr;
+	const ax_trait *val_tr;
+	size_t nshard;
+	struct shard_st *shards;
+};
+
+inline static ax_hmap *shard_hmap(const struct shard_st *shard)
+{
+	ax_hmap_r hmap = AX_R_INIT(ax_map, shard->map);
+	return hmap.ax_hmap;
+}
+
+/* The hash picking the shard is passed to the hmap of the shard as well,
+ * so the key is hashed once and outside of the lock */
+static struct shard_st *locate_shard(ax_chmap *chmap, const void *key, size_t *hash)
+{
+	*hash = ax_hmap_hash(shard_hmap(chmap->shards), key);
+	return chmap->shards + ax_hash64_thomas(*hash) % chmap->nshard;
+}
+
+ax_chmap *ax_chmap_create(const ax_trait *key_tr, const ax_trait *val_tr, size_t nshard)
+{
+	assert(key_tr);
+	assert(val_tr);
+
+	if (!nshard) {
+		int nprocs = ax_sys_nprocs();
+		nshard = nprocs > 4 ? nprocs * 4 : 16;
+	}
+
+	ax_chmap *chmap = malloc(sizeof *chmap);
+	if (!chmap)
+		return NULL;
+
+	chmap->key_tr = key_tr;
+	chmap->val_tr = val_tr;
+	chmap->nshard = 0;
+	chmap->shards = malloc(nshard * sizeof(struct shard_st));
+	if (!chmap->shards)
+		goto fail;
+
+	for (; chmap->nshard < nshard; chmap->nshard++) {
+		struct shard_st *shard = chmap->shards + chmap->nshard;
+		shard->map = __ax_hmap_construct(key_tr, val_tr);
+		if (!shard->map)
+			goto fail;
+		if (ax_rwlock_init(&shard->lock)) {
+			ax_one_free(ax_r(ax_map, shard->map).ax_one);
+			goto fail;
+		}
+	}
+	return chmap;
+fail:
+	ax_chmap_free(chmap);
+	return NULL;
+}
+
+void ax_chmap_free(ax_chmap *chmap)
+{
+	if (!chmap)
+		return;
+
+	for (size_t i = 0; i < chmap->nshard; i++) {
+		ax_rwlock_destroy(&chmap->shards[i].lock);
+		ax_one_free(ax_r(ax_map, chmap->shards[i].map).ax_one);
+	}
+	free(chmap->shards);
+	free(chmap);
+}
+
+ax_fail ax_chmap_put(ax_chmap *chmap, const void *key, const void *val)
+{
+	assert(chmap);
+
+	size_t hash;
+	const void *in_key = ax_trait_in(chmap->key_tr, key);
+	struct shard_st *shard = locate_shard(chmap, in_key, &hash);
+	ax_rwlock_wlock(&shard->lock);
+	void *p = ax_hmap_put_hashed(shard_hmap(shard), in_key, hash,
+			ax_trait_in(chmap->val_tr, val));
+	ax_rwlock_unlock(&shard->lock);
+	return !p;
+}
+
+ax_fail ax_chmap_get(ax_chmap *chmap, const void *key, void *val)
+{
+	assert(chmap);
+
+	ax_fail fail = false;
+	size_t hash;
+	const void *in_key = ax_trait_in(chmap->key_tr, key);
+	struct shard_st *shard = locate_shard(chmap, in_key, &hash);
+	ax_rwlock_rlock(&shard->lock);
+	void *p = ax_hmap_get_hashed(shard_hmap(shard), in_key, hash);
+	if (!p)
+		fail = true;
+	else if (val)
+		fail = ax_trait_copy(chmap->val_tr, val, p);
+	ax_rwlock_unlock(&shard->lock);
+	return fail;
+}
+
+bool ax_chmap_exist(ax_chmap *chmap, const void *key)
+{
+	assert(chmap);
+
+	size_t hash;
+	const void *in_key = ax_trait_in(chmap->key_tr, key);
+	struct shard_st *shard = locate_shard(chmap, in_key, &hash);
+	ax_rwlock_rlock(&shard->lock);
+	bool exist = !!ax_hmap_get_hashed(shard_hmap(shard), in_key, hash);
+	ax_rwlock_unlock(&shard->lock);
+	return exist;
+}
+
+ax_fail ax_chmap_erase(ax_chmap *chmap, const void *key)
+{
+	assert(chmap);
+
+	size_t hash;
+	const void *in_key = ax_trait_in(chmap->key_tr, key);
+	struct shard_st *shard = locate_shard(chmap, in_key, &hash);
+	ax_rwlock_wlock(&shard->lock);
+	ax_fail fail = ax_hmap_erase_hashed(shard_hmap(shard), in_key, hash);
+	ax_rwlock_unlock(&shard->lock);
+	return fail;
+}
+
+ax_fail ax_chmap_compute_if_absent(ax_chmap *chmap, const void *key,
+		ax_chmap_compute_f *compute, void *arg, void *val)
+{
+	assert(chmap);
+	assert(compute);
+
+	ax_fail fail = true;
+	size_t hash;
+	const void *in_key = ax_trait_in(chmap->key_tr, key);
+	struct shard_st *shard = locate_shard(chmap, in_key, &hash);
+	ax_hmap *hmap = shard_hmap(shard);
+
+	/* Most of calls find the key, try it with the shared lock first */
+	ax_rwlock_rlock(&shard->lock);
+	void *p = ax_hmap_get_hashed(hmap, in_key, hash);
+	if (p) {
+		fail = val ? ax_trait_copy(chmap->val_tr, val, p) : false;
+		ax_rwlock_unlock(&shard->lock);
+		return fail;
+	}
+	ax_rwlock_unlock(&shard->lock);
+
+	ax_byte *tmp = malloc(ax_trait_size(chmap->val_tr));
+	if (!tmp)
+		return true;
+
+	ax_rwlock_wlock(&shard->lock);
+	p = ax_hmap_get_hashed(hmap, in_key, hash);
+	if (!p) {
+		if (compute(key, tmp, arg))
+			goto out;
+		p = ax_hmap_put_hashed(hmap, in_key, hash, tmp);
+		ax_trait_free(chmap->val_tr, tmp);
+		if (!p)
+			goto out;
+	}
+	fail = val ? ax_trait_copy(chmap->val_tr, val, p) : false;
+out:
+	ax_rwlock_unlock(&shard->lock);
+	free(tmp);
+	return fail;
+}
+
+size_t ax_chmap_size(ax_chmap *chmap)
+{
+	assert(chmap);
+
+	size_t size = 0;
+	for (size_t i = 0; i < chmap->nshard; i++) {
+		ax_rwlock_rlock(&chmap->shards[i].lock);
+		size += ax_box_size(ax_r(ax_map, chmap->shards[i].map).ax_box);
+		ax_rwlock_unlock(&chmap->shards[i].lock);
+	}
+	return size;
+}
+
+size_t ax_chmap_shards(const ax_chmap *chmap)
+{
+	assert(chmap);
+	return chmap->nshard;
+}
+
+ax_map *ax_chmap_snapshot(ax_chmap *chmap)
+{
+	assert(chmap);
+
+	ax_map *snap = __ax_hmap_construct(chmap->key_tr, chmap->val_tr);
+	if (!snap)
+		return NULL;
+
+	/* Shards are always locked in the same order, so that it never deadlocks */
+	for (size_t i = 0; i < chmap->nshard; i++)
+		ax_rwlock_rlock(&chmap->shards[i].lock);
+
+	for (size_t i = 0; i < chmap->nshard; i++) {
+		ax_map_cforeach(chmap->shards[i].map, const void *, key, const void *, val) {
+			if (!ax_map_put(snap, key, val)) {
+				ax_one_free(ax_r(ax_map, snap).ax_one);
+				snap = NULL;
+				goto out;
+			}
+		}
+	}
+out:
+	for (size_t i = 0; i < chmap->nshard; i++)
+		ax_rwlock_unlock(&chmap->shards[i].lock);
+	return snap;
+}
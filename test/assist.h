@@ -24,6 +24,12 @@
 #define UTIL_H_
 #include <ax/algo.h>
 #include <ax/type/seq.h>
+#include <stdlib.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+#define HAVE_MALLINFO2
+#include <malloc.h>
+#endif
 
 inline static bool seq_equal_array(ax_seq *seq, void *arr, size_t mem_size)
 {
@@ -31,4 +37,14 @@ inline static bool seq_equal_array(ax_seq *seq, void *arr, size_t mem_size)
 	ax_iter last = ax_box_end(ax_r(ax_seq, seq).ax_box);
 	return ax_equal_to_array(&first, &last, arr, mem_size, NULL);
 }
+
+/* Bytes allocated from the heap, always 0 without mallinfo2() */
+inline static size_t heap_used()
+{
+#ifdef HAVE_MALLINFO2
+	return mallinfo2().uordblks;
+#else
+	return 0;
+#endif
+}
 #endif
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/acmatch.h"
+#include "ax/art.h"
+#include "ax/btrie.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+struct match_st
+{
+	size_t end, len;
+	uint32_t id;
+};
+
+struct collect_st
+{
+	struct match_st *matches;
+	size_t count, capacity;
+	size_t stop_at;
+};
+
+static bool collect_cb(size_t end, size_t len, uint32_t id, void *ctx)
+{
+	struct collect_st *c = ctx;
+	if (c->count < c->capacity)
+		c->matches[c->count] = (struct match_st) { end, len, id };
+	c->count++;
+	return c->count == c->stop_at;
+}
+
+static int match_comp(const void *a, const void *b)
+{
+	const struct match_st *x = a, *y = b;
+	if (x->end != y->end)
+		return x->end < y->end ? -1 : 1;
+	return x->len < y->len ? -1 : x->len > y->len;
+}
+
+static ax_trie *make_patterns(ax_trie *trie, const char *const patterns[], size_t n)
+{
+	for (int i = 0; i < n; i++)
+		ax_trie_put_bytes(trie, patterns[i], strlen(patterns[i]), &i);
+	return trie;
+}
+
+static uint32_t int_id(const void *val, void *ctx)
+{
+	return *(const int *)val;
+}
+
+static void classic(ut_runner *r)
+{
+	static const char *const patterns[] = { "he", "she", "his", "hers", "" };
+	ax_art_r art = AX_R_INIT(ax_trie, make_patterns(ax_new(ax_art, ax_t(char), ax_t(int)).ax_trie, patterns, 5));
+	ax_acmatch ac;
+	ut_assert(r, !ax_acmatch_compile(&ac, art.ax_trie, int_id, NULL));
+	ax_one_free(art.ax_one);
+	ut_assert_uint_equal(r, 4, ax_acmatch_size(&ac));
+
+	struct match_st buf[16];
+	struct collect_st c = { .matches = buf, .capacity = 16 };
+	ut_assert_uint_equal(r, 9, ax_acmatch_scan(&ac, "ushershis", 9, collect_cb, &c));
+	ut_assert_uint_equal(r, 4, c.count);
+	qsort(buf, c.count, sizeof *buf, match_comp);
+
+	static const struct match_st expect[] = {
+		{ 4, 2, 0 }, { 4, 3, 1 }, { 6, 4, 3 }, { 9, 3, 2 },
+	};
+	for (int i = 0; i < 4; i++) {
+		ut_assert_uint_equal(r, expect[i].end, buf[i].end);
+		ut_assert_uint_equal(r, expect[i].len, buf[i].len);
+		ut_assert_uint_equal(r, expect[i].id, buf[i].id);
+	}
+
+	/* Stop at the first match */
+	c = (struct collect_st) { .matches = buf, .capacity = 16, .stop_at = 1 };
+	ut_assert_uint_equal(r, 4, ax_acmatch_scan(&ac, "ushershis", 9, collect_cb, &c));
+
+	ax_acmatch_free(&ac);
+}
+
+static void high_bytes(ut_runner *r)
+{
+	/* Without id_f, ids follow byte order under a signed char trie too */
+	static const char *const patterns[] = { "\xe4", "a", "\xe4\xb8", "ab" };
+	ax_btrie_r btrie = AX_R_INIT(ax_trie, make_patterns(ax_new(ax_btrie, ax_t(char), ax_t(int)).ax_trie, patterns, 4));
+	ax_acmatch ac;
+	ut_assert(r, !ax_acmatch_compile(&ac, btrie.ax_trie, NULL, NULL));
+	ax_one_free(btrie.ax_one);
+	ut_assert_uint_equal(r, 4, ax_acmatch_size(&ac));
+
+	struct match_st buf[16];
+	struct collect_st c = { .matches = buf, .capacity = 16 };
+	ut_assert_uint_equal(r, 5, ax_acmatch_scan(&ac, "ab\xe4\xb8x", 5, collect_cb, &c));
+	ut_assert_uint_equal(r, 4, c.count);
+	qsort(buf, c.count, sizeof *buf, match_comp);
+
+	static const struct match_st expect[] = {
+		{ 1, 1, 0 }, { 2, 2, 1 }, { 3, 1, 2 }, { 4, 2, 3 },
+	};
+	for (int i = 0; i < 4; i++) {
+		ut_assert_uint_equal(r, expect[i].end, buf[i].end);
+		ut_assert_uint_equal(r, expect[i].len, buf[i].len);
+		ut_assert_uint_equal(r, expect[i].id, buf[i].id);
+	}
+
+	ax_acmatch_free(&ac);
+}
+
+static void empty(ut_runner *r)
+{
+	ax_btrie_r btrie = ax_new(ax_btrie, ax_t(char), ax_t(int));
+	ax_acmatch ac;
+	ut_assert(r, !ax_acmatch_compile(&ac, btrie.ax_trie, NULL, NULL));
+	ut_assert_uint_equal(r, 0, ax_acmatch_size(&ac));
+
+	struct collect_st c = { 0 };
+	ut_assert_uint_equal(r, 5, ax_acmatch_scan(&ac, "hello", 5, collect_cb, &c));
+	ut_assert_uint_equal(r, 0, c.count);
+
+	ax_acmatch_free(&ac);
+	ax_one_free(btrie.ax_one);
+}
+
+static void stream(ut_runner *r)
+{
+	enum { NPAT = 200, TEXT = 50000 };
+	char *patterns[NPAT];
+	char *text = malloc(TEXT);
+
+	srand(11);
+	for (int i = 0; i < NPAT; i++) {
+		int len = 1 + rand() % 6;
+		patterns[i] = malloc(len + 1);
+		for (int j = 0; j < len; j++)
+			patterns[i][j] = 'a' + rand() % 4;
+		patterns[i][len] = '\0';
+	}
+	for (int i = 0; i < TEXT; i++)
+		text[i] = 'a' + rand() % 5;
+
+	ax_btrie_r btrie = AX_R_INIT(ax_trie, make_patterns(ax_new(ax_btrie, ax_t(char), ax_t(int)).ax_trie,
+				(const char *const *)patterns, NPAT));
+	ax_acmatch ac;
+	ut_assert(r, !ax_acmatch_compile(&ac, btrie.ax_trie, NULL, NULL));
+
+	/* Count the occurrences of distinct patterns one by one */
+	size_t expect = 0;
+	ax_trie *seen = ax_new(ax_art, ax_t(char), ax_t(int)).ax_trie;
+	for (int i = 0; i < NPAT; i++) {
+		size_t len = strlen(patterns[i]);
+		if (ax_trie_get_bytes(seen, patterns[i], len))
+			continue;
+		ax_trie_put_bytes(seen, patterns[i], len, &i);
+		for (size_t j = 0; j + len <= TEXT; j++)
+			expect += memcmp(text + j, patterns[i], len) == 0;
+	}
+	ut_assert_uint_equal(r, ax_box_size(ax_r(ax_trie, seen).ax_box), ax_acmatch_size(&ac));
+
+	struct collect_st c = { 0 };
+	ax_acmatch_scan(&ac, text, TEXT, collect_cb, &c);
+	ut_assert_uint_equal(r, expect, c.count);
+
+	/* Feed through a ring buffer in odd sized chunks */
+	uint8_t ring[97];
+	ax_iobuf b;
+	ax_iobuf_init(&b, ring, sizeof ring);
+	ax_acmatch_stream st;
+	ax_acmatch_stream_init(&st, &ac);
+	c = (struct collect_st) { 0 };
+	for (size_t pos = 0; pos < TEXT; ) {
+		size_t n = 1 + rand() % 60;
+		if (n > TEXT - pos)
+			n = TEXT - pos;
+		pos += ax_iobuf_write(&b, text + pos, n);
+		ax_acmatch_stream_feed_iobuf(&st, &b, collect_cb, &c);
+		ut_assert(r, ax_iobuf_empty(&b));
+	}
+	ut_assert_uint_equal(r, expect, c.count);
+	ut_assert_uint_equal(r, TEXT, st.offset);
+
+	ax_one_free(ax_r(ax_trie, seen).ax_one);
+	ax_one_free(btrie.ax_one);
+	ax_acmatch_free(&ac);
+	for (int i = 0; i < NPAT; i++)
+		free(patterns[i]);
+	free(text);
+}
+
+static bool count_cb(size_t end, size_t len, uint32_t id, void *ctx)
+{
+	(*(size_t *)ctx)++;
+	return false;
+}
+
+static void scan_time(ut_runner *r)
+{
+	enum { NPAT = 2000, TEXT = 1 << 20 };
+	char (*patterns)[16] = malloc(sizeof *patterns * NPAT);
+	char *text = malloc(TEXT + 1);
+
+	srand(13);
+	ax_art_r art = ax_new(ax_art, ax_t(char), ax_t(int));
+	for (int i = 0; i < NPAT; i++) {
+		sprintf(patterns[i], "key%x", rand() % 0x10000);
+		ax_trie_put_bytes(art.ax_trie, patterns[i], strlen(patterns[i]), &i);
+	}
+	/* Tokens shaped like the patterns, some of them match */
+	for (int i = 0; i < TEXT; ) {
+		char token[16];
+		int n = sprintf(token, "key%x ", rand() % 0x20000);
+		memcpy(text + i, token, n < TEXT - i ? n : TEXT - i);
+		i += n;
+	}
+	text[TEXT] = '\0';
+
+	ax_acmatch ac;
+	ut_assert(r, !ax_acmatch_compile(&ac, art.ax_trie, NULL, NULL));
+
+	size_t ac_count = 0;
+	clock_t time_before = clock();
+	ax_acmatch_scan(&ac, text, TEXT, count_cb, &ac_count);
+	double ac_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+	/* Only a tenth of the patterns, scanning for each of them is slow */
+	size_t naive_count = 0;
+	time_before = clock();
+	for (int i = 0; i < NPAT / 10; i++)
+		for (const char *p = text; (p = strstr(p, patterns[i])); p++)
+			naive_count++;
+	ut_printf(r, "%d patterns over %d bytes: ax_acmatch spent %lfs, "
+			"strstr() for %d patterns spent %lfs (%zu, %zu)",
+			NPAT, TEXT, ac_time, NPAT / 10,
+			(double)(clock() - time_before) / CLOCKS_PER_SEC, ac_count, naive_count);
+
+	ax_acmatch_free(&ac);
+	ax_one_free(art.ax_one);
+	free(patterns);
+	free(text);
+}
+
+ut_suite *suite_for_acmatch()
+{
+	ut_suite *suite = ut_suite_create("acmatch");
+
+	ut_suite_add(suite, classic, 0);
+	ut_suite_add(suite, high_bytes, 0);
+	ut_suite_add(suite, empty, 0);
+	ut_suite_add(suite, stream, 0);
+	ut_suite_add(suite, scan_time, 0);
+
+	return suite;
+}
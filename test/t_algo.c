@@ -25,6 +25,8 @@
 #include "ax/iter.h"
 #include "ax/vector.h"
 #include "ax/list.h"
+#include "ax/deq.h"
+#include "ax/string.h"
 #include "ax/pred.h"
 #include "ax/oper.h"
 #include "ax/arraya.h"
@@ -331,6 +333,173 @@ static void sort_time(ut_runner *r) {
 	ax_one_free(vec4.ax_one);
 }
 
+static void span(ut_runner *r)
+{
+	ax_vector_r vec = ax_new(ax_vector, ax_t(int));
+	ax_seq_push_arraya(vec.ax_seq, ax_arraya(int, 0, 1, 2, 3, 4));
+
+	void *p;
+	ax_iter it = ax_box_begin(vec.ax_box), last = ax_box_end(vec.ax_box);
+	ut_assert(r, ax_iter_spannable(&it));
+	ut_assert_uint_equal(r, 2, ax_iter_span(&it, &last, 2, &p));
+	ut_assert(r, p == ax_vector_buffer(vec.ax_vector));
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&it));
+	ut_assert_uint_equal(r, 3, ax_iter_span(&it, NULL, SIZE_MAX, &p));
+	ut_assert_int_equal(r, 2, *(int *)p);
+	ut_assert(r, ax_iter_equal(&it, &last));
+	ut_assert_uint_equal(r, 0, ax_iter_span(&it, &last, SIZE_MAX, &p));
+
+	it = ax_box_rbegin(vec.ax_box);
+	ut_assert(r, !ax_iter_spannable(&it));
+
+	ax_string_r str = ax_new0(ax_string);
+	ax_str_append(str.ax_str, "hello");
+	ax_citer cit = ax_box_cbegin(str.ax_box);
+	ut_assert_uint_equal(r, 5, ax_citer_span(&cit, NULL, SIZE_MAX, &p));
+	ut_assert(r, memcmp(p, "hello", 5) == 0);
+
+	/* A deque spans one block at a time */
+	ax_deq_r deq = ax_new(ax_deq, ax_t(int));
+	for (int i = 0; i < 3000; i++)
+		ax_seq_push(deq.ax_seq, &i);
+	it = ax_box_begin(deq.ax_box);
+	last = ax_seq_at(deq.ax_seq, 2500);
+	ut_assert(r, ax_iter_spannable(&it));
+	size_t n, total = 0, spans = 0;
+	while ((n = ax_iter_span(&it, &last, SIZE_MAX, &p))) {
+		for (size_t i = 0; i < n; i++)
+			ut_assert_int_equal(r, total + i, ((int *)p)[i]);
+		total += n;
+		spans++;
+	}
+	ut_assert_uint_equal(r, 2500, total);
+	ut_assert(r, spans > 2);
+	ut_assert(r, ax_iter_equal(&it, &last));
+	ut_assert_uint_equal(r, 7, ax_iter_span(&it, NULL, 7, &p));
+	ut_assert_int_equal(r, 2500, *(int *)p);
+	ut_assert_int_equal(r, 2507, *(int *)ax_iter_get(&it));
+
+	it = ax_box_rbegin(deq.ax_box);
+	ut_assert(r, !ax_iter_spannable(&it));
+
+	ax_one_free(deq.ax_one);
+	ax_one_free(str.ax_one);
+	ax_one_free(vec.ax_one);
+}
+
+static void span_algos(ut_runner *r)
+{
+	/* The vector goes through spans and the list does not, results must agree */
+	ax_vector_r vec = ax_new(ax_vector, ax_t(int));
+	ax_list_r list = ax_new(ax_list, ax_t(int));
+	for (int i = 0; i < 100; i++) {
+		ax_seq_push(vec.ax_seq, &i);
+		ax_seq_push(list.ax_seq, &i);
+	}
+
+	ax_iter vfirst = ax_box_begin(vec.ax_box), vlast = ax_box_end(vec.ax_box);
+	ax_iter lfirst = ax_box_begin(list.ax_box), llast = ax_box_end(list.ax_box);
+
+	int ten = 10, one = 1;
+	ax_pred2 lt = ax_pred2_make(ax_op(int32_t).o_lt, NULL);
+	ut_assert_uint_equal(r, 10, ax_count_if(ax_iter_c(&vfirst), ax_iter_c(&vlast), ax_pred2_bind2(&lt, &ten)));
+	ut_assert_uint_equal(r, 10, ax_count_if(ax_iter_c(&lfirst), ax_iter_c(&llast), ax_pred2_bind2(&lt, &ten)));
+
+	ax_pred2 gt = ax_pred2_make(ax_op(int32_t).o_gt, NULL);
+	int key = 41;
+	ax_citer found = *ax_iter_c(&vfirst);
+	ax_find_if(&found, ax_iter_c(&vlast), ax_pred2_bind2(&gt, &key));
+	ut_assert_int_equal(r, 42, *(int *)ax_citer_get(&found));
+	key = 100;
+	found = *ax_iter_c(&vfirst);
+	ax_find_if(&found, ax_iter_c(&vlast), ax_pred2_bind2(&gt, &key));
+	ut_assert(r, ax_citer_equal(&found, ax_iter_c(&vlast)));
+
+	/* vector to list, then list back to vector */
+	ax_pred2 add = ax_pred2_make(ax_op(int32_t).o_add, NULL);
+	ax_transform(ax_iter_c(&vfirst), ax_iter_c(&vlast), &lfirst, ax_pred2_bind2(&add, &one));
+	ax_transform(ax_iter_c(&lfirst), ax_iter_c(&llast), &vfirst, ax_pred2_bind2(&add, &one));
+	int i = 0;
+	ax_box_cforeach(vec.ax_box, const int *, v)
+		ut_assert_int_equal(r, i++ + 2, *v);
+
+	int *table = malloc(100 * sizeof *table);
+	for (i = 0; i < 100; i++)
+		table[i] = i + 2;
+	ut_assert(r, ax_equal_to_array(&vfirst, &vlast, table, 100 * sizeof *table, NULL));
+	ut_assert(r, !ax_equal_to_array(&vfirst, &vlast, table, 99 * sizeof *table, NULL));
+	table[99] = 0;
+	ut_assert(r, !ax_equal_to_array(&vfirst, &vlast, table, 100 * sizeof *table, NULL));
+	free(table);
+
+	int seven = 7;
+	ax_iter middle = vfirst;
+	ax_iter_move(&middle, 50);
+	ax_generate(&vfirst, &middle, &seven);
+	ut_assert_int_equal(r, 50, ax_count_if(ax_iter_c(&vfirst), ax_iter_c(&vlast), ax_pred2_bind2(&lt, &ten)));
+
+	/* The deque spans block by block, long enough to cross several blocks */
+	ax_deq_r deq = ax_new(ax_deq, ax_t(int));
+	for (i = 0; i < 3000; i++)
+		ax_seq_push(deq.ax_seq, &i);
+	ax_iter dfirst = ax_box_begin(deq.ax_box), dlast = ax_box_end(deq.ax_box);
+	ut_assert_uint_equal(r, 10, ax_count_if(ax_iter_c(&dfirst), ax_iter_c(&dlast), ax_pred2_bind2(&lt, &ten)));
+
+	key = 2041;
+	found = *ax_iter_c(&dfirst);
+	ax_find_if(&found, ax_iter_c(&dlast), ax_pred2_bind2(&gt, &key));
+	ut_assert_int_equal(r, 2042, *(int *)ax_citer_get(&found));
+
+	ax_iter dout = dfirst;
+	ax_transform(ax_iter_c(&dfirst), ax_iter_c(&dlast), &dout, ax_pred2_bind2(&add, &one));
+	table = malloc(3000 * sizeof *table);
+	for (i = 0; i < 3000; i++)
+		table[i] = i + 1;
+	ut_assert(r, ax_equal_to_array(&dfirst, &dlast, table, 3000 * sizeof *table, NULL));
+	table[2999] = 0;
+	ut_assert(r, !ax_equal_to_array(&dfirst, &dlast, table, 3000 * sizeof *table, NULL));
+	free(table);
+
+	middle = ax_seq_at(deq.ax_seq, 2000);
+	ax_generate(&dfirst, &middle, &seven);
+	ut_assert_int_equal(r, 2000, ax_count_if(ax_iter_c(&dfirst), ax_iter_c(&dlast), ax_pred2_bind2(&lt, &ten)));
+
+	ax_one_free(deq.ax_one);
+	ax_one_free(list.ax_one);
+	ax_one_free(vec.ax_one);
+}
+
+static void span_time(ut_runner *r)
+{
+	const int n = 1000000;
+	ax_vector_r vec = ax_new(ax_vector, ax_t(int));
+	for (int i = 0; i < n; i++)
+		ax_seq_push(vec.ax_seq, &i);
+
+	ax_iter first = ax_box_begin(vec.ax_box), last = ax_box_end(vec.ax_box);
+	int half = n / 2;
+	ax_pred2 lt = ax_pred2_make(ax_op(int32_t).o_lt, NULL);
+	ax_pred1 *pred = ax_pred2_bind2(&lt, &half);
+
+	/* What ax_count_if did before spans */
+	clock_t time_before = clock();
+	size_t count = 0;
+	bool out;
+	for (ax_citer it = *ax_iter_c(&first); !ax_citer_equal(&it, ax_iter_c(&last)); ax_citer_next(&it)) {
+		ax_pred1_do(pred, &out, ax_citer_get(&it));
+		count += out;
+	}
+	double iter_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_uint_equal(r, half, count);
+
+	time_before = clock();
+	ut_assert_uint_equal(r, half, ax_count_if(ax_iter_c(&first), ax_iter_c(&last), pred));
+	ut_printf(r, "count_if over %d ints: by iterator %lfs, by span %lfs", n, iter_time,
+			(double)(clock() - time_before) / CLOCKS_PER_SEC);
+
+	ax_one_free(vec.ax_one);
+}
+
 ut_suite *suite_for_algo()
 {
 	ut_suite* suite = ut_suite_create("algo");
@@ -344,6 +513,9 @@ ut_suite *suite_for_algo()
 	ut_suite_add(suite, binary_search, 0);
 	ut_suite_add(suite, binary_search_if_not, 0);
 	ut_suite_add(suite, insertion_sort, 0);
+	ut_suite_add(suite, span, 0);
+	ut_suite_add(suite, span_algos, 0);
+	ut_suite_add(suite, span_time, 0);
 
 	return suite;
 }
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "assist.h"
+#include "ax/art.h"
+#include "ax/btrie.h"
+#include "ax/string.h"
+#include "ax/rb.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define N 20000
+
+static ax_string_r key_of(ax_string_r key, const char *s)
+{
+	ax_box_clear(key.ax_box);
+	ax_str_append(key.ax_str, s);
+	return key;
+}
+
+static ax_art_r make_test_art(ax_string_r key)
+{
+	static const struct {
+		const char *key;
+		int value;
+	} table[] = {
+		{ "aaa", 111 }, { "aba", 121 }, { "a", 1 }, { "aab", 112 },
+		{ "", 0 }, { "baa", 211 }, { "aa", 11 },
+	};
+
+	ax_art_r art = ax_new(ax_art, ax_t(char), ax_t(int));
+	for (int i = 0; i < sizeof table / sizeof *table; i++)
+		ax_trie_put(art.ax_trie, key_of(key, table[i].key).ax_seq, &table[i].value);
+	return art;
+}
+
+static void iterate(ut_runner *r)
+{
+	ax_string_r key = ax_new0(ax_string);
+	ax_art_r art = make_test_art(key);
+	ut_assert_uint_equal(r, 7, ax_box_size(art.ax_box));
+
+	/* Children are visited in byte order */
+	ax_iter it = ax_box_begin(art.ax_box);
+	ut_assert(r, ax_trie_iter_valued(&it));
+	ut_assert_int_equal(r, 0, *(int *)ax_iter_get(&it));
+
+	ax_iter a = ax_trie_iter_begin(&it);
+	ut_assert_int_equal(r, 'a', *(char *)ax_trie_iter_word(&a));
+	ax_iter aa = ax_trie_iter_begin(&a);
+	ut_assert_int_equal(r, 'a', *(char *)ax_trie_iter_word(&aa));
+	ax_iter_next(&aa);
+	ut_assert_int_equal(r, 'b', *(char *)ax_trie_iter_word(&aa));
+	ut_assert(r, !ax_trie_iter_valued(&aa));
+	ax_iter_prev(&aa);
+	ut_assert_int_equal(r, 11, *(int *)ax_iter_get(&aa));
+	ax_iter_next(&a);
+	ut_assert_int_equal(r, 'b', *(char *)ax_trie_iter_word(&a));
+	ax_iter_next(&a);
+	ax_iter end = ax_trie_iter_end(&it);
+	ut_assert(r, ax_iter_equal(&a, &end));
+
+	ax_iter parent;
+	it = ax_trie_at(art.ax_trie, key_of(key, "aab").ax_seq);
+	ut_assert(r, ax_class_trait(art.ax_trie).it_parent(ax_iter_cc(&it), &parent));
+	ut_assert_int_equal(r, 11, *(int *)ax_iter_get(&parent));
+	it = ax_box_begin(art.ax_box);
+	ut_assert(r, !ax_class_trait(art.ax_trie).it_parent(ax_iter_cc(&it), &parent));
+
+	ax_one_free(art.ax_one);
+	ax_one_free(key.ax_one);
+}
+
+static void get_and_exist(ut_runner *r)
+{
+	ax_string_r key = ax_new0(ax_string);
+	ax_art_r art = make_test_art(key);
+	bool valued;
+
+	ut_assert_int_equal(r, 111, *(int *)ax_trie_get(art.ax_trie, key_of(key, "aaa").ax_seq));
+	ut_assert_int_equal(r, 11, *(int *)ax_trie_get(art.ax_trie, key_of(key, "aa").ax_seq));
+	ut_assert_int_equal(r, 0, *(int *)ax_trie_get(art.ax_trie, key_of(key, "").ax_seq));
+	ut_assert(r, !ax_trie_get(art.ax_trie, key_of(key, "ab").ax_seq));
+	ut_assert(r, !ax_trie_get(art.ax_trie, key_of(key, "aaaa").ax_seq));
+
+	ut_assert(r, ax_trie_exist(art.ax_trie, key_of(key, "ab").ax_seq, &valued));
+	ut_assert(r, !valued);
+	ut_assert(r, ax_trie_exist(art.ax_trie, key_of(key, "ba").ax_seq, &valued));
+	ut_assert(r, !valued);
+	ut_assert(r, ax_trie_exist(art.ax_trie, key_of(key, "aba").ax_seq, &valued));
+	ut_assert(r, valued);
+	ut_assert(r, !ax_trie_exist(art.ax_trie, key_of(key, "abb").ax_seq, NULL));
+	ut_assert(r, !ax_trie_exist(art.ax_trie, key_of(key, "bab").ax_seq, NULL));
+
+	ax_iter it = ax_trie_at(art.ax_trie, key_of(key, "aaaa").ax_seq);
+	ax_iter end = ax_box_end(art.ax_box);
+	ut_assert(r, ax_iter_equal(&it, &end));
+
+	/* Put on a prefix without value */
+	it = ax_trie_at(art.ax_trie, key_of(key, "ba").ax_seq);
+	ut_assert(r, !ax_iter_set(&it, ax_p(int, 21)));
+	ut_assert_int_equal(r, 21, *(int *)ax_trie_get(art.ax_trie, key.ax_seq));
+	ut_assert_uint_equal(r, 8, ax_box_size(art.ax_box));
+
+	ax_one_free(art.ax_one);
+	ax_one_free(key.ax_one);
+}
+
+static void erase_and_prune(ut_runner *r)
+{
+	ax_string_r key = ax_new0(ax_string);
+	ax_art_r art = make_test_art(key);
+
+	ut_assert(r, ax_trie_erase(art.ax_trie, key_of(key, "aa").ax_seq));
+	ut_assert(r, !ax_trie_erase(art.ax_trie, key_of(key, "aa").ax_seq));
+	ut_assert(r, !ax_trie_erase(art.ax_trie, key_of(key, "ab").ax_seq));
+	ut_assert_uint_equal(r, 6, ax_box_size(art.ax_box));
+	ut_assert_int_equal(r, 112, *(int *)ax_trie_get(art.ax_trie, key_of(key, "aab").ax_seq));
+	ax_one_free(art.ax_one);
+
+	art = make_test_art(key);
+	ut_assert(r, ax_trie_prune(art.ax_trie, key_of(key, "aa").ax_seq));
+	ut_assert_uint_equal(r, 4, ax_box_size(art.ax_box));
+	ut_assert(r, !ax_trie_exist(art.ax_trie, key_of(key, "aa").ax_seq, NULL));
+	ut_assert(r, !ax_trie_exist(art.ax_trie, key_of(key, "aab").ax_seq, NULL));
+	ut_assert_int_equal(r, 121, *(int *)ax_trie_get(art.ax_trie, key_of(key, "aba").ax_seq));
+	ax_one_free(art.ax_one);
+
+	art = make_test_art(key);
+	ut_assert(r, ax_trie_prune(art.ax_trie, key_of(key, "a").ax_seq));
+	ut_assert_uint_equal(r, 2, ax_box_size(art.ax_box));
+	ut_assert(r, !ax_trie_prune(art.ax_trie, key_of(key, "a").ax_seq));
+	ut_assert(r, ax_trie_prune(art.ax_trie, key_of(key, "").ax_seq));
+	ut_assert_uint_equal(r, 0, ax_box_size(art.ax_box));
+	ax_one_free(art.ax_one);
+
+	/* Erasing by iterator keeps the node if it still has children */
+	art = make_test_art(key);
+	ax_iter it = ax_trie_at(art.ax_trie, key_of(key, "aa").ax_seq);
+	ax_iter_erase(&it);
+	ut_assert(r, !ax_trie_iter_valued(&it));
+	ut_assert_int_equal(r, 'a', *(char *)ax_trie_iter_word(&it));
+	it = ax_trie_at(art.ax_trie, key_of(key, "aab").ax_seq);
+	ax_iter_erase(&it);
+	ax_iter end = ax_trie_iter_end(&it);
+	ut_assert(r, ax_iter_equal(&it, &end));
+	ut_assert_uint_equal(r, 5, ax_box_size(art.ax_box));
+	ax_one_free(art.ax_one);
+
+	ax_one_free(key.ax_one);
+}
+
+static void rekey(ut_runner *r)
+{
+	ax_string_r key = ax_new0(ax_string), to = ax_new0(ax_string);
+	ax_art_r art = make_test_art(key);
+
+	ut_assert(r, !ax_trie_rekey(art.ax_trie, key_of(key, "aab").ax_seq, key_of(to, "abc").ax_seq));
+	ut_assert(r, !ax_trie_exist(art.ax_trie, key.ax_seq, NULL));
+	ut_assert_int_equal(r, 112, *(int *)ax_trie_get(art.ax_trie, to.ax_seq));
+	ut_assert_uint_equal(r, 7, ax_box_size(art.ax_box));
+
+	/* Replace the value of an existing key */
+	ut_assert(r, !ax_trie_rekey(art.ax_trie, key_of(key, "abc").ax_seq, key_of(to, "a").ax_seq));
+	ut_assert_int_equal(r, 112, *(int *)ax_trie_get(art.ax_trie, to.ax_seq));
+	ut_assert_uint_equal(r, 6, ax_box_size(art.ax_box));
+
+	ax_one_free(art.ax_one);
+	ax_one_free(to.ax_one);
+	ax_one_free(key.ax_one);
+}
+
+static void bytes_key(ut_runner *r)
+{
+	ax_string_r key = ax_new0(ax_string);
+	ax_art_r art = make_test_art(key);
+	bool valued;
+
+	ut_assert_int_equal(r, 111, *(int *)ax_trie_get_bytes(art.ax_trie, "aaa", 3));
+	ut_assert_int_equal(r, 11, *(int *)ax_trie_get_bytes(art.ax_trie, "aaa", 2));
+	ut_assert_int_equal(r, 0, *(int *)ax_trie_get_bytes(art.ax_trie, NULL, 0));
+	ut_assert(r, !ax_trie_get_bytes(art.ax_trie, "ab", 2));
+
+	ut_assert(r, ax_trie_exist_bytes(art.ax_trie, "ab", 2, &valued));
+	ut_assert(r, !valued);
+	ut_assert(r, !ax_trie_exist_bytes(art.ax_trie, "abb", 3, NULL));
+
+	ut_assert(r, ax_trie_put_bytes(art.ax_trie, "abb", 3, ax_p(int, 122)));
+	ut_assert_uint_equal(r, 8, ax_box_size(art.ax_box));
+	ut_assert_int_equal(r, 122, *(int *)ax_trie_get(art.ax_trie, key_of(key, "abb").ax_seq));
+
+	ax_one_free(art.ax_one);
+	ax_one_free(key.ax_one);
+}
+
+static size_t count_valued(const ax_iter *it)
+{
+	size_t count = ax_trie_iter_valued(it);
+	ax_iter end = ax_trie_iter_end(it);
+	for (ax_iter cur = ax_trie_iter_begin(it); !ax_iter_equal(&cur, &end); ax_iter_next(&cur))
+		count += count_valued(&cur);
+	return count;
+}
+
+static void random_ops(ut_runner *r)
+{
+	ax_art_r art = ax_new(ax_art, ax_t(char), ax_t(int));
+	ax_rb_r ref = ax_new(ax_rb, ax_t(str), ax_t(int));
+	ax_string_r key = ax_new0(ax_string);
+
+	/* Long shared prefixes exceed the part of path stored in nodes */
+	static const char *const stems[] = {
+		"", "x", "http://example.com/", "http://example.com/index/", "http://example.org/",
+	};
+
+	srand(7);
+	for (int i = 0; i < N; i++) {
+		char buf[64];
+		sprintf(buf, "%s%d", stems[rand() % 5], rand() % 2000);
+		key_of(key, buf);
+		if (rand() % 3) {
+			ax_trie_put(art.ax_trie, key.ax_seq, &i);
+			ax_map_put(ref.ax_map, buf, &i);
+		} else
+			ut_assert_int_equal(r, ax_map_erase(ref.ax_map, buf) == false,
+					ax_trie_erase(art.ax_trie, key.ax_seq));
+	}
+	ut_assert_uint_equal(r, ax_box_size(ref.ax_box), ax_box_size(art.ax_box));
+
+	ax_map_cforeach(ref.ax_map, const char *, k, const int *, v) {
+		int *p = ax_trie_get(art.ax_trie, key_of(key, k).ax_seq);
+		ut_assert(r, p != NULL);
+		ut_assert_int_equal(r, *v, *p);
+	}
+
+	/* Every pair is reached by walking the trie */
+	ax_iter root = ax_box_begin(art.ax_box);
+	ut_assert_uint_equal(r, ax_box_size(ref.ax_box), count_valued(&root));
+
+	ax_trie_r copy = AX_R_INIT(ax_any, ax_any_copy(art.ax_any));
+	ax_box_clear(art.ax_box);
+	ut_assert_uint_equal(r, ax_box_size(ref.ax_box), ax_box_size(ax_r(ax_trie, copy.ax_trie).ax_box));
+	ut_assert_uint_equal(r, 0, ax_box_size(art.ax_box));
+
+	ax_one_free(copy.ax_one);
+	ax_one_free(key.ax_one);
+	ax_one_free(ref.ax_one);
+	ax_one_free(art.ax_one);
+}
+
+static void bench_trie(ut_runner *r, const char *name, ax_trie *trie, ax_string_r *keys)
+{
+	char (*words)[64] = malloc(sizeof *words * N);
+	for (int i = 0; i < N; i++)
+		strcpy(words[i], ax_str_cstrz(keys[i].ax_str));
+
+	size_t before = heap_used();
+	for (int i = 0; i < N; i++)
+		ax_trie_put(trie, keys[i].ax_seq, &i);
+	size_t after = heap_used();
+
+	clock_t time_before = clock();
+	for (int round = 0; round < 10; round++)
+		for (int i = 0; i < N; i++)
+			ut_assert(r, ax_trie_get(trie, keys[i].ax_seq) != NULL);
+	double seq_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+	time_before = clock();
+	for (int round = 0; round < 10; round++)
+		for (int i = 0; i < N; i++)
+			ut_assert(r, ax_trie_get_bytes(trie, words[i], strlen(words[i])) != NULL);
+	ut_printf(r, "%s: lookup spent %lfs, by bytes %lfs, used %zu bytes", name, seq_time,
+			(double)(clock() - time_before) / CLOCKS_PER_SEC, after - before);
+	free(words);
+
+	ax_one_free(ax_r(ax_trie, trie).ax_one);
+}
+
+static void bench(ut_runner *r)
+{
+	ax_string_r *keys = malloc(sizeof *keys * N);
+	for (int i = 0; i < N; i++) {
+		char buf[64];
+		sprintf(buf, "https://www.example.com/%d/item/%d", i % 97, i);
+		keys[i] = ax_new0(ax_string);
+		ax_str_append(keys[i].ax_str, buf);
+	}
+
+	bench_trie(r, "ax_art", ax_new(ax_art, ax_t(char), ax_t(int)).ax_trie, keys);
+	bench_trie(r, "ax_btrie", ax_new(ax_btrie, ax_t(char), ax_t(int)).ax_trie, keys);
+
+	for (int i = 0; i < N; i++)
+		ax_one_free(keys[i].ax_one);
+	free(keys);
+}
+
+ut_suite *suite_for_art()
+{
+	ut_suite *suite = ut_suite_create("art");
+
+	ut_suite_add(suite, iterate, 0);
+	ut_suite_add(suite, get_and_exist, 0);
+	ut_suite_add(suite, erase_and_prune, 0);
+	ut_suite_add(suite, rekey, 0);
+	ut_suite_add(suite, bytes_key, 0);
+	ut_suite_add(suite, random_ops, 0);
+	ut_suite_add(suite, bench, 0);
+
+	return suite;
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "assist.h"
+#include "ax/atom.h"
+#include "ax/hmap.h"
+#include "ax/rb.h"
+#include "ax/thread.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define N 10000
+
+static void intern(ut_runner *r)
+{
+	ax_atom *atom = ax_atom_create(4);
+
+	char buf[32];
+	strcpy(buf, "hello");
+	const char *a = ax_atom_intern(atom, buf);
+	strcpy(buf, "world");
+	const char *b = ax_atom_intern(atom, buf);
+	ut_assert(r, a != b);
+	ut_assert(r, a == ax_atom_intern(atom, "hello"));
+	ut_assert(r, a == ax_atom_intern_n(atom, "hello, world", 5));
+	ut_assert(r, b == ax_atom_lookup(atom, "world"));
+	ut_assert(r, ax_atom_lookup(atom, "hello, world") == NULL);
+	ut_assert_str_equal(r, "hello", a);
+	ut_assert_uint_equal(r, 5, ax_atom_length(a));
+
+	const char *empty = ax_atom_intern(atom, "");
+	ut_assert(r, empty == ax_atom_intern_n(atom, NULL, 0));
+	ut_assert_uint_equal(r, 0, ax_atom_length(empty));
+
+	/* Strings are binary, the terminator is only appended */
+	const char *bin = ax_atom_intern_n(atom, "a\0b", 3);
+	ut_assert(r, bin != ax_atom_intern(atom, "a"));
+	ut_assert_uint_equal(r, 3, ax_atom_length(bin));
+	ut_assert(r, !memcmp(bin, "a\0b", 4));
+	ut_assert_uint_equal(r, 5, ax_atom_size(atom));
+
+	/* Large strings get blocks of their own, earlier strings stay put */
+	char *large = malloc(100000);
+	memset(large, 'x', 99999);
+	large[99999] = '\0';
+	const char *l = ax_atom_intern(atom, large);
+	ut_assert(r, l != large);
+	ut_assert_str_equal(r, large, l);
+	ut_assert(r, l == ax_atom_intern(atom, large));
+	free(large);
+
+	const char *p[N];
+	for (int i = 0; i < N; i++) {
+		sprintf(buf, "identifier_%d", i);
+		p[i] = ax_atom_intern(atom, buf);
+	}
+	for (int i = 0; i < N; i++) {
+		sprintf(buf, "identifier_%d", i);
+		ut_assert(r, p[i] == ax_atom_lookup(atom, buf));
+		ut_assert_str_equal(r, buf, p[i]);
+		ut_assert_uint_equal(r, strlen(buf), ax_atom_length(p[i]));
+	}
+	ut_assert_uint_equal(r, N + 6, ax_atom_size(atom));
+	ut_assert_str_equal(r, "hello", a);
+
+	ax_atom_free(atom);
+}
+
+static void trait(ut_runner *r)
+{
+	ax_atom *atom = ax_atom_create(0);
+	const char *a = ax_atom_intern(atom, "alpha"), *b = ax_atom_intern(atom, "beta");
+
+	ax_hmap_r hmap = ax_new(ax_hmap, ax_t(atom), ax_t(int));
+	ax_map_put(hmap.ax_map, a, ax_p(int, 1));
+	ax_map_put(hmap.ax_map, b, ax_p(int, 2));
+	ax_map_put(hmap.ax_map, ax_atom_intern(atom, "alpha"), ax_p(int, 3));
+	ut_assert_uint_equal(r, 2, ax_box_size(hmap.ax_box));
+	ut_assert_int_equal(r, 3, *(int *)ax_map_get(hmap.ax_map, a));
+
+	/* The text does not matter, only the pointer */
+	char copy[] = "beta";
+	ut_assert(r, !ax_map_exist(hmap.ax_map, copy));
+	ut_assert(r, ax_map_exist(hmap.ax_map, ax_atom_intern(atom, copy)));
+
+	ax_rb_r rb = ax_new(ax_rb, ax_t(atom), ax_t(int));
+	ax_map_put(rb.ax_map, b, ax_p(int, 2));
+	ax_map_put(rb.ax_map, a, ax_p(int, 1));
+	ut_assert_int_equal(r, 1, *(int *)ax_map_get(rb.ax_map, a));
+	ut_assert_int_equal(r, 2, *(int *)ax_map_get(rb.ax_map, b));
+
+	ax_rb_r rb_copy = AX_R_INIT(ax_any, ax_any_copy(rb.ax_any));
+	ax_map_cforeach(rb_copy.ax_map, const char *, key, const int *, val)
+		ut_assert(r, (key == a && *val == 1) || (key == b && *val == 2));
+
+	ax_one_free(rb_copy.ax_one);
+	ax_one_free(rb.ax_one);
+	ax_one_free(hmap.ax_one);
+	ax_atom_free(atom);
+}
+
+#define THREADS 8
+
+struct worker_st
+{
+	ax_atom *atom;
+	const char **out;
+	int offset;
+};
+
+static uintptr_t worker(void *arg)
+{
+	struct worker_st *w = arg;
+	for (int i = 0; i < N; i++) {
+		char buf[32];
+		int k = (i + w->offset) % N;
+		sprintf(buf, "name_%d", k);
+		w->out[k] = ax_atom_intern(w->atom, buf);
+	}
+	return 0;
+}
+
+static void threads(ut_runner *r)
+{
+	ax_atom *atom = ax_atom_create(0);
+	const char **out = malloc(sizeof *out * N * THREADS);
+	struct worker_st w[THREADS];
+	ax_thread t[THREADS];
+
+	for (int i = 0; i < THREADS; i++) {
+		w[i] = (struct worker_st) { atom, out + i * N, i * N / THREADS };
+		ax_thread_create(worker, w + i, t + i);
+	}
+	for (int i = 0; i < THREADS; i++)
+		ax_thread_join(t + i, NULL);
+
+	ut_assert_uint_equal(r, N, ax_atom_size(atom));
+	for (int i = 0; i < N; i++)
+		for (int j = 1; j < THREADS; j++)
+			ut_assert(r, out[i] == out[j * N + i]);
+
+	free(out);
+	ax_atom_free(atom);
+}
+
+#define KEYS 200000
+#define ROUNDS 10
+
+static void bench_map(ut_runner *r, const char *name, const ax_trait *key_tr, const char **keys)
+{
+	size_t before = heap_used();
+	ax_hmap_r hmap = ax_new(ax_hmap, key_tr, ax_t(int));
+	for (int i = 0; i < KEYS; i++)
+		ax_map_put(hmap.ax_map, keys[i], &i);
+	size_t used = heap_used() - before;
+
+	long sum = 0;
+	clock_t time_before = clock();
+	for (int round = 0; round < ROUNDS; round++)
+		for (int i = 0; i < KEYS; i++)
+			sum += *(int *)ax_map_get(hmap.ax_map, keys[i]);
+	double time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+	ut_printf(r, "%s keys: %d lookups spent %lfs, map used %zu bytes (%ld)",
+			name, KEYS * ROUNDS, time, used, sum & 0xF);
+	ax_one_free(hmap.ax_one);
+}
+
+static void bench(ut_runner *r)
+{
+	char (*words)[48] = malloc(sizeof *words * KEYS);
+	const char **keys = malloc(sizeof *keys * KEYS);
+	for (int i = 0; i < KEYS; i++) {
+		sprintf(words[i], "some_rather_long_identifier_number_%d", i);
+		keys[i] = words[i];
+	}
+	bench_map(r, "ax_t(str)", ax_t(str), keys);
+
+	size_t before = heap_used();
+	ax_atom *atom = ax_atom_create(0);
+	clock_t time_before = clock();
+	for (int i = 0; i < KEYS; i++)
+		keys[i] = ax_atom_intern(atom, words[i]);
+	double time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_printf(r, "interning %d strings spent %lfs, table used %zu bytes",
+			KEYS, time, heap_used() - before);
+	bench_map(r, "ax_t(atom)", ax_t(atom), keys);
+
+	ax_atom_free(atom);
+	free(keys);
+	free(words);
+}
+
+ut_suite *suite_for_atom()
+{
+	ut_suite *suite = ut_suite_create("atom");
+
+	ut_suite_add(suite, intern, 0);
+	ut_suite_add(suite, trait, 0);
+	ut_suite_add(suite, threads, 0);
+	ut_suite_add(suite, bench, 0);
+
+	return suite;
+}
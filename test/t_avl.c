@@ -206,6 +206,88 @@ static void clear(ut_runner *r)
 	ax_one_free(avl.ax_one);
 }
 
+static void build(ut_runner *r)
+{
+	int keys[1000], vals[1000];
+	for (int i = 0; i < 1000; i++)
+		keys[i] = i * 2, vals[i] = i;
+
+	ax_avl_r avl = ax_new(ax_avl, ax_t(int), ax_t(int));
+	ut_assert(r, !ax_avl_build(avl.ax_avl, keys, vals, 1000));
+	ut_assert_uint_equal(r, 1000, ax_box_size(avl.ax_box));
+
+	int i = 0;
+	ax_map_cforeach(avl.ax_map, const int *, key, const int *, val) {
+		ut_assert_int_equal(r, i * 2, *key);
+		ut_assert_int_equal(r, i, *val);
+		i++;
+	}
+	ut_assert_uint_equal(r, 300, ax_map_rank(avl.ax_map, ax_p(int, 599)));
+
+	/* The tree stays balanced after building, no matter what follows */
+	for (int i = 0; i < 1000; i += 2)
+		ax_map_erase(avl.ax_map, keys + i);
+	ut_assert_uint_equal(r, 500, ax_box_size(avl.ax_box));
+
+	ax_avl_r copy = ax_new(ax_avl, ax_t(int), ax_t(int));
+	ax_citer first = ax_box_cbegin(avl.ax_box), last = ax_box_cend(avl.ax_box);
+	ut_assert(r, !ax_avl_build_range(copy.ax_avl, &first, &last));
+	ut_assert_uint_equal(r, 500, ax_box_size(copy.ax_box));
+	for (int i = 1; i < 1000; i += 2)
+		ut_assert_int_equal(r, i, *(int *)ax_map_get(copy.ax_map, keys + i));
+
+	ax_one_free(copy.ax_one);
+	ax_one_free(avl.ax_one);
+}
+
+static void set_ops(ut_runner *r)
+{
+	/* a holds the multiples of 2, and b holds the multiples of 3, below 1000 */
+	ax_avl_r a = ax_new(ax_avl, ax_t(str), ax_t(int)), b = ax_new(ax_avl, ax_t(str), ax_t(int));
+	char key[16];
+	for (int i = 0; i < 1000; i++) {
+		sprintf(key, "%03d", i);
+		if (i % 2 == 0)
+			ax_map_put(a.ax_map, key, &i);
+		if (i % 3 == 0)
+			ax_map_put(b.ax_map, key, ax_p(int, -i));
+	}
+
+	ax_avl_r c = AX_R_INIT(ax_any, ax_any_copy(a.ax_any));
+	ax_avl_intersection(c.ax_avl, b.ax_avl);
+	ut_assert_uint_equal(r, 167, ax_box_size(c.ax_box));
+	ax_map_cforeach(c.ax_map, const char *, k, const int *, val) {
+		ut_assert_int_equal(r, atoi(k), *val);
+		ut_assert_int_equal(r, 0, *val % 6);
+	}
+	ax_avl_difference(a.ax_avl, c.ax_avl);
+	ut_assert_uint_equal(r, 500 - 167, ax_box_size(a.ax_box));
+
+	/* Pairs of b replace the ones of c */
+	ax_avl_union(c.ax_avl, b.ax_avl);
+	ut_assert_uint_equal(r, 334, ax_box_size(c.ax_box));
+	ut_assert_uint_equal(r, 0, ax_box_size(b.ax_box));
+	ax_map_cforeach(c.ax_map, const char *, k, const int *, val) {
+		ut_assert_int_equal(r, -atoi(k), *val);
+		ut_assert_int_equal(r, 0, -*val % 3);
+	}
+	ax_avl_union(a.ax_avl, c.ax_avl);
+	ut_assert_uint_equal(r, 667, ax_box_size(a.ax_box));
+
+	ax_avl_split(a.ax_avl, "500", b.ax_avl);
+	ut_assert_uint_equal(r, 333, ax_box_size(a.ax_box));
+	ut_assert_uint_equal(r, 334, ax_box_size(b.ax_box));
+	ax_iter first = ax_box_begin(b.ax_box);
+	ut_assert_str_equal(r, "500", ax_map_iter_key(&first));
+	ax_avl_join(a.ax_avl, b.ax_avl);
+	ut_assert_uint_equal(r, 667, ax_box_size(a.ax_box));
+	ut_assert_uint_equal(r, 400, ax_map_rank(a.ax_map, "600"));
+
+	ax_one_free(c.ax_one);
+	ax_one_free(b.ax_one);
+	ax_one_free(a.ax_one);
+}
+
 ut_suite* suite_for_avl()
 {
 	ut_suite *suite = ut_suite_create("avl");
@@ -216,6 +298,8 @@ ut_suite* suite_for_avl()
 	ut_suite_add(suite, clear, 0);
 	ut_suite_add(suite, duplicate, 0);
 	ut_suite_add(suite, erase, 0);
+	ut_suite_add(suite, build, 0);
+	ut_suite_add(suite, set_ops, 0);
 
 	return suite;
 }
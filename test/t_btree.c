@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/btree.h"
+#include "ax/rb.h"
+#include "ax/iter.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define N 20000
+#define RANGE 4096
+
+static void check_order(ut_runner *r, ax_map *map, const bool *present)
+{
+	size_t count = 0;
+	int last = -1;
+	ax_map_cforeach(map, const int *, key, const int *, val) {
+		ut_assert(r, *key > last);
+		ut_assert(r, present[*key]);
+		ut_assert_int_equal(r, *key * 2, *val);
+		last = *key;
+		count++;
+	}
+	ut_assert_uint_equal(r, ax_box_size(ax_r(ax_map, map).ax_box), count);
+
+	int next = RANGE;
+	ax_box *box = ax_r(ax_map, map).ax_box;
+	for (ax_iter it = ax_box_rbegin(box), end = ax_box_rend(box); !ax_iter_equal(&it, &end); ax_iter_next(&it)) {
+		const int *key = ax_map_iter_key(&it);
+		ut_assert(r, *key < next);
+		next = *key;
+		count--;
+	}
+	ut_assert_uint_equal(r, 0, count);
+}
+
+static void random_ops(ut_runner *r)
+{
+	ax_btree_r btree = ax_new(ax_btree, ax_t(int), ax_t(int));
+	bool present[RANGE] = { false };
+	size_t size = 0;
+
+	srand(1);
+	for (int i = 0; i < N; i++) {
+		int key = rand() % RANGE, val = key * 2;
+		/* Insertions dominate in the first half, removals in the second */
+		if (rand() % 4 < (i < N / 2 ? 3 : 1)) {
+			ut_assert(r, ax_map_put(btree.ax_map, &key, &val) != NULL);
+			size += !present[key];
+			present[key] = true;
+		} else {
+			ut_assert(r, ax_map_erase(btree.ax_map, &key) == !present[key]);
+			size -= present[key];
+			present[key] = false;
+		}
+		if (i % 2000 == 0)
+			check_order(r, btree.ax_map, present);
+	}
+	ut_assert_uint_equal(r, size, ax_box_size(btree.ax_box));
+	check_order(r, btree.ax_map, present);
+
+	for (int i = 0; i < RANGE; i++)
+		ut_assert(r, ax_map_exist(btree.ax_map, &i) == present[i]);
+
+	for (int i = 0; i < RANGE; i++)
+		ax_map_erase(btree.ax_map, &i);
+	ut_assert_uint_equal(r, 0, ax_box_size(btree.ax_box));
+	ax_iter first = ax_box_begin(btree.ax_box), last = ax_box_end(btree.ax_box);
+	ut_assert(r, ax_iter_equal(&first, &last));
+
+	ax_one_free(btree.ax_one);
+}
+
+static void str_key(ut_runner *r)
+{
+	ax_btree_r btree = ax_new(ax_btree, ax_t(str), ax_t(int));
+	for (int i = 0; i < N; i++) {
+		char key[16];
+		sprintf(key, "%05d", (i * 7919) % N);
+		ax_map_put(btree.ax_map, key, &i);
+	}
+	ut_assert_uint_equal(r, N, ax_box_size(btree.ax_box));
+
+	int expect = 0;
+	ax_map_cforeach(btree.ax_map, const char *, key, const int *, val) {
+		char buf[16];
+		sprintf(buf, "%05d", expect);
+		ut_assert_str_equal(r, buf, key);
+		ut_assert_int_equal(r, expect, *val * 7919 % N);
+		expect++;
+	}
+
+	/* Separators are copies of keys, they must outlive the removed pairs */
+	for (int i = 0; i < N; i += 2) {
+		char key[16];
+		sprintf(key, "%05d", i);
+		ut_assert(r, !ax_map_erase(btree.ax_map, key));
+	}
+	for (int i = 0; i < N; i++) {
+		char key[16];
+		sprintf(key, "%05d", i);
+		ut_assert(r, ax_map_exist(btree.ax_map, key) == (i % 2));
+	}
+
+	ax_btree_r copy = AX_R_INIT(ax_any, ax_any_copy(btree.ax_any));
+	ut_assert_uint_equal(r, N / 2, ax_box_size(copy.ax_box));
+	ax_one_free(btree.ax_one);
+	ut_assert(r, ax_map_exist(copy.ax_map, "00001"));
+	ax_one_free(copy.ax_one);
+}
+
+static void iter_erase(ut_runner *r)
+{
+	ax_btree_r btree = ax_new(ax_btree, ax_t(int), ax_t(int));
+	for (int i = 0; i < N; i++)
+		ax_map_put(btree.ax_map, &i, &i);
+
+	ax_iter it = ax_box_begin(btree.ax_box), end = ax_box_end(btree.ax_box);
+	while (!ax_iter_equal(&it, &end)) {
+		if (*(int *)ax_iter_get(&it) % 2)
+			ax_iter_erase(&it);
+		else
+			ax_iter_next(&it);
+	}
+	ut_assert_uint_equal(r, N / 2, ax_box_size(btree.ax_box));
+
+	int expect = N - 2;
+	it = ax_box_rbegin(btree.ax_box), end = ax_box_rend(btree.ax_box);
+	while (!ax_iter_equal(&it, &end)) {
+		ut_assert_int_equal(r, expect, *(int *)ax_iter_get(&it));
+		expect -= 2;
+		ax_iter_erase(&it);
+	}
+	ut_assert_int_equal(r, -2, expect);
+	ut_assert_uint_equal(r, 0, ax_box_size(btree.ax_box));
+
+	ax_one_free(btree.ax_one);
+}
+
+static void dist(ut_runner *r)
+{
+	ax_btree_r btree = ax_new(ax_btree, ax_t(int), ax_t(int));
+	for (int i = 0; i < N; i++)
+		ax_map_put(btree.ax_map, &i, &i);
+
+	ax_iter first = ax_box_begin(btree.ax_box), last = ax_box_end(btree.ax_box);
+	ut_assert_int_equal(r, N, ax_iter_dist(&first, &last));
+
+	ax_iter it = ax_map_at(btree.ax_map, ax_p(int, 1234));
+	ut_assert_int_equal(r, 1234, ax_iter_dist(&first, &it));
+	ut_assert(r, ax_iter_less(&first, &it));
+	ut_assert(r, ax_iter_less(&it, &last));
+	ut_assert(r, !ax_iter_less(&last, &it));
+
+	ax_iter rfirst = ax_box_rbegin(btree.ax_box), rlast = ax_box_rend(btree.ax_box);
+	ut_assert_int_equal(r, N, ax_iter_dist(&rfirst, &rlast));
+
+	ax_one_free(btree.ax_one);
+}
+
+static void chkey(ut_runner *r)
+{
+	ax_btree_r btree = ax_new(ax_btree, ax_t(int), ax_t(int));
+	for (int i = 0; i < 1000; i++)
+		ax_map_put(btree.ax_map, &i, &i);
+
+	int *kp = ax_map_chkey(btree.ax_map, ax_p(int, 10), ax_p(int, 5000));
+	ut_assert(r, kp != NULL);
+	ut_assert_int_equal(r, 5000, *kp);
+	ut_assert_int_equal(r, 10, *(int *)ax_map_get(btree.ax_map, ax_p(int, 5000)));
+	ut_assert(r, !ax_map_exist(btree.ax_map, ax_p(int, 10)));
+	ut_assert_uint_equal(r, 1000, ax_box_size(btree.ax_box));
+
+	/* Overwrite an existing key */
+	ax_map_chkey(btree.ax_map, ax_p(int, 5000), ax_p(int, 20));
+	ut_assert_uint_equal(r, 999, ax_box_size(btree.ax_box));
+	ut_assert_int_equal(r, 10, *(int *)ax_map_get(btree.ax_map, ax_p(int, 20)));
+
+	ax_one_free(btree.ax_one);
+}
+
+static void scan_time(ut_runner *r)
+{
+	const int count = 1 << 18;
+	ax_btree_r btree = ax_new(ax_btree, ax_t(int), ax_t(int));
+	ax_rb_r rb = ax_new(ax_rb, ax_t(int), ax_t(int));
+	for (int i = 0; i < count; i++) {
+		int key = rand();
+		ax_map_put(btree.ax_map, &key, &i);
+		ax_map_put(rb.ax_map, &key, &i);
+	}
+
+	long sum = 0;
+	clock_t time_before = clock();
+	ax_box_cforeach(btree.ax_box, const int *, val)
+		sum += *val;
+	double btree_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+	time_before = clock();
+	ax_box_cforeach(rb.ax_box, const int *, val)
+		sum -= *val;
+	double rb_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_int_equal(r, 0, sum);
+
+	ut_printf(r, "scan %d pairs: ax_btree spent %lfs, ax_rb spent %lfs", count, btree_time, rb_time);
+
+	ax_one_free(btree.ax_one);
+	ax_one_free(rb.ax_one);
+}
+
+ut_suite *suite_for_btree()
+{
+	ut_suite *suite = ut_suite_create("btree");
+
+	ut_suite_add(suite, random_ops, 0);
+	ut_suite_add(suite, str_key, 0);
+	ut_suite_add(suite, iter_erase, 0);
+	ut_suite_add(suite, dist, 0);
+	ut_suite_add(suite, chkey, 0);
+	ut_suite_add(suite, scan_time, 1);
+
+	return suite;
+}
@@ -408,6 +408,43 @@ static void trie_rekey(ut_runner *r)
 	ut_assert(r, !"BUG");
 }
 
+static void bytes_key(ut_runner *r)
+{
+	ax_btrie_r btrie = make_test_btrie();
+	bool valued;
+
+	int k111[] = { 1, 1, 1 }, k12[] = { 1, 2 }, k122[] = { 1, 2, 2 }, k3[] = { 3 };
+	ut_assert_int_equal(r, 111, *(int *)ax_trie_get_bytes(btrie.ax_trie, k111, sizeof k111));
+	ut_assert_int_equal(r, 11, *(int *)ax_trie_get_bytes(btrie.ax_trie, k111, sizeof(int) * 2));
+	ut_assert_int_equal(r, 0, *(int *)ax_trie_get_bytes(btrie.ax_trie, NULL, 0));
+	ut_assert(r, !ax_trie_get_bytes(btrie.ax_trie, k12, sizeof k12));
+	ut_assert(r, !ax_trie_get_bytes(btrie.ax_trie, k3, sizeof k3));
+
+	ut_assert(r, ax_trie_exist_bytes(btrie.ax_trie, k12, sizeof k12, &valued));
+	ut_assert(r, !valued);
+	ut_assert(r, !ax_trie_exist_bytes(btrie.ax_trie, k122, sizeof k122, NULL));
+
+	ut_assert(r, ax_trie_put_bytes(btrie.ax_trie, k122, sizeof k122, ax_p(int, 122)));
+	ut_assert(r, ax_trie_put_bytes(btrie.ax_trie, k111, sizeof k111, ax_p(int, -111)));
+	ut_assert_uint_equal(r, 8, ax_box_size(btrie.ax_box));
+
+	ax_list_r key = ax_new(ax_list, ax_trie_key_tr(btrie.ax_trie));
+	ax_seq_push_arraya(key.ax_seq, ax_arraya(int, 1, 2, 2));
+	ut_assert_int_equal(r, 122, *(int *)ax_trie_get(btrie.ax_trie, key.ax_seq));
+	ax_box_clear(key.ax_box);
+	ax_seq_push_arraya(key.ax_seq, ax_arraya(int, 1, 1, 1));
+	ut_assert_int_equal(r, -111, *(int *)ax_trie_get(btrie.ax_trie, key.ax_seq));
+	ax_one_free(key.ax_one);
+	ax_one_free(btrie.ax_one);
+
+	btrie = ax_new(ax_btrie, ax_t(char), ax_t(int));
+	ut_assert(r, ax_trie_put_bytes(btrie.ax_trie, "abc", 3, ax_p(int, 1)));
+	ut_assert_int_equal(r, 1, *(int *)ax_trie_get_bytes(btrie.ax_trie, "abcd", 3));
+	ut_assert(r, ax_trie_exist_bytes(btrie.ax_trie, "ab", 2, &valued));
+	ut_assert(r, !valued);
+	ax_one_free(btrie.ax_one);
+}
+
 ut_suite *suite_for_btrie()
 {
 	ut_suite *suite = ut_suite_create("btrie");
@@ -421,6 +458,7 @@ ut_suite *suite_for_btrie()
 	ut_suite_add(suite, trie_prune, 2);
 	ut_suite_add(suite, trie_rekey, 2);
 	ut_suite_add(suite, iterater, 2);
+	ut_suite_add(suite, bytes_key, 2);
 
 	return suite;
 }
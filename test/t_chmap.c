@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/chmap.h"
+#include "ax/hmap.h"
+#include "ax/thread.h"
+#include "ax/rwlock.h"
+#include "ax/timeval.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N 10000
+
+static void put_get(ut_runner *r)
+{
+	ax_chmap *chmap = ax_chmap_create(ax_t(str), ax_t(int), 8);
+	ut_assert(r, chmap != NULL);
+	ut_assert_uint_equal(r, 8, ax_chmap_shards(chmap));
+
+	for (int i = 0; i < N; i++) {
+		char key[16];
+		sprintf(key, "%d", i);
+		ut_assert(r, !ax_chmap_put(chmap, key, &i));
+	}
+	ut_assert_uint_equal(r, N, ax_chmap_size(chmap));
+
+	for (int i = 0; i < N; i++) {
+		char key[16];
+		int val = -1;
+		sprintf(key, "%d", i);
+		ut_assert(r, !ax_chmap_get(chmap, key, &val));
+		ut_assert_int_equal(r, i, val);
+		ut_assert(r, ax_chmap_exist(chmap, key));
+	}
+
+	for (int i = 0; i < N; i += 2) {
+		char key[16];
+		sprintf(key, "%d", i);
+		ut_assert(r, !ax_chmap_erase(chmap, key));
+		ut_assert(r, ax_chmap_erase(chmap, key));
+		ut_assert(r, ax_chmap_get(chmap, key, NULL));
+	}
+	ut_assert_uint_equal(r, N / 2, ax_chmap_size(chmap));
+
+	ax_chmap_free(chmap);
+}
+
+static ax_fail make_str(const void *key, void *val, void *arg)
+{
+	(*(int *)arg)++;
+	*(char **)val = ax_strdup(key);
+	return !*(char **)val;
+}
+
+static size_t hash_calls;
+
+static size_t counted_hash(const void *p)
+{
+	hash_calls++;
+	return *(int *)p;
+}
+
+static bool counted_equal(const void *p1, const void *p2)
+{
+	return *(int *)p1 == *(int *)p2;
+}
+
+ax_trait_declare(counted_int, int);
+ax_trait_define(counted_int, HASH(counted_hash), EQUAL(counted_equal));
+
+static void hash_once(ut_runner *r)
+{
+	ax_chmap *chmap = ax_chmap_create(ax_t(counted_int), ax_t(int), 4);
+	ut_assert(r, chmap != NULL);
+
+	/* Each operation hashes the key once, resizing uses the cached hashes */
+	for (int i = 0; i < 8; i++)
+		ut_assert(r, !ax_chmap_put(chmap, &i, &i));
+
+	hash_calls = 0;
+	for (int i = 0; i < 8; i++) {
+		int val;
+		ut_assert(r, !ax_chmap_put(chmap, &i, &i));
+		ut_assert(r, !ax_chmap_get(chmap, &i, &val));
+		ut_assert(r, ax_chmap_exist(chmap, &i));
+		ut_assert(r, !ax_chmap_erase(chmap, &i));
+	}
+#ifndef AX_HMAP_NO_HASH_CACHE
+	ut_assert_uint_equal(r, 8 * 4, hash_calls);
+#endif
+
+	ax_chmap_free(chmap);
+}
+
+static void compute_if_absent(ut_runner *r)
+{
+	ax_chmap *chmap = ax_chmap_create(ax_t(str), ax_t(str), 0);
+	int calls = 0;
+	char *val = NULL;
+
+	ut_assert(r, !ax_chmap_compute_if_absent(chmap, "foo", make_str, &calls, &val));
+	ut_assert_str_equal(r, "foo", val);
+	ut_assert_int_equal(r, 1, calls);
+	free(val);
+
+	ut_assert(r, !ax_chmap_compute_if_absent(chmap, "foo", make_str, &calls, &val));
+	ut_assert_str_equal(r, "foo", val);
+	ut_assert_int_equal(r, 1, calls);
+	free(val);
+
+	ut_assert(r, !ax_chmap_compute_if_absent(chmap, "bar", make_str, &calls, NULL));
+	ut_assert_int_equal(r, 2, calls);
+	ut_assert_uint_equal(r, 2, ax_chmap_size(chmap));
+
+	ax_chmap_free(chmap);
+}
+
+static void snapshot(ut_runner *r)
+{
+	ax_chmap *chmap = ax_chmap_create(ax_t(int), ax_t(int), 4);
+	for (int i = 0; i < N; i++)
+		ax_chmap_put(chmap, &i, &i);
+
+	ax_map *snap = ax_chmap_snapshot(chmap);
+	ut_assert(r, snap != NULL);
+	for (int i = 0; i < N; i++)
+		ax_chmap_erase(chmap, &i);
+
+	ut_assert_uint_equal(r, 0, ax_chmap_size(chmap));
+	ut_assert_uint_equal(r, N, ax_box_size(ax_r(ax_map, snap).ax_box));
+	int *table = calloc(N, sizeof(int));
+	ax_map_cforeach(snap, const int *, key, const int *, val) {
+		ut_assert_int_equal(r, *key, *val);
+		table[*key]++;
+	}
+	for (int i = 0; i < N; i++)
+		ut_assert_int_equal(r, 1, table[i]);
+	free(table);
+
+	ax_one_free(ax_r(ax_map, snap).ax_one);
+	ax_chmap_free(chmap);
+}
+
+#define THREADS 8
+#define KEYS (1 << 16)
+#define OPS 200000
+
+struct bench_st
+{
+	ax_chmap *chmap;
+	ax_map *hmap;
+	ax_rwlock *lock;
+	unsigned seed;
+};
+
+static unsigned bench_rand(unsigned *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return *seed >> 8;
+}
+
+static uintptr_t bench_chmap(void *arg)
+{
+	struct bench_st *b = arg;
+	for (int i = 0; i < OPS; i++) {
+		int key = bench_rand(&b->seed) % KEYS, val;
+		if (i % 10 == 0)
+			ax_chmap_put(b->chmap, &key, &i);
+		else
+			ax_chmap_get(b->chmap, &key, &val);
+	}
+	return 0;
+}
+
+static uintptr_t bench_locked_hmap(void *arg)
+{
+	struct bench_st *b = arg;
+	for (int i = 0; i < OPS; i++) {
+		int key = bench_rand(&b->seed) % KEYS, val;
+		if (i % 10 == 0) {
+			ax_rwlock_wlock(b->lock);
+			ax_map_put(b->hmap, &key, &i);
+		} else {
+			ax_rwlock_rlock(b->lock);
+			int *p = ax_map_get(b->hmap, &key);
+			if (p)
+				val = *p;
+			ax_unused(val);
+		}
+		ax_rwlock_unlock(b->lock);
+	}
+	return 0;
+}
+
+static double run_threads(ax_thread_func_f *func, struct bench_st *b)
+{
+	ax_thread threads[THREADS];
+	struct timeval before, after, diff;
+	ax_timeval_timeofday(&before);
+	for (int i = 0; i < THREADS; i++)
+		ax_thread_create(func, b + i, threads + i);
+	for (int i = 0; i < THREADS; i++)
+		ax_thread_join(threads + i, NULL);
+	ax_timeval_timeofday(&after);
+	ax_timeval_sub(&after, &before, &diff);
+	return diff.tv_sec + diff.tv_usec / 1000000.0;
+}
+
+static void throughput(ut_runner *r)
+{
+	struct bench_st b[THREADS];
+	ax_rwlock lock;
+	ax_rwlock_init(&lock);
+	ax_chmap *chmap = ax_chmap_create(ax_t(int), ax_t(int), 0);
+	ax_hmap_r hmap = ax_new(ax_hmap, ax_t(int), ax_t(int));
+
+	for (int i = 0; i < KEYS; i += 2) {
+		ax_chmap_put(chmap, &i, &i);
+		ax_map_put(hmap.ax_map, &i, &i);
+	}
+
+	for (int i = 0; i < THREADS; i++)
+		b[i] = (struct bench_st) { chmap, hmap.ax_map, &lock, i };
+	double locked = run_threads(bench_locked_hmap, b);
+
+	for (int i = 0; i < THREADS; i++)
+		b[i].seed = i;
+	double sharded = run_threads(bench_chmap, b);
+
+	ut_printf(r, "%d threads, %d ops each: ax_hmap with ax_rwlock spent %lfs, "
+			"ax_chmap with %zu shards spent %lfs",
+			THREADS, OPS, locked, ax_chmap_shards(chmap), sharded);
+
+	for (int i = 0; i < KEYS; i++) {
+		int *p = ax_map_get(hmap.ax_map, &i), val;
+		ut_assert(r, !p == ax_chmap_get(chmap, &i, &val));
+	}
+	ut_assert_uint_equal(r, ax_box_size(hmap.ax_box), ax_chmap_size(chmap));
+
+	ax_one_free(hmap.ax_one);
+	ax_chmap_free(chmap);
+	ax_rwlock_destroy(&lock);
+}
+
+ut_suite *suite_for_chmap()
+{
+	ut_suite *suite = ut_suite_create("chmap");
+
+	ut_suite_add(suite, put_get, 0);
+	ut_suite_add(suite, hash_once, 0);
+	ut_suite_add(suite, compute_if_absent, 0);
+	ut_suite_add(suite, snapshot, 0);
+	ut_suite_add(suite, throughput, 0);
+
+	return suite;
+}
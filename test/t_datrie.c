@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/datrie.h"
+#include "ax/btrie.h"
+#include "ax/art.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define N 100000
+
+static const char *const words[] = {
+	"a", "ab", "abc", "abd", "b", "ba", "bcd", "hello", "help", "helpful", "",
+};
+
+#define NWORDS (sizeof words / sizeof *words)
+
+static uint32_t int_value(const void *val, void *ctx)
+{
+	return *(const int *)val;
+}
+
+static ax_trie *make_trie(ax_trie *trie)
+{
+	for (int i = 0; i < NWORDS; i++)
+		ax_trie_put_bytes(trie, words[i], strlen(words[i]), &i);
+	return trie;
+}
+
+struct enum_ctx_st
+{
+	ut_runner *r;
+	const char *const *expect;
+	int index;
+};
+
+static bool enum_cb(const ax_byte *key, size_t len, uint32_t value, void *ctx)
+{
+	struct enum_ctx_st *ectx = ctx;
+	const char *expect = ectx->expect[ectx->index++];
+	ut_assert_uint_equal(ectx->r, strlen(expect), len);
+	ut_assert(ectx->r, memcmp(expect, key, len) == 0);
+	return false;
+}
+
+static void query(ut_runner *r)
+{
+	ax_btrie_r btrie = AX_R_INIT(ax_trie, make_trie(ax_new(ax_btrie, ax_t(char), ax_t(int)).ax_trie));
+	ax_datrie dat;
+	ut_assert(r, !ax_datrie_freeze(&dat, btrie.ax_trie, int_value, NULL));
+	ax_one_free(btrie.ax_one);
+	ut_assert_uint_equal(r, NWORDS, ax_datrie_size(&dat));
+
+	uint32_t value;
+	for (int i = 0; i < NWORDS; i++) {
+		ut_assert(r, ax_datrie_get(&dat, words[i], strlen(words[i]), &value));
+		ut_assert_uint_equal(r, i, value);
+	}
+	ut_assert(r, !ax_datrie_get(&dat, "hel", 3, NULL));
+	ut_assert(r, !ax_datrie_get(&dat, "abcd", 4, NULL));
+	ut_assert(r, !ax_datrie_get(&dat, "c", 1, NULL));
+
+	size_t len;
+	ut_assert(r, ax_datrie_longest_prefix(&dat, "helpfulness", 11, &len, &value));
+	ut_assert_uint_equal(r, 7, len);
+	ut_assert_uint_equal(r, 9, value);
+	ut_assert(r, ax_datrie_longest_prefix(&dat, "helicopter", 10, &len, &value));
+	ut_assert_uint_equal(r, 0, len);
+	ut_assert_uint_equal(r, 10, value);
+
+	static const char *const expect_ab[] = { "ab", "abc", "abd" };
+	struct enum_ctx_st ectx = { .r = r, .expect = expect_ab };
+	ut_assert(r, !ax_datrie_enum_prefix(&dat, "ab", 2, enum_cb, &ectx));
+	ut_assert_int_equal(r, 3, ectx.index);
+
+	static const char *const expect_all[] = {
+		"", "a", "ab", "abc", "abd", "b", "ba", "bcd", "hello", "help", "helpful",
+	};
+	ectx = (struct enum_ctx_st) { .r = r, .expect = expect_all };
+	ut_assert(r, !ax_datrie_enum_prefix(&dat, NULL, 0, enum_cb, &ectx));
+	ut_assert_int_equal(r, NWORDS, ectx.index);
+
+	ectx = (struct enum_ctx_st) { .r = r, .expect = NULL };
+	ut_assert(r, !ax_datrie_enum_prefix(&dat, "x", 1, enum_cb, &ectx));
+	ut_assert_int_equal(r, 0, ectx.index);
+
+	ax_datrie_free(&dat);
+}
+
+static void ordinal(ut_runner *r)
+{
+	ax_art_r art = AX_R_INIT(ax_trie, make_trie(ax_new(ax_art, ax_t(char), ax_t(int)).ax_trie));
+	ax_datrie dat;
+	ut_assert(r, !ax_datrie_freeze(&dat, art.ax_trie, NULL, NULL));
+	ax_one_free(art.ax_one);
+
+	/* Values are positions in byte order */
+	uint32_t value;
+	ut_assert(r, ax_datrie_get(&dat, "", 0, &value));
+	ut_assert_uint_equal(r, 0, value);
+	ut_assert(r, ax_datrie_get(&dat, "abd", 3, &value));
+	ut_assert_uint_equal(r, 4, value);
+	ut_assert(r, ax_datrie_get(&dat, "helpful", 7, &value));
+	ut_assert_uint_equal(r, 10, value);
+
+	ax_datrie_free(&dat);
+
+	art = ax_new(ax_art, ax_t(char), ax_t(int));
+	ut_assert(r, !ax_datrie_freeze(&dat, art.ax_trie, NULL, NULL));
+	ut_assert_uint_equal(r, 0, ax_datrie_size(&dat));
+	ut_assert(r, !ax_datrie_get(&dat, "", 0, NULL));
+	ut_assert(r, !ax_datrie_longest_prefix(&dat, "a", 1, NULL, NULL));
+	ax_datrie_free(&dat);
+	ax_one_free(art.ax_one);
+}
+
+static void signed_bytes(ut_runner *r)
+{
+	/* Keys sorted in unsigned byte order */
+	static const char *const keys[] = { "a", "z", "\x80", "\xc3", "\xc3\xa9", "\xff" };
+	static const int order[] = { 3, 0, 5, 1, 4, 2 };
+
+	ax_btrie_r btrie = ax_new(ax_btrie, ax_t(char), ax_t(int));
+	for (int i = 0; i < 6; i++)
+		ax_trie_put_bytes(btrie.ax_trie, keys[order[i]], strlen(keys[order[i]]), &i);
+
+	ax_datrie dat;
+	ut_assert(r, !ax_datrie_freeze(&dat, btrie.ax_trie, NULL, NULL));
+	ax_one_free(btrie.ax_one);
+	ut_assert_uint_equal(r, 6, ax_datrie_size(&dat));
+
+	uint32_t value;
+	for (int i = 0; i < 6; i++) {
+		ut_assert(r, ax_datrie_get(&dat, keys[i], strlen(keys[i]), &value));
+		ut_assert_uint_equal(r, i, value);
+	}
+	ut_assert(r, !ax_datrie_get(&dat, "\xc3\xa8", 2, NULL));
+
+	struct enum_ctx_st ectx = { .r = r, .expect = keys };
+	ut_assert(r, !ax_datrie_enum_prefix(&dat, NULL, 0, enum_cb, &ectx));
+	ut_assert_int_equal(r, 6, ectx.index);
+
+	ax_datrie_free(&dat);
+}
+
+static void image(ut_runner *r)
+{
+	ax_btrie_r btrie = AX_R_INIT(ax_trie, make_trie(ax_new(ax_btrie, ax_t(char), ax_t(int)).ax_trie));
+	ax_datrie dat;
+	ut_assert(r, !ax_datrie_freeze(&dat, btrie.ax_trie, int_value, NULL));
+	ax_one_free(btrie.ax_one);
+
+	size_t size;
+	const void *img = ax_datrie_image(&dat, &size);
+	FILE *fp = tmpfile();
+	ut_assert(r, fp != NULL);
+	ut_assert_uint_equal(r, size, fwrite(img, 1, size, fp));
+	ax_datrie_free(&dat);
+
+	/* Read back at another address */
+	uint32_t *buf = malloc(size);
+	rewind(fp);
+	ut_assert_uint_equal(r, size, fread(buf, 1, size, fp));
+	fclose(fp);
+
+	ut_assert(r, ax_datrie_load(&dat, buf, size - 1));
+	ut_assert(r, !ax_datrie_load(&dat, buf, size));
+	uint32_t value;
+	ut_assert(r, ax_datrie_get(&dat, "bcd", 3, &value));
+	ut_assert_uint_equal(r, 6, value);
+	ut_assert_uint_equal(r, NWORDS, ax_datrie_size(&dat));
+	ax_datrie_free(&dat);
+
+	buf[0] = ~buf[0];
+	ut_assert(r, ax_datrie_load(&dat, buf, size));
+	free(buf);
+}
+
+static void load_time(ut_runner *r)
+{
+	char (*keys)[32] = malloc(sizeof *keys * N);
+	for (int i = 0; i < N; i++)
+		sprintf(keys[i], "word%x-%d", i * 2654435761u, i % 100);
+
+	clock_t time_before = clock();
+	ax_art_r art = ax_new(ax_art, ax_t(char), ax_t(int));
+	for (int i = 0; i < N; i++)
+		ax_trie_put_bytes(art.ax_trie, keys[i], strlen(keys[i]), &i);
+	double build_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+	ax_datrie dat, loaded;
+	time_before = clock();
+	ut_assert(r, !ax_datrie_freeze(&dat, art.ax_trie, int_value, NULL));
+	double freeze_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ax_one_free(art.ax_one);
+
+	size_t size;
+	const void *img = ax_datrie_image(&dat, &size);
+	ut_assert(r, !ax_datrie_load(&loaded, img, size));
+
+	time_before = clock();
+	for (int i = 0; i < N; i++) {
+		uint32_t value;
+		ut_assert(r, ax_datrie_get(&loaded, keys[i], strlen(keys[i]), &value));
+		ut_assert_uint_equal(r, i, value);
+	}
+	ut_printf(r, "%d keys: building ax_art spent %lfs, freezing spent %lfs, "
+			"lookup spent %lfs, image is %zu bytes", N, build_time, freeze_time,
+			(double)(clock() - time_before) / CLOCKS_PER_SEC, size);
+
+	ax_datrie_free(&loaded);
+	ax_datrie_free(&dat);
+	free(keys);
+}
+
+ut_suite *suite_for_datrie()
+{
+	ut_suite *suite = ut_suite_create("datrie");
+
+	ut_suite_add(suite, query, 0);
+	ut_suite_add(suite, ordinal, 0);
+	ut_suite_add(suite, signed_bytes, 0);
+	ut_suite_add(suite, image, 0);
+	ut_suite_add(suite, load_time, 0);
+
+	return suite;
+}
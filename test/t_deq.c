@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#include "assist.h"
+#include "ax/deq.h"
+#include "ax/vector.h"
+#include "ax/iter.h"
+#include "ax/arraya.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+
+/* Enough elements to span several blocks of the deque */
+#define N 3000
+
+static void push_n(ut_runner *r)
+{
+	ax_deq_r deq = ax_new(ax_deq, ax_t(int));
+	int *arr = malloc(sizeof *arr * (N + 2));
+	for (int i = 0; i < N + 2; i++)
+		arr[i] = i;
+
+	ut_assert(r, !ax_seq_push_n(deq.ax_seq, arr, 2));
+	ut_assert(r, !ax_seq_push_n(deq.ax_seq, arr + 2, N));
+	ut_assert(r, !ax_seq_push_n(deq.ax_seq, NULL, 0));
+	ut_assert_uint_equal(r, N + 2, ax_box_size(deq.ax_box));
+	ut_assert(r, seq_equal_array(deq.ax_seq, arr, sizeof *arr * (N + 2)));
+
+	/* The rear is left where a push would put the next element */
+	int last = N + 2;
+	ut_assert(r, !ax_seq_push(deq.ax_seq, &last));
+	ut_assert_int_equal(r, N + 2, *(int *)ax_seq_last(deq.ax_seq));
+	for (int i = N + 2; i >= 0; i--) {
+		ut_assert_int_equal(r, i, *(int *)ax_seq_last(deq.ax_seq));
+		ax_seq_pop(deq.ax_seq);
+	}
+	ut_assert_uint_equal(r, 0, ax_box_size(deq.ax_box));
+
+	free(arr);
+	ax_one_free(deq.ax_one);
+}
+
+static void insert_range(ut_runner *r)
+{
+	ax_deq_r deq = ax_new(ax_deq, ax_t(int));
+	ax_vector_r src = ax_new(ax_vector, ax_t(int));
+	int *expect = malloc(sizeof *expect * (N * 2 + 3));
+	for (int i = 0; i < N; i++) {
+		ax_seq_push(deq.ax_seq, &i);
+		int val = -i;
+		ax_seq_push(src.ax_seq, &val);
+	}
+
+	/* Move the elements behind index 100 across the blocks */
+	ax_citer first = ax_box_cbegin(src.ax_box), last = ax_box_cend(src.ax_box);
+	ax_iter it = ax_seq_at(deq.ax_seq, 100);
+	ut_assert(r, !ax_seq_insert_range(deq.ax_seq, &it, &first, &last));
+	for (int i = 0; i < 100; i++)
+		expect[i] = i;
+	for (int i = 0; i < N; i++)
+		expect[100 + i] = -i;
+	for (int i = 100; i < N; i++)
+		expect[N + i] = i;
+	ut_assert_uint_equal(r, N * 2, ax_box_size(deq.ax_box));
+	ut_assert(r, seq_equal_array(deq.ax_seq, expect, sizeof *expect * N * 2));
+	ut_assert_int_equal(r, 100, *(int *)ax_iter_get(&it));
+
+	/* Same as inserting the elements one by one through a reversed iterator */
+	ax_vector_r small = ax_new(ax_vector, ax_t(int));
+	ax_seq_push_arraya(small.ax_seq, ax_arraya(int, 7, 8, 9));
+	first = ax_box_cbegin(small.ax_box);
+	last = ax_box_cend(small.ax_box);
+	it = ax_box_rbegin(deq.ax_box);
+	ut_assert(r, !ax_seq_insert_range(deq.ax_seq, &it, &first, &last));
+	expect[N * 2] = 9;
+	expect[N * 2 + 1] = 8;
+	expect[N * 2 + 2] = 7;
+	ut_assert(r, seq_equal_array(deq.ax_seq, expect, sizeof *expect * (N * 2 + 3)));
+	ut_assert_int_equal(r, N - 1, *(int *)ax_iter_get(&it));
+
+	free(expect);
+	ax_one_free(small.ax_one);
+	ax_one_free(src.ax_one);
+	ax_one_free(deq.ax_one);
+}
+
+static void erase_range(ut_runner *r)
+{
+	ax_deq_r deq = ax_new(ax_deq, ax_t(int));
+	int *expect = malloc(sizeof *expect * N);
+	for (int i = 0; i < N; i++)
+		ax_seq_push(deq.ax_seq, &i);
+
+	/* Leaves the elements of the last block to move to the first one */
+	ax_iter first = ax_seq_at(deq.ax_seq, 50), last = ax_seq_at(deq.ax_seq, N - 100);
+	ax_seq_erase_range(deq.ax_seq, &first, &last);
+	for (int i = 0; i < 50; i++)
+		expect[i] = i;
+	for (int i = 0; i < 100; i++)
+		expect[50 + i] = N - 100 + i;
+	ut_assert(r, seq_equal_array(deq.ax_seq, expect, sizeof *expect * 150));
+	ut_assert(r, ax_iter_equal(&first, &last));
+	ut_assert_int_equal(r, N - 100, *(int *)ax_iter_get(&first));
+
+	/* Erase the last 10 elements backward */
+	first = ax_box_rbegin(deq.ax_box);
+	last = first;
+	for (int i = 0; i < 10; i++)
+		ax_iter_next(&last);
+	ax_seq_erase_range(deq.ax_seq, &first, &last);
+	ut_assert(r, seq_equal_array(deq.ax_seq, expect, sizeof *expect * 140));
+	ut_assert_int_equal(r, N - 11, *(int *)ax_iter_get(&first));
+
+	first = ax_box_begin(deq.ax_box);
+	last = ax_box_end(deq.ax_box);
+	ax_seq_erase_range(deq.ax_seq, &first, &last);
+	ut_assert_uint_equal(r, 0, ax_box_size(deq.ax_box));
+
+	/* Still usable */
+	ax_seq_push_arraya(deq.ax_seq, ax_arraya(int, 1, 2, 3));
+	int table1[] = {1, 2, 3};
+	ut_assert(r, seq_equal_array(deq.ax_seq, table1, sizeof table1));
+
+	free(expect);
+	ax_one_free(deq.ax_one);
+}
+
+ut_suite *suite_for_deq()
+{
+	ut_suite *suite = ut_suite_create("deq");
+
+	ut_suite_add(suite, push_n, 0);
+	ut_suite_add(suite, insert_range, 0);
+	ut_suite_add(suite, erase_range, 0);
+
+	return suite;
+}
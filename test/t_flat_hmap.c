@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/flat_hmap.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N 10000
+
+static void str_key(ut_runner *r)
+{
+	ax_flat_hmap_r fhmap = ax_new(ax_flat_hmap, ax_t(str), ax_t(int));
+	for (int i = 0; i < N; i++) {
+		char key[16];
+		sprintf(key, "%d", i);
+		ax_map_put(fhmap.ax_map, key, &i);
+	}
+	ut_assert_uint_equal(r, N, ax_box_size(fhmap.ax_box));
+
+	int *table = calloc(N, sizeof(int));
+	ax_map_cforeach(fhmap.ax_map, const char *, key, const int *, val) {
+		int k;
+		sscanf(key, "%d", &k);
+		ut_assert_int_equal(r, k, *val);
+		table[k]++;
+	}
+	for (int i = 0; i < N; i++)
+		ut_assert_int_equal(r, 1, table[i]);
+	free(table);
+
+	ax_flat_hmap_r copy = AX_R_INIT(ax_any, ax_any_copy(fhmap.ax_any));
+	for (int i = 0; i < N; i++) {
+		char key[16];
+		sprintf(key, "%d", i);
+		int *val = ax_map_get(copy.ax_map, key);
+		ut_assert(r, val != NULL);
+		ut_assert_int_equal(r, i, *val);
+	}
+
+	ax_one_free(copy.ax_one);
+	ax_one_free(fhmap.ax_one);
+}
+
+static void churn(ut_runner *r)
+{
+	ax_flat_hmap_r fhmap = ax_new(ax_flat_hmap, ax_t(int), ax_t(int));
+
+	/* Keep the size small while keys keep changing, tombstones must not
+	 * fill the table up */
+	for (int i = 0; i < N; i++) {
+		ax_map_put(fhmap.ax_map, &i, &i);
+		if (i >= 100) {
+			int k = i - 100;
+			ut_assert(r, !ax_map_erase(fhmap.ax_map, &k));
+		}
+	}
+	ut_assert_uint_equal(r, 100, ax_box_size(fhmap.ax_box));
+	ut_assert(r, ax_flat_hmap_capacity(fhmap.ax_flat_hmap) <= 256);
+
+	for (int i = N - 100; i < N; i++)
+		ut_assert_int_equal(r, i, *(int *)ax_map_get(fhmap.ax_map, &i));
+	for (int i = 0; i < N - 100; i++)
+		ut_assert(r, !ax_map_exist(fhmap.ax_map, &i));
+
+	ax_one_free(fhmap.ax_one);
+}
+
+static void chkey(ut_runner *r)
+{
+	ax_flat_hmap_r fhmap = ax_new(ax_flat_hmap, ax_t(int), ax_t(int));
+
+	ax_map_put(fhmap.ax_map, ax_p(int, 1), ax_p(int, 2));
+	ax_map_put(fhmap.ax_map, ax_p(int, 3), ax_p(int, 4));
+
+	int *kp = ax_map_chkey(fhmap.ax_map, ax_p(int, 1), ax_p(int, 5));
+	ut_assert(r, kp != NULL);
+	ut_assert_int_equal(r, 5, *kp);
+	ut_assert_uint_equal(r, 2, ax_box_size(fhmap.ax_box));
+	ut_assert_int_equal(r, 2, *(int *)ax_map_get(fhmap.ax_map, ax_p(int, 5)));
+	ut_assert(r, !ax_map_exist(fhmap.ax_map, ax_p(int, 1)));
+
+	/* Overwrite an existing key */
+	ax_map_chkey(fhmap.ax_map, ax_p(int, 5), ax_p(int, 3));
+	ut_assert_uint_equal(r, 1, ax_box_size(fhmap.ax_box));
+	ut_assert_int_equal(r, 2, *(int *)ax_map_get(fhmap.ax_map, ax_p(int, 3)));
+
+	ax_one_free(fhmap.ax_one);
+}
+
+static void reserve(ut_runner *r)
+{
+	ax_flat_hmap_r fhmap = ax_new(ax_flat_hmap, ax_t(int), ax_t(int));
+	ut_assert_uint_equal(r, 0, ax_flat_hmap_capacity(fhmap.ax_flat_hmap));
+
+	ut_assert(r, !ax_flat_hmap_reserve(fhmap.ax_flat_hmap, N));
+	size_t capacity = ax_flat_hmap_capacity(fhmap.ax_flat_hmap);
+	ut_assert(r, capacity >= N);
+
+	for (int i = 0; i < N; i++)
+		ax_map_put(fhmap.ax_map, &i, &i);
+	ut_assert_uint_equal(r, capacity, ax_flat_hmap_capacity(fhmap.ax_flat_hmap));
+
+	ax_box_clear(fhmap.ax_box);
+	ut_assert_uint_equal(r, 0, ax_box_size(fhmap.ax_box));
+	ut_assert(r, !ax_map_exist(fhmap.ax_map, ax_p(int, 0)));
+
+	ax_one_free(fhmap.ax_one);
+}
+
+ut_suite *suite_for_flat_hmap()
+{
+	ut_suite *suite = ut_suite_create("flat_hmap");
+
+	ut_suite_add(suite, str_key, 0);
+	ut_suite_add(suite, churn, 0);
+	ut_suite_add(suite, chkey, 0);
+	ut_suite_add(suite, reserve, 0);
+
+	return suite;
+}
@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 #define N 400
 
@@ -178,6 +179,34 @@ static void iterate(ut_runner *r)
 	ax_one_free(hmap.ax_one);
 }
 
+static void iterate_str_value(ut_runner *r)
+{
+	/* The key is converted by the key trait, not the value trait */
+	ax_hmap_r hmap = ax_new(ax_hmap, ax_t(int), ax_t(str));
+	const int count = 100;
+	for (int i = 0; i < count; i++) {
+		char val[4];
+		sprintf(val, "%d", i);
+		ax_map_put(hmap.ax_map, &i, val);
+	}
+
+	int check_table[count];
+	for (int i = 0; i < count; i++) check_table[i] = -1;
+	ax_map_cforeach(hmap.ax_map, const int *, key, const char *, val) {
+		int v;
+		sscanf(val, "%d", &v);
+		ut_assert_int_equal(r, v, *key);
+		check_table[*key] = 0;
+	}
+	for (int i = 0; i < count; i++)
+		ut_assert(r, check_table[i] == 0);
+
+	ax_iter it = ax_box_begin(hmap.ax_box);
+	ut_assert(r, *(int *)ax_map_iter_key(&it) < count);
+
+	ax_one_free(hmap.ax_one);
+}
+
 static void rehash(ut_runner* r)
 {
 	ax_hmap_r hmap = ax_new(ax_hmap, ax_t(str), ax_t(int));
@@ -241,17 +270,170 @@ static void check_size(ut_runner* r)
 	ax_one_free(hmap.ax_one);
 }
 
+static void incremental_rehash(ut_runner* r)
+{
+	const size_t step = 4;
+	const int count = 100000;
+
+	ax_hmap_r hmap = ax_new(ax_hmap, ax_t(int), ax_t(int));
+	ut_assert(r, !ax_hmap_set_rehash_step(hmap.ax_hmap, step));
+	ut_assert_uint_equal(r, step, ax_hmap_rehash_step(hmap.ax_hmap));
+
+	/* Each operation moves at most step buckets, a new migration starts
+	 * with all but step buckets left in the old table */
+	size_t pending = 0, migrations = 0;
+	for (int i = 0; i < count; i++) {
+		ax_map_put(hmap.ax_map, &i, &i);
+		size_t cur = ax_hmap_rehash_pending(hmap.ax_hmap);
+		if (cur > pending)
+			migrations++;
+		else
+			ut_assert(r, pending - cur <= step);
+		pending = cur;
+
+		if (pending && i % 1000 == 0) {
+			for (int k = 0; k <= i; k += 7)
+				ut_assert_int_equal(r, k, *(int *)ax_map_get(hmap.ax_map, &k));
+			size_t size = 0;
+			ax_map_cforeach(hmap.ax_map, const int *, key, const int *, val) {
+				ut_assert_int_equal(r, *key, *val);
+				size++;
+			}
+			ut_assert_uint_equal(r, i + 1, size);
+		}
+	}
+	ut_assert(r, migrations > 0);
+	ut_assert_uint_equal(r, count, ax_box_size(hmap.ax_box));
+
+	/* Shrinking while erasing is spread out too */
+	for (int i = 0; i < count; i++) {
+		ut_assert(r, !ax_map_erase(hmap.ax_map, &i));
+		size_t cur = ax_hmap_rehash_pending(hmap.ax_hmap);
+		if (cur <= pending)
+			ut_assert(r, pending - cur <= step);
+		pending = cur;
+
+		if (i % 1000 == 0)
+			for (int k = i + 1; k < count; k += 97)
+				ut_assert(r, ax_map_exist(hmap.ax_map, &k));
+	}
+	ut_assert_uint_equal(r, 0, ax_box_size(hmap.ax_box));
+
+	for (int i = 0; i < N; i++)
+		ax_map_put(hmap.ax_map, &i, &i);
+	ut_assert(r, !ax_hmap_set_rehash_step(hmap.ax_hmap, 0));
+	ut_assert_uint_equal(r, 0, ax_hmap_rehash_pending(hmap.ax_hmap));
+	for (int i = 0; i < N; i++)
+		ut_assert_int_equal(r, i, *(int *)ax_map_get(hmap.ax_map, &i));
+
+	ax_one_free(hmap.ax_one);
+}
+
+static size_t hash_calls, equal_calls;
+
+static size_t counted_hash(const void *p)
+{
+	hash_calls++;
+	return *(int *)p;
+}
+
+static bool counted_equal(const void *p1, const void *p2)
+{
+	equal_calls++;
+	return *(int *)p1 == *(int *)p2;
+}
+
+ax_trait_declare(counted, int);
+ax_trait_define(counted, HASH(counted_hash), EQUAL(counted_equal));
+
+static void hash_cache(ut_runner* r)
+{
+	ax_hmap_r hmap = ax_new(ax_hmap, ax_t(counted), ax_t(int));
+
+	/* Long chains, with the hash cached only the matched node is compared
+	 * with the key, without it the other nodes are compared too */
+	ax_hmap_set_threshold(hmap.ax_hmap, N);
+	for (int i = 0; i < N; i++)
+		ax_map_put(hmap.ax_map, &i, &i);
+
+	equal_calls = 0;
+	for (int i = 0; i < N; i++)
+		ut_assert_int_equal(r, i, *(int *)ax_map_get(hmap.ax_map, &i));
+#ifndef AX_HMAP_NO_HASH_CACHE
+	ut_assert_uint_equal(r, N, equal_calls);
+#else
+	ut_assert(r, equal_calls > N);
+#endif
+
+	/* Rehashing uses the cached hashes, or hashes every key again */
+	hash_calls = 0;
+	ut_assert(r, !ax_hmap_rehash(hmap.ax_hmap, N));
+	ut_assert(r, !ax_hmap_set_threshold(hmap.ax_hmap, 1));
+#ifndef AX_HMAP_NO_HASH_CACHE
+	ut_assert_uint_equal(r, 0, hash_calls);
+#else
+	ut_assert(r, hash_calls >= N);
+#endif
+
+	for (int i = 0; i < N; i++)
+		ut_assert_int_equal(r, i, *(int *)ax_map_get(hmap.ax_map, &i));
+
+	ax_one_free(hmap.ax_one);
+}
+
+static void batch_time(ut_runner* r)
+{
+	const int count = 1 << 20, batch = 64;
+	ax_hmap_r hmap = ax_new(ax_hmap, ax_t(int), ax_t(int));
+	for (int i = 0; i < count; i++)
+		ax_map_put(hmap.ax_map, &i, &i);
+
+	int *keys = malloc(count * sizeof(int));
+	const void **keyp = malloc(count * sizeof(void *));
+	for (int i = 0; i < count; i++) {
+		keys[i] = rand() % count;
+		keyp[i] = keys + i;
+	}
+
+	size_t sum = 0;
+	clock_t time_before = clock();
+	for (int i = 0; i < count; i++)
+		sum += *(int *)ax_map_get(hmap.ax_map, keyp[i]);
+	double single = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+	void *vals[64];
+	time_before = clock();
+	for (int i = 0; i < count; i += batch) {
+		ut_assert_uint_equal(r, batch, ax_map_get_batch(hmap.ax_map, keyp + i, batch, vals));
+		for (int j = 0; j < batch; j++)
+			sum -= *(int *)vals[j];
+	}
+	double batched = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_uint_equal(r, 0, sum);
+
+	ut_printf(r, "%d random lookups: ax_map_get() spent %lfs, ax_map_get_batch() spent %lfs",
+			count, single, batched);
+
+	free(keys);
+	free(keyp);
+	ax_one_free(hmap.ax_one);
+}
+
 ut_suite *suite_for_hmap()
 {
 	ut_suite *suite = ut_suite_create("hmap");
 
 	ut_suite_add(suite, iterate, 0);
+	ut_suite_add(suite, iterate_str_value, 0);
 	ut_suite_add(suite, erase, 1);
 	ut_suite_add(suite, iter_erase, 1);
 	ut_suite_add(suite, map_chkey, 1);
 	ut_suite_add(suite, rehash, 1);
 	ut_suite_add(suite, duplicate, 1);
 	ut_suite_add(suite, check_size, 1);
+	ut_suite_add(suite, incremental_rehash, 1);
+	ut_suite_add(suite, hash_cache, 1);
+	ut_suite_add(suite, batch_time, 1);
 
 	return suite;
 }
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/irb.h"
+#include "ax/ihash.h"
+#include "ax/iheap.h"
+#include "ax/hmap.h"
+#include "ax/mem.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#define N 10000
+#define BENCH_N 1000000
+
+struct conn
+{
+	int fd;
+	ax_irb_node rb_node;
+	ax_ihash_node hash_node;
+	ax_iheap_node heap_node;
+};
+
+static bool conn_rb_less(const ax_irb_node *node1, const ax_irb_node *node2, void *ctx)
+{
+	return ax_irb_entry(node1, struct conn, rb_node)->fd
+		< ax_irb_entry(node2, struct conn, rb_node)->fd;
+}
+
+static bool conn_hash_equal(const ax_ihash_node *node1, const ax_ihash_node *node2, void *ctx)
+{
+	return ax_ihash_entry(node1, struct conn, hash_node)->fd
+		== ax_ihash_entry(node2, struct conn, hash_node)->fd;
+}
+
+static bool conn_heap_less(const ax_iheap_node *node1, const ax_iheap_node *node2, void *ctx)
+{
+	return ax_iheap_entry(node1, struct conn, heap_node)->fd
+		< ax_iheap_entry(node2, struct conn, heap_node)->fd;
+}
+
+static struct conn *conns_create(size_t n)
+{
+	struct conn *conns = malloc(sizeof *conns * n);
+	for (size_t i = 0; i < n; i++) {
+		conns[i].fd = i;
+		ax_iheap_node_init(&conns[i].heap_node);
+	}
+	for (size_t i = n - 1; i > 0; i--) {
+		size_t j = rand() % (i + 1);
+		int fd = conns[i].fd;
+		conns[i].fd = conns[j].fd;
+		conns[j].fd = fd;
+	}
+	return conns;
+}
+
+/* Return the black height, or -1 if a red-black rule is broken */
+static int rb_check(const ax_irb_node *node, const ax_irb_node *parent)
+{
+	if (!node)
+		return 1;
+	if (node->parent != parent)
+		return -1;
+	if (node->red && ((node->left && node->left->red) || (node->right && node->right->red)))
+		return -1;
+	int left = rb_check(node->left, node), right = rb_check(node->right, node);
+	if (left < 0 || left != right)
+		return -1;
+	return left + !node->red;
+}
+
+static void irb(ut_runner *r)
+{
+	struct conn *conns = conns_create(N);
+	ax_irb tree = AX_IRB_INITIALIZER(conn_rb_less, NULL);
+
+	for (int i = 0; i < N; i++)
+		ut_assert(r, !ax_irb_insert(&tree, &conns[i].rb_node));
+	ut_assert_uint_equal(r, N, ax_irb_size(&tree));
+	ut_assert(r, !tree.root->red && rb_check(tree.root, NULL) > 0);
+
+	struct conn probe = { .fd = N / 2 };
+	ax_irb_node *node = ax_irb_find(&tree, &probe.rb_node);
+	ut_assert(r, node != NULL);
+	ut_assert_int_equal(r, N / 2, ax_irb_entry(node, struct conn, rb_node)->fd);
+	ut_assert(r, ax_irb_insert(&tree, &probe.rb_node) == node);
+
+	int fd = 0;
+	ax_irb_foreach(node, &tree)
+		ut_assert_int_equal(r, fd++, ax_irb_entry(node, struct conn, rb_node)->fd);
+	ut_assert_int_equal(r, N, fd);
+
+	/* Remove the odd ones in random order */
+	for (int i = 0; i < N; i++) {
+		if (conns[i].fd % 2)
+			ax_irb_remove(&tree, &conns[i].rb_node);
+		if (i % 1000 == 0)
+			ut_assert(r, rb_check(tree.root, NULL) > 0);
+	}
+	ut_assert_uint_equal(r, N / 2, ax_irb_size(&tree));
+	ut_assert(r, rb_check(tree.root, NULL) > 0);
+
+	probe.fd = 101;
+	ut_assert(r, !ax_irb_find(&tree, &probe.rb_node));
+	node = ax_irb_lower_bound(&tree, &probe.rb_node);
+	ut_assert_int_equal(r, 102, ax_irb_entry(node, struct conn, rb_node)->fd);
+	probe.fd = 102;
+	node = ax_irb_upper_bound(&tree, &probe.rb_node);
+	ut_assert_int_equal(r, 104, ax_irb_entry(node, struct conn, rb_node)->fd);
+	node = ax_irb_prev(node);
+	ut_assert_int_equal(r, 102, ax_irb_entry(node, struct conn, rb_node)->fd);
+	probe.fd = N;
+	ut_assert(r, !ax_irb_lower_bound(&tree, &probe.rb_node));
+
+	fd = N - 2;
+	for (node = ax_irb_last(&tree); node; node = ax_irb_prev(node)) {
+		ut_assert_int_equal(r, fd, ax_irb_entry(node, struct conn, rb_node)->fd);
+		fd -= 2;
+	}
+	ut_assert_int_equal(r, -2, fd);
+
+	while ((node = ax_irb_first(&tree)))
+		ax_irb_remove(&tree, node);
+	ut_assert_uint_equal(r, 0, ax_irb_size(&tree));
+	ut_assert(r, tree.root == NULL);
+
+	free(conns);
+}
+
+static void ihash(ut_runner *r)
+{
+	struct conn *conns = conns_create(N);
+	ax_ihash ht;
+	ut_assert(r, !ax_ihash_init(&ht, conn_hash_equal, NULL));
+
+	for (int i = 0; i < N; i++)
+		ut_assert(r, !ax_ihash_insert(&ht, &conns[i].hash_node, ax_hash_u64(conns[i].fd)));
+	ut_assert_uint_equal(r, N, ax_ihash_size(&ht));
+	ut_assert(r, ht.nbuckets >= N);
+
+	struct conn probe = { .fd = 7 };
+	ax_ihash_node *node = ax_ihash_find(&ht, &probe.hash_node, ax_hash_u64(7));
+	ut_assert(r, node != NULL);
+	ut_assert_int_equal(r, 7, ax_ihash_entry(node, struct conn, hash_node)->fd);
+	ut_assert(r, ax_ihash_insert(&ht, &probe.hash_node, ax_hash_u64(7)) == node);
+
+	for (int i = 0; i < N; i++)
+		if (conns[i].fd % 2)
+			ax_ihash_remove(&ht, &conns[i].hash_node);
+	ut_assert_uint_equal(r, N / 2, ax_ihash_size(&ht));
+
+	int *table = calloc(N, sizeof(int));
+	ax_ihash_foreach(node, &ht)
+		table[ax_ihash_entry(node, struct conn, hash_node)->fd]++;
+	for (int i = 0; i < N; i++) {
+		ut_assert_int_equal(r, i % 2 == 0, table[i]);
+		probe.fd = i;
+		ut_assert_int_equal(r, i % 2 == 0,
+				!!ax_ihash_find(&ht, &probe.hash_node, ax_hash_u64(i)));
+	}
+	free(table);
+
+	ax_ihash_destroy(&ht);
+	free(conns);
+}
+
+static void iheap(ut_runner *r)
+{
+	struct conn *conns = conns_create(N);
+	ax_iheap heap = AX_IHEAP_INITIALIZER(conn_heap_less, NULL);
+
+	for (int i = 0; i < N; i++)
+		ut_assert(r, !ax_iheap_push(&heap, &conns[i].heap_node));
+	ut_assert_uint_equal(r, N, ax_iheap_size(&heap));
+	ut_assert_int_equal(r, 0, ax_iheap_entry(ax_iheap_top(&heap), struct conn, heap_node)->fd);
+
+	/* Remove the odd ones, then move the multiples of 4 behind all others */
+	for (int i = 0; i < N; i++) {
+		if (conns[i].fd % 2) {
+			ax_iheap_remove(&heap, &conns[i].heap_node);
+			ut_assert(r, !ax_iheap_node_linked(&conns[i].heap_node));
+		}
+	}
+	for (int i = 0; i < N; i++) {
+		if (conns[i].fd % 4 == 0) {
+			conns[i].fd += N;
+			ax_iheap_update(&heap, &conns[i].heap_node);
+		}
+	}
+	ut_assert_uint_equal(r, N / 2, ax_iheap_size(&heap));
+
+	int fd = 2;
+	ax_iheap_node *node;
+	while ((node = ax_iheap_pop(&heap))) {
+		int cur = ax_iheap_entry(node, struct conn, heap_node)->fd;
+		ut_assert_int_equal(r, fd, cur);
+		/* 2, 6, ..., N - 2 first, then N, N + 4, ..., 2N - 4 */
+		fd = fd == N - 2 ? N : fd + 4;
+		ut_assert(r, !ax_iheap_node_linked(node));
+	}
+	ut_assert_int_equal(r, 2 * N, fd);
+
+	/* Decreasing a key moves the node to the top */
+	for (int i = 0; i < 100; i++)
+		ax_iheap_push(&heap, &conns[i].heap_node);
+	conns[50].fd = -1;
+	ax_iheap_update(&heap, &conns[50].heap_node);
+	ut_assert(r, ax_iheap_top(&heap) == &conns[50].heap_node);
+
+	ax_iheap_destroy(&heap);
+	ut_assert(r, !ax_iheap_node_linked(&conns[0].heap_node));
+	free(conns);
+}
+
+static void bench(ut_runner *r)
+{
+	struct conn *conns = conns_create(BENCH_N);
+
+	clock_t time_before = clock();
+	ax_ihash ht;
+	ax_ihash_init(&ht, conn_hash_equal, NULL);
+	for (int i = 0; i < BENCH_N; i++)
+		ax_ihash_insert(&ht, &conns[i].hash_node, ax_hash_u64(conns[i].fd));
+	for (int i = 0; i < BENCH_N; i++)
+		ax_ihash_remove(&ht, &conns[i].hash_node);
+	ax_ihash_destroy(&ht);
+	double ihash_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+	time_before = clock();
+	ax_hmap_r hmap = ax_new(ax_hmap, ax_t(int), ax_t(ptr));
+	for (int i = 0; i < BENCH_N; i++)
+		ax_map_put(hmap.ax_map, &conns[i].fd, ax_p(void *, conns + i));
+	for (int i = 0; i < BENCH_N; i++)
+		ax_map_erase(hmap.ax_map, &conns[i].fd);
+	ax_one_free(hmap.ax_one);
+	double hmap_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+	ut_printf(r, "%d connections added and removed: ax_ihash spent %lfs, ax_hmap spent %lfs",
+			BENCH_N, ihash_time, hmap_time);
+	free(conns);
+}
+
+ut_suite *suite_for_intrusive()
+{
+	ut_suite *suite = ut_suite_create("intrusive");
+
+	ut_suite_add(suite, irb, 0);
+	ut_suite_add(suite, ihash, 0);
+	ut_suite_add(suite, iheap, 0);
+	ut_suite_add(suite, bench, 0);
+
+	return suite;
+}
@@ -22,6 +22,7 @@
 
 #include "ax/iter.h"
 #include "ax/list.h"
+#include "ax/vector.h"
 #include "ax/algo.h"
 #include "ax/arraya.h"
 #include "ut/runner.h"
@@ -282,6 +283,35 @@ static void seq_invert(ut_runner *r)
 	ax_one_free(list.ax_one);
 }
 
+static void range(ut_runner *r)
+{
+	ax_list_r list = ax_new(ax_list, ax_t(int));
+	ax_vector_r vec = ax_new(ax_vector, ax_t(int));
+	ax_seq_push_arraya(vec.ax_seq, ax_arraya(int, 7, 8, 9));
+
+	int table1[] = {1, 2, 3};
+	ut_assert(r, !ax_seq_push_n(list.ax_seq, table1, 3));
+	ut_assert(r, seq_equal_array(list.ax_seq, table1, sizeof table1));
+
+	ax_citer first = ax_box_cbegin(vec.ax_box), last = ax_box_cend(vec.ax_box);
+	ax_iter it = ax_seq_at(list.ax_seq, 1);
+	ut_assert(r, !ax_seq_insert_range(list.ax_seq, &it, &first, &last));
+	int table2[] = {1, 7, 8, 9, 2, 3};
+	ut_assert(r, seq_equal_array(list.ax_seq, table2, sizeof table2));
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&it));
+
+	ax_iter begin = ax_box_begin(list.ax_box);
+	ax_iter_next(&begin);
+	ax_seq_erase_range(list.ax_seq, &begin, &it);
+	int table3[] = {1, 2, 3};
+	ut_assert(r, seq_equal_array(list.ax_seq, table3, sizeof table3));
+	ut_assert(r, ax_iter_equal(&begin, &it));
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&it));
+
+	ax_one_free(vec.ax_one);
+	ax_one_free(list.ax_one);
+}
+
 ut_suite* suite_for_list()
 {
 	ut_suite *suite = ut_suite_create("list");
@@ -296,6 +326,7 @@ ut_suite* suite_for_list()
 	ut_suite_add(suite, seq_invert, 0);
 	ut_suite_add(suite, any_copy, 0);
 	ut_suite_add(suite, iter_erase, 0);
+	ut_suite_add(suite, range, 0);
 
 	return suite;
 }
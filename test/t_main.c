@@ -46,6 +46,20 @@ extern ut_suite *suite_for_iobuf();
 extern ut_suite *suite_for_mpool();
 extern ut_suite *suite_for_bitmap();
 extern ut_suite *suite_for_splay();
+extern ut_suite *suite_for_flat_hmap();
+extern ut_suite *suite_for_chmap();
+extern ut_suite *suite_for_btree();
+extern ut_suite *suite_for_rb();
+extern ut_suite *suite_for_prb();
+extern ut_suite *suite_for_art();
+extern ut_suite *suite_for_datrie();
+extern ut_suite *suite_for_acmatch();
+extern ut_suite *suite_for_svec();
+extern ut_suite *suite_for_ulist();
+extern ut_suite *suite_for_deq();
+extern ut_suite *suite_for_intrusive();
+extern ut_suite *suite_for_atom();
+extern ut_suite *suite_for_strview();
 
 extern void suite_for_maps(ut_runner *r);
 
@@ -80,6 +94,20 @@ int main()
 	ut_runner_add(r, suite_for_mpool());
 	ut_runner_add(r, suite_for_bitmap());
 	ut_runner_add(r, suite_for_splay());
+	ut_runner_add(r, suite_for_flat_hmap());
+	ut_runner_add(r, suite_for_chmap());
+	ut_runner_add(r, suite_for_btree());
+	ut_runner_add(r, suite_for_rb());
+	ut_runner_add(r, suite_for_prb());
+	ut_runner_add(r, suite_for_art());
+	ut_runner_add(r, suite_for_datrie());
+	ut_runner_add(r, suite_for_acmatch());
+	ut_runner_add(r, suite_for_svec());
+	ut_runner_add(r, suite_for_ulist());
+	ut_runner_add(r, suite_for_deq());
+	ut_runner_add(r, suite_for_intrusive());
+	ut_runner_add(r, suite_for_atom());
+	ut_runner_add(r, suite_for_strview());
 
 	suite_for_maps(r);
 
@@ -22,7 +22,10 @@
 #include "ax/def.h"
 #include "ax/avl.h"
 #include "ax/hmap.h"
+#include "ax/flat_hmap.h"
 #include "ax/rb.h"
+#include "ax/btree.h"
+#include "ax/prb.h"
 #include "ax/iter.h"
 #include "ut/suite.h"
 #include "ut/runner.h"
@@ -55,6 +58,21 @@ static ax_map *create_empty_rb(void)
 	return ax_new(ax_rb, ax_t(int), ax_t(int)).ax_map;
 }
 
+static ax_map *create_empty_flat_hmap(void)
+{
+	return ax_new(ax_flat_hmap, ax_t(int), ax_t(int)).ax_map;
+}
+
+static ax_map *create_empty_btree(void)
+{
+	return ax_new(ax_btree, ax_t(int), ax_t(int)).ax_map;
+}
+
+static ax_map *create_empty_prb(void)
+{
+	return ax_new(ax_prb, ax_t(int), ax_t(int)).ax_map;
+}
+
 static void workflow(ut_runner *r)
 {
 	create_map_f *create = (create_map_f *)(intptr_t)ut_runner_arg(r);
@@ -221,10 +239,164 @@ static void copy(ut_runner *r)
 	ax_one_free(ax_r(ax_map,map1).ax_one);
 }
 
+static void batch(ut_runner *r)
+{
+	create_map_f *create = (create_map_f *)(intptr_t)ut_runner_arg(r);
+	ax_map *map = create();
+
+	int nums[100], keys[100];
+	const void *keyp[100];
+	void *vals[100];
+	bool exist[100];
+
+	for (int i = 0; i < 100; i++) {
+		nums[i] = i * 2;
+		ax_map_put(map, nums + i, nums + i);
+	}
+
+	/* Even numbers exist, odd numbers do not */
+	for (int i = 0; i < 100; i++) {
+		keys[i] = i;
+		keyp[i] = keys + i;
+	}
+
+	ut_assert_uint_equal(r, 50, ax_map_get_batch(map, keyp, 100, vals));
+	ut_assert_uint_equal(r, 50, ax_map_exist_batch(map, keyp, 100, exist));
+	for (int i = 0; i < 100; i++) {
+		if (i % 2) {
+			ut_assert(r, vals[i] == NULL);
+			ut_assert(r, !exist[i]);
+		} else {
+			ut_assert(r, vals[i] != NULL);
+			ut_assert_int_equal(r, i, *(int *)vals[i]);
+			ut_assert(r, exist[i]);
+		}
+	}
+
+	ut_assert_uint_equal(r, 0, ax_map_get_batch(map, keyp, 0, vals));
+	ax_one_free(ax_r(ax_map, map).ax_one);
+}
+
+static void check_order_statistic(ut_runner *r, ax_map *map, const bool *present, int n)
+{
+	ax_box *box = ax_r(ax_map, map).ax_box;
+
+	/* Keys are the even numbers below 2 * n */
+	int below = 0;
+	for (int i = 0; i < n; i++) {
+		ut_assert_uint_equal(r, below, ax_map_rank(map, ax_p(int, 2 * i)));
+		below += present[i];
+		ut_assert_uint_equal(r, below, ax_map_rank(map, ax_p(int, 2 * i + 1)));
+	}
+
+	ax_iter it = ax_box_begin(box), end = ax_box_end(box);
+	for (size_t i = 0; i < ax_box_size(box); i++) {
+		ax_iter sel = ax_map_select(map, i);
+		ut_assert(r, ax_iter_equal(&sel, &it));
+		ax_iter_next(&it);
+	}
+	ax_iter sel = ax_map_select(map, ax_box_size(box));
+	ut_assert(r, ax_iter_equal(&sel, &end));
+
+	if (!it.tr->move)
+		return;
+
+	ax_iter first = ax_box_begin(box);
+	ut_assert_int_equal(r, ax_box_size(box), ax_iter_dist(&first, &end));
+	for (size_t i = 0; i < ax_box_size(box); i += 7) {
+		ax_iter moved = first;
+		ax_iter_move(&moved, i);
+		sel = ax_map_select(map, i);
+		ut_assert(r, ax_iter_equal(&sel, &moved));
+		ut_assert_int_equal(r, i, ax_iter_dist(&first, &moved));
+		ax_iter_move(&moved, -(long)i);
+		ut_assert(r, ax_iter_equal(&first, &moved));
+	}
+
+	ax_iter rfirst = ax_box_rbegin(box), rend = ax_box_rend(box);
+	ut_assert_int_equal(r, ax_box_size(box), ax_iter_dist(&rfirst, &rend));
+	ax_iter_move(&rfirst, ax_box_size(box));
+	ut_assert(r, ax_iter_equal(&rfirst, &rend));
+}
+
+static void order_statistic(ut_runner *r)
+{
+	create_map_f *create = (create_map_f *)(intptr_t)ut_runner_arg(r);
+	ax_map *map = create();
+
+	const int n = 1000;
+	bool present[1000] = { false };
+	for (int i = 0; i < n; i++) {
+		int k = (i * 379) % n, key = 2 * k;
+		ax_map_put(map, &key, &k);
+		present[k] = true;
+	}
+	check_order_statistic(r, map, present, n);
+
+	for (int i = 0; i < n; i += 3) {
+		ax_map_erase(map, ax_p(int, 2 * i));
+		present[i] = false;
+	}
+	check_order_statistic(r, map, present, n);
+
+	ax_one_free(ax_r(ax_map, map).ax_one);
+}
+
+static void bound(ut_runner *r)
+{
+	create_map_f *create = (create_map_f *)(intptr_t)ut_runner_arg(r);
+	ax_map *map = create();
+	ax_box *box = ax_r(ax_map, map).ax_box;
+	ax_iter it, last, end;
+
+	it = ax_map_lower_bound(map, ax_p(int, 0));
+	end = ax_box_end(box);
+	ut_assert(r, ax_iter_equal(&it, &end));
+
+	/* Keys are the multiples of 3 below 3000 */
+	const int n = 1000;
+	for (int i = 0; i < n; i++) {
+		int k = (i * 379) % n, key = 3 * k;
+		ax_map_put(map, &key, &k);
+	}
+	end = ax_box_end(box);
+
+	for (int key = -1; key <= 3 * n; key++) {
+		int lower = key < 0 ? 0 : (key + 2) / 3 * 3;
+		int upper = key < 0 ? 0 : (key / 3 + 1) * 3;
+
+		it = ax_map_lower_bound(map, &key);
+		if (lower < 3 * n)
+			ut_assert_int_equal(r, lower, *(int *)ax_map_iter_key(&it));
+		else
+			ut_assert(r, ax_iter_equal(&it, &end));
+
+		it = ax_map_upper_bound(map, &key);
+		if (upper < 3 * n)
+			ut_assert_int_equal(r, upper, *(int *)ax_map_iter_key(&it));
+		else
+			ut_assert(r, ax_iter_equal(&it, &end));
+
+		ax_map_equal_range(map, &key, &it, &last);
+		ut_assert_int_equal(r, key >= 0 && key % 3 == 0 && key < 3 * n, ax_iter_dist(&it, &last));
+	}
+
+	/* Count the pairs in [300, 600) */
+	it = ax_map_lower_bound(map, ax_p(int, 300));
+	last = ax_map_lower_bound(map, ax_p(int, 600));
+	int count = 0;
+	for (; !ax_iter_equal(&it, &last); ax_iter_next(&it))
+		count++;
+	ut_assert_int_equal(r, 100, count);
+
+	ax_one_free(ax_r(ax_map, map).ax_one);
+}
+
 void suite_for_maps(ut_runner *r)
 {
-	for (int i = 0; i < 3; i++) {
+	for (int i = 0; i < 6; i++) {
 		ut_suite *suite = NULL;
+		bool ordered = true;
 		switch(i) {
 			case 0:
 				suite = ut_suite_create("avl");
@@ -233,11 +405,25 @@ void suite_for_maps(ut_runner *r)
 			case 1:
 				suite = ut_suite_create("hmap");
 				ut_suite_set_arg(suite, (void *)(intptr_t)create_empty_hmap);
+				ordered = false;
 				break;
 			case 2:
 				suite = ut_suite_create("rb");
 				ut_suite_set_arg(suite, (void *)(intptr_t)create_empty_rb);
 				break;
+			case 3:
+				suite = ut_suite_create("flat_hmap");
+				ut_suite_set_arg(suite, (void *)(intptr_t)create_empty_flat_hmap);
+				ordered = false;
+				break;
+			case 4:
+				suite = ut_suite_create("btree");
+				ut_suite_set_arg(suite, (void *)(intptr_t)create_empty_btree);
+				break;
+			case 5:
+				suite = ut_suite_create("prb");
+				ut_suite_set_arg(suite, (void *)(intptr_t)create_empty_prb);
+				break;
 		}
 
 		ut_suite_add(suite, workflow, 0);
@@ -246,6 +432,10 @@ void suite_for_maps(ut_runner *r)
 		ut_suite_add(suite, iterator, 3);
 		ut_suite_add(suite, erase, 4);
 		ut_suite_add(suite, copy, 4);
+		ut_suite_add(suite, batch, 4);
+		ut_suite_add(suite, order_statistic, 4);
+		if (ordered)
+			ut_suite_add(suite, bound, 4);
 		ut_runner_add(r, suite);
 	}
 }
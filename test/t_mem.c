@@ -26,6 +26,9 @@
 #include "ut/suite.h"
 
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wchar.h>
 
 static void strsplit(ut_runner *r)
 {
@@ -87,10 +90,219 @@ static void strrepl(ut_runner *r)
 
 }
 
+static void wcsrepl(ut_runner *r)
+{
+	wchar_t *res = ax_wcsrepl(L"a\\b\\\"c", L"\\", L"\\\\");
+	ut_assert(r, !wcscmp(L"a\\\\b\\\\\"c", res));
+	free(res);
+
+	res = ax_wcsrepl(L"xyxyx", L"xyx", L"-");
+	ut_assert(r, !wcscmp(L"-yx", res));
+	free(res);
+
+	/* The bytes of the pattern may appear across two characters */
+	const wchar_t orig[] = { 0x0100, 0x0200, 0 }, rep[] = { 0x0001, 0 };
+	res = ax_wcsrepl(orig, rep, L"");
+	ut_assert(r, !wcscmp(orig, res));
+	free(res);
+}
+
+static void strrepl_grow(ut_runner *r)
+{
+	char orig[1024], expect[4096];
+	for (size_t i = 0; i < sizeof orig - 1; i++)
+		orig[i] = i % 3 ? 'b' : 'a';
+	orig[sizeof orig - 1] = '\0';
+	for (size_t i = 0, j = 0; i < sizeof orig; i++) {
+		if (orig[i] == 'a') {
+			memcpy(expect + j, "aaaa", 4);
+			j += 4;
+		} else
+			expect[j++] = orig[i];
+	}
+
+	char *res = ax_strrepl(orig, "a", "aaaa");
+	ut_assert_str_equal(r, expect, res);
+	free(res);
+}
+
+static const char *naive_memmem(const char *s, size_t size, const char *pat, size_t pat_size)
+{
+	for (size_t i = 0; i + pat_size <= size; i++)
+		if (!memcmp(s + i, pat, pat_size))
+			return s + i;
+	return NULL;
+}
+
+static void memscan(ut_runner *r)
+{
+	char buf[300];
+	srand(20240101);
+	for (size_t i = 0; i < sizeof buf; i++)
+		buf[i] = 'a' + rand() % 4;
+
+	/* Every offset and length takes the vector bodies and the tails */
+	for (size_t off = 0; off < 64; off++) {
+		for (size_t len = 0; off + len <= sizeof buf; len++) {
+			for (int ch = 'a'; ch <= 'e'; ch++)
+				ut_assert(r, ax_memchr(buf + off, ch, len) == memchr(buf + off, ch, len));
+			for (size_t pat_size = 1; pat_size < 6; pat_size++) {
+				const char *pat = buf + (off * 7 + len) % (sizeof buf - pat_size);
+				ut_assert(r, ax_memmem(buf + off, len, pat, pat_size)
+						== naive_memmem(buf + off, len, pat, pat_size));
+			}
+		}
+	}
+	ut_assert(r, ax_memmem(buf, 4, "", 0) == buf);
+	ut_assert(r, ax_memmem(buf, 4, buf, 5) == NULL);
+
+	buf[sizeof buf - 1] = '\0';
+	for (size_t off = 0; off < 64; off++)
+		for (int ch = 'a'; ch <= 'e'; ch++)
+			ut_assert(r, ax_strchrnul(buf + off, ch)
+					== (strchr(buf + off, ch) ? strchr(buf + off, ch) : buf + sizeof buf - 1));
+	ut_assert(r, ax_strchrnul(buf, '\0') == buf + sizeof buf - 1);
+}
+
+static void hash(ut_runner *r)
+{
+	/* The seed is fixed by the first use, setting the same one is allowed */
+	uint64_t seed = ax_hash_seed();
+	ut_assert(r, seed != 0);
+	ut_assert_uint_equal(r, seed, ax_hash_seed());
+	ax_hash_set_seed(seed);
+
+	ut_assert_uint_equal(r, ax_hash64("hello", 5, seed), ax_memhash("hello", 5));
+	ut_assert_uint_equal(r, ax_memhash("hello", 5), ax_strhash("hello"));
+	ut_assert_uint_equal(r, ax_memhash(L"hello", 5 * sizeof(wchar_t)), ax_wcshash(L"hello"));
+	ut_assert(r, ax_hash64("hello", 5, 1) != ax_hash64("hello", 5, 2));
+
+	/* Every length takes a different code path, prefixes must not collide */
+	char buf[128];
+	uint64_t h[sizeof buf + 1];
+	for (size_t i = 0; i < sizeof buf; i++)
+		buf[i] = (char)i;
+	for (size_t i = 0; i <= sizeof buf; i++) {
+		h[i] = ax_memhash(buf, i);
+		for (size_t j = 0; j < i; j++)
+			ut_assert(r, h[i] != h[j]);
+	}
+
+	/* Flipping any bit changes the hash */
+	for (size_t i = 0; i < 64 * 8; i++) {
+		char tmp[64];
+		memcpy(tmp, buf, sizeof tmp);
+		tmp[i / 8] ^= 1 << (i % 8);
+		ut_assert(r, ax_memhash(tmp, sizeof tmp) != h[64]);
+	}
+
+	ut_assert(r, ax_hash_u64(1) != ax_hash_u64(2));
+}
+
+static void hash_time(ut_runner *r)
+{
+	static const size_t sizes[] = { 8, 32, 256, 4096 };
+	const size_t total = 64 * 1024 * 1024;
+	char *buf = malloc(4096 + 8);
+	for (size_t i = 0; i < 4096 + 8; i++)
+		buf[i] = (char)rand();
+
+	for (size_t i = 0; i < sizeof sizes / sizeof *sizes; i++) {
+		size_t n = total / sizes[i];
+		size_t sum = 0;
+		clock_t time_before = clock();
+		for (size_t j = 0; j < n; j++)
+			sum += ax_hash_djb(buf + (j & 7), sizes[i]);
+		double djb = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+		time_before = clock();
+		for (size_t j = 0; j < n; j++)
+			sum += ax_memhash(buf + (j & 7), sizes[i]);
+		double wy = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+
+		ut_printf(r, "%zu bytes key: ax_hash_djb() spent %lfs, ax_memhash() spent %lfs (%zx)",
+				sizes[i], djb, wy, sum & 0xF);
+	}
+	free(buf);
+}
+
+static double throughput(clock_t time_before, size_t size, int rounds)
+{
+	double time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	return time > 0 ? (double)size * rounds / time / (1024 * 1024) : 0;
+}
+
+static void memscan_time(ut_runner *r)
+{
+	const size_t size = 1024 * 1024;
+	const int rounds = 64;
+	char *text = malloc(size + 1);
+	for (size_t i = 0; i < size; i++)
+		text[i] = i % 64 == 63 ? '\n' : 'a' + rand() % 26;
+	text[size] = '\0';
+
+	ut_printf(r, "kernel: %s", ax_memscan_kernel());
+
+	/* A volatile byte keeps the calls in the loop */
+	volatile char ch = '!';
+	size_t sum = 0;
+	clock_t time_before = clock();
+	for (int i = 0; i < rounds; i++)
+		sum += memchr(text, ch, size) != NULL;
+	double libc = throughput(time_before, size, rounds);
+	time_before = clock();
+	for (int i = 0; i < rounds; i++)
+		sum += ax_memchr(text, ch, size) != NULL;
+	ut_printf(r, "1MB search for a byte: memchr() %.0lfMB/s, ax_memchr() %.0lfMB/s",
+			libc, throughput(time_before, size, rounds));
+
+	/* Hide the pattern from the compiler, or the search leaves the loop */
+	char pat[] = "qz!";
+	char *volatile pat_p = pat;
+	text[size - 4] = '!';
+	time_before = clock();
+	for (int i = 0; i < rounds; i++)
+		sum += strstr(text, pat_p) != NULL;
+	libc = throughput(time_before, size, rounds);
+	time_before = clock();
+	for (int i = 0; i < rounds; i++)
+		sum += ax_memmem(text, size, pat_p, 3) != NULL;
+	ut_printf(r, "1MB substring search: strstr() %.0lfMB/s, ax_memmem() %.0lfMB/s",
+			libc, throughput(time_before, size, rounds));
+	text[size - 4] = 'a';
+
+	time_before = clock();
+	for (int i = 0; i < rounds; i++) {
+		char *res = ax_strrepl(text, "\n", "\r\n");
+		sum += res[0];
+		free(res);
+	}
+	ut_printf(r, "1MB ax_strrepl(): %.0lfMB/s", throughput(time_before, size, rounds));
+
+	char *copy = malloc(size + 1);
+	time_before = clock();
+	for (int i = 0; i < rounds; i++) {
+		memcpy(copy, text, size + 1);
+		char *next = copy, *line;
+		while ((line = ax_strsplit(&next, '\n')))
+			sum++;
+	}
+	ut_printf(r, "1MB ax_strsplit(): %.0lfMB/s (%zx)", throughput(time_before, size, rounds), sum & 0xF);
+
+	free(copy);
+	free(text);
+}
+
 ut_suite *suite_for_mem()
 {
 	ut_suite* suite = ut_suite_create("mem");
 	ut_suite_add(suite, strsplit, 0);
 	ut_suite_add(suite, strrepl, 0);
+	ut_suite_add(suite, strrepl_grow, 0);
+	ut_suite_add(suite, wcsrepl, 0);
+	ut_suite_add(suite, memscan, 0);
+	ut_suite_add(suite, hash, 0);
+	ut_suite_add(suite, hash_time, 0);
+	ut_suite_add(suite, memscan_time, 0);
 	return suite;
 }
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/prb.h"
+#include "ax/iter.h"
+#include "ax/thread.h"
+#include "ax/mutex.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define N 1000
+
+static void snapshot(ut_runner *r)
+{
+	ax_prb_r prb = ax_new(ax_prb, ax_t(int), ax_t(int));
+	for (int i = 0; i < N; i++)
+		ax_map_put(prb.ax_map, &i, &i);
+
+	ax_prb_r snap = AX_R_INIT(ax_map, ax_prb_snapshot(prb.ax_prb));
+	ut_assert(r, snap.ax_map != NULL);
+
+	/* Update values, erase and insert pairs after the snapshot was taken */
+	for (int i = 0; i < N; i += 2)
+		ax_map_put(prb.ax_map, &i, ax_p(int, -i));
+	for (int i = 1; i < N; i += 4)
+		ax_map_erase(prb.ax_map, &i);
+	for (int i = N; i < 2 * N; i++)
+		ax_map_put(prb.ax_map, &i, &i);
+	ut_assert_uint_equal(r, N / 4 * 3 + N, ax_box_size(prb.ax_box));
+
+	ut_assert_uint_equal(r, N, ax_box_size(snap.ax_box));
+	int i = 0;
+	ax_map_cforeach(snap.ax_map, const int *, key, const int *, val) {
+		ut_assert_int_equal(r, i, *key);
+		ut_assert_int_equal(r, i, *val);
+		i++;
+	}
+	ut_assert_int_equal(r, N, i);
+
+	for (i = 0; i < 2 * N; i++) {
+		int *val = ax_map_get(prb.ax_map, &i);
+		if (i < N && i % 4 == 1)
+			ut_assert(r, val == NULL);
+		else {
+			ut_assert(r, val != NULL);
+			ut_assert_int_equal(r, i < N && i % 2 == 0 ? -i : i, *val);
+		}
+	}
+
+	/* The snapshot outlives the tree it was taken from */
+	ax_one_free(prb.ax_one);
+	ut_assert_int_equal(r, N - 1, *(int *)ax_map_get(snap.ax_map, ax_p(int, N - 1)));
+	ax_one_free(snap.ax_one);
+}
+
+static void writable_copy(ut_runner *r)
+{
+	ax_prb_r prb = ax_new(ax_prb, ax_t(str), ax_t(str));
+	for (int i = 0; i < N; i++) {
+		char key[16];
+		sprintf(key, "%04d", i);
+		ax_map_put(prb.ax_map, key, key);
+	}
+
+	ax_prb_r copy = { .ax_any = ax_any_copy(prb.ax_any) };
+	ut_assert(r, copy.ax_any != NULL);
+
+	ax_map_put(copy.ax_map, "0000", "zero");
+	ax_map_erase(copy.ax_map, "0001");
+	ax_map_erase(prb.ax_map, "0002");
+	ax_map_put(prb.ax_map, "zzzz", "last");
+
+	ut_assert_str_equal(r, "0000", ax_map_get(prb.ax_map, "0000"));
+	ut_assert_str_equal(r, "zero", ax_map_get(copy.ax_map, "0000"));
+	ut_assert(r, ax_map_exist(prb.ax_map, "0001"));
+	ut_assert(r, !ax_map_exist(copy.ax_map, "0001"));
+	ut_assert(r, !ax_map_exist(prb.ax_map, "0002"));
+	ut_assert(r, ax_map_exist(copy.ax_map, "0002"));
+	ut_assert(r, !ax_map_exist(copy.ax_map, "zzzz"));
+
+	/* Erase through iterators of the copy */
+	ax_iter it = ax_map_lower_bound(copy.ax_map, "0500"),
+		end = ax_box_end(copy.ax_box);
+	while (!ax_iter_equal(&it, &end))
+		ax_iter_erase(&it);
+	ut_assert_uint_equal(r, 499, ax_box_size(copy.ax_box));
+	ut_assert_uint_equal(r, N, ax_box_size(prb.ax_box));
+
+	ax_one_free(prb.ax_one);
+	ax_map_cforeach(copy.ax_map, const char *, key, const char *, val) {
+		ut_assert(r, strcmp(key, "0500") < 0);
+		ut_assert_str_equal(r, strcmp(key, "0000") ? key : "zero", val);
+	}
+	ax_one_free(copy.ax_one);
+}
+
+#define KEYS 64
+#define READERS 4
+#define ROUNDS 20000
+
+struct reader_st
+{
+	ax_prb *prb;
+	ax_mutex *lock;
+	bool *stop;
+	int snapshots, errors;
+};
+
+static uintptr_t reader(void *arg)
+{
+	struct reader_st *rd = arg;
+	for (;;) {
+		ax_mutex_lock(rd->lock);
+		if (*rd->stop) {
+			ax_mutex_unlock(rd->lock);
+			break;
+		}
+		ax_prb_r snap = AX_R_INIT(ax_map, ax_prb_snapshot(rd->prb));
+		ax_mutex_unlock(rd->lock);
+
+		/* Iterate without the lock while the writer goes on */
+		int sum = 0, last = -1;
+		ax_map_cforeach(snap.ax_map, const int *, key, const int *, val) {
+			if (*key <= last)
+				rd->errors++;
+			last = *key;
+			sum += *val;
+		}
+		if (sum != 0)
+			rd->errors++;
+		rd->snapshots++;
+		ax_one_free(snap.ax_one);
+	}
+	return 0;
+}
+
+static void concurrent(ut_runner *r)
+{
+	ax_prb_r prb = ax_new(ax_prb, ax_t(int), ax_t(int));
+	int vals[KEYS] = { 0 };
+	bool present[KEYS];
+	for (int i = 0; i < KEYS; i++) {
+		ax_map_put(prb.ax_map, &i, vals + i);
+		present[i] = true;
+	}
+
+	ax_mutex lock;
+	ax_mutex_init(&lock);
+	bool stop = false;
+	struct reader_st rd[READERS];
+	ax_thread threads[READERS];
+	for (int i = 0; i < READERS; i++) {
+		rd[i] = (struct reader_st) { .prb = prb.ax_prb, .lock = &lock, .stop = &stop };
+		ax_thread_create(reader, rd + i, threads + i);
+	}
+
+	/* Every update keeps the sum of values zero */
+	unsigned seed = 1;
+	for (int i = 0; i < ROUNDS; i++) {
+		seed = seed * 1103515245 + 12345;
+		int a = (seed >> 8) % KEYS, b = (seed >> 16) % KEYS;
+		if (a == b || !present[b])
+			continue;
+		ax_mutex_lock(&lock);
+		if (!present[a]) {
+			vals[a] = 0;
+			ax_map_put(prb.ax_map, &a, vals + a);
+			present[a] = true;
+		} else if (i % 3 == 0) {
+			vals[b] += vals[a];
+			ax_map_put(prb.ax_map, &b, vals + b);
+			ax_map_erase(prb.ax_map, &a);
+			present[a] = false;
+		} else {
+			vals[a] += i;
+			vals[b] -= i;
+			ax_map_put(prb.ax_map, &a, vals + a);
+			ax_map_put(prb.ax_map, &b, vals + b);
+		}
+		ax_mutex_unlock(&lock);
+	}
+
+	ax_mutex_lock(&lock);
+	stop = true;
+	ax_mutex_unlock(&lock);
+	for (int i = 0; i < READERS; i++) {
+		ax_thread_join(threads + i, NULL);
+		ut_assert_int_equal(r, 0, rd[i].errors);
+	}
+	ax_mutex_destroy(&lock);
+
+	for (int i = 0; i < KEYS; i++) {
+		int *val = ax_map_get(prb.ax_map, &i);
+		ut_assert(r, present[i] == !!val);
+		if (val)
+			ut_assert_int_equal(r, vals[i], *val);
+	}
+	ax_one_free(prb.ax_one);
+}
+
+ut_suite *suite_for_prb()
+{
+	ut_suite *suite = ut_suite_create("prb");
+
+	ut_suite_add(suite, snapshot, 0);
+	ut_suite_add(suite, writable_copy, 0);
+	ut_suite_add(suite, concurrent, 1);
+
+	return suite;
+}
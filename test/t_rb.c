@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/rb.h"
+#include "ax/iter.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define N 10000
+
+static void build(ut_runner *r)
+{
+	int *keys = malloc(N * sizeof(int)), *vals = malloc(N * sizeof(int));
+	for (int i = 0; i < N; i++)
+		keys[i] = i * 2, vals[i] = i;
+
+	ax_rb_r rb = ax_new(ax_rb, ax_t(int), ax_t(int));
+	ut_assert(r, !ax_rb_build(rb.ax_rb, keys, vals, N));
+	ut_assert_uint_equal(r, N, ax_box_size(rb.ax_box));
+
+	int i = 0;
+	ax_map_cforeach(rb.ax_map, const int *, key, const int *, val) {
+		ut_assert_int_equal(r, i * 2, *key);
+		ut_assert_int_equal(r, i, *val);
+		i++;
+	}
+
+	ax_iter it = ax_map_select(rb.ax_map, 1234);
+	ut_assert_int_equal(r, 2468, *(int *)ax_map_iter_key(&it));
+
+	/* The built tree keeps working as a normal one */
+	for (int i = 0; i < N; i += 2)
+		ut_assert(r, !ax_map_erase(rb.ax_map, keys + i));
+	for (int i = 0; i < N; i += 2)
+		ax_map_put(rb.ax_map, ax_p(int, keys[i] + 1), ax_p(int, -1));
+	ut_assert_uint_equal(r, N, ax_box_size(rb.ax_box));
+	ut_assert_uint_equal(r, N / 2, ax_map_rank(rb.ax_map, ax_p(int, N)));
+
+	ax_one_free(rb.ax_one);
+	free(keys);
+	free(vals);
+}
+
+static void build_range(ut_runner *r)
+{
+	ax_rb_r src = ax_new(ax_rb, ax_t(str), ax_t(int));
+	char key[16];
+	for (int i = 0; i < N; i++) {
+		sprintf(key, "%05d", i);
+		ax_map_put(src.ax_map, key, &i);
+	}
+
+	ax_rb_r dst = ax_new(ax_rb, ax_t(str), ax_t(int));
+	ax_iter first = ax_map_select(src.ax_map, 100), last = ax_map_select(src.ax_map, 200);
+	ut_assert(r, !ax_rb_build_range(dst.ax_rb, ax_iter_c(&first), ax_iter_c(&last)));
+	ut_assert_uint_equal(r, 100, ax_box_size(dst.ax_box));
+	ut_assert(r, !ax_map_exist(dst.ax_map, "00099"));
+	ut_assert_int_equal(r, 100, *(int *)ax_map_get(dst.ax_map, "00100"));
+	ut_assert_int_equal(r, 199, *(int *)ax_map_get(dst.ax_map, "00199"));
+	ut_assert(r, !ax_map_exist(dst.ax_map, "00200"));
+
+	/* Keys after the greatest one are appended */
+	first = ax_map_select(src.ax_map, 5000), last = ax_box_end(src.ax_box);
+	ut_assert(r, !ax_rb_build_range(dst.ax_rb, ax_iter_c(&first), ax_iter_c(&last)));
+	ut_assert_uint_equal(r, N - 5000 + 100, ax_box_size(dst.ax_box));
+	ax_iter rbegin = ax_box_rbegin(dst.ax_box);
+	ut_assert_str_equal(r, "09999", ax_map_iter_key(&rbegin));
+
+	ax_one_free(dst.ax_one);
+	ax_one_free(src.ax_one);
+}
+
+static void build_time(ut_runner *r)
+{
+	const int count = 1 << 20;
+	int *keys = malloc(count * sizeof(int));
+	for (int i = 0; i < count; i++)
+		keys[i] = i;
+
+	ax_rb_r rb = ax_new(ax_rb, ax_t(int), ax_t(int));
+	clock_t time_before = clock();
+	for (int i = 0; i < count; i++)
+		ax_map_put(rb.ax_map, keys + i, keys + i);
+	double put_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ax_one_free(rb.ax_one);
+
+	rb = ax_new(ax_rb, ax_t(int), ax_t(int));
+	time_before = clock();
+	ut_assert(r, !ax_rb_build(rb.ax_rb, keys, keys, count));
+	double build_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_uint_equal(r, count, ax_box_size(rb.ax_box));
+	ax_one_free(rb.ax_one);
+
+	ut_printf(r, "%d sorted pairs: ax_map_put() spent %lfs, ax_rb_build() spent %lfs",
+			count, put_time, build_time);
+	free(keys);
+}
+
+static void split_join(ut_runner *r)
+{
+	ax_rb_r rb = ax_new(ax_rb, ax_t(int), ax_t(int)), right = ax_new(ax_rb, ax_t(int), ax_t(int));
+	for (int i = 0; i < N; i++)
+		ax_map_put(rb.ax_map, ax_p(int, i * 2), &i);
+
+	ax_iter it = ax_map_at(rb.ax_map, ax_p(int, 5000));
+	ax_rb_split(rb.ax_rb, ax_p(int, 5000), right.ax_rb);
+	ut_assert_uint_equal(r, 2500, ax_box_size(rb.ax_box));
+	ut_assert_uint_equal(r, N - 2500, ax_box_size(right.ax_box));
+	ut_assert(r, !ax_map_exist(rb.ax_map, ax_p(int, 5000)));
+	ut_assert_int_equal(r, 2500, *(int *)ax_map_get(right.ax_map, ax_p(int, 5000)));
+
+	/* Nodes are moved, not copied */
+	ax_iter first = ax_box_begin(right.ax_box);
+	ut_assert(r, first.point == it.point);
+
+	ax_iter last = ax_box_rbegin(rb.ax_box);
+	ut_assert_int_equal(r, 4998, *(int *)ax_map_iter_key(&last));
+	ut_assert_uint_equal(r, 100, ax_map_rank(right.ax_map, ax_p(int, 5200)));
+
+	ax_rb_join(rb.ax_rb, right.ax_rb);
+	ut_assert_uint_equal(r, N, ax_box_size(rb.ax_box));
+	ut_assert_uint_equal(r, 0, ax_box_size(right.ax_box));
+	int i = 0;
+	ax_map_cforeach(rb.ax_map, const int *, key, const int *, val) {
+		ut_assert_int_equal(r, i * 2, *key);
+		ut_assert_int_equal(r, i, *val);
+		i++;
+	}
+
+	/* Split by a key out of range */
+	ax_rb_split(rb.ax_rb, ax_p(int, -1), right.ax_rb);
+	ut_assert_uint_equal(r, 0, ax_box_size(rb.ax_box));
+	ut_assert_uint_equal(r, N, ax_box_size(right.ax_box));
+	ax_rb_join(rb.ax_rb, right.ax_rb);
+	ut_assert_uint_equal(r, N, ax_box_size(rb.ax_box));
+
+	ax_one_free(right.ax_one);
+	ax_one_free(rb.ax_one);
+}
+
+static void set_ops(ut_runner *r)
+{
+	/* a holds the multiples of 2, and b holds the multiples of 3 */
+	ax_rb_r a = ax_new(ax_rb, ax_t(int), ax_t(int)), b = ax_new(ax_rb, ax_t(int), ax_t(int));
+	for (int i = 0; i < N; i++) {
+		if (i % 2 == 0)
+			ax_map_put(a.ax_map, &i, ax_p(int, 2));
+		if (i % 3 == 0)
+			ax_map_put(b.ax_map, &i, ax_p(int, 3));
+	}
+
+	ax_rb_r c = AX_R_INIT(ax_any, ax_any_copy(a.ax_any));
+	ax_rb_intersection(c.ax_rb, b.ax_rb);
+	ut_assert_uint_equal(r, (N + 5) / 6, ax_box_size(c.ax_box));
+	ax_map_cforeach(c.ax_map, const int *, key, const int *, val) {
+		ut_assert_int_equal(r, 0, *key % 6);
+		ut_assert_int_equal(r, 2, *val);
+	}
+	ax_one_free(c.ax_one);
+
+	c.ax_any = ax_any_copy(a.ax_any);
+	ax_rb_difference(c.ax_rb, b.ax_rb);
+	ut_assert_uint_equal(r, (N + 1) / 2 - (N + 5) / 6, ax_box_size(c.ax_box));
+	ax_map_cforeach(c.ax_map, const int *, key, const int *, val) {
+		ut_assert(r, *key % 2 == 0 && *key % 3 != 0);
+		ut_assert_int_equal(r, 2, *val);
+	}
+	ax_one_free(c.ax_one);
+
+	/* Pairs of b replace the ones of a */
+	ax_rb_union(a.ax_rb, b.ax_rb);
+	ut_assert_uint_equal(r, 0, ax_box_size(b.ax_box));
+	ut_assert_uint_equal(r, (N + 1) / 2 + (N + 2) / 3 - (N + 5) / 6, ax_box_size(a.ax_box));
+	int prev = -1;
+	ax_map_cforeach(a.ax_map, const int *, key, const int *, val) {
+		ut_assert(r, *key > prev);
+		ut_assert_int_equal(r, *key % 3 == 0 ? 3 : 2, *val);
+		prev = *key;
+	}
+
+	ax_one_free(b.ax_one);
+	ax_one_free(a.ax_one);
+}
+
+static void union_time(ut_runner *r)
+{
+	const int count = 1 << 20, small = 1 << 10;
+
+	ax_rb_r big = ax_new(ax_rb, ax_t(int), ax_t(int)), delta = ax_new(ax_rb, ax_t(int), ax_t(int));
+	for (int i = 0; i < count; i++)
+		ax_map_put(big.ax_map, ax_p(int, i * 2), &i);
+	for (int i = 0; i < small; i++)
+		ax_map_put(delta.ax_map, ax_p(int, i * 2048 + 1), &i);
+
+	clock_t time_before = clock();
+	ax_map_cforeach(delta.ax_map, const int *, key, const int *, val)
+		ax_map_put(big.ax_map, key, val);
+	double put_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	for (int i = 0; i < small; i++)
+		ut_assert(r, !ax_map_erase(big.ax_map, ax_p(int, i * 2048 + 1)));
+
+	time_before = clock();
+	ax_rb_union(big.ax_rb, delta.ax_rb);
+	double union_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_uint_equal(r, count + small, ax_box_size(big.ax_box));
+
+	ut_printf(r, "%d pairs into %d pairs: ax_map_put() spent %lfs, ax_rb_union() spent %lfs",
+			small, count, put_time, union_time);
+	ax_one_free(delta.ax_one);
+	ax_one_free(big.ax_one);
+}
+
+ut_suite *suite_for_rb()
+{
+	ut_suite *suite = ut_suite_create("rb");
+
+	ut_suite_add(suite, build, 0);
+	ut_suite_add(suite, build_range, 0);
+	ut_suite_add(suite, build_time, 1);
+	ut_suite_add(suite, split_join, 0);
+	ut_suite_add(suite, set_ops, 0);
+	ut_suite_add(suite, union_time, 1);
+
+	return suite;
+}
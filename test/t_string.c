@@ -20,8 +20,10 @@
  * THE SOFTWARE.
  */
 
+#include "assist.h"
 #include "ax/iter.h"
 #include "ax/string.h"
+#include "ax/dump.h"
 #include "ut/runner.h"
 #include "ut/suite.h"
 
@@ -30,6 +32,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 static void create(ut_runner *r)
 {
@@ -74,6 +77,241 @@ static void split(ut_runner *r)
 	ax_one_free(ret.ax_one);
 }
 
+static void range(ut_runner *r)
+{
+	ax_string_r str_r = ax_new0(ax_string);
+	ax_string_r src = ax_new0(ax_string);
+	ut_assert(r, !ax_seq_push_n(str_r.ax_seq, "hello!", 5));
+	ut_assert_str_equal(r, "hello", ax_str_strz(str_r.ax_str));
+
+	ax_str_append(src.ax_str, "abc");
+	ax_citer first = ax_box_cbegin(src.ax_box), last = ax_box_cend(src.ax_box);
+	ax_iter it = ax_seq_at(str_r.ax_seq, 2);
+	ut_assert(r, !ax_seq_insert_range(str_r.ax_seq, &it, &first, &last));
+	ut_assert_str_equal(r, "heabcllo", ax_str_strz(str_r.ax_str));
+	ut_assert_int_equal(r, 'l', *(char *)ax_iter_get(&it));
+
+	it = ax_box_rend(str_r.ax_box);
+	ut_assert(r, !ax_seq_insert_range(str_r.ax_seq, &it, &first, &last));
+	ut_assert_str_equal(r, "cbaheabcllo", ax_str_strz(str_r.ax_str));
+	ut_assert_uint_equal(r, 11, ax_str_length(str_r.ax_str));
+
+	ax_iter efirst = ax_seq_at(str_r.ax_seq, 3), elast = ax_seq_at(str_r.ax_seq, 8);
+	ax_seq_erase_range(str_r.ax_seq, &efirst, &elast);
+	ut_assert_str_equal(r, "cballo", ax_str_strz(str_r.ax_str));
+	ut_assert_int_equal(r, 'l', *(char *)ax_iter_get(&efirst));
+
+	ax_one_free(src.ax_one);
+	ax_one_free(str_r.ax_one);
+}
+
+static void inline_storage(ut_runner *r)
+{
+	ax_string_r str_r = ax_new0(ax_string);
+	for (int i = 0; i < AX_STRING_INLINE_CAPACITY; i++)
+		ut_assert(r, !ax_seq_push(str_r.ax_seq, ax_p(char, 'a' + i)));
+	ut_assert(r, ax_string_inlined(str_r.ax_string));
+	ut_assert_str_equal(r, "abcdefghijklmnopqrstuv", ax_str_strz(str_r.ax_str));
+
+	ut_assert(r, !ax_seq_push(str_r.ax_seq, ax_p(char, 'w')));
+	ut_assert(r, !ax_string_inlined(str_r.ax_string));
+	ut_assert_str_equal(r, "abcdefghijklmnopqrstuvw", ax_str_strz(str_r.ax_str));
+
+	ax_box_clear(str_r.ax_box);
+	ut_assert(r, ax_string_inlined(str_r.ax_string));
+	ut_assert_str_equal(r, "", ax_str_strz(str_r.ax_str));
+	ax_one_free(str_r.ax_one);
+}
+
+static void substr(ut_runner *r)
+{
+	const char *text = "The quick brown fox jumps over the lazy dog";
+	ax_string_r str_r = ax_new0(ax_string);
+	ax_str_append(str_r.ax_str, text);
+
+	ax_string_r shrt = AX_R_INIT(ax_str, ax_str_substr(str_r.ax_str, 4, 5));
+	ut_assert(r, ax_string_inlined(shrt.ax_string));
+	ut_assert_str_equal(r, "quick", ax_str_strz(shrt.ax_str));
+
+	/* Long pieces share the bytes, in the middle they are not terminated */
+	ax_string_r mid = AX_R_INIT(ax_str, ax_str_substr(str_r.ax_str, 4, 30));
+	ax_string_r tail = AX_R_INIT(ax_str, ax_str_substr(str_r.ax_str, 10, 33));
+	ut_assert(r, ax_string_shared(mid.ax_string));
+	ut_assert(r, ax_string_shared(str_r.ax_string));
+	ut_assert_uint_equal(r, 30, ax_str_length(mid.ax_str));
+	ut_assert_int_equal(r, 0, ax_str_comp(mid.ax_str, "quick brown fox jumps over the"));
+	ut_assert(r, ax_str_comp(mid.ax_str, "quick brown fox jumps over thf") < 0);
+	ut_assert(r, ax_str_comp(mid.ax_str, "quick brown fox jumps over th") > 0);
+	ut_assert(r, ax_str_comp(mid.ax_str, "quick brown fox jumps over the ") < 0);
+
+	/* Modifying any of them leaves the others alone */
+	ax_str_append(str_r.ax_str, "!");
+	ut_assert(r, !ax_string_shared(str_r.ax_string));
+	ax_seq_pop(tail.ax_seq);
+	ut_assert_str_equal(r, "brown fox jumps over the lazy do", ax_str_strz(tail.ax_str));
+	ut_assert_str_equal(r, "quick brown fox jumps over the", ax_str_strz(mid.ax_str));
+	ut_assert(r, !ax_string_shared(mid.ax_string));
+	ut_assert_str_equal(r, "The quick brown fox jumps over the lazy dog!", ax_str_strz(str_r.ax_str));
+
+	ax_string_r sub = AX_R_INIT(ax_str, ax_str_substr(mid.ax_str, 6, 24));
+	ax_one_free(mid.ax_one);
+	ax_str_insert(sub.ax_str, 0, "a ");
+	ut_assert_str_equal(r, "a brown fox jumps over the", ax_str_strz(sub.ax_str));
+
+	ax_one_free(sub.ax_one);
+	ax_one_free(tail.ax_one);
+	ax_one_free(shrt.ax_one);
+	ax_one_free(str_r.ax_one);
+}
+
+static void copy(ut_runner *r)
+{
+	ax_string_r str_r = ax_new0(ax_string);
+	ax_str_append(str_r.ax_str, "a string longer than the inline storage");
+
+	ax_string_r copy = AX_R_INIT(ax_any, ax_any_copy(str_r.ax_any));
+	ut_assert(r, ax_string_shared(copy.ax_string));
+
+	/* Reading leaves the buffer shared */
+	size_t spaces = 0;
+	ax_box_cforeach(copy.ax_box, const char *, c)
+		spaces += *c == ' ';
+	ut_assert_uint_equal(r, 6, spaces);
+	ut_assert(r, ax_string_shared(copy.ax_string));
+
+	/* Writing through an iterator makes the buffer private first */
+	ax_iter it = ax_seq_at(copy.ax_seq, 1);
+	ut_assert(r, ax_string_shared(copy.ax_string));
+	ut_assert(r, !ax_iter_set(&it, "-"));
+	ut_assert(r, !ax_string_shared(copy.ax_string));
+	ax_iter_prev(&it);
+	ut_assert(r, !ax_iter_set(&it, "A"));
+	ut_assert_str_equal(r, "A-string longer than the inline storage", ax_str_strz(copy.ax_str));
+	ut_assert_str_equal(r, "a string longer than the inline storage", ax_str_strz(str_r.ax_str));
+	ax_one_free(copy.ax_one);
+
+	ax_box_clear(str_r.ax_box);
+	ax_str_append(str_r.ax_str, "short");
+	copy.ax_any = ax_any_copy(str_r.ax_any);
+	ut_assert(r, ax_string_inlined(copy.ax_string));
+	ut_assert_str_equal(r, "short", ax_str_strz(copy.ax_str));
+	ax_one_free(copy.ax_one);
+
+	ax_one_free(str_r.ax_one);
+}
+
+static void pinned(ut_runner *r)
+{
+	const char *text = "a string longer than the inline storage";
+	ax_string_r str_r = ax_new0(ax_string);
+	ax_str_append(str_r.ax_str, text);
+
+	/* Iterators and the strz pointer taken before copying still write
+	 * into the source only */
+	ax_iter it = ax_box_begin(str_r.ax_box);
+	char *p = ax_str_strz(str_r.ax_str);
+	ax_string_r copy = AX_R_INIT(ax_any, ax_any_copy(str_r.ax_any));
+	ax_string_r sub = AX_R_INIT(ax_str, ax_str_substr(str_r.ax_str, 2, 30));
+	ut_assert(r, !ax_string_shared(str_r.ax_string));
+	ut_assert(r, !ax_string_shared(copy.ax_string));
+	ut_assert(r, !ax_string_shared(sub.ax_string));
+
+	ut_assert(r, !ax_iter_set(&it, "A"));
+	p[2] = 'S';
+	ut_assert_str_equal(r, "A String longer than the inline storage", ax_str_strz(str_r.ax_str));
+	ut_assert_str_equal(r, text, ax_str_strz(copy.ax_str));
+	ut_assert_str_equal(r, "string longer than the inline ", ax_str_strz(sub.ax_str));
+
+	/* A cleared string is shared again */
+	ax_one_free(copy.ax_one);
+	ax_box_clear(str_r.ax_box);
+	ax_str_append(str_r.ax_str, text);
+	copy.ax_any = ax_any_copy(str_r.ax_any);
+	ut_assert(r, ax_string_shared(copy.ax_string));
+
+	ax_one_free(copy.ax_one);
+	ax_one_free(sub.ax_one);
+	ax_one_free(str_r.ax_one);
+}
+
+static void edit(ut_runner *r)
+{
+	ax_string_r str_r = ax_new0(ax_string);
+	ax_str_append(str_r.ax_str, "abcdef");
+
+	ax_iter it = ax_seq_at(str_r.ax_seq, 2);
+	ax_iter_erase(&it);
+	ut_assert_str_equal(r, "abdef", ax_str_strz(str_r.ax_str));
+	ut_assert_int_equal(r, 'd', *(char *)ax_iter_get(&it));
+
+	it = ax_box_rbegin(str_r.ax_box);
+	ax_iter_erase(&it);
+	ut_assert_str_equal(r, "abde", ax_str_strz(str_r.ax_str));
+	ut_assert_int_equal(r, 'e', *(char *)ax_iter_get(&it));
+
+	ax_seq_invert(str_r.ax_seq);
+	ut_assert_str_equal(r, "edba", ax_str_strz(str_r.ax_str));
+	ax_seq_trunc(str_r.ax_seq, 2);
+	ut_assert_str_equal(r, "ed", ax_str_strz(str_r.ax_str));
+	ax_seq_trunc(str_r.ax_seq, 4);
+	ut_assert_uint_equal(r, 4, ax_str_length(str_r.ax_str));
+	ax_seq_invert(str_r.ax_seq);
+	ut_assert_str_equal(r, "", ax_str_strz(str_r.ax_str));
+
+	ax_one_free(str_r.ax_one);
+}
+
+static int append_out(const char *str, size_t len, void *ctx)
+{
+	strncat(ctx, str, len);
+	return 0;
+}
+
+static void dump(ut_runner *r)
+{
+	ax_string_r str_r = ax_new0(ax_string);
+	ax_str_append(str_r.ax_str, "a string longer than the inline storage");
+	ax_string_r sub = AX_R_INIT(ax_str, ax_str_substr(str_r.ax_str, 2, 25));
+
+	/* The substring is not terminated in the shared buffer */
+	char out[256] = "";
+	ax_dump *dmp = ax_any_dump(sub.ax_any);
+	ax_dump_serialize(dmp, ax_dump_default_format(), append_out, out);
+	ut_assert(r, strstr(out, " \"string longer than the in\"") != NULL);
+	ax_dump_free(dmp);
+
+	ax_one_free(sub.ax_one);
+	ax_one_free(str_r.ax_one);
+}
+
+static void bench_substr(ut_runner *r, const ax_str *text, size_t len)
+{
+	size_t n = ax_str_length(text) / len;
+	ax_str **pieces = malloc(sizeof *pieces * n);
+
+	size_t before = heap_used();
+	clock_t time_before = clock();
+	for (size_t i = 0; i < n; i++)
+		pieces[i] = ax_str_substr(text, i * len, len);
+	double time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	size_t used = heap_used() - before;
+
+	for (size_t i = 0; i < n; i++)
+		ax_one_free(ax_r(ax_str, pieces[i]).ax_one);
+	free(pieces);
+	ut_printf(r, "%zu substrings of %zu chars spent %lfs, used %zu bytes", n, len, time, used);
+}
+
+static void substr_time(ut_runner *r)
+{
+	ax_string_r text = ax_new0(ax_string);
+	ax_seq_trunc(text.ax_seq, 1 << 24);
+
+	bench_substr(r, text.ax_str, 8);
+	bench_substr(r, text.ax_str, 256);
+	ax_one_free(text.ax_one);
+}
+
 ut_suite *suite_for_string()
 {
 	ut_suite* suite = ut_suite_create("string");
@@ -81,6 +319,14 @@ ut_suite *suite_for_string()
 	ut_suite_add(suite, create, 0);
 	ut_suite_add(suite, append, 0);
 	ut_suite_add(suite, split, 0);
+	ut_suite_add(suite, range, 0);
+	ut_suite_add(suite, inline_storage, 0);
+	ut_suite_add(suite, substr, 0);
+	ut_suite_add(suite, copy, 0);
+	ut_suite_add(suite, pinned, 0);
+	ut_suite_add(suite, edit, 0);
+	ut_suite_add(suite, dump, 0);
+	ut_suite_add(suite, substr_time, 0);
 
 	return suite;
 }
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ax/strview.h"
+#include "ax/string.h"
+#include "ax/buff.h"
+#include "ax/hmap.h"
+#include "ax/rb.h"
+#include "ax/dump.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static void view(ut_runner *r)
+{
+	ax_strview v = ax_strview_cstr("hello, world");
+	ut_assert_uint_equal(r, 12, v.len);
+
+	ax_strview hello = ax_strview_sub(v, 0, 5), world = ax_strview_sub(v, 7, 5);
+	ut_assert(r, ax_strview_equal(hello, ax_strview_make("hello!", 5)));
+	ut_assert(r, !ax_strview_equal(hello, world));
+	ut_assert(r, ax_strview_comp(hello, world) < 0);
+	ut_assert(r, ax_strview_comp(world, hello) > 0);
+	ut_assert(r, ax_strview_comp(hello, ax_strview_sub(v, 0, 4)) > 0);
+	ut_assert(r, ax_strview_comp(ax_strview_make(NULL, 0), ax_strview_cstr("")) == 0);
+	ut_assert(r, ax_strview_equal(ax_strview_make(NULL, 0), ax_strview_sub(v, 12, 0)));
+}
+
+static void from(ut_runner *r)
+{
+	ax_string_r str = ax_new0(ax_string);
+	ax_str_append(str.ax_str, "The quick brown fox jumps over the lazy dog");
+	ax_string_r sub = AX_R_INIT(ax_str, ax_str_substr(str.ax_str, 4, 30));
+
+	/* The view of a shared substring does not copy it */
+	ax_strview v = ax_strview_from_string(sub.ax_string);
+	ut_assert(r, ax_string_shared(sub.ax_string));
+	ut_assert(r, ax_strview_equal(v, ax_strview_cstr("quick brown fox jumps over the")));
+	ut_assert(r, v.ptr == ax_string_data(str.ax_string) + 4);
+
+	ax_buff_r buff = ax_new0(ax_buff);
+	ax_buff_resize(buff.ax_buff, 3);
+	memcpy(ax_buff_ptr(buff.ax_buff), "abc", 3);
+	v = ax_strview_from_buff(buff.ax_buff);
+	ut_assert(r, ax_strview_equal(v, ax_strview_cstr("abc")));
+
+	char mem[8];
+	ax_iobuf iobuf;
+	ax_iobuf_init(&iobuf, mem, sizeof mem);
+	ax_iobuf_write(&iobuf, "123456", 6);
+	ax_iobuf_read(&iobuf, NULL, 4);
+	ax_iobuf_write(&iobuf, "789", 3);
+	v = ax_strview_from_iobuf(&iobuf);
+	ut_assert(r, ax_strview_equal(v, ax_strview_cstr("5678")));
+	v = ax_strview_make(ax_iobuf_pullup(&iobuf), ax_iobuf_data_size(&iobuf));
+	ut_assert(r, ax_strview_equal(v, ax_strview_cstr("56789")));
+	ut_assert(r, ax_strview_equal(ax_strview_from_iobuf(&iobuf), v));
+
+	ax_one_free(buff.ax_one);
+	ax_one_free(sub.ax_one);
+	ax_one_free(str.ax_one);
+}
+
+static void split(ut_runner *r)
+{
+	ax_string_r str = ax_new0(ax_string);
+	ax_str_append(str.ax_str, ":GET /index.html HTTP/1.1::host");
+	const char *data = ax_string_data(str.ax_string);
+
+	/* Pieces point into the string */
+	ax_seq_r pieces = ax_r(ax_seq, ax_strview_split(ax_strview_from_string(str.ax_string), ':'));
+	static const char *const expect[] = { "", "GET /index.html HTTP/1.1", "", "host" };
+	static const size_t offset[] = { 0, 1, 26, 27 };
+	ut_assert_uint_equal(r, 4, ax_box_size(pieces.ax_box));
+	int i = 0;
+	ax_box_cforeach(pieces.ax_box, const ax_strview *, v) {
+		ut_assert(r, ax_strview_equal(*v, ax_strview_cstr(expect[i])));
+		ut_assert(r, v->ptr == data + offset[i]);
+		i++;
+	}
+	ax_one_free(pieces.ax_one);
+
+	pieces = ax_r(ax_seq, ax_strview_split(ax_strview_make(NULL, 0), ':'));
+	ut_assert_uint_equal(r, 1, ax_box_size(pieces.ax_box));
+	ut_assert_uint_equal(r, 0, ((ax_strview *)ax_seq_first(pieces.ax_seq))->len);
+	ax_one_free(pieces.ax_one);
+
+	ax_one_free(str.ax_one);
+}
+
+static void index_headers(ut_runner *r)
+{
+	char request[] =
+		"Host: example.com\r\n"
+		"Accept: */*\r\n"
+		"User-Agent: test\r\n";
+
+	ax_hmap_r headers = ax_new(ax_hmap, ax_t(strview), ax_t(strview));
+	ax_strview rest = ax_strview_cstr(request);
+	while (rest.len) {
+		const char *eol = ax_memmem(rest.ptr, rest.len, "\r\n", 2);
+		ax_strview line = ax_strview_sub(rest, 0, eol - rest.ptr);
+		const char *colon = memchr(line.ptr, ':', line.len);
+		ax_strview name = ax_strview_sub(line, 0, colon - line.ptr);
+		ax_strview value = ax_strview_sub(line, name.len + 2, line.len - name.len - 2);
+		ut_assert(r, ax_map_put(headers.ax_map, &name, &value) != NULL);
+		rest = ax_strview_sub(rest, line.len + 2, rest.len - line.len - 2);
+	}
+	ut_assert_uint_equal(r, 3, ax_box_size(headers.ax_box));
+
+	ax_strview key = ax_strview_cstr("Accept");
+	ax_strview *val = ax_map_get(headers.ax_map, &key);
+	ut_assert(r, val != NULL);
+	ut_assert(r, ax_strview_equal(*val, ax_strview_cstr("*/*")));
+	ut_assert(r, val->ptr >= request && val->ptr < request + sizeof request);
+
+	/* Views in an ordered map sort by chars */
+	ax_rb_r rb = ax_new(ax_rb, ax_t(strview), ax_t(int));
+	ax_map_cforeach(headers.ax_map, const ax_strview *, k, const ax_strview *, v) {
+		int len = v->len;
+		ax_map_put(rb.ax_map, k, &len);
+	}
+	const char *order[] = { "Accept", "Host", "User-Agent" };
+	int i = 0;
+	ax_map_cforeach(rb.ax_map, const ax_strview *, k, const int *, len) {
+		ut_assert(r, ax_strview_equal(*k, ax_strview_cstr(order[i])));
+		i++;
+		ax_unused(len);
+	}
+	ut_assert_int_equal(r, 3, i);
+
+	ax_one_free(rb.ax_one);
+	ax_one_free(headers.ax_one);
+}
+
+static int append_out(const char *str, size_t len, void *ctx)
+{
+	strncat(ctx, str, len);
+	return 0;
+}
+
+static void dump(ut_runner *r)
+{
+	char out[256] = "";
+	ax_strview v = ax_strview_cstr("value, not terminated");
+	v.len = 5;
+	ax_dump *dmp = ax_trait_dump(ax_t(strview), &v);
+	ax_dump_serialize(dmp, ax_dump_default_format(), append_out, out);
+	ut_assert(r, strstr(out, " \"value\"") != NULL);
+	ut_assert(r, strstr(out, "not") == NULL);
+	ax_dump_free(dmp);
+
+	/* A substring of a shared buffer is not terminated */
+	ax_string_r str = ax_new0(ax_string);
+	ax_str_append(str.ax_str, "a string longer than the inline storage");
+	ax_string_r sub = AX_R_INIT(ax_str, ax_str_substr(str.ax_str, 2, 25));
+	dmp = ax_any_dump(sub.ax_any);
+	out[0] = '\0';
+	ax_dump_serialize(dmp, ax_dump_default_format(), append_out, out);
+	ut_assert(r, strstr(out, " \"string longer than the in\"") != NULL);
+	ax_dump_free(dmp);
+
+	ax_one_free(sub.ax_one);
+	ax_one_free(str.ax_one);
+}
+
+ut_suite *suite_for_strview()
+{
+	ut_suite *suite = ut_suite_create("strview");
+
+	ut_suite_add(suite, view, 0);
+	ut_suite_add(suite, from, 0);
+	ut_suite_add(suite, split, 0);
+	ut_suite_add(suite, index_headers, 0);
+	ut_suite_add(suite, dump, 0);
+
+	return suite;
+}
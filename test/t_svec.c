@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "assist.h"
+#include "ax/svec.h"
+#include "ax/vector.h"
+#include "ax/algo.h"
+#include "ax/iter.h"
+#include "ax/pred.h"
+#include "ax/oper.h"
+#include "ax/arraya.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N 100000
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define HAVE_ALLOC_COUNT
+
+/* Count the allocations of the program by standing in for the allocation
+ * functions of glibc, the sanitizers replace them in their own way */
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t nmemb, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+static size_t alloc_count;
+
+void *malloc(size_t size)
+{
+	__atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	__atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	__atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+	return __libc_realloc(ptr, size);
+}
+#endif
+
+static void spill(ut_runner *r)
+{
+	ax_svec_r svec = ax_new(ax_svec, ax_t(int), 4);
+	ut_assert(r, ax_svec_inlined(svec.ax_svec));
+	ut_assert_uint_equal(r, 4, ax_svec_capacity(svec.ax_svec));
+
+	for (int i = 0; i < 4; i++)
+		ut_assert(r, !ax_seq_push(svec.ax_seq, &i));
+	ut_assert(r, ax_svec_inlined(svec.ax_svec));
+
+	for (int i = 4; i < 100; i++)
+		ut_assert(r, !ax_seq_push(svec.ax_seq, &i));
+	ut_assert(r, !ax_svec_inlined(svec.ax_svec));
+	ut_assert_uint_equal(r, 100, ax_box_size(svec.ax_box));
+
+	int i = 0;
+	ax_box_cforeach(svec.ax_box, const int *, v)
+		ut_assert_int_equal(r, i++, *v);
+
+	for (i = 0; i < 98; i++)
+		ut_assert(r, !ax_seq_pop(svec.ax_seq));
+	ut_assert_int_equal(r, 1, *(int *)ax_seq_last(svec.ax_seq));
+
+	ax_box_clear(svec.ax_box);
+	ut_assert(r, ax_svec_inlined(svec.ax_svec));
+	ut_assert_uint_equal(r, 0, ax_box_size(svec.ax_box));
+
+	ax_one_free(svec.ax_one);
+}
+
+static void no_inline(ut_runner *r)
+{
+	ax_svec_r svec = ax_new(ax_svec, ax_t(int), 0);
+	for (int i = 0; i < 10; i++)
+		ut_assert(r, !ax_seq_push(svec.ax_seq, &i));
+	ut_assert(r, !ax_svec_inlined(svec.ax_svec));
+	ut_assert_int_equal(r, 0, *(int *)ax_seq_first(svec.ax_seq));
+	ut_assert_int_equal(r, 9, *(int *)ax_seq_last(svec.ax_seq));
+	ax_one_free(svec.ax_one);
+}
+
+static void insert_erase(ut_runner *r)
+{
+	ax_svec_r svec = ax_new(ax_svec, ax_t(int), 4);
+	ax_seq_push_arraya(svec.ax_seq, ax_arraya(int, 1, 2, 4));
+
+	/* Grows across the inline boundary in the middle of the sequence */
+	ax_iter it = ax_seq_at(svec.ax_seq, 2);
+	ut_assert(r, !ax_seq_insert(svec.ax_seq, &it, ax_p(int, 3)));
+	it = ax_seq_at(svec.ax_seq, 0);
+	ut_assert(r, !ax_seq_insert(svec.ax_seq, &it, ax_p(int, 0)));
+	ut_assert(r, !ax_svec_inlined(svec.ax_svec));
+
+	int i = 0;
+	ax_box_cforeach(svec.ax_box, const int *, v)
+		ut_assert_int_equal(r, i++, *v);
+	ut_assert_int_equal(r, 5, i);
+
+	/* Erase odd elements forward, then the rest backward */
+	it = ax_box_begin(svec.ax_box);
+	ax_iter end = ax_box_end(svec.ax_box);
+	while (!ax_iter_equal(&it, &end)) {
+		if (*(int *)ax_iter_get(&it) % 2) {
+			ax_iter_erase(&it);
+			end = ax_box_end(svec.ax_box);
+		}
+		else
+			ax_iter_next(&it);
+	}
+	int table1[] = { 0, 2, 4 };
+	ut_assert(r, seq_equal_array(svec.ax_seq, table1, sizeof table1));
+
+	it = ax_box_rbegin(svec.ax_box);
+	ax_iter_erase(&it);
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&it));
+	ax_iter_erase(&it);
+	ut_assert_int_equal(r, 0, *(int *)ax_iter_get(&it));
+	ax_iter_erase(&it);
+	end = ax_box_rend(svec.ax_box);
+	ut_assert(r, ax_iter_equal(&it, &end));
+	ut_assert_uint_equal(r, 0, ax_box_size(svec.ax_box));
+
+	ax_one_free(svec.ax_one);
+}
+
+static void invert(ut_runner *r)
+{
+	ax_svec_r svec = ax_new(ax_svec, ax_t(int), 8);
+	for (int n = 0; n < 6; n++) {
+		ax_box_clear(svec.ax_box);
+		for (int i = 0; i < n; i++)
+			ax_seq_push(svec.ax_seq, &i);
+		ax_seq_invert(svec.ax_seq);
+
+		int i = n;
+		ax_box_cforeach(svec.ax_box, const int *, v)
+			ut_assert_int_equal(r, --i, *v);
+	}
+	ax_one_free(svec.ax_one);
+}
+
+static void trunc_and_riter(ut_runner *r)
+{
+	ax_svec_r svec = ax_new(ax_svec, ax_t(int), 2);
+	ut_assert(r, !ax_seq_trunc(svec.ax_seq, 5));
+	ut_assert_uint_equal(r, 5, ax_box_size(svec.ax_box));
+	ax_box_cforeach(svec.ax_box, const int *, v)
+		ut_assert_int_equal(r, 0, *v);
+
+	int i = 0;
+	ax_box_foreach(svec.ax_box, int *, v)
+		*v = i++;
+
+	ax_iter first = ax_box_rbegin(svec.ax_box), last = ax_box_rend(svec.ax_box);
+	ut_assert_int_equal(r, 5, ax_iter_dist(&first, &last));
+	for (i = 4; !ax_iter_equal(&first, &last); ax_iter_next(&first))
+		ut_assert_int_equal(r, i--, *(int *)ax_iter_get(&first));
+
+	ut_assert(r, !ax_seq_trunc(svec.ax_seq, 1));
+	int table1[] = { 0 };
+	ut_assert(r, seq_equal_array(svec.ax_seq, table1, sizeof table1));
+
+	ax_one_free(svec.ax_one);
+}
+
+static void algo(ut_runner *r)
+{
+	ax_svec_r svec = ax_new(ax_svec, &ax_t_i32, 16);
+	ax_seq_push_arraya(svec.ax_seq, ax_arraya(int32_t, 1, 8, 2, 4, 9, 5, 3, 6, 7, 0));
+
+	ax_iter first = ax_box_begin(svec.ax_box);
+	ax_iter last = ax_box_end(svec.ax_box);
+	ax_pred2 pred = ax_pred2_make(ax_oper_int32_t.o_le, NULL);
+	ut_assert(r, !ax_quick_sort(&first, &last, &pred));
+	int32_t table1[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	ut_assert(r, seq_equal_array(svec.ax_seq, table1, sizeof table1));
+
+	ax_one_free(svec.ax_one);
+}
+
+static void copy(ut_runner *r)
+{
+	ax_svec_r svec = ax_new(ax_svec, ax_t(str), 2);
+	ax_seq_push(svec.ax_seq, "foo");
+	ax_seq_push(svec.ax_seq, "bar");
+
+	ax_svec_r copy1 = AX_R_INIT(ax_any, ax_any_copy(svec.ax_any));
+	ut_assert(r, ax_svec_inlined(copy1.ax_svec));
+
+	ax_seq_push(svec.ax_seq, "baz");
+	ax_svec_r copy2 = AX_R_INIT(ax_any, ax_any_copy(svec.ax_any));
+	ut_assert(r, !ax_svec_inlined(copy2.ax_svec));
+
+	ut_assert_uint_equal(r, 2, ax_box_size(copy1.ax_box));
+	ut_assert_uint_equal(r, 3, ax_box_size(copy2.ax_box));
+	ut_assert_str_equal(r, "bar", *(char **)ax_seq_last(copy1.ax_seq));
+	ut_assert_str_equal(r, "baz", *(char **)ax_seq_last(copy2.ax_seq));
+
+	ax_one_free(copy1.ax_one);
+	ax_one_free(copy2.ax_one);
+	ax_one_free(svec.ax_one);
+}
+
+static void range(ut_runner *r)
+{
+	ax_svec_r svec = ax_new(ax_svec, ax_t(int), 4);
+	ax_svec_r src = ax_new(ax_svec, ax_t(int), 4);
+	ax_seq_push_arraya(src.ax_seq, ax_arraya(int, 7, 8, 9));
+
+	int table1[] = {1, 2, 3};
+	ut_assert(r, !ax_seq_push_n(svec.ax_seq, table1, 3));
+	ut_assert(r, ax_svec_inlined(svec.ax_svec));
+
+	ax_citer first = ax_box_cbegin(src.ax_box), last = ax_box_cend(src.ax_box);
+	ax_iter it = ax_seq_at(svec.ax_seq, 1);
+	ut_assert(r, !ax_seq_insert_range(svec.ax_seq, &it, &first, &last));
+	int table2[] = {1, 7, 8, 9, 2, 3};
+	ut_assert(r, seq_equal_array(svec.ax_seq, table2, sizeof table2));
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&it));
+
+	it = ax_box_rbegin(svec.ax_box);
+	ut_assert(r, !ax_seq_insert_range(svec.ax_seq, &it, &first, &last));
+	int table3[] = {1, 7, 8, 9, 2, 3, 9, 8, 7};
+	ut_assert(r, seq_equal_array(svec.ax_seq, table3, sizeof table3));
+
+	/* Erase backward down to the element 8 at index 2 */
+	ax_iter efirst = ax_box_rbegin(svec.ax_box), elast = efirst;
+	ax_iter_move(&elast, 6);
+	ax_seq_erase_range(svec.ax_seq, &efirst, &elast);
+	int table4[] = {1, 7, 8};
+	ut_assert(r, seq_equal_array(svec.ax_seq, table4, sizeof table4));
+	ut_assert(r, ax_iter_equal(&efirst, &elast));
+	ut_assert_int_equal(r, 8, *(int *)ax_iter_get(&efirst));
+
+	ax_one_free(src.ax_one);
+	ax_one_free(svec.ax_one);
+}
+
+/* Returns the number of allocations, 0 when they are not counted */
+static size_t bench_seq(ut_runner *r, const char *name, ax_seq *(*create)(void))
+{
+	ax_seq **seqs = malloc(sizeof *seqs * N);
+	ut_assert(r, seqs != NULL);
+
+	size_t before = heap_used();
+#ifdef HAVE_ALLOC_COUNT
+	size_t allocs = __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
+#endif
+	clock_t time_before = clock();
+	for (int i = 0; i < N; i++) {
+		seqs[i] = create();
+		for (int j = 0; j < 4; j++)
+			ax_seq_push(seqs[i], &j);
+	}
+	double build_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+#ifdef HAVE_ALLOC_COUNT
+	allocs = __atomic_load_n(&alloc_count, __ATOMIC_RELAXED) - allocs;
+	ut_printf(r, "%s: %d containers of 4 ints spent %lfs, %zu allocations, used %zu bytes",
+			name, N, build_time, allocs, heap_used() - before);
+#else
+	size_t allocs = 0;
+	ut_printf(r, "%s: %d containers of 4 ints spent %lfs, used %zu bytes",
+			name, N, build_time, heap_used() - before);
+#endif
+
+	for (int i = 0; i < N; i++) {
+		int sum = 0;
+		ax_box_cforeach(ax_r(ax_seq, seqs[i]).ax_box, const int *, v)
+			sum += *v;
+		ut_assert_int_equal(r, 6, sum);
+		ax_one_free(ax_r(ax_seq, seqs[i]).ax_one);
+	}
+	free(seqs);
+	return allocs;
+}
+
+static ax_seq *create_svec()
+{
+	return ax_new(ax_svec, ax_t(int), 4).ax_seq;
+}
+
+static ax_seq *create_vector()
+{
+	return ax_new(ax_vector, ax_t(int)).ax_seq;
+}
+
+static void bench(ut_runner *r)
+{
+	/* The inline capacity of svec covers all elements */
+	ax_svec_r probe = ax_new(ax_svec, ax_t(int), 4);
+	for (int j = 0; j < 4; j++)
+		ax_seq_push(probe.ax_seq, &j);
+	ut_assert(r, ax_svec_inlined(probe.ax_svec));
+	ax_one_free(probe.ax_one);
+
+	size_t svec_allocs = bench_seq(r, "ax_svec", create_svec);
+	size_t vector_allocs = bench_seq(r, "ax_vector", create_vector);
+#ifdef HAVE_ALLOC_COUNT
+	ut_assert_uint_equal(r, N, svec_allocs);
+	ut_assert(r, vector_allocs > svec_allocs);
+#else
+	ax_unused(svec_allocs);
+	ax_unused(vector_allocs);
+#endif
+}
+
+ut_suite *suite_for_svec()
+{
+	ut_suite *suite = ut_suite_create("svec");
+
+	ut_suite_add(suite, spill, 0);
+	ut_suite_add(suite, no_inline, 0);
+	ut_suite_add(suite, insert_erase, 0);
+	ut_suite_add(suite, invert, 0);
+	ut_suite_add(suite, trunc_and_riter, 0);
+	ut_suite_add(suite, algo, 0);
+	ut_suite_add(suite, copy, 0);
+	ut_suite_add(suite, range, 0);
+	ut_suite_add(suite, bench, 0);
+
+	return suite;
+}
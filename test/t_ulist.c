@@ -0,0 +1,459 @@
+/*
+ * Copyright (c) 2024 Li Xilin <lixilin@gmx.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "assist.h"
+#include "ax/ulist.h"
+#include "ax/list.h"
+#include "ax/deq.h"
+#include "ax/algo.h"
+#include "ax/iter.h"
+#include "ax/pred.h"
+#include "ax/oper.h"
+#include "ax/arraya.h"
+#include "ut/runner.h"
+#include "ut/suite.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N 1000
+#define BENCH_N 1000000
+
+static void push_pop(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(int));
+	size_t capacity = ax_ulist_node_capacity(ulist.ax_ulist);
+	ut_assert(r, capacity >= 4 && capacity < N);
+
+	/* Both ends cross node boundaries many times */
+	for (int i = 0; i < N; i++) {
+		ut_assert(r, !ax_seq_push(ulist.ax_seq, &i));
+		int j = -1 - i;
+		ut_assert(r, !ax_seq_pushf(ulist.ax_seq, &j));
+	}
+	ut_assert_uint_equal(r, 2 * N, ax_box_size(ulist.ax_box));
+	ut_assert_int_equal(r, -N, *(int *)ax_seq_first(ulist.ax_seq));
+	ut_assert_int_equal(r, N - 1, *(int *)ax_seq_last(ulist.ax_seq));
+
+	int i = -N;
+	ax_box_cforeach(ulist.ax_box, const int *, v)
+		ut_assert_int_equal(r, i++, *v);
+	ut_assert_int_equal(r, N, i);
+
+	for (i = 0; i < N / 2; i++) {
+		ut_assert(r, !ax_seq_pop(ulist.ax_seq));
+		ut_assert(r, !ax_seq_popf(ulist.ax_seq));
+	}
+	ut_assert_uint_equal(r, N, ax_box_size(ulist.ax_box));
+	ut_assert_int_equal(r, -N / 2, *(int *)ax_seq_first(ulist.ax_seq));
+	ut_assert_int_equal(r, N / 2 - 1, *(int *)ax_seq_last(ulist.ax_seq));
+
+	while (ax_box_size(ulist.ax_box))
+		ut_assert(r, !ax_seq_pop(ulist.ax_seq));
+	ut_assert(r, !ax_seq_push(ulist.ax_seq, ax_p(int, 1)));
+	ut_assert_int_equal(r, 1, *(int *)ax_seq_first(ulist.ax_seq));
+
+	ax_one_free(ulist.ax_one);
+}
+
+static void push_pop_boundary(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(int));
+	size_t capacity = ax_ulist_node_capacity(ulist.ax_ulist);
+
+	/* With both end nodes full, each push opens a node that the pop drops,
+	 * the elements of the end nodes are neither copied nor reallocated */
+	for (int i = 0; i < 2 * capacity; i++)
+		ut_assert(r, !ax_seq_push(ulist.ax_seq, &i));
+	int *first = ax_seq_first(ulist.ax_seq), *last = ax_seq_last(ulist.ax_seq);
+
+	for (int i = 0; i < 100; i++) {
+		ut_assert(r, !ax_seq_push(ulist.ax_seq, &i));
+		ut_assert(r, !ax_seq_pop(ulist.ax_seq));
+		ut_assert(r, !ax_seq_pushf(ulist.ax_seq, &i));
+		ut_assert(r, !ax_seq_popf(ulist.ax_seq));
+	}
+	ut_assert(r, ax_seq_first(ulist.ax_seq) == first);
+	ut_assert(r, ax_seq_last(ulist.ax_seq) == last);
+	ut_assert_int_equal(r, 0, *first);
+	ut_assert_int_equal(r, 2 * capacity - 1, *last);
+	ut_assert_uint_equal(r, 2 * capacity, ax_box_size(ulist.ax_box));
+
+	ax_one_free(ulist.ax_one);
+}
+
+static void insert_middle(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(int));
+
+	/* Keep inserting at the same place so that nodes are split repeatedly */
+	ax_seq_push_arraya(ulist.ax_seq, ax_arraya(int, -1, N));
+	ax_iter it = ax_seq_at(ulist.ax_seq, 1);
+	for (int i = N - 1; i >= 0; i--) {
+		ut_assert(r, !ax_seq_insert(ulist.ax_seq, &it, &i));
+		ut_assert_int_equal(r, i + 1, *(int *)ax_iter_get(&it));
+		ax_iter_prev(&it);
+	}
+	ut_assert_uint_equal(r, N + 2, ax_box_size(ulist.ax_box));
+
+	int i = -1;
+	ax_box_cforeach(ulist.ax_box, const int *, v)
+		ut_assert_int_equal(r, i++, *v);
+	ut_assert_int_equal(r, N + 1, i);
+
+	for (i = 0; i < N + 2; i += 7) {
+		it = ax_seq_at(ulist.ax_seq, i);
+		ut_assert_int_equal(r, i - 1, *(int *)ax_iter_get(&it));
+	}
+
+	/* Reversed insertion puts the element behind the iterator in memory */
+	it = ax_box_rbegin(ulist.ax_box);
+	ut_assert(r, !ax_seq_insert(ulist.ax_seq, &it, ax_p(int, N + 1)));
+	ut_assert_int_equal(r, N, *(int *)ax_iter_get(&it));
+	ut_assert_int_equal(r, N + 1, *(int *)ax_seq_last(ulist.ax_seq));
+
+	ax_iter end = ax_box_end(ulist.ax_box);
+	ut_assert(r, !ax_seq_insert(ulist.ax_seq, &end, ax_p(int, N + 2)));
+	ut_assert_int_equal(r, N + 2, *(int *)ax_seq_last(ulist.ax_seq));
+
+	ax_one_free(ulist.ax_one);
+}
+
+static void erase(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(int));
+	for (int i = 0; i < N; i++)
+		ax_seq_push(ulist.ax_seq, &i);
+
+	/* Erase odd elements forward, nodes are merged on the way */
+	ax_iter it = ax_box_begin(ulist.ax_box), end = ax_box_end(ulist.ax_box);
+	while (!ax_iter_equal(&it, &end)) {
+		if (*(int *)ax_iter_get(&it) % 2)
+			ax_iter_erase(&it);
+		else
+			ax_iter_next(&it);
+	}
+	ut_assert_uint_equal(r, N / 2, ax_box_size(ulist.ax_box));
+	int i = 0;
+	ax_box_cforeach(ulist.ax_box, const int *, v) {
+		ut_assert_int_equal(r, i, *v);
+		i += 2;
+	}
+
+	/* Then erase everything backward */
+	it = ax_box_rbegin(ulist.ax_box);
+	end = ax_box_rend(ulist.ax_box);
+	for (i = N - 2; !ax_iter_equal(&it, &end); i -= 2) {
+		ut_assert_int_equal(r, i, *(int *)ax_iter_get(&it));
+		ax_iter_erase(&it);
+	}
+	ut_assert_int_equal(r, -2, i);
+	ut_assert_uint_equal(r, 0, ax_box_size(ulist.ax_box));
+
+	ax_one_free(ulist.ax_one);
+}
+
+/* Every node but the ends is at least half full, the nodes are returned */
+static size_t check_nodes(ut_runner *r, ax_ulist *ulist)
+{
+	ax_citer it = ax_box_cbegin(ax_r(ax_ulist, ulist).ax_box);
+	size_t capacity = ax_ulist_node_capacity(ulist), size = ax_box_size(ax_r(ax_ulist, ulist).ax_box);
+	size_t nodes = 0, total = 0, n;
+	void *ptr;
+	while ((n = ax_citer_span(&it, NULL, SIZE_MAX, &ptr))) {
+		total += n;
+		nodes++;
+		if (nodes > 1 && total < size)
+			ut_assert(r, n >= capacity / 2);
+	}
+	return nodes;
+}
+
+static void erase_middle(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(int));
+	int *expect = malloc(sizeof *expect * N * 8);
+	ut_assert(r, expect != NULL);
+
+	size_t size = 0;
+	for (int i = 0; i < N * 4; i++) {
+		ut_assert(r, !ax_seq_push(ulist.ax_seq, &i));
+		expect[size++] = i;
+	}
+
+	/* Split nodes by inserting into the middle */
+	for (int i = 0; i < N * 4; i++) {
+		size_t index = (i * 7919u) % size;
+		ax_iter it = ax_seq_at(ulist.ax_seq, index);
+		int val = -i;
+		ut_assert(r, !ax_seq_insert(ulist.ax_seq, &it, &val));
+		memmove(expect + index + 1, expect + index, (size - index) * sizeof *expect);
+		expect[index] = val;
+		size++;
+	}
+	check_nodes(r, ulist.ax_ulist);
+
+	/* Erase from the middle, backward every other time */
+	for (int i = 0; size > N / 2; i++) {
+		size_t index = (i * 104729u) % size;
+		if (i % 2) {
+			ax_iter it = ax_box_rbegin(ulist.ax_box);
+			ax_iter_move(&it, size - 1 - index);
+			ut_assert_int_equal(r, expect[index], *(int *)ax_iter_get(&it));
+			ax_iter_erase(&it);
+			if (index > 0)
+				ut_assert_int_equal(r, expect[index - 1], *(int *)ax_iter_get(&it));
+		} else {
+			ax_iter it = ax_seq_at(ulist.ax_seq, index);
+			ax_iter_erase(&it);
+			if (index + 1 < size)
+				ut_assert_int_equal(r, expect[index + 1], *(int *)ax_iter_get(&it));
+		}
+		memmove(expect + index, expect + index + 1, (size - index - 1) * sizeof *expect);
+		size--;
+		if (i % 64 == 0)
+			check_nodes(r, ulist.ax_ulist);
+	}
+
+	size_t capacity = ax_ulist_node_capacity(ulist.ax_ulist);
+	ut_assert(r, check_nodes(r, ulist.ax_ulist) <= size / (capacity / 2) + 2);
+	ut_assert(r, seq_equal_array(ulist.ax_seq, expect, size * sizeof *expect));
+
+	free(expect);
+	ax_one_free(ulist.ax_one);
+}
+
+static void iterate(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(int));
+	ut_assert(r, !ax_seq_trunc(ulist.ax_seq, N));
+	ax_box_cforeach(ulist.ax_box, const int *, v)
+		ut_assert_int_equal(r, 0, *v);
+
+	int i = 0;
+	ax_box_foreach(ulist.ax_box, int *, v)
+		*v = i++;
+
+	ax_iter first = ax_box_begin(ulist.ax_box), last = ax_box_end(ulist.ax_box);
+	ut_assert_int_equal(r, N, ax_iter_dist(&first, &last));
+	ax_iter_move(&first, N / 2);
+	ut_assert_int_equal(r, N / 2, *(int *)ax_iter_get(&first));
+	ax_iter_move(&first, -N / 4);
+	ut_assert_int_equal(r, N / 4, *(int *)ax_iter_get(&first));
+	ut_assert(r, ax_iter_less(&first, &last));
+
+	first = ax_box_rbegin(ulist.ax_box);
+	last = ax_box_rend(ulist.ax_box);
+	ut_assert_int_equal(r, N, ax_iter_dist(&first, &last));
+	for (i = N - 1; !ax_iter_equal(&first, &last); ax_iter_next(&first))
+		ut_assert_int_equal(r, i--, *(int *)ax_iter_get(&first));
+	ax_iter_prev(&first);
+	ut_assert_int_equal(r, 0, *(int *)ax_iter_get(&first));
+	ax_iter_move(&first, -(N - 1));
+	ut_assert_int_equal(r, N - 1, *(int *)ax_iter_get(&first));
+
+	ax_seq_invert(ulist.ax_seq);
+	i = N - 1;
+	ax_box_cforeach(ulist.ax_box, const int *, v)
+		ut_assert_int_equal(r, i--, *v);
+
+	ut_assert(r, !ax_seq_trunc(ulist.ax_seq, 1));
+	int table1[] = { N - 1 };
+	ut_assert(r, seq_equal_array(ulist.ax_seq, table1, sizeof table1));
+
+	ax_one_free(ulist.ax_one);
+}
+
+static void algo(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, &ax_t_i32);
+	ax_seq_push_arraya(ulist.ax_seq, ax_arraya(int32_t, 1, 8, 2, 4, 9, 5, 3, 6, 7, 0));
+
+	ax_iter first = ax_box_begin(ulist.ax_box);
+	ax_iter last = ax_box_end(ulist.ax_box);
+	ax_pred2 pred = ax_pred2_make(ax_oper_int32_t.o_le, NULL);
+	ut_assert(r, !ax_quick_sort(&first, &last, &pred));
+	int32_t table1[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	ut_assert(r, seq_equal_array(ulist.ax_seq, table1, sizeof table1));
+
+	ax_one_free(ulist.ax_one);
+}
+
+static void span(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(int));
+	for (int i = 0; i < N; i++)
+		ax_seq_push(ulist.ax_seq, &i);
+
+	/* Spans cover a node at most and never pass the last iterator */
+	ax_citer first = ax_box_cbegin(ulist.ax_box), last = ax_seq_cat(ulist.ax_seq, N - 1);
+	size_t capacity = ax_ulist_node_capacity(ulist.ax_ulist), total = 0, n;
+	int *ptr;
+	while ((n = ax_citer_span(&first, &last, SIZE_MAX, (void **)&ptr))) {
+		ut_assert(r, n <= capacity);
+		for (size_t i = 0; i < n; i++)
+			ut_assert_int_equal(r, total + i, ptr[i]);
+		total += n;
+	}
+	ut_assert_uint_equal(r, N - 1, total);
+	ut_assert(r, ax_citer_equal(&first, &last));
+
+	ax_one_free(ulist.ax_one);
+}
+
+static void copy(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(str));
+	ax_seq_push(ulist.ax_seq, "foo");
+	ax_seq_push(ulist.ax_seq, "bar");
+	ax_seq_pushf(ulist.ax_seq, "baz");
+
+	ax_ulist_r copy = AX_R_INIT(ax_any, ax_any_copy(ulist.ax_any));
+	ax_one_free(ulist.ax_one);
+
+	ut_assert_uint_equal(r, 3, ax_box_size(copy.ax_box));
+	ut_assert_str_equal(r, "baz", *(char **)ax_seq_first(copy.ax_seq));
+	ut_assert_str_equal(r, "bar", *(char **)ax_seq_last(copy.ax_seq));
+	ax_iter it = ax_seq_at(copy.ax_seq, 1);
+	ut_assert_str_equal(r, "foo", (char *)ax_iter_get(&it));
+	ut_assert(r, !ax_iter_set(&it, "qux"));
+	ut_assert_str_equal(r, "qux", (char *)ax_iter_get(&it));
+
+	ax_one_free(copy.ax_one);
+}
+
+static void range(ut_runner *r)
+{
+	ax_ulist_r ulist = ax_new(ax_ulist, ax_t(int));
+	ax_list_r src = ax_new(ax_list, ax_t(int));
+	ax_seq_push_arraya(src.ax_seq, ax_arraya(int, 7, 8, 9));
+
+	int table1[] = {1, 2, 3};
+	ut_assert(r, !ax_seq_push_n(ulist.ax_seq, table1, 3));
+
+	ax_citer first = ax_box_cbegin(src.ax_box), last = ax_box_cend(src.ax_box);
+	ax_iter it = ax_seq_at(ulist.ax_seq, 1);
+	ut_assert(r, !ax_seq_insert_range(ulist.ax_seq, &it, &first, &last));
+	int table2[] = {1, 7, 8, 9, 2, 3};
+	ut_assert(r, seq_equal_array(ulist.ax_seq, table2, sizeof table2));
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&it));
+
+	ax_iter efirst = ax_seq_at(ulist.ax_seq, 1), elast = ax_seq_at(ulist.ax_seq, 4);
+	ax_seq_erase_range(ulist.ax_seq, &efirst, &elast);
+	int table3[] = {1, 2, 3};
+	ut_assert(r, seq_equal_array(ulist.ax_seq, table3, sizeof table3));
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&efirst));
+
+	ax_one_free(src.ax_one);
+	ax_one_free(ulist.ax_one);
+}
+
+static void is_even(void *out, const void *in, void *arg)
+{
+	*(bool *)out = *(int *)in % 2 == 0;
+}
+
+static void bench_seq(ut_runner *r, const char *name, ax_seq *seq)
+{
+
+	size_t before = heap_used();
+	clock_t time_before = clock();
+	for (int i = 0; i < BENCH_N / 2; i++) {
+		ax_seq_push(seq, &i);
+		ax_seq_pushf(seq, &i);
+	}
+	double push_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	size_t used = heap_used() - before;
+
+	time_before = clock();
+	ax_citer first = ax_box_cbegin(ax_r(ax_seq, seq).ax_box);
+	ax_citer last = ax_box_cend(ax_r(ax_seq, seq).ax_box);
+	ax_pred1 pred = ax_pred1_make(is_even, NULL);
+	size_t count = ax_count_if(&first, &last, &pred);
+	double count_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_uint_equal(r, BENCH_N / 2, count);
+
+	time_before = clock();
+	for (int i = 0; i < BENCH_N / 2; i++) {
+		ax_seq_pop(seq);
+		ax_seq_popf(seq);
+	}
+	double pop_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_uint_equal(r, 0, ax_box_size(ax_r(ax_seq, seq).ax_box));
+
+	ut_printf(r, "%s: %d ints, push %lfs, count_if %lfs, pop %lfs, used %zu bytes",
+			name, BENCH_N, push_time, count_time, pop_time, used);
+}
+
+static void bench_insert(ut_runner *r, const char *name, ax_seq *seq)
+{
+	for (int i = 0; i < N * 10; i++)
+		ax_seq_push(seq, &i);
+
+	/* Insert in the middle through an iterator held across insertions */
+	clock_t time_before = clock();
+	ax_iter it = ax_seq_at(seq, N * 5);
+	for (int i = 0; i < BENCH_N / 10; i++)
+		ax_seq_insert(seq, &it, &i);
+	double insert_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_uint_equal(r, N * 10 + BENCH_N / 10, ax_box_size(ax_r(ax_seq, seq).ax_box));
+
+	ut_printf(r, "%s: %d middle insertions spent %lfs", name, BENCH_N / 10, insert_time);
+}
+
+static void bench(ut_runner *r)
+{
+	ax_seq *ulist = ax_new(ax_ulist, ax_t(int)).ax_seq;
+	bench_seq(r, "ax_ulist", ulist);
+	bench_insert(r, "ax_ulist", ulist);
+	ax_one_free(ax_r(ax_seq, ulist).ax_one);
+
+	ax_seq *list = ax_new(ax_list, ax_t(int)).ax_seq;
+	bench_seq(r, "ax_list", list);
+	bench_insert(r, "ax_list", list);
+	ax_one_free(ax_r(ax_seq, list).ax_one);
+
+	/* The deque is only measured at both ends, which is what it is built for */
+	ax_seq *deq = ax_new(ax_deq, ax_t(int)).ax_seq;
+	bench_seq(r, "ax_deq", deq);
+	ax_one_free(ax_r(ax_seq, deq).ax_one);
+}
+
+ut_suite *suite_for_ulist()
+{
+	ut_suite *suite = ut_suite_create("ulist");
+
+	ut_suite_add(suite, push_pop, 0);
+	ut_suite_add(suite, push_pop_boundary, 0);
+	ut_suite_add(suite, insert_middle, 0);
+	ut_suite_add(suite, erase, 0);
+	ut_suite_add(suite, erase_middle, 0);
+	ut_suite_add(suite, iterate, 0);
+	ut_suite_add(suite, algo, 0);
+	ut_suite_add(suite, span, 0);
+	ut_suite_add(suite, copy, 0);
+	ut_suite_add(suite, range, 0);
+	ut_suite_add(suite, bench, 0);
+
+	return suite;
+}
@@ -23,6 +23,7 @@
 #include "assist.h"
 #include "ax/iter.h"
 #include "ax/vector.h"
+#include "ax/list.h"
 #include "ax/algo.h"
 #include "ax/arraya.h"
 #include "ut/suite.h"
@@ -33,6 +34,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 static void create(ut_runner *r)
 {
@@ -255,6 +257,105 @@ static void seq_invert(ut_runner *r)
 	ax_one_free(vec.ax_one);
 }
 
+static void seq_push_n(ut_runner *r)
+{
+	ax_vector_r vec = ax_new(ax_vector, ax_t(int));
+	int table1[] = {1, 2, 3, 4};
+	ut_assert(r, !ax_seq_push_n(vec.ax_seq, table1, 4));
+	ut_assert(r, !ax_seq_push_n(vec.ax_seq, NULL, 0));
+	ut_assert(r, seq_equal_array(vec.ax_seq, table1, sizeof table1));
+	ax_one_free(vec.ax_one);
+
+	ax_vector_r svec = ax_new(ax_vector, ax_t(str));
+	const char *strs[] = {"foo", "bar"};
+	ut_assert(r, !ax_seq_push_n(svec.ax_seq, strs, 2));
+	ut_assert(r, *(char **)ax_seq_first(svec.ax_seq) != strs[0]);
+	ut_assert_str_equal(r, "bar", *(char **)ax_seq_last(svec.ax_seq));
+	ax_one_free(svec.ax_one);
+}
+
+static void seq_insert_range(ut_runner *r)
+{
+	ax_vector_r vec = ax_new(ax_vector, ax_t(int));
+	ax_list_r list = ax_new(ax_list, ax_t(int));
+	ax_seq_push_arraya(vec.ax_seq, ax_arraya(int, 1, 2));
+	ax_seq_push_arraya(list.ax_seq, ax_arraya(int, 7, 8, 9));
+
+	ax_citer first = ax_box_cbegin(list.ax_box), last = ax_box_cend(list.ax_box);
+	ax_iter it = ax_seq_at(vec.ax_seq, 1);
+	ut_assert(r, !ax_seq_insert_range(vec.ax_seq, &it, &first, &last));
+	int table1[] = {1, 7, 8, 9, 2};
+	ut_assert(r, seq_equal_array(vec.ax_seq, table1, sizeof table1));
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&it));
+
+	/* Same as inserting the elements one by one through a reversed iterator */
+	it = ax_box_rbegin(vec.ax_box);
+	ut_assert(r, !ax_seq_insert_range(vec.ax_seq, &it, &first, &last));
+	int table2[] = {1, 7, 8, 9, 2, 9, 8, 7};
+	ut_assert(r, seq_equal_array(vec.ax_seq, table2, sizeof table2));
+	ut_assert_int_equal(r, 2, *(int *)ax_iter_get(&it));
+
+	ax_one_free(list.ax_one);
+	ax_one_free(vec.ax_one);
+}
+
+static void seq_erase_range(ut_runner *r)
+{
+	ax_vector_r vec = ax_new(ax_vector, ax_t(int));
+	ax_seq_push_arraya(vec.ax_seq, ax_arraya(int, 0, 1, 2, 3, 4, 5, 6, 7));
+
+	ax_iter first = ax_seq_at(vec.ax_seq, 1), last = ax_seq_at(vec.ax_seq, 3);
+	ax_seq_erase_range(vec.ax_seq, &first, &last);
+	int table1[] = {0, 3, 4, 5, 6, 7};
+	ut_assert(r, seq_equal_array(vec.ax_seq, table1, sizeof table1));
+	ut_assert(r, ax_iter_equal(&first, &last));
+	ut_assert_int_equal(r, 3, *(int *)ax_iter_get(&first));
+
+	/* Erase 6 and 5 backward */
+	first = ax_box_rbegin(vec.ax_box);
+	ax_iter_next(&first);
+	last = first;
+	ax_iter_move(&last, 2);
+	ax_seq_erase_range(vec.ax_seq, &first, &last);
+	int table2[] = {0, 3, 4, 7};
+	ut_assert(r, seq_equal_array(vec.ax_seq, table2, sizeof table2));
+	ut_assert_int_equal(r, 4, *(int *)ax_iter_get(&first));
+
+	first = ax_box_begin(vec.ax_box);
+	last = ax_box_end(vec.ax_box);
+	ax_seq_erase_range(vec.ax_seq, &first, &last);
+	ut_assert_uint_equal(r, 0, ax_box_size(vec.ax_box));
+
+	ax_one_free(vec.ax_one);
+}
+
+static void push_time(ut_runner *r)
+{
+	const size_t n = 1000000;
+	int *arr = malloc(n * sizeof *arr);
+	for (size_t i = 0; i < n; i++)
+		arr[i] = i;
+
+	ax_vector_r vec = ax_new(ax_vector, ax_t(int));
+	clock_t time_before = clock();
+	for (size_t i = 0; i < n; i++)
+		ax_seq_push(vec.ax_seq, arr + i);
+	double push_time = (double)(clock() - time_before) / CLOCKS_PER_SEC;
+	ut_assert_uint_equal(r, n, ax_box_size(vec.ax_box));
+
+	ax_box_clear(vec.ax_box);
+	time_before = clock();
+	ut_assert(r, !ax_seq_push_n(vec.ax_seq, arr, n));
+	ut_assert_uint_equal(r, n, ax_box_size(vec.ax_box));
+	ut_assert(r, memcmp(ax_vector_buffer(vec.ax_vector), arr, n * sizeof *arr) == 0);
+
+	ut_printf(r, "%zu ints: ax_seq_push() spent %lfs, ax_seq_push_n() spent %lfs",
+			n, push_time, (double)(clock() - time_before) / CLOCKS_PER_SEC);
+
+	ax_one_free(vec.ax_one);
+	free(arr);
+}
+
 ut_suite *suite_for_vector()
 {
 	ut_suite* suite = ut_suite_create("vector");
@@ -268,6 +369,10 @@ ut_suite *suite_for_vector()
 	ut_suite_add(suite, seq_insert_for_riter, 0);
 	ut_suite_add(suite, seq_trunc, 0);
 	ut_suite_add(suite, seq_invert, 0);
+	ut_suite_add(suite, seq_push_n, 0);
+	ut_suite_add(suite, seq_insert_range, 0);
+	ut_suite_add(suite, seq_erase_range, 0);
+	ut_suite_add(suite, push_time, 0);
 
 	return suite;
 }